@@ -1,4 +1,5 @@
 set(_ParaViewPlugin_cmake_dir "${CMAKE_CURRENT_LIST_DIR}")
+set(_ParaViewPlugin_script_file "${CMAKE_CURRENT_LIST_FILE}")
 
 #[==[.md
 # ParaView Plugin CMake API
@@ -1400,6 +1401,46 @@ function (paraview_add_plugin name)
     COMPONENT "${_paraview_build_PLUGINS_COMPONENT}"
     ARCHIVE DESTINATION "${_paraview_add_plugin_destination}"
     LIBRARY DESTINATION "${_paraview_add_plugin_destination}")
+
+  # Generate the manifest describing the proxies of the plugin next to its
+  # library so that it may be loaded on demand.
+  set(_paraview_add_plugin_manifest_xmls
+    ${_paraview_add_plugin_module_xmls}
+    ${_paraview_add_plugin_xmls})
+  if (_paraview_add_plugin_built_shared AND _paraview_add_plugin_manifest_xmls)
+    # Plugins with client-side components have to be loaded eagerly.
+    set(_paraview_add_plugin_defer 1)
+    if (_paraview_add_plugin_with_ui OR _paraview_add_plugin_with_python)
+      set(_paraview_add_plugin_defer 0)
+    endif ()
+
+    set(_paraview_add_plugin_manifest_xmls_file
+      "${CMAKE_CURRENT_BINARY_DIR}/CMakeFiles/${_paraview_build_plugin}-manifest-xmls.txt")
+    file(GENERATE
+      OUTPUT  "${_paraview_add_plugin_manifest_xmls_file}"
+      CONTENT "${_paraview_add_plugin_manifest_xmls}")
+    string(REPLACE ";" "," _paraview_add_plugin_manifest_requires
+      "${_paraview_add_plugin_REQUIRED_PLUGINS}")
+    set(_paraview_add_plugin_manifest
+      "$<TARGET_FILE_DIR:${_paraview_build_plugin}>/${_paraview_build_plugin}.manifest.xml")
+    add_custom_command(
+      TARGET  "${_paraview_build_plugin}"
+      POST_BUILD
+      COMMAND "${CMAKE_COMMAND}"
+              "-Dplugin_name=${_paraview_build_plugin}"
+              "-Ddefer=${_paraview_add_plugin_defer}"
+              "-Drequires=${_paraview_add_plugin_manifest_requires}"
+              "-Dxmls_file=${_paraview_add_plugin_manifest_xmls_file}"
+              "-Doutput_file=${_paraview_add_plugin_manifest}"
+              -D_paraview_plugin_manifest_run=ON
+              -P "${_ParaViewPlugin_script_file}"
+      COMMENT "Generating manifest for the ${_paraview_build_plugin} plugin"
+      VERBATIM)
+    install(
+      FILES       "${_paraview_add_plugin_manifest}"
+      DESTINATION "${_paraview_add_plugin_destination}"
+      COMPONENT   "${_paraview_build_PLUGINS_COMPONENT}")
+  endif ()
 endfunction ()
 
 #[==[.md
@@ -2107,3 +2148,36 @@ function (paraview_plugin_add_proxy)
     "${CMAKE_CURRENT_BINARY_DIR}/${_paraview_proxy_NAME}ServerManagerModelImplementation.h"
     PARENT_SCOPE)
 endfunction ()
+
+# Generate a plugin manifest.
+if (_paraview_plugin_manifest_run AND CMAKE_SCRIPT_MODE_FILE)
+  file(READ "${xmls_file}" xmls)
+  string(REPLACE "," ";" requires "${requires}")
+
+  set(_paraview_pm_content
+    "<PluginManifest name=\"${plugin_name}\" defer=\"${defer}\">\n")
+  foreach (_paraview_pm_require IN LISTS requires)
+    string(APPEND _paraview_pm_content
+      "  <Requires name=\"${_paraview_pm_require}\" />\n")
+  endforeach ()
+
+  foreach (_paraview_pm_xml IN LISTS xmls)
+    file(READ "${_paraview_pm_xml}" _paraview_pm_xml_content)
+    # Drop the XML declaration, the manifest has its own root element.
+    string(REGEX REPLACE "<\\?xml[^>]*\\?>" "" _paraview_pm_xml_content
+      "${_paraview_pm_xml_content}")
+    if (NOT _paraview_pm_xml_content MATCHES "<ServerManagerConfiguration[ \t\r\n>]" OR
+        NOT _paraview_pm_xml_content MATCHES "</ServerManagerConfiguration>")
+      message(FATAL_ERROR
+        "The `${plugin_name}` plugin manifest cannot be generated: "
+        "`${_paraview_pm_xml}` is not a server manager configuration file.")
+    endif ()
+    string(APPEND _paraview_pm_content
+      "${_paraview_pm_xml_content}\n")
+  endforeach ()
+  string(APPEND _paraview_pm_content
+    "</PluginManifest>\n")
+
+  file(WRITE "${output_file}"
+    "${_paraview_pm_content}")
+endif ()
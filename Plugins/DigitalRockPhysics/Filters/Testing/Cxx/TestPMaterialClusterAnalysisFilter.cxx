@@ -0,0 +1,158 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPMaterialClusterAnalysisFilter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkPMaterialClusterAnalysisFilter gives the same cluster volumes
+// and centers in parallel, each process holding a slab of the image, as on a
+// single process with the complete image.
+
+#include "vtkDataArray.h"
+#include "vtkDummyController.h"
+#include "vtkFieldData.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkPMaterialClusterAnalysisFilter.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <array>
+#include <cmath>
+#include <map>
+
+#define expect(x, msg)                                                                             \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << __LINE__ << ": " msg << endl;                                                          \
+    return EXIT_FAILURE;                                                                           \
+  }
+
+namespace
+{
+const int Dimension = 12;
+const int SlabThickness = 4;
+
+// Image of Dimension x Dimension x (SlabThickness * numberOfSlabs) points,
+// restricted to the given slabs, with labels in [-20, 20]. 0 is the rockfill.
+vtkSmartPointer<vtkImageData> MakeImage(int firstSlab, int lastSlab)
+{
+  auto image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(0, Dimension - 1, 0, Dimension - 1, firstSlab * SlabThickness,
+    (lastSlab + 1) * SlabThickness - 1);
+  vtkNew<vtkIntArray> labels;
+  labels->SetName("Material");
+  labels->SetNumberOfTuples(image->GetNumberOfPoints());
+  int* extent = image->GetExtent();
+  vtkIdType idx = 0;
+  for (int k = extent[4]; k <= extent[5]; k++)
+  {
+    for (int j = extent[2]; j <= extent[3]; j++)
+    {
+      for (int i = extent[0]; i <= extent[1]; i++, idx++)
+      {
+        labels->SetValue(idx, (i + 3 * j + 7 * k) % 41 - 20);
+      }
+    }
+  }
+  image->GetPointData()->SetScalars(labels);
+  return image;
+}
+
+struct ClusterValues
+{
+  double Volume;
+  std::array<double, 3> Center;
+};
+
+std::map<int, ClusterValues> GetClusters(vtkImageData* output)
+{
+  std::map<int, ClusterValues> clusters;
+  vtkFieldData* fd = output->GetFieldData();
+  vtkDataArray* labels = fd->GetArray("Label");
+  vtkDataArray* volumes = fd->GetArray("Volume");
+  vtkDataArray* centers = fd->GetArray("Center");
+  for (vtkIdType idx = 0; idx < labels->GetNumberOfTuples(); idx++)
+  {
+    ClusterValues& values = clusters[static_cast<int>(labels->GetComponent(idx, 0))];
+    values.Volume = volumes->GetComponent(idx, 0);
+    centers->GetTuple(idx, values.Center.data());
+  }
+  return clusters;
+}
+
+int Check(vtkImageData* serial, vtkImageData* parallel, int rank)
+{
+  const std::map<int, ClusterValues> serialClusters = GetClusters(serial);
+  const std::map<int, ClusterValues> parallelClusters = GetClusters(parallel);
+  expect(!parallelClusters.empty(), "no cluster");
+  expect(rank != 0 || parallelClusters.size() == serialClusters.size(),
+    "the first process does not report every cluster");
+  for (const auto& it : parallelClusters)
+  {
+    auto serialIt = serialClusters.find(it.first);
+    expect(serialIt != serialClusters.end(), "unexpected cluster");
+    expect(it.second.Volume == serialIt->second.Volume, "wrong cluster volume");
+    for (int i = 0; i < 3; i++)
+    {
+      expect(std::abs(it.second.Center[i] - serialIt->second.Center[i]) < 1e-9,
+        "wrong cluster center");
+    }
+  }
+
+  // the points of the slab are at the same place in the complete image
+  vtkDataArray* serialVolumes = serial->GetPointData()->GetArray("Volume");
+  vtkDataArray* parallelVolumes = parallel->GetPointData()->GetArray("Volume");
+  const vtkIdType offset = rank * SlabThickness * Dimension * Dimension;
+  for (vtkIdType idx = 0; idx < parallelVolumes->GetNumberOfTuples(); idx++)
+  {
+    expect(parallelVolumes->GetComponent(idx, 0) ==
+        serialVolumes->GetComponent(offset + idx, 0),
+      "wrong point volume");
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestPMaterialClusterAnalysisFilter(int argc, char* argv[])
+{
+  vtkMPIController* contr = vtkMPIController::New();
+  contr->Initialize(&argc, &argv);
+
+  const int rank = contr->GetLocalProcessId();
+  const int numProcs = contr->GetNumberOfProcesses();
+
+  int status = EXIT_SUCCESS;
+  {
+    // the filter reduces the clusters over the global controller
+    vtkNew<vtkDummyController> serialContr;
+    vtkMultiProcessController::SetGlobalController(serialContr);
+    vtkNew<vtkPMaterialClusterAnalysisFilter> serial;
+    serial->SetInputData(MakeImage(0, numProcs - 1));
+    serial->Update();
+
+    vtkMultiProcessController::SetGlobalController(contr);
+    vtkNew<vtkPMaterialClusterAnalysisFilter> parallel;
+    parallel->SetInputData(MakeImage(rank, rank));
+    parallel->Update();
+
+    status = Check(serial->GetOutput(), parallel->GetOutput(), rank);
+  }
+  int globalStatus = EXIT_SUCCESS;
+  contr->AllReduce(&status, &globalStatus, 1, vtkCommunicator::MAX_OP);
+
+  vtkMultiProcessController::SetGlobalController(nullptr);
+  contr->Finalize();
+  contr->Delete();
+  return globalStatus;
+}
@@ -29,12 +29,10 @@
 #include "vtkSMPTools.h"
 #include "vtkTable.h"
 
-#define BROADCAST_VALUES_TAG 621
-
 #include <array>
 #include <atomic>
 #include <map>
-#include <set>
+#include <vector>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkPMaterialClusterAnalysisFilter);
@@ -61,8 +59,7 @@ void vtkPMaterialClusterAnalysisFilter::PrintSelf(ostream& os, vtkIndent indent)
 namespace
 {
 typedef std::map<int, std::pair<unsigned int, std::array<double, 3> > >
-  LabelValuesMap;                                    // cluster label -> { count, barycenter }
-typedef std::map<int, std::set<int> > LabelRanksMap; // cluster label -> { list of rank using it }
+  LabelValuesMap; // cluster label -> { count, barycenter }
 
 //----------------------------------------------------------------------------
 void Barycenter(unsigned int weight1, const double* point1, unsigned int weight2,
@@ -105,129 +102,169 @@ void AppendMapToTable(LabelValuesMap& lvMap, vtkTable* table)
 }
 
 //----------------------------------------------------------------------------
-bool AppendTableToMap(vtkTable* table, LabelValuesMap& lvMap, int rockfillLabel, bool center = true)
+// Reduces the label values of all ranks. Every label is owned by one rank,
+// which receives the volume and the volume weighted center of that label from
+// the ranks that use it, sums them up and sends the result back to these
+// ranks only, so that the memory used on a rank grows with the number of
+// labels it uses or owns rather than with the global number of labels.
+// On return, lvMap contains the reduced values of all the labels on rank 0 and
+// of the labels used locally on the other ranks.
+int ReduceLabelValues(vtkAlgorithm* that, LabelValuesMap& lvMap)
 {
-  vtkIntArray* labelArray = vtkIntArray::SafeDownCast(table->GetColumnByName("Label"));
-  vtkDoubleArray* volumeArray = vtkDoubleArray::SafeDownCast(table->GetColumnByName("Volume"));
-  vtkDoubleArray* barycenterArray = vtkDoubleArray::SafeDownCast(table->GetColumnByName("Center"));
-
-  if (!labelArray || !volumeArray || (!barycenterArray && center))
+  vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
+  if (!controller || (controller && controller->GetNumberOfProcesses() <= 1))
   {
-    vtkErrorWithObjectMacro(table, "Could not Append table to map");
-    return false;
+    return 1;
   }
 
-  std::array<double, 3> barycenter;
-  vtkIdType nRows = table->GetNumberOfRows();
-  for (vtkIdType iRow = 0; iRow < nRows; iRow++)
+  that->SetProgressText("Reducing data");
+  that->UpdateProgress(0.0);
+
+  const int nRanks = controller->GetNumberOfProcesses();
+  const int localRank = controller->GetLocalProcessId();
+
+  // { label, volume, volume * center } for the labels owned by every rank
+  const int entrySize = 5;
+  std::vector<std::vector<double> > sendEntries(nRanks);
+  for (const auto& it : lvMap)
   {
-    int label = labelArray->GetValue(iRow);
-    if (label != rockfillLabel)
+    const int owner = ((it.first % nRanks) + nRanks) % nRanks;
+    const double volume = it.second.first;
+    std::vector<double>& entries = sendEntries[owner];
+    entries.push_back(it.first);
+    entries.push_back(volume);
+    for (int i = 0; i < 3; i++)
     {
-      double volume = volumeArray->GetValue(iRow);
-      if (center)
-      {
-        barycenterArray->GetTuple(iRow, &barycenter[0]);
-      }
-      auto iter = lvMap.emplace(label, std::make_pair(volume, barycenter));
-      if (!iter.second)
-      {
-        if (center)
-        {
-          Barycenter(iter.first->second.first, &iter.first->second.second[0], volume,
-            &barycenter[0], &iter.first->second.second[0]);
-        }
-        iter.first->second.first += volume;
-      }
+      entries.push_back(volume * it.second.second[i]);
     }
   }
-  return true;
-}
-
-//----------------------------------------------------------------------------
-int ReduceTable(vtkAlgorithm* that, LabelValuesMap& lvMap, vtkTable* table, int rockfillLabel)
-{
-  vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
-  if (!controller || (controller && controller->GetNumberOfProcesses() <= 1))
+  std::vector<vtkIdType> sendLengths(nRanks);
+  for (int iRank = 0; iRank < nRanks; iRank++)
   {
-    return 1;
+    sendLengths[iRank] = static_cast<vtkIdType>(sendEntries[iRank].size());
   }
-
-  that->SetProgressText("Reducing data");
-  that->UpdateProgress(0.0);
-  std::vector<vtkSmartPointer<vtkDataObject> > recv;
-  controller->Gather(table, recv, 0);
-  while (table->GetNumberOfColumns() != 0)
+  std::vector<vtkIdType> allLengths(nRanks * nRanks);
+  if (!controller->AllGather(sendLengths.data(), allLengths.data(), nRanks))
   {
-    table->RemoveColumn(0);
+    vtkErrorWithObjectMacro(controller, "Could not reduce labels from other ranks");
+    return 0;
   }
 
-  if (controller->GetLocalProcessId() == 0)
+  // Gather on every owner the entries of the labels it owns.
+  std::vector<vtkIdType> recvLengths(nRanks);
+  std::vector<vtkIdType> recvOffsets(nRanks);
+  vtkIdType recvSize = 0;
+  for (int iRank = 0; iRank < nRanks; iRank++)
+  {
+    recvLengths[iRank] = allLengths[iRank * nRanks + localRank];
+    recvOffsets[iRank] = recvSize;
+    recvSize += recvLengths[iRank];
+  }
+  std::vector<double> recvEntries(recvSize);
+  for (int owner = 0; owner < nRanks; owner++)
   {
-    LabelRanksMap ranksMap;
-    for (size_t iRank = 1; iRank < recv.size(); iRank++)
+    if (!controller->GatherV(sendEntries[owner].data(), recvEntries.data(), sendLengths[owner],
+          recvLengths.data(), recvOffsets.data(), owner))
     {
-      vtkTable* localTable = vtkTable::SafeDownCast(recv[iRank]);
-      if (!localTable)
-      {
-        vtkErrorWithObjectMacro(controller, "Could not reduce tables from other ranks");
-        return 0;
-      }
-
-      // Create Label Values Map
-      if (!AppendTableToMap(localTable, lvMap, rockfillLabel))
-      {
-        vtkErrorWithObjectMacro(
-          controller, "Could not append table to map. This rank will be ignored.");
-        continue;
-      }
+      vtkErrorWithObjectMacro(controller, "Could not reduce label values from other ranks");
+      return 0;
+    }
+  }
+  that->UpdateProgress(0.3);
 
-      // Create ranks map
-      vtkIdType nRows = localTable->GetNumberOfRows();
-      vtkIntArray* tmpLabelArray = vtkIntArray::SafeDownCast(localTable->GetColumnByName("Label"));
-      if (!tmpLabelArray)
-      {
-        vtkErrorWithObjectMacro(
-          controller, "Could not create ranks map. This rank will be ignored.");
-        continue;
-      }
-      for (vtkIdType iRow = 0; iRow < nRows; iRow++)
-      {
-        int tmpLabel = tmpLabelArray->GetValue(iRow);
-        ranksMap[tmpLabel].insert(static_cast<int>(iRank));
-      }
+  // { volume, volume * center } for every owned label
+  std::map<int, std::array<double, 4> > ownedSums;
+  for (vtkIdType idx = 0; idx < recvSize; idx += entrySize)
+  {
+    auto& sums = ownedSums[static_cast<int>(recvEntries[idx])];
+    for (int i = 0; i < 4; i++)
+    {
+      sums[i] += recvEntries[idx + 1 + i];
     }
-    that->UpdateProgress(0.8);
+  }
+  // { label, volume, center } for every owned label
+  std::vector<double> ownedValues;
+  ownedValues.reserve(entrySize * ownedSums.size());
+  for (auto& it : ownedSums)
+  {
+    const double volume = it.second[0];
+    ownedValues.push_back(it.first);
+    ownedValues.push_back(volume);
+    for (int i = 0; i < 3; i++)
+    {
+      it.second[1 + i] /= volume;
+      ownedValues.push_back(it.second[1 + i]);
+    }
+  }
 
-    // Export map to a vtkTable
-    AppendMapToTable(lvMap, table);
+  // Send the reduced values back to the ranks that use the labels, in the
+  // order they were received.
+  for (vtkIdType idx = 0; idx < recvSize; idx += entrySize)
+  {
+    const auto& sums = ownedSums[static_cast<int>(recvEntries[idx])];
+    recvEntries[idx + 1] = sums[0];
+    for (int i = 0; i < 3; i++)
+    {
+      recvEntries[idx + 2 + i] = sums[1 + i];
+    }
+  }
+  for (int owner = 0; owner < nRanks; owner++)
+  {
+    if (!controller->ScatterV(recvEntries.data(), sendEntries[owner].data(), recvLengths.data(),
+          recvOffsets.data(), sendLengths[owner], owner))
+    {
+      vtkErrorWithObjectMacro(controller, "Could not reduce label values from other ranks");
+      return 0;
+    }
+  }
+  that->UpdateProgress(0.6);
+
+  // Rank 0 reports every label, so it also gathers the values of all the
+  // labels owned by the other ranks.
+  vtkIdType ownedSize = static_cast<vtkIdType>(ownedValues.size());
+  std::vector<vtkIdType> ownedLengths(nRanks, 0);
+  std::vector<vtkIdType> ownedOffsets(nRanks, 0);
+  if (!controller->Gather(&ownedSize, ownedLengths.data(), 1, 0))
+  {
+    vtkErrorWithObjectMacro(controller, "Could not reduce labels from other ranks");
+    return 0;
+  }
+  vtkIdType allOwnedSize = 0;
+  for (int iRank = 0; iRank < nRanks; iRank++)
+  {
+    ownedOffsets[iRank] = allOwnedSize;
+    allOwnedSize += ownedLengths[iRank];
+  }
+  std::vector<double> allValues(localRank == 0 ? allOwnedSize : 0);
+  if (!controller->GatherV(ownedValues.data(), allValues.data(), ownedSize, ownedLengths.data(),
+        ownedOffsets.data(), 0))
+  {
+    vtkErrorWithObjectMacro(controller, "Could not reduce label values from other ranks");
+    return 0;
+  }
+  that->UpdateProgress(0.8);
 
-    // Broadcast it rank by rank using the ranks map
-    vtkDataSetAttributes* attr = table->GetRowData();
-    vtkIntArray* labelArray = vtkIntArray::SafeDownCast(table->GetColumnByName("Label"));
-    for (int iRank = 1; iRank < controller->GetNumberOfProcesses(); iRank++)
+  for (int owner = 0; owner < nRanks; owner++)
+  {
+    const std::vector<double>& entries = sendEntries[owner];
+    for (size_t idx = 0; idx < entries.size(); idx += entrySize)
     {
-      vtkNew<vtkTable> localTable;
-      vtkDataSetAttributes* localAttr = localTable->GetRowData();
-      localAttr->CopyAllocate(attr);
-      vtkIdType iRowLocal = 0;
-      for (vtkIdType iRow = 0; iRow < table->GetNumberOfRows(); iRow++)
+      auto& value = lvMap[static_cast<int>(entries[idx])];
+      value.first = static_cast<unsigned int>(entries[idx + 1]);
+      for (int i = 0; i < 3; i++)
       {
-        auto tmpSet = ranksMap[labelArray->GetValue(iRow)];
-        if (tmpSet.find(iRank) != tmpSet.end())
-        {
-          localAttr->CopyData(attr, iRow, iRowLocal);
-          iRowLocal++;
-        }
+        value.second[i] = entries[idx + 2 + i];
       }
-      localAttr->Squeeze();
-      controller->Send(localTable, iRank, BROADCAST_VALUES_TAG);
     }
   }
-  else
+  for (size_t idx = 0; idx < allValues.size(); idx += entrySize)
   {
-    // Receive our own label values map
-    controller->Receive(table, 0, BROADCAST_VALUES_TAG);
+    auto& value = lvMap[static_cast<int>(allValues[idx])];
+    value.first = static_cast<unsigned int>(allValues[idx + 1]);
+    for (int i = 0; i < 3; i++)
+    {
+      value.second[i] = allValues[idx + 2 + i];
+    }
   }
 
   return 1;
@@ -366,17 +403,13 @@ int vtkPMaterialClusterAnalysisFilter::RequestData(vtkInformation* vtkNotUsed(re
   this->SetProgressText("Processing data");
   this->UpdateProgress(0.0);
 
-  vtkNew<vtkTable> table;
-  ::AppendMapToTable(lvMap, table.Get());
-
-  if (!::ReduceTable(this, lvMap, table.Get(), this->RockfillLabel))
+  if (!::ReduceLabelValues(this, lvMap))
   {
     return 0;
   }
 
-  // Copy reduced volume to map
-  LabelValuesMap localLvMap;
-  ::AppendTableToMap(table, localLvMap, this->RockfillLabel, false);
+  vtkNew<vtkTable> table;
+  ::AppendMapToTable(lvMap, table.Get());
 
   // Use map to fill point data with volume and center
   vtkNew<vtkDoubleArray> volumeArray;
@@ -387,7 +420,7 @@ int vtkPMaterialClusterAnalysisFilter::RequestData(vtkInformation* vtkNotUsed(re
     int tmpLabel = array->GetVariantValue(i).ToInt();
     if (tmpLabel != this->RockfillLabel)
     {
-      auto& value = localLvMap[tmpLabel];
+      auto& value = lvMap[tmpLabel];
       volumeArray->SetValue(i, value.first);
     }
     else
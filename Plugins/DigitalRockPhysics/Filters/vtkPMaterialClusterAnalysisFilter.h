@@ -27,7 +27,9 @@
  * Note that this filter has two levels of parallelization: it takes benefit of
  * data parallelism if it is enabled (eg. MPI), but it takes also benefit from
  * task parallelism using the SMP feature of VTK if enabled (OpenMP, TBB, etc.)
- * to perform faster.
+ * to perform faster. In parallel, the volume and barycenter of every cluster
+ * are reduced on the rank that owns its label and sent back to the ranks that
+ * use it. Only the first rank reports every cluster.
  *
  * @par Thanks:
  * This class was written by Joachim Pouderoux and Mathieu Westphal, Kitware 2017
@@ -0,0 +1,189 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestFastMarchingFlatArrays.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkFastMarchingGeodesicDistance gives the same distances with
+// UseFlatArrays on as with the GW_GeodesicMesh, with and without the optional
+// stop criteria, exclusion region and propagation weights.
+
+#include "vtkFastMarchingGeodesicDistance.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPlaneSource.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTriangleFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+
+namespace
+{
+vtkSmartPointer<vtkPolyData> MakeSphere()
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(40);
+  sphere->SetPhiResolution(30);
+  sphere->SetRadius(2.0);
+  sphere->Update();
+  return sphere->GetOutput();
+}
+
+// A triangulated plane whose points are jittered, hence with obtuse
+// triangles that need unfolding.
+vtkSmartPointer<vtkPolyData> MakeJitteredPlane()
+{
+  vtkNew<vtkPlaneSource> plane;
+  plane->SetResolution(30, 30);
+  vtkNew<vtkTriangleFilter> triangles;
+  triangles->SetInputConnection(plane->GetOutputPort());
+  triangles->Update();
+
+  auto mesh = vtkSmartPointer<vtkPolyData>::New();
+  mesh->DeepCopy(triangles->GetOutput());
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(42);
+  vtkPoints* points = mesh->GetPoints();
+  const double step = 1.0 / 30;
+  for (vtkIdType cc = 0; cc < points->GetNumberOfPoints(); ++cc)
+  {
+    double x[3];
+    points->GetPoint(cc, x);
+    for (int i = 0; i < 2; ++i)
+    {
+      random->Next();
+      x[i] += random->GetRangeValue(-0.35, 0.35) * step;
+    }
+    points->SetPoint(cc, x);
+  }
+  return mesh;
+}
+
+vtkSmartPointer<vtkPolyData> March(vtkPolyData* mesh, bool flat,
+  const std::function<void(vtkFastMarchingGeodesicDistance*)>& configure,
+  vtkFastMarchingGeodesicDistance* filter)
+{
+  filter->SetInputData(mesh);
+  filter->SetFieldDataName("distance");
+  filter->SetUseFlatArrays(flat);
+  configure(filter);
+  filter->Update();
+  return filter->GetOutput();
+}
+
+bool Compare(vtkPolyData* mesh, const std::string& name,
+  const std::function<void(vtkFastMarchingGeodesicDistance*)>& configure)
+{
+  vtkNew<vtkFastMarchingGeodesicDistance> gw;
+  vtkNew<vtkFastMarchingGeodesicDistance> flat;
+  vtkSmartPointer<vtkPolyData> expected = March(mesh, false, configure, gw);
+  vtkSmartPointer<vtkPolyData> actual = March(mesh, true, configure, flat);
+
+  auto e = vtkFloatArray::SafeDownCast(expected->GetPointData()->GetArray("distance"));
+  auto a = vtkFloatArray::SafeDownCast(actual->GetPointData()->GetArray("distance"));
+  if (!e || !a || e->GetNumberOfTuples() != a->GetNumberOfTuples())
+  {
+    cerr << name << ": missing distance field." << endl;
+    return false;
+  }
+  if (gw->GetNumberOfVisitedPoints() != flat->GetNumberOfVisitedPoints())
+  {
+    cerr << name << ": visited " << flat->GetNumberOfVisitedPoints() << " points instead of "
+         << gw->GetNumberOfVisitedPoints() << endl;
+    return false;
+  }
+  for (vtkIdType cc = 0; cc < e->GetNumberOfTuples(); ++cc)
+  {
+    const float ev = e->GetValue(cc);
+    const float av = a->GetValue(cc);
+    if (!(std::abs(ev - av) <= 1e-4f * std::max(1.f, std::abs(ev))))
+    {
+      cerr << name << ": point " << cc << ": expected " << ev << ", got " << av << endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestFastMarchingFlatArrays(int, char*[])
+{
+  bool success = true;
+  for (auto mesh : { MakeSphere(), MakeJitteredPlane() })
+  {
+    const vtkIdType numPoints = mesh->GetNumberOfPoints();
+
+    success &= Compare(mesh, "one seed", [](vtkFastMarchingGeodesicDistance* filter) {
+      vtkNew<vtkIdList> seeds;
+      seeds->InsertNextId(0);
+      filter->SetSeeds(seeds);
+    });
+
+    success &= Compare(mesh, "two seeds", [numPoints](vtkFastMarchingGeodesicDistance* filter) {
+      vtkNew<vtkIdList> seeds;
+      seeds->InsertNextId(0);
+      seeds->InsertNextId(numPoints / 2 + 7);
+      filter->SetSeeds(seeds);
+    });
+
+    success &= Compare(mesh, "distance stop", [](vtkFastMarchingGeodesicDistance* filter) {
+      vtkNew<vtkIdList> seeds;
+      seeds->InsertNextId(0);
+      filter->SetSeeds(seeds);
+      filter->SetDistanceStopCriterion(0.5);
+    });
+
+    success &=
+      Compare(mesh, "destination stop", [numPoints](vtkFastMarchingGeodesicDistance* filter) {
+        vtkNew<vtkIdList> seeds;
+        seeds->InsertNextId(0);
+        filter->SetSeeds(seeds);
+        vtkNew<vtkIdList> destinations;
+        destinations->InsertNextId(numPoints / 3);
+        filter->SetDestinationVertexStopCriterion(destinations);
+      });
+
+    success &= Compare(mesh, "exclusion", [numPoints](vtkFastMarchingGeodesicDistance* filter) {
+      vtkNew<vtkIdList> seeds;
+      seeds->InsertNextId(0);
+      filter->SetSeeds(seeds);
+      vtkNew<vtkIdList> excluded;
+      for (vtkIdType cc = numPoints / 4; cc < numPoints / 4 + 20; ++cc)
+      {
+        excluded->InsertNextId(cc);
+      }
+      filter->SetExclusionPointIds(excluded);
+    });
+
+    vtkNew<vtkFloatArray> weights;
+    weights->SetNumberOfTuples(numPoints);
+    for (vtkIdType cc = 0; cc < numPoints; ++cc)
+    {
+      weights->SetValue(cc, 1.0f + static_cast<float>(cc % 7) / 7.0f);
+    }
+    success &= Compare(mesh, "weights", [&weights](vtkFastMarchingGeodesicDistance* filter) {
+      vtkNew<vtkIdList> seeds;
+      seeds->InsertNextId(0);
+      filter->SetSeeds(seeds);
+      filter->SetPropagationWeights(weights);
+    });
+  }
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -31,13 +31,20 @@
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStaticCellLinks.h"
 
 #include "gw_core/GW_Face.h"
 #include "gw_core/GW_Vertex.h"
 #include "gw_geodesic/GW_GeodesicMesh.h"
 #include "gw_geodesic/GW_GeodesicPath.h"
+#include <algorithm>
 #include <assert.h>
+#include <cmath>
 #include <set>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 // new is being defined to a new method that takes in 4 parameters.
@@ -53,6 +60,481 @@ vtkCxxSetObjectMacro(vtkFastMarchingGeodesicDistance, DestinationVertexStopCrite
 vtkCxxSetObjectMacro(vtkFastMarchingGeodesicDistance, ExclusionPointIds, vtkIdList);
 vtkCxxSetObjectMacro(vtkFastMarchingGeodesicDistance, PropagationWeights, vtkDataArray);
 
+//-----------------------------------------------------------------------------
+// Fast marching performed directly on flat arrays built from the vtkPolyData:
+// the point coordinates, the triangle connectivity and the point to triangle
+// adjacency of vtkStaticCellLinks. The update scheme is the one of
+// GW_GeodesicMesh::PerformFastMarchingOneStep (Sethian's update, unfolding of
+// obtuse triangles and one front per seed), but all indices are vtkIdType and
+// the narrow band is an indexed binary heap instead of a std::multimap.
+class vtkFlatFastMarching
+{
+public:
+  enum
+  {
+    Far = 0,
+    Alive = 1,
+    Dead = 2
+  };
+
+  // Build the arrays from a triangle mesh. Returns false if the mesh has
+  // cells other than triangles.
+  bool Build(vtkPolyData* in)
+  {
+    const vtkIdType nPts = in->GetNumberOfPoints();
+    vtkPoints* pts = in->GetPoints();
+    this->Points.resize(3 * nPts);
+    for (vtkIdType i = 0; i < nPts; i++)
+    {
+      pts->GetPoint(i, &this->Points[3 * i]);
+    }
+
+    this->Triangles.clear();
+    vtkCellArray* cells = in->GetPolys();
+    const vtkIdType nCells = cells ? cells->GetNumberOfCells() : 0;
+    this->Triangles.reserve(3 * nCells);
+    if (cells)
+    {
+      vtkIdType npts = 0;
+      const vtkIdType* ptIds = nullptr;
+      for (cells->InitTraversal(); cells->GetNextCell(npts, ptIds);)
+      {
+        if (npts != 3)
+        {
+          this->Triangles.clear();
+          return false;
+        }
+        this->Triangles.insert(this->Triangles.end(), ptIds, ptIds + 3);
+      }
+    }
+
+    // Only keep the triangles so that the cell ids of the links are the
+    // triangle ids.
+    vtkNew<vtkPolyData> triangles;
+    triangles->SetPoints(pts);
+    if (cells)
+    {
+      triangles->SetPolys(cells);
+    }
+    this->Links->BuildLinks(triangles);
+
+    this->Distance.resize(nPts);
+    this->Front.resize(nPts);
+    this->State.resize(nPts);
+    this->HeapIndex.resize(nPts);
+    this->BuildTime.Modified();
+    return true;
+  }
+
+  vtkIdType GetNumberOfPoints() const
+  {
+    return static_cast<vtkIdType>(this->State.size());
+  }
+
+  void Reset()
+  {
+    std::fill(this->Distance.begin(), this->Distance.end(), GW_INFINITE);
+    std::fill(this->Front.begin(), this->Front.end(), -1);
+    std::fill(this->State.begin(), this->State.end(), static_cast<unsigned char>(Far));
+    std::fill(this->HeapIndex.begin(), this->HeapIndex.end(), -1);
+    this->Heap.clear();
+  }
+
+  void AddSeed(vtkIdType ptId)
+  {
+    if (ptId < 0 || ptId >= this->GetNumberOfPoints() || this->State[ptId] != Far)
+    {
+      return;
+    }
+    this->Front[ptId] = ptId;
+    this->Distance[ptId] = 0;
+    this->State[ptId] = Alive;
+    this->Push(ptId);
+  }
+
+  // Performs one step of the marching. Returns true when the marching is done.
+  bool Step()
+  {
+    if (this->Heap.empty())
+    {
+      return true;
+    }
+
+    const vtkIdType cur = this->Pop();
+    this->State[cur] = Dead;
+    const vtkIdType front = this->Front[cur];
+
+    // Neighbors of the current vertex, each one once.
+    this->Neighbors.clear();
+    const vtkIdType nFaces = this->Links->GetNcells(cur);
+    const vtkIdType* faces = this->Links->GetCells(cur);
+    for (vtkIdType i = 0; i < nFaces; i++)
+    {
+      const vtkIdType* tri = &this->Triangles[3 * faces[i]];
+      for (int j = 0; j < 3; j++)
+      {
+        if (tri[j] != cur &&
+          std::find(this->Neighbors.begin(), this->Neighbors.end(), tri[j]) ==
+            this->Neighbors.end())
+        {
+          this->Neighbors.push_back(tri[j]);
+        }
+      }
+    }
+
+    for (const vtkIdType nb : this->Neighbors)
+    {
+      if (this->State[nb] == Dead)
+      {
+        continue;
+      }
+
+      // compute its new distance using the triangles around it
+      double newDistance = GW_INFINITE;
+      const vtkIdType nNbFaces = this->Links->GetNcells(nb);
+      const vtkIdType* nbFaces = this->Links->GetCells(nb);
+      for (vtkIdType i = 0; i < nNbFaces; i++)
+      {
+        const vtkIdType face = nbFaces[i];
+        const vtkIdType* tri = &this->Triangles[3 * face];
+        const int k = tri[0] == nb ? 0 : (tri[1] == nb ? 1 : 2);
+        vtkIdType v1 = tri[(k + 1) % 3];
+        vtkIdType v2 = tri[(k + 2) % 3];
+        if (this->Distance[v1] > this->Distance[v2])
+        {
+          std::swap(v1, v2);
+        }
+        newDistance =
+          std::min(newDistance, this->ComputeVertexDistance(face, nb, v1, v2, front));
+      }
+
+      if (this->State[nb] == Far)
+      {
+        if (this->Excluded.empty() || !this->Excluded[nb])
+        {
+          this->Distance[nb] = newDistance;
+          this->State[nb] = Alive;
+          this->Front[nb] = front;
+          this->Push(nb);
+        }
+      }
+      else if (newDistance <= this->Distance[nb])
+      {
+        const bool decreased = newDistance < this->Distance[nb];
+        this->Distance[nb] = newDistance;
+        this->Front[nb] = front;
+        if (decreased)
+        {
+          this->SiftUp(this->HeapIndex[nb]);
+        }
+      }
+    }
+
+    if (this->Heap.empty())
+    {
+      return true;
+    }
+    // Same termination criteria as vtkGeodesicMeshInternals::FastMarchingStopCallback
+    if (this->DistanceStopCriterion > 0)
+    {
+      return this->DistanceStopCriterion <= this->Distance[cur];
+    }
+    return !this->Destinations.empty() && this->Destinations[cur];
+  }
+
+  // Per point weights, empty for a constant weight of 1.
+  std::vector<double> Weights;
+  // Per point flags for the exclusion region, empty if none.
+  std::vector<unsigned char> Excluded;
+  // Per point flags for the destination vertices, empty if none.
+  std::vector<unsigned char> Destinations;
+  double DistanceStopCriterion = -1;
+
+  std::vector<double> Distance;
+  std::vector<unsigned char> State;
+  vtkTimeStamp BuildTime;
+
+private:
+  void Push(vtkIdType ptId)
+  {
+    this->Heap.emplace_back(this->Distance[ptId], ptId);
+    this->HeapIndex[ptId] = static_cast<vtkIdType>(this->Heap.size()) - 1;
+    this->SiftUp(this->HeapIndex[ptId]);
+  }
+
+  vtkIdType Pop()
+  {
+    const vtkIdType top = this->Heap.front().second;
+    this->HeapIndex[top] = -1;
+    const std::pair<double, vtkIdType> last = this->Heap.back();
+    this->Heap.pop_back();
+    if (!this->Heap.empty())
+    {
+      // sift down the last element from the root
+      const vtkIdType size = static_cast<vtkIdType>(this->Heap.size());
+      vtkIdType pos = 0;
+      for (vtkIdType child = 1; child < size; child = 2 * pos + 1)
+      {
+        if (child + 1 < size && this->Heap[child + 1].first < this->Heap[child].first)
+        {
+          ++child;
+        }
+        if (!(this->Heap[child].first < last.first))
+        {
+          break;
+        }
+        this->Heap[pos] = this->Heap[child];
+        this->HeapIndex[this->Heap[pos].second] = pos;
+        pos = child;
+      }
+      this->Heap[pos] = last;
+      this->HeapIndex[last.second] = pos;
+    }
+    return top;
+  }
+
+  // Moves up the heap entry at pos after its vertex distance decreased.
+  void SiftUp(vtkIdType pos)
+  {
+    const vtkIdType ptId = this->Heap[pos].second;
+    const double key = this->Distance[ptId];
+    while (pos > 0)
+    {
+      const vtkIdType parent = (pos - 1) / 2;
+      if (!(key < this->Heap[parent].first))
+      {
+        break;
+      }
+      this->Heap[pos] = this->Heap[parent];
+      this->HeapIndex[this->Heap[pos].second] = pos;
+      pos = parent;
+    }
+    this->Heap[pos] = std::make_pair(key, ptId);
+    this->HeapIndex[ptId] = pos;
+  }
+
+  const double* Point(vtkIdType ptId) const { return &this->Points[3 * ptId]; }
+
+  // Returns the triangle sharing the edge (a, b) with face, or -1.
+  vtkIdType GetFaceNeighbor(vtkIdType face, vtkIdType a, vtkIdType b) const
+  {
+    const vtkIdType nFaces = this->Links->GetNcells(a);
+    const vtkIdType* faces = this->Links->GetCells(a);
+    for (vtkIdType i = 0; i < nFaces; i++)
+    {
+      const vtkIdType* tri = &this->Triangles[3 * faces[i]];
+      if (faces[i] != face && (tri[0] == b || tri[1] == b || tri[2] == b))
+      {
+        return faces[i];
+      }
+    }
+    return -1;
+  }
+
+  // Returns the vertex of face that is neither a nor b.
+  vtkIdType GetThirdVertex(vtkIdType face, vtkIdType a, vtkIdType b) const
+  {
+    const vtkIdType* tri = &this->Triangles[3 * face];
+    for (int j = 0; j < 3; j++)
+    {
+      if (tri[j] != a && tri[j] != b)
+      {
+        return tri[j];
+      }
+    }
+    return -1;
+  }
+
+  // See GW_GeodesicMesh::ComputeVertexDistance
+  double ComputeVertexDistance(
+    vtkIdType face, vtkIdType ptId, vtkIdType v1, vtkIdType v2, vtkIdType front) const
+  {
+    const double F = this->Weights.empty() ? 1.0 : this->Weights[ptId];
+    const unsigned char s1 = this->State[v1];
+    const unsigned char s2 = this->State[v2];
+    if (s1 == Far && s2 == Far)
+    {
+      return GW_INFINITE;
+    }
+
+    const double* p = this->Point(ptId);
+    double e1[3], e2[3];
+    for (int j = 0; j < 3; j++)
+    {
+      e1[j] = this->Point(v1)[j] - p[j];
+      e2[j] = this->Point(v2)[j] - p[j];
+    }
+    const double b = std::sqrt(e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2]);
+    const double a = std::sqrt(e2[0] * e2[0] + e2[1] * e2[1] + e2[2] * e2[2]);
+
+    const double d1 = this->Distance[v1];
+    const double d2 = this->Distance[v2];
+
+    // only take into account dead vertices of the same front
+    const bool usable1 = s1 == Dead && this->Front[v1] == front;
+    const bool usable2 = s2 == Dead && this->Front[v2] == front;
+    if (!usable1 && usable2)
+    {
+      return d2 + a * F;
+    }
+    if (usable1 && !usable2)
+    {
+      return d1 + b * F;
+    }
+    if (usable1 && usable2)
+    {
+      const double dot = (e1[0] * e2[0] + e1[1] * e2[1] + e1[2] * e2[2]) / (a * b);
+      // special case for obtuse angles
+      if (dot < 0)
+      {
+        double c, dot1, dot2;
+        const vtkIdType v3 = this->UnfoldTriangle(face, ptId, v1, v2, c, dot1, dot2);
+        if (v3 >= 0 && this->State[v3] != Far)
+        {
+          const double d3 = this->Distance[v3];
+          return std::min(vtkFlatFastMarching::ComputeUpdate(d1, d3, c, b, dot1, F),
+            vtkFlatFastMarching::ComputeUpdate(d3, d2, a, c, dot2, F));
+        }
+      }
+      return vtkFlatFastMarching::ComputeUpdate(d1, d2, a, b, dot, F);
+    }
+    return GW_INFINITE;
+  }
+
+  // Sethian's update from the 2 vertices of a triangle, see
+  // GW_GeodesicMesh::ComputeUpdate_SethianMethod
+  static double ComputeUpdate(double d1, double d2, double a, double b, double dot, double F)
+  {
+    double t = GW_INFINITE;
+    const double cosAngle = dot;
+    const double sinAngle = std::sqrt(1 - dot * dot);
+
+    const double u = d2 - d1;
+    const double f2 = a * a + b * b - 2 * a * b * cosAngle;
+    const double f1 = b * u * (a * cosAngle - b);
+    const double f0 = b * b * (u * u - F * F * a * a * sinAngle * sinAngle);
+
+    const double delta = f1 * f1 - f0 * f2;
+    if (delta >= 0)
+    {
+      if (std::abs(f2) > GW_EPSILON)
+      {
+        t = (-f1 - std::sqrt(delta)) / f2;
+        // test if we must choose the other solution
+        if (t < u || b * (t - u) / t < a * cosAngle || a / cosAngle < b * (t - u) / t)
+        {
+          t = (-f1 + std::sqrt(delta)) / f2;
+        }
+      }
+      else
+      {
+        t = f1 != 0 ? -f0 / f1 : -GW_INFINITE;
+      }
+    }
+    else
+    {
+      t = -GW_INFINITE;
+    }
+
+    // choose the update from the 2 vertices only if the upwind criterion is met
+    if (u < t && a * cosAngle < b * (t - u) / t && b * (t - u) / t < a / cosAngle)
+    {
+      return t + d1;
+    }
+    return std::min(b * F + d1, a * F + d2);
+  }
+
+  // See GW_GeodesicMesh::UnfoldTriangle
+  vtkIdType UnfoldTriangle(vtkIdType face, vtkIdType ptId, vtkIdType v1, vtkIdType v2,
+    double& dist, double& dot1, double& dot2) const
+  {
+    auto sub = [this](vtkIdType i, vtkIdType j, double e[3]) {
+      for (int k = 0; k < 3; k++)
+      {
+        e[k] = this->Point(i)[k] - this->Point(j)[k];
+      }
+      return std::sqrt(e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+    };
+    auto dot2D = [](const double x[2], const double y[2]) { return x[0] * y[0] + x[1] * y[1]; };
+
+    double e1[3], e2[3];
+    double norm1 = sub(v1, ptId, e1);
+    double norm2 = sub(v2, ptId, e2);
+    double dot = (e1[0] * e2[0] + e1[1] * e2[1] + e1[2] * e2[2]) / (norm1 * norm2);
+
+    // the lines defining the unfolding region, {x ; <x,eq> = 0}
+    const double eq1[2] = { dot, std::sqrt(1 - dot * dot) };
+    const double eq2[2] = { 1, 0 };
+
+    // position of the 2 points on the unfolding plane
+    double x1[2] = { norm1, 0 };
+    double x2[2] = { eq1[0] * norm2, eq1[1] * norm2 };
+    const double xstart1[2] = { x1[0], x1[1] };
+    const double xstart2[2] = { x2[0], x2[1] };
+
+    vtkIdType pV1 = v1;
+    vtkIdType pV2 = v2;
+    vtkIdType curFace = this->GetFaceNeighbor(face, v1, v2);
+    for (int n = 0; n < 50 && curFace >= 0; n++)
+    {
+      const vtkIdType pV = this->GetThirdVertex(curFace, pV1, pV2);
+      norm1 = sub(pV2, pV1, e1);
+      norm2 = sub(pV, pV1, e2);
+      dot = (e1[0] * e2[0] + e1[1] * e2[1] + e1[2] * e2[2]) / (norm1 * norm2);
+
+      // rotate (x2 - x1) by -acos(dot) to get the new point on the unfolding plane
+      const double vv[2] = { (x2[0] - x1[0]) * norm2 / norm1, (x2[1] - x1[1]) * norm2 / norm1 };
+      const double angle = -std::acos(dot);
+      const double x[2] = { std::cos(angle) * vv[0] - std::sin(angle) * vv[1] + x1[0],
+        std::sin(angle) * vv[0] + std::cos(angle) * vv[1] + x1[1] };
+
+      const double xmx1[2] = { x[0] - x1[0], x[1] - x1[1] };
+      const double xmx2[2] = { x[0] - x2[0], x[1] - x2[1] };
+      const double lambda11 = -dot2D(x1, eq1) / dot2D(xmx1, eq1);
+      const double lambda12 = -dot2D(x1, eq2) / dot2D(xmx1, eq2);
+      const double lambda21 = -dot2D(x2, eq1) / dot2D(xmx2, eq1);
+      const double lambda22 = -dot2D(x2, eq2) / dot2D(xmx2, eq2);
+      const bool intersect11 = lambda11 >= 0 && lambda11 <= 1;
+      const bool intersect12 = lambda12 >= 0 && lambda12 <= 1;
+      const bool intersect21 = lambda21 >= 0 && lambda21 <= 1;
+      const bool intersect22 = lambda22 >= 0 && lambda22 <= 1;
+      if (intersect11 && intersect12)
+      {
+        // unfold on edge [x x1]
+        curFace = this->GetFaceNeighbor(curFace, pV1, pV);
+        pV2 = pV;
+        x2[0] = x[0];
+        x2[1] = x[1];
+      }
+      else if (intersect21 && intersect22)
+      {
+        // unfold on edge [x x2]
+        curFace = this->GetFaceNeighbor(curFace, pV2, pV);
+        pV1 = pV;
+        x1[0] = x[0];
+        x1[1] = x[1];
+      }
+      else
+      {
+        dist = std::sqrt(dot2D(x, x));
+        dot1 = dot2D(x, xstart1) / (dist * std::sqrt(dot2D(xstart1, xstart1)));
+        dot2 = dot2D(x, xstart2) / (dist * std::sqrt(dot2D(xstart2, xstart2)));
+        return pV;
+      }
+    }
+    return -1;
+  }
+
+  std::vector<double> Points;
+  std::vector<vtkIdType> Triangles;
+  vtkNew<vtkStaticCellLinks> Links;
+
+  std::vector<vtkIdType> Front;
+  std::vector<vtkIdType> HeapIndex;
+  std::vector<std::pair<double, vtkIdType> > Heap;
+  std::vector<vtkIdType> Neighbors;
+};
+
 //-----------------------------------------------------------------------------
 class vtkGeodesicMeshInternals
 {
@@ -131,6 +613,7 @@ public:
   }
 
   GW::GW_GeodesicMesh* Mesh;
+  vtkFlatFastMarching Flat;
 };
 
 //-----------------------------------------------------------------------------
@@ -144,6 +627,7 @@ vtkFastMarchingGeodesicDistance::vtkFastMarchingGeodesicDistance()
   this->DestinationVertexStopCriterion = NULL;
   this->ExclusionPointIds = NULL;
   this->PropagationWeights = NULL;
+  this->UseFlatArrays = false;
   this->IterationIndex = 0;
   this->FastMarchingIterationEventResolution = 100;
 }
@@ -174,11 +658,22 @@ int vtkFastMarchingGeodesicDistance::RequestData(vtkInformation* vtkNotUsed(requ
   // Copy everything from the input
   output->ShallowCopy(input);
 
-  // Initialize the GW_GeodesicMesh structure
-  this->SetupGeodesicMesh(input);
+  if (this->UseFlatArrays)
+  {
+    // Initialize the flat arrays
+    if (!this->SetupFlatMesh(input))
+    {
+      return 0;
+    }
+  }
+  else
+  {
+    // Initialize the GW_GeodesicMesh structure
+    this->SetupGeodesicMesh(input);
 
-  // Setup termination criteria, if any
-  this->SetupCallbacks();
+    // Setup termination criteria, if any
+    this->SetupCallbacks();
+  }
 
   // Extract seed point id list as points with non-zero values of a given field
   vtkDataArray* inNonZeroField = this->GetInputArrayToProcess(0, input);
@@ -293,6 +788,25 @@ void vtkFastMarchingGeodesicDistance::SetupGeodesicMesh(vtkPolyData* in)
   this->Internals->Mesh->ResetGeodesicMesh();
 }
 
+//-----------------------------------------------------------------------------
+bool vtkFastMarchingGeodesicDistance::SetupFlatMesh(vtkPolyData* in)
+{
+  vtkFlatFastMarching& flat = this->Internals->Flat;
+  if (flat.BuildTime.GetMTime() < in->GetMTime() ||
+    flat.GetNumberOfPoints() != in->GetNumberOfPoints())
+  {
+    if (!flat.Build(in))
+    {
+      vtkErrorMacro(<< "This filter works only with triangle meshes. Triangulate first.");
+      return false;
+    }
+  }
+
+  // Restart in preparation for fast marching
+  flat.Reset();
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 void vtkFastMarchingGeodesicDistance::AddSeedsInternal()
 {
@@ -302,6 +816,16 @@ void vtkFastMarchingGeodesicDistance::AddSeedsInternal()
     return;
   }
 
+  if (this->UseFlatArrays)
+  {
+    const vtkIdType nSeeds = this->Seeds->GetNumberOfIds();
+    for (vtkIdType i = 0; i < nSeeds; i++)
+    {
+      this->Internals->Flat.AddSeed(this->Seeds->GetId(i));
+    }
+    return;
+  }
+
   // Add the seeds to the internal geodesic mesh instance
   const int n = this->Seeds->GetNumberOfIds();
   GW::GW_GeodesicMesh* mesh = this->Internals->Mesh;
@@ -331,6 +855,11 @@ void vtkFastMarchingGeodesicDistance::SetSeedsFromNonZeroField(vtkDataArray* non
 //-----------------------------------------------------------------------------
 int vtkFastMarchingGeodesicDistance::Compute()
 {
+  if (this->UseFlatArrays)
+  {
+    return this->ComputeOnFlatArrays();
+  }
+
   this->MaximumDistance = 0;
 
   this->Internals->Mesh->SetUpFastMarching();
@@ -351,14 +880,90 @@ int vtkFastMarchingGeodesicDistance::Compute()
 }
 
 //-----------------------------------------------------------------------------
-void vtkFastMarchingGeodesicDistance::CopyDistanceField(vtkPolyData* pd)
+int vtkFastMarchingGeodesicDistance::ComputeOnFlatArrays()
 {
-  GW::GW_GeodesicMesh* mesh = this->Internals->Mesh;
+  this->MaximumDistance = 0;
+
+  vtkFlatFastMarching& flat = this->Internals->Flat;
+  const vtkIdType nPts = flat.GetNumberOfPoints();
+
+  // The same options as the callbacks registered by SetupCallbacks, but
+  // looked up in per point arrays rather than vtkIdLists.
+  flat.DistanceStopCriterion = this->DistanceStopCriterion;
+  auto toMask = [nPts](vtkIdList* ids, std::vector<unsigned char>& mask) {
+    mask.clear();
+    if (ids && ids->GetNumberOfIds())
+    {
+      mask.resize(nPts, 0);
+      for (vtkIdType i = 0; i < ids->GetNumberOfIds(); i++)
+      {
+        const vtkIdType id = ids->GetId(i);
+        if (id >= 0 && id < nPts)
+        {
+          mask[id] = 1;
+        }
+      }
+    }
+  };
+  toMask(this->DestinationVertexStopCriterion, flat.Destinations);
+  toMask(this->ExclusionPointIds, flat.Excluded);
 
+  flat.Weights.clear();
+  if (this->PropagationWeights && this->PropagationWeights->GetNumberOfTuples() == nPts)
+  {
+    flat.Weights.resize(nPts);
+    for (vtkIdType i = 0; i < nPts; i++)
+    {
+      flat.Weights[i] = this->PropagationWeights->GetTuple1(i);
+    }
+  }
+
+  // Do the fast marching
+  while (!flat.Step())
+  {
+    if ((++this->IterationIndex) % this->FastMarchingIterationEventResolution == 0)
+    {
+      this->InvokeEvent(vtkFastMarchingGeodesicDistance::IterationEvent);
+    }
+  }
+
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkFastMarchingGeodesicDistance::CopyDistanceField(vtkPolyData* pd)
+{
   float distance;
   this->MaximumDistance = 0;
   this->NumberOfVisitedPoints = 0;
 
+  if (this->UseFlatArrays)
+  {
+    const vtkFlatFastMarching& flat = this->Internals->Flat;
+    const vtkIdType nPts = flat.GetNumberOfPoints();
+    vtkFloatArray* arr = this->GetGeodesicDistanceField(pd);
+    for (vtkIdType i = 0; i < nPts; i++)
+    {
+      if (flat.State[i] != vtkFlatFastMarching::Far)
+      {
+        ++this->NumberOfVisitedPoints;
+        distance = static_cast<float>(flat.Distance[i]);
+        this->MaximumDistance = std::max(this->MaximumDistance, distance);
+        if (arr)
+        {
+          arr->SetValue(i, distance);
+        }
+      }
+      else if (arr)
+      {
+        arr->SetValue(i, this->NotVisitedValue);
+      }
+    }
+    return;
+  }
+
+  GW::GW_GeodesicMesh* mesh = this->Internals->Mesh;
+
   const int n = mesh->GetNbrVertex();
 
   // get the field array to populate into
@@ -487,6 +1092,7 @@ void vtkFastMarchingGeodesicDistance::PrintSelf(ostream& os, vtkIndent indent)
   {
     this->ExclusionPointIds->PrintSelf(os, indent.GetNextIndent());
   }
+  os << indent << "UseFlatArrays: " << this->UseFlatArrays << endl;
   os << indent << "PropagationWeights: " << this->PropagationWeights << endl;
   if (this->PropagationWeights)
   {
@@ -60,6 +60,16 @@
 // propagate quickly in regions of low curvature and slow down in regions of
 // high curvature. Note that the propagation weights must be strictly positive.
 //
+// .SECTION Flat arrays
+// By default the fast marching runs on a GW_GeodesicMesh, made of one object
+// per vertex and per face, which is slow to build and limited to 2^31
+// elements. When UseFlatArrays is on, the fast marching runs directly on
+// arrays built from the input instead: the point coordinates, the triangles
+// and the point to triangle links of vtkStaticCellLinks, with an indexed
+// binary heap as narrow band. It uses the same update scheme hence gives the
+// same distances up to round-off. vtkFastMarchingGeodesicPath needs the
+// GW_GeodesicMesh and does not use it.
+//
 // .SECTION Miscellaneous
 // The filter reports IterationEvents. It does not report progress events,
 // since its not possible to pre-determine when the front might terminate.
@@ -139,6 +149,15 @@ public:
   virtual void SetPropagationWeights(vtkDataArray*);
   vtkGetObjectMacro(PropagationWeights, vtkDataArray);
 
+  // Description:
+  // Run the fast marching directly on flat arrays built from the input
+  // instead of the GW_GeodesicMesh. This is faster to set up, uses less
+  // memory and supports meshes with more than 2^31 points or triangles.
+  // Default is off.
+  vtkSetMacro(UseFlatArrays, bool);
+  vtkGetMacro(UseFlatArrays, bool);
+  vtkBooleanMacro(UseFlatArrays, bool);
+
   // Description:
   // Events invoked by the filter
 
@@ -156,6 +175,13 @@ protected:
   // Create GW_GeodesicMesh given an instance of a vtkPolyData
   void SetupGeodesicMesh(vtkPolyData* in);
 
+  // Build the flat arrays used when UseFlatArrays is on. Returns false if
+  // the input is not a triangle mesh.
+  bool SetupFlatMesh(vtkPolyData* in);
+
+  // Fast marching on the flat arrays
+  int ComputeOnFlatArrays();
+
   // Setup the optional termination criteria, if set
   void SetupCallbacks();
 
@@ -198,6 +224,9 @@ protected:
   // Propagation, ie speed function weights
   vtkDataArray* PropagationWeights;
 
+  // Use the flat arrays instead of the GW_GeodesicMesh
+  bool UseFlatArrays;
+
   friend class vtkFastMarchingGeodesicPath;
   friend class vtkGeodesicMeshInternals;
   void* GetGeodesicMesh();
@@ -9,17 +9,22 @@
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkVector.h"
 #include "vtkVectorOperators.h"
 
 #include "vtksys/FStream.hxx"
 
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <sstream>
 
 static constexpr std::streamoff headerSize = 6 * sizeof(double) + 4 * sizeof(int);
 static constexpr std::streamoff subgridHeaderSize = 9 * sizeof(int);
 static constexpr std::streamoff pfbEntrySize = sizeof(double);
+// Consecutive subgrids are read with a single read up to this many bytes.
+static constexpr std::streamoff maxCoalescedReadSize = 256 * 1024 * 1024;
 static const char* clmBaseComponentNames[] = { "eflx_lh_tot", "eflx_lwrad_out", "eflx_sh_tot",
   "eflx_soil_grnd", "qflx_evap_tot", "qflx_evap_grnd", "qflx_evap_soi", "qflx_evap_veg",
   "qflx_tran_veg", "qflx_infl", "swe_out", "t_grnd" };
@@ -53,6 +58,9 @@ vtkParFlowReader::vtkParFlowReader()
   , CLMIrrType(0)
   , NZ(0)
   , InferredAsCLM(-1)
+  , CachedDimensions(0, 0, 0)
+  , CachedNumberOfSubgrids(-1)
+  , CachedAsCLM(-1)
 {
   this->SetNumberOfInputPorts(0);
 }
@@ -193,26 +201,70 @@ int vtkParFlowReader::RequestData(vtkInformation* vtkNotUsed(request),
     << "  subgrids   " << numSubGrids << "\n";
 #endif
 
-  // Update {I,J,K}Divs on rank 0 by reading file:
-  this->ScanBlocks(pfb, numSubGrids);
-  // Update {I,J,K}Divs on ranks > 0 via network:
-  this->BroadcastBlocks();
+  // Reuse {I,J,K}Divs from the previous file when rank 0 finds they still apply:
+  int layoutValid = 0;
+  if (!mpc || mpc->GetLocalProcessId() == 0)
+  {
+    layoutValid = this->ValidateBlocks(pfb, nn, numSubGrids) ? 1 : 0;
+  }
+  if (mpc)
+  {
+    mpc->Broadcast(&layoutValid, 1, 0);
+  }
+  if (!layoutValid)
+  {
+    // Update {I,J,K}Divs on rank 0 by reading file:
+    this->ScanBlocks(pfb, numSubGrids);
+    // Update {I,J,K}Divs on ranks > 0 via network:
+    this->BroadcastBlocks();
+    this->CachedDimensions = nn;
+    this->CachedNumberOfSubgrids = numSubGrids;
+    this->CachedAsCLM = this->InferredAsCLM;
+  }
 
   int gridLo = (rank * numSubGrids) / jbsz;
   int gridHi = ((rank + 1) * numSubGrids) / jbsz;
   // std::cout << "Rank " << rank << " owns subgrids " << gridLo << " -- " << gridHi << "\n";
 
+  const int numBlocks = static_cast<int>(this->IJKDivs[0].size() - 1) *
+    static_cast<int>(this->IJKDivs[1].size() - 1) * static_cast<int>(this->IJKDivs[2].size() - 1);
+  gridHi = std::min(gridHi, numBlocks);
+  auto blockEnd = [this, numBlocks](int blockId) {
+    return blockId + 1 < numBlocks ? this->GetBlockOffset(blockId + 1) : this->GetEndOffset();
+  };
+
+  // Subgrids are stored one after the other, so the subgrids of this rank are
+  // read with as few large reads as possible.
   output->SetNumberOfBlocks(numSubGrids);
-  for (int ni = gridLo; ni < gridHi; ++ni)
+  std::vector<char> buffer;
+  bool valid = true;
+  for (int first = gridLo; valid && first < gridHi;)
   {
-    this->ReadBlock(pfb, output, xx, dx, arrayName, ni);
+    const std::streamoff start = this->GetBlockOffset(first);
+    int last = first + 1;
+    while (last < gridHi && blockEnd(last) - start <= maxCoalescedReadSize)
+    {
+      ++last;
+    }
+    buffer.resize(static_cast<size_t>(blockEnd(last - 1) - start));
+    pfb.clear();
+    pfb.seekg(start);
+    pfb.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    const std::streamoff count = pfb.gcount();
+    for (int ni = first; valid && ni < last && blockEnd(ni) - start <= count; ++ni)
+    {
+      const std::streamoff blockStart = this->GetBlockOffset(ni);
+      valid = this->ReadBlock(buffer.data() + (blockStart - start), blockEnd(ni) - blockStart,
+        output, xx, dx, arrayName, ni);
+    }
+    first = last;
   }
 
   // Prevent accidents; don't preserve across calls to RequestData:
   this->NZ = 0;
   this->InferredAsCLM = -1;
 
-  return 1;
+  return valid ? 1 : 0;
 }
 
 bool vtkParFlowReader::ReadSubgridHeader(
@@ -230,6 +282,45 @@ bool vtkParFlowReader::ReadSubgridHeader(
   return pfb.good() && !pfb.eof();
 }
 
+bool vtkParFlowReader::ValidateBlocks(istream& pfb, const vtkVector3i& nn, int numSubGrids)
+{
+  if (nn != this->CachedDimensions || numSubGrids != this->CachedNumberOfSubgrids ||
+    this->InferredAsCLM != this->CachedAsCLM || this->IJKDivs[0].size() < 2 ||
+    this->IJKDivs[1].size() < 2 || this->IJKDivs[2].size() < 2)
+  {
+    return false;
+  }
+  const int numBlocks = static_cast<int>(this->IJKDivs[0].size() - 1) *
+    static_cast<int>(this->IJKDivs[1].size() - 1) * static_cast<int>(this->IJKDivs[2].size() - 1);
+  if (numBlocks != numSubGrids)
+  {
+    return false;
+  }
+
+  // The last subgrid must be where the cached layout puts it and
+  // the file must end right after it.
+  vtkVector3i si;
+  vtkVector3i sn;
+  vtkVector3i sr;
+  bool valid = false;
+  pfb.seekg(this->GetBlockOffset(numBlocks - 1), std::ios::beg);
+  if (this->ReadSubgridHeader(pfb, si, sn, sr))
+  {
+    valid = true;
+    for (int ijk = 0; ijk < 3; ++ijk)
+    {
+      const auto& divs = this->IJKDivs[ijk];
+      valid &= si[ijk] == divs[divs.size() - 2] && si[ijk] + sn[ijk] == divs.back();
+    }
+    pfb.seekg(0, std::ios::end);
+    valid &= pfb.tellg() == this->GetEndOffset();
+  }
+
+  pfb.clear();
+  pfb.seekg(headerSize, std::ios::beg);
+  return valid;
+}
+
 void vtkParFlowReader::ScanBlocks(istream& pfb, int vtkNotUsed(numSubGrids))
 {
   auto mpc = vtkMultiProcessController::GetGlobalController();
@@ -350,81 +441,111 @@ std::streamoff vtkParFlowReader::GetEndOffset() const
   return offset;
 }
 
-void vtkParFlowReader::ReadBlock(istream& pfb, vtkMultiBlockDataSet* output, vtkVector3d& origin,
-  vtkVector3d& spacing, const std::string& arrayName, int blockId)
+bool vtkParFlowReader::ReadBlock(const char* pfb, std::streamoff size,
+  vtkMultiBlockDataSet* output, vtkVector3d& origin, vtkVector3d& spacing,
+  const std::string& arrayName, int blockId)
 {
   vtkVector3i si;
   vtkVector3i sn;
   vtkVector3i sr;
 
-  // Move file cursor to start of block.
-  std::streamoff blockOffset = this->GetBlockOffset(blockId);
-  pfb.seekg(blockOffset);
+  // Parse the subgrid header, knowing that we started with big-endian data:
+  std::memcpy(si.GetData(), pfb, 3 * sizeof(int));
+  std::memcpy(sn.GetData(), pfb + 3 * sizeof(int), 3 * sizeof(int));
+  std::memcpy(sr.GetData(), pfb + 6 * sizeof(int), 3 * sizeof(int));
+  vtkByteSwap::SwapBERange(si.GetData(), 3);
+  vtkByteSwap::SwapBERange(sn.GetData(), 3);
+  vtkByteSwap::SwapBERange(sr.GetData(), 3);
+  pfb += subgridHeaderSize;
 
-  if (this->ReadSubgridHeader(pfb, si, sn, sr))
+  // The buffer was sized from the cached layout, the header must not
+  // describe more values than it holds:
+  std::streamoff numValues = -1;
+  if (sn[0] >= 0 && sn[1] >= 0 && sn[2] >= 0)
   {
-    vtkNew<vtkImageData> image;
-    image->SetOrigin(origin.GetData());
-    image->SetSpacing(spacing.GetData());
-
     if (this->InferredAsCLM)
     {
-      // The CLM files have the full simulation extent listed but only
-      // provide data on the top 2-d surface:
-      image->SetExtent(si[0], si[0] + sn[0], si[1], si[1] + sn[1], si[2], si[2]);
-
+      // Same number of arrays as read below:
       const int numCLMVars = sn[2] - si[2];
-      int numComponents = 0;
-      for (int cc = 0; cc < clmBaseComponents && cc < numCLMVars; ++cc, ++numComponents)
+      int numArrays = std::min(clmBaseComponents, std::max(numCLMVars, 0));
+      numArrays += (this->CLMIrrType == 1 || this->CLMIrrType == 3) ? 1 : 0;
+      numArrays = std::max(numArrays, numCLMVars);
+      numValues = static_cast<std::streamoff>(sn[0]) * sn[1] * numArrays;
+    }
+    else
+    {
+      numValues = static_cast<std::streamoff>(sn[0]) * sn[1] * sn[2];
+    }
+  }
+  if (numValues < 0 || numValues > (size - subgridHeaderSize) / pfbEntrySize)
+  {
+    vtkErrorMacro("Subgrid " << blockId << " has size " << sn[0] << "x" << sn[1] << "x" << sn[2]
+                             << ", which does not match the layout of the other subgrids.");
+    return false;
+  }
+
+  vtkNew<vtkImageData> image;
+  image->SetOrigin(origin.GetData());
+  image->SetSpacing(spacing.GetData());
+
+  if (this->InferredAsCLM)
+  {
+    // The CLM files have the full simulation extent listed but only
+    // provide data on the top 2-d surface:
+    image->SetExtent(si[0], si[0] + sn[0], si[1], si[1] + sn[1], si[2], si[2]);
+
+    const int numCLMVars = sn[2] - si[2];
+    int numComponents = 0;
+    for (int cc = 0; cc < clmBaseComponents && cc < numCLMVars; ++cc, ++numComponents)
+    {
+      vtkNew<vtkDoubleArray> field;
+      field->SetName(clmBaseComponentNames[cc]);
+      this->ReadBlockIntoArray(pfb, image, field);
+    }
+    switch (this->CLMIrrType)
+    {
+      case 1:
       {
         vtkNew<vtkDoubleArray> field;
-        field->SetName(clmBaseComponentNames[cc]);
+        field->SetName("qflx_qirr");
         this->ReadBlockIntoArray(pfb, image, field);
+        ++numComponents;
       }
-      switch (this->CLMIrrType)
-      {
-        case 1:
-        {
-          vtkNew<vtkDoubleArray> field;
-          field->SetName("qflx_qirr");
-          this->ReadBlockIntoArray(pfb, image, field);
-          ++numComponents;
-        }
-        break;
-        case 3:
-        {
-          vtkNew<vtkDoubleArray> field;
-          field->SetName("qflx_qirr_inst");
-          this->ReadBlockIntoArray(pfb, image, field);
-          ++numComponents;
-        }
-        break;
-        default:
-          break;
-      }
-      for (int cz = 0; numComponents < numCLMVars; ++cz, ++numComponents)
+      break;
+      case 3:
       {
         vtkNew<vtkDoubleArray> field;
-        std::ostringstream name;
-        name << "tsoil_" << cz;
-        field->SetName(name.str().c_str());
+        field->SetName("qflx_qirr_inst");
         this->ReadBlockIntoArray(pfb, image, field);
+        ++numComponents;
       }
+      break;
+      default:
+        break;
     }
-    else
+    for (int cz = 0; numComponents < numCLMVars; ++cz, ++numComponents)
     {
-      // Read a single PFB state variable:
       vtkNew<vtkDoubleArray> field;
-      image->SetExtent(si[0], si[0] + sn[0], si[1], si[1] + sn[1], si[2], si[2] + sn[2]);
-      field->SetName(arrayName.c_str());
+      std::ostringstream name;
+      name << "tsoil_" << cz;
+      field->SetName(name.str().c_str());
       this->ReadBlockIntoArray(pfb, image, field);
     }
-
-    output->SetBlock(blockId, image);
   }
+  else
+  {
+    // Read a single PFB state variable:
+    vtkNew<vtkDoubleArray> field;
+    image->SetExtent(si[0], si[0] + sn[0], si[1], si[1] + sn[1], si[2], si[2] + sn[2]);
+    field->SetName(arrayName.c_str());
+    this->ReadBlockIntoArray(pfb, image, field);
+  }
+
+  output->SetBlock(blockId, image);
+  return true;
 }
 
-void vtkParFlowReader::ReadBlockIntoArray(istream& file, vtkImageData* img, vtkDoubleArray* arr)
+void vtkParFlowReader::ReadBlockIntoArray(const char*& data, vtkImageData* img, vtkDoubleArray* arr)
 {
   arr->SetNumberOfTuples(img->GetNumberOfCells());
   auto cellData = img->GetCellData();
@@ -436,9 +557,13 @@ void vtkParFlowReader::ReadBlockIntoArray(istream& file, vtkImageData* img, vtkD
     cellData->SetScalars(arr);
   }
 
-  vtkIdType numValues = arr->GetNumberOfTuples() * arr->GetNumberOfComponents();
-  file.read(reinterpret_cast<char*>(arr->GetVoidPointer(0)), sizeof(double) * numValues);
-  vtkByteSwap::SwapBERange(reinterpret_cast<double*>(arr->GetVoidPointer(0)), numValues);
-  // std::cout << arr->GetNumberOfComponents() << " " << numValues << "Read to byte " << pfb.tellg()
-  // << "\n";
+  // Copy and swap in cache-sized chunks, in parallel:
+  const vtkIdType numValues = arr->GetNumberOfTuples() * arr->GetNumberOfComponents();
+  const char* src = data;
+  double* dst = arr->GetPointer(0);
+  vtkSMPTools::For(0, numValues, 32768, [src, dst](vtkIdType begin, vtkIdType end) {
+    std::memcpy(dst + begin, src + begin * sizeof(double), (end - begin) * sizeof(double));
+    vtkByteSwap::SwapBERange(dst + begin, end - begin);
+  });
+  data += numValues * sizeof(double);
 }
@@ -79,6 +79,14 @@ protected:
   /// This sets IJKDivs on all ranks.
   void BroadcastBlocks();
 
+  /// Check on rank 0 whether the grid topology of the previous file applies to this one.
+  ///
+  /// Files of a run usually share the same subgrid layout, so rather than scanning
+  /// all the subgrid headers again, this compares the file header against the one
+  /// the layout was computed for and checks the last subgrid header and the file
+  /// size against the cached IJKDivs.
+  bool ValidateBlocks(istream& file, const vtkVector3i& dimensions, int nblocks);
+
   /// Use grid topology to compute a block (subgrid) offset.
   ///
   /// Only call this after IJKDivs has been set.
@@ -94,26 +102,34 @@ protected:
 
   static bool ReadSubgridHeader(istream& pfb, vtkVector3i& si, vtkVector3i& sn, vtkVector3i& sr);
 
-  /// Read a single block from the file
-  void ReadBlock(istream& file, vtkMultiBlockDataSet* output, vtkVector3d& origin,
-    vtkVector3d& spacing, const std::string& arrayName, int block);
+  /// Read a single block from a buffer of \a size bytes holding its subgrid
+  /// header and data, as read from the file. Returns false if the subgrid
+  /// header describes more data than the buffer holds.
+  bool ReadBlock(const char* data, std::streamoff size, vtkMultiBlockDataSet* output,
+    vtkVector3d& origin, vtkVector3d& spacing, const std::string& arrayName, int block);
 
   /// Given the size of the whole grid, the number of subgrids on each axis, and a block IJK
   /// return the min and max node coordinates for that block.
   static void GetBlockExtent(const vtkVector3i& wholeExtentIn, const vtkVector3i& numberOfBlocksIn,
     const vtkVector3i& blockIJKIn, vtkVector3i& blockExtentMinOut, vtkVector3i& blockExtentMaxOut);
 
-  static void ReadBlockIntoArray(istream& file, vtkImageData* img, vtkDoubleArray* arr);
+  /// Copy big-endian values from \a data into \a arr and advance \a data past them.
+  static void ReadBlockIntoArray(const char*& data, vtkImageData* img, vtkDoubleArray* arr);
 
   /// The filename, which must be a valid path before RequestData is called.
   char* FileName;
   int IsCLMFile;
   int CLMIrrType;
-  /// IJKDivs, NZ, and InferredAsCLM are only valid inside RequestData; used to compute subgrid
-  /// offsets.
+  /// NZ and InferredAsCLM are only valid inside RequestData; used to compute subgrid
+  /// offsets. IJKDivs is kept across calls so that files with the same layout need not be
+  /// scanned again.
   std::vector<int> IJKDivs[3];
   int NZ;
   int InferredAsCLM;
+  /// The file header values IJKDivs was last computed for; used by ValidateBlocks.
+  vtkVector3i CachedDimensions;
+  int CachedNumberOfSubgrids;
+  int CachedAsCLM;
 };
 
 #endif // vtkParflowReader_h
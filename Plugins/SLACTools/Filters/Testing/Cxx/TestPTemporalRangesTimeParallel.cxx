@@ -0,0 +1,167 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPTemporalRangesTimeParallel.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkPTemporalRanges requests the complete data set on every
+// process when TimeParallel is on, including processes without time steps,
+// and that the ranges of all time steps are combined.
+
+#include "vtkDoubleArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPTemporalRanges.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTable.h"
+
+#include <cmath>
+
+#define expect(x, msg)                                                                             \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << __LINE__ << ": " msg << endl;                                                          \
+    return EXIT_FAILURE;                                                                           \
+  }
+
+namespace
+{
+const int NumberOfTimeSteps = 2;
+const int NumberOfPoints = 4;
+
+// Produces the same points for any piece, with a "value" array holding
+// 10 * time + point index, and records whether a partial piece was requested.
+class TemporalPointsSource : public vtkPolyDataAlgorithm
+{
+public:
+  static TemporalPointsSource* New();
+  vtkTypeMacro(TemporalPointsSource, vtkPolyDataAlgorithm);
+
+  bool PartialPieceRequested = false;
+
+protected:
+  TemporalPointsSource() { this->SetNumberOfInputPorts(0); }
+
+  int RequestInformation(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector* outputVector) override
+  {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    double times[NumberOfTimeSteps];
+    for (int i = 0; i < NumberOfTimeSteps; ++i)
+    {
+      times[i] = i;
+    }
+    double range[2] = { times[0], times[NumberOfTimeSteps - 1] };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times, NumberOfTimeSteps);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+    outInfo->Set(vtkAlgorithm::CAN_HANDLE_PIECE_REQUEST(), 1);
+    return 1;
+  }
+
+  int RequestData(
+    vtkInformation*, vtkInformationVector**, vtkInformationVector* outputVector) override
+  {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    if (outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES()) != 1 ||
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER()) != 0)
+    {
+      this->PartialPieceRequested = true;
+    }
+    const double time = outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP())
+      ? outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP())
+      : 0.0;
+
+    vtkNew<vtkPoints> points;
+    vtkNew<vtkDoubleArray> values;
+    values->SetName("value");
+    for (int i = 0; i < NumberOfPoints; ++i)
+    {
+      points->InsertNextPoint(i, 0, 0);
+      values->InsertNextValue(10 * time + i);
+    }
+    vtkPolyData* output = vtkPolyData::GetData(outInfo);
+    output->SetPoints(points);
+    output->GetPointData()->AddArray(values);
+    return 1;
+  }
+
+private:
+  TemporalPointsSource(const TemporalPointsSource&) = delete;
+  void operator=(const TemporalPointsSource&) = delete;
+};
+vtkStandardNewMacro(TemporalPointsSource);
+
+int Check(vtkPTemporalRanges* ranges, int rank)
+{
+  if (rank != 0)
+  {
+    // the ranges are reduced to process 0.
+    return EXIT_SUCCESS;
+  }
+  vtkTable* table = ranges->GetOutput();
+  auto column = vtkDoubleArray::SafeDownCast(table->GetColumnByName("value"));
+  expect(column != nullptr, "missing 'value' column");
+  expect(column->GetValue(vtkTemporalRanges::COUNT_ROW) == NumberOfTimeSteps * NumberOfPoints,
+    "wrong count");
+  expect(column->GetValue(vtkTemporalRanges::MINIMUM_ROW) == 0, "wrong minimum");
+  expect(column->GetValue(vtkTemporalRanges::MAXIMUM_ROW) ==
+      10 * (NumberOfTimeSteps - 1) + NumberOfPoints - 1,
+    "wrong maximum");
+  const double average = 5 * (NumberOfTimeSteps - 1) + (NumberOfPoints - 1) / 2.0;
+  expect(std::abs(column->GetValue(vtkTemporalRanges::AVERAGE_ROW) - average) < 1e-12,
+    "wrong average");
+  return EXIT_SUCCESS;
+}
+}
+
+int TestPTemporalRangesTimeParallel(int argc, char* argv[])
+{
+  vtkMPIController* contr = vtkMPIController::New();
+  contr->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(contr);
+
+  const int rank = contr->GetLocalProcessId();
+  const int numProcs = contr->GetNumberOfProcesses();
+
+  int status = EXIT_SUCCESS;
+  {
+    // With more processes than time steps, some processes accumulate nothing.
+    vtkNew<TemporalPointsSource> source;
+    vtkNew<vtkPTemporalRanges> ranges;
+    ranges->SetController(contr);
+    ranges->SetInputConnection(source->GetOutputPort());
+    ranges->TimeParallelOn();
+    ranges->UpdatePiece(rank, numProcs, 0);
+    if (source->PartialPieceRequested)
+    {
+      cerr << "process " << rank << " requested a partial piece" << endl;
+      status = EXIT_FAILURE;
+    }
+    else
+    {
+      status = Check(ranges, rank);
+    }
+  }
+  int globalStatus = EXIT_SUCCESS;
+  contr->AllReduce(&status, &globalStatus, 1, vtkCommunicator::MAX_OP);
+
+  vtkMultiProcessController::SetGlobalController(nullptr);
+  contr->Finalize();
+  contr->Delete();
+  return globalStatus;
+}
@@ -20,67 +20,21 @@
 
 #include "vtkPTemporalRanges.h"
 
+#include "vtkCommunicator.h"
+#include "vtkDoubleArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
-#include "vtkReductionFilter.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTable.h"
+#include "vtkTypeTraits.h"
 
-#include "vtkSmartPointer.h"
-#define VTK_CREATE(type, name) vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
 
-//=============================================================================
-//=============================================================================
-class vtkPTemporalRanges::vtkRangeTableReduction : public vtkTableAlgorithm
-{
-public:
-  vtkTypeMacro(vtkPTemporalRanges::vtkRangeTableReduction, vtkTableAlgorithm);
-  static vtkRangeTableReduction* New()
-  {
-    vtkRangeTableReduction* ret = new vtkRangeTableReduction;
-    ret->InitializeObjectBase();
-    return ret;
-  }
-
-  vtkGetObjectMacro(Parent, vtkPTemporalRanges);
-  vtkSetObjectMacro(Parent, vtkPTemporalRanges);
-
-protected:
-  vtkRangeTableReduction() { this->Parent = NULL; }
-  ~vtkRangeTableReduction() { this->SetParent(NULL); }
-
-  virtual int FillInputPortInformation(int port, vtkInformation* info) override
-  {
-    info->Set(vtkAlgorithm::INPUT_IS_REPEATABLE(), 1);
-    return this->Superclass::FillInputPortInformation(port, info);
-  }
-
-  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
-
-  vtkPTemporalRanges* Parent;
-};
-
-//-----------------------------------------------------------------------------
-int vtkPTemporalRanges::vtkRangeTableReduction::RequestData(vtkInformation* vtkNotUsed(request),
-  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
-{
-  int numInputs = inputVector[0]->GetNumberOfInformationObjects();
-  vtkTable* output = vtkTable::GetData(outputVector);
-
-  this->Parent->InitializeTable(output);
-
-  for (int i = 0; i < numInputs; i++)
-  {
-    vtkTable* input = vtkTable::GetData(inputVector[0], i);
-    this->Parent->AccumulateTable(input, output);
-  }
-
-  return 1;
-}
-
-//=============================================================================
 //=============================================================================
 vtkStandardNewMacro(vtkPTemporalRanges);
 
@@ -91,6 +45,9 @@ vtkPTemporalRanges::vtkPTemporalRanges()
 {
   this->Controller = NULL;
   this->SetController(vtkMultiProcessController::GetGlobalController());
+  this->TimeParallel = false;
+  this->PartialResultsTimeParallel = false;
+  this->PartialResultsNumberOfProcesses = 1;
 }
 
 vtkPTemporalRanges::~vtkPTemporalRanges()
@@ -103,6 +60,31 @@ void vtkPTemporalRanges::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "TimeParallel: " << this->TimeParallel << endl;
+}
+
+//-----------------------------------------------------------------------------
+int vtkPTemporalRanges::RequestUpdateExtent(
+  vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  if (!this->Superclass::RequestUpdateExtent(request, inputVector, outputVector))
+  {
+    return 0;
+  }
+
+  if (this->TimeParallel)
+  {
+    // Each process reads the complete data set for its own time steps. This
+    // holds on processes without time steps too, since the upstream pipeline
+    // still executes there and would otherwise expect a piece from every
+    // process.
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(), 0);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(), 1);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(), 0);
+  }
+
+  return 1;
 }
 
 //-----------------------------------------------------------------------------
@@ -123,6 +105,51 @@ int vtkPTemporalRanges::RequestData(
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+void vtkPTemporalRanges::ComputeTimeIndices(vtkInformation* inInfo)
+{
+  this->Superclass::ComputeTimeIndices(inInfo);
+
+  if (!this->TimeParallel || !this->Controller)
+  {
+    return;
+  }
+
+  // Round-robin distribution of the time steps, which balances the load when
+  // appended time steps are resumed.
+  const int numProcs = this->Controller->GetNumberOfProcesses();
+  const int rank = this->Controller->GetLocalProcessId();
+  std::vector<int> localIndices;
+  for (int index : this->TimeIndices)
+  {
+    if (index % numProcs == rank)
+    {
+      localIndices.push_back(index);
+    }
+  }
+  this->TimeIndices.swap(localIndices);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkPTemporalRanges::CanResume(vtkInformation* inInfo)
+{
+  // The partial results only cover the time steps of this process, which must
+  // hence be distributed the same way.
+  const int numProcs = this->Controller ? this->Controller->GetNumberOfProcesses() : 1;
+  return this->Superclass::CanResume(inInfo) &&
+    this->PartialResultsTimeParallel == this->TimeParallel &&
+    this->PartialResultsNumberOfProcesses == numProcs;
+}
+
+//-----------------------------------------------------------------------------
+void vtkPTemporalRanges::InitializePartialResults()
+{
+  this->Superclass::InitializePartialResults();
+  this->PartialResultsTimeParallel = this->TimeParallel;
+  this->PartialResultsNumberOfProcesses =
+    this->Controller ? this->Controller->GetNumberOfProcesses() : 1;
+}
+
 //-----------------------------------------------------------------------------
 void vtkPTemporalRanges::Reduce(vtkTable* table)
 {
@@ -131,24 +158,100 @@ void vtkPTemporalRanges::Reduce(vtkTable* table)
     return;
   }
 
-  VTK_CREATE(vtkReductionFilter, reduceFilter);
-  reduceFilter->SetController(this->Controller);
+  // Gather the names of the range columns of all processes as null separated
+  // lists. The columns are combined in the order they first appear.
+  std::vector<char> localNames;
+  for (vtkIdType i = 0; i < table->GetNumberOfColumns(); i++)
+  {
+    vtkDoubleArray* column = vtkDoubleArray::SafeDownCast(table->GetColumn(i));
+    if (column && column->GetName())
+    {
+      const char* name = column->GetName();
+      localNames.insert(localNames.end(), name, name + strlen(name) + 1);
+    }
+  }
 
-  VTK_CREATE(vtkPTemporalRanges::vtkRangeTableReduction, reduceOperation);
-  reduceOperation->SetParent(this);
-  reduceFilter->SetPostGatherHelper(reduceOperation);
+  const int numProcs = this->Controller->GetNumberOfProcesses();
+  vtkIdType localLength = static_cast<vtkIdType>(localNames.size());
+  std::vector<vtkIdType> lengths(numProcs);
+  this->Controller->AllGather(&localLength, &lengths[0], 1);
+  std::vector<vtkIdType> offsets(numProcs);
+  vtkIdType totalLength = 0;
+  for (int i = 0; i < numProcs; i++)
+  {
+    offsets[i] = totalLength;
+    totalLength += lengths[i];
+  }
+  if (totalLength == 0)
+  {
+    if (this->Controller->GetLocalProcessId() != 0)
+    {
+      table->Initialize();
+    }
+    return;
+  }
+  localNames.push_back('\0'); // Keep the buffers valid when empty.
+  std::vector<char> allNames(totalLength + 1);
+  this->Controller->AllGatherV(&localNames[0], &allNames[0], localLength, &lengths[0], &offsets[0]);
 
-  VTK_CREATE(vtkTable, copy);
-  copy->ShallowCopy(table);
-  reduceFilter->SetInputData(copy);
-  reduceFilter->Update();
+  std::vector<std::string> names;
+  std::set<std::string> seen;
+  for (vtkIdType pos = 0; pos < totalLength;)
+  {
+    std::string name(&allNames[pos]);
+    pos += static_cast<vtkIdType>(name.size()) + 1;
+    if (seen.insert(name).second)
+    {
+      names.push_back(name);
+    }
+  }
 
-  if (this->Controller->GetLocalProcessId() == 0)
+  // Combine all the columns at once: totals and counts are summed, minima and
+  // maxima reduced. Columns missing on a process do not contribute.
+  const size_t numColumns = names.size();
+  std::vector<double> localSums(2 * numColumns, 0.0);
+  std::vector<double> localMinima(numColumns, vtkTypeTraits<double>::Max());
+  std::vector<double> localMaxima(numColumns, vtkTypeTraits<double>::Min());
+  for (size_t i = 0; i < numColumns; i++)
   {
-    table->ShallowCopy(reduceFilter->GetOutput());
+    vtkDoubleArray* column =
+      vtkDoubleArray::SafeDownCast(table->GetColumnByName(names[i].c_str()));
+    if (!column)
+    {
+      continue;
+    }
+    const double count = column->GetValue(COUNT_ROW);
+    if (count > 0.0)
+    {
+      localSums[2 * i] = count * column->GetValue(AVERAGE_ROW);
+      localSums[2 * i + 1] = count;
+      localMinima[i] = column->GetValue(MINIMUM_ROW);
+      localMaxima[i] = column->GetValue(MAXIMUM_ROW);
+    }
   }
-  else
+
+  std::vector<double> sums(2 * numColumns);
+  std::vector<double> minima(numColumns);
+  std::vector<double> maxima(numColumns);
+  const vtkIdType numValues = static_cast<vtkIdType>(numColumns);
+  this->Controller->AllReduce(&localSums[0], &sums[0], 2 * numValues, vtkCommunicator::SUM_OP);
+  this->Controller->AllReduce(&localMinima[0], &minima[0], numValues, vtkCommunicator::MIN_OP);
+  this->Controller->AllReduce(&localMaxima[0], &maxima[0], numValues, vtkCommunicator::MAX_OP);
+
+  if (this->Controller->GetLocalProcessId() != 0)
   {
     table->Initialize();
+    return;
+  }
+
+  this->InitializeTable(table);
+  for (size_t i = 0; i < numColumns; i++)
+  {
+    vtkDoubleArray* column = this->GetColumn(table, names[i].c_str());
+    const double count = sums[2 * i + 1];
+    column->SetValue(AVERAGE_ROW, count > 0.0 ? sums[2 * i] / count : 0.0);
+    column->SetValue(MINIMUM_ROW, minima[i]);
+    column->SetValue(MAXIMUM_ROW, maxima[i]);
+    column->SetValue(COUNT_ROW, count);
   }
 }
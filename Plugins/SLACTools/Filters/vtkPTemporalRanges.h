@@ -25,6 +25,10 @@
 // vtkPTemporalRanges works basically like its superclass, vtkTemporalRanges,
 // except that it works in a data parallel manner.
 //
+// When TimeParallel is on, the time steps are instead distributed among the
+// processes, each of which reads the complete data set for its own time steps.
+// The ranges of all processes are combined in a single reduction at the end.
+//
 
 #ifndef vtkPTemporalRanges_h
 #define vtkPTemporalRanges_h
@@ -44,22 +48,45 @@ public:
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
   virtual void SetController(vtkMultiProcessController*);
 
+  // Description:
+  // When on, each process accumulates every N-th time step of the complete
+  // data set (N being the number of processes) rather than its piece of every
+  // time step. This requires an upstream pipeline that can provide the
+  // complete data set on each process independently, i.e. without
+  // communicating with the other processes. Off by default.
+  vtkGetMacro(TimeParallel, bool);
+  vtkSetMacro(TimeParallel, bool);
+  vtkBooleanMacro(TimeParallel, bool);
+
 protected:
   vtkPTemporalRanges();
   ~vtkPTemporalRanges();
 
   vtkMultiProcessController* Controller;
 
+  bool TimeParallel;
+
+  // Distribution of the time steps covered by the partial results.
+  bool PartialResultsTimeParallel;
+  int PartialResultsNumberOfProcesses;
+
+  virtual int RequestUpdateExtent(
+    vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
   virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
+  virtual void ComputeTimeIndices(vtkInformation* inInfo) override;
+  virtual bool CanResume(vtkInformation* inInfo) override;
+  virtual void InitializePartialResults() override;
+
+  // Description:
+  // Combines the ranges of all processes. The result is left in the table of
+  // process 0, the tables of the other processes are emptied.
   virtual void Reduce(vtkTable* table);
 
 private:
   vtkPTemporalRanges(const vtkPTemporalRanges&) = delete;
   void operator=(const vtkPTemporalRanges&) = delete;
-
-  class vtkRangeTableReduction;
-  friend class vtkRangeTableReduction;
 };
 
 #endif // vtkPTemporalRanges_h
@@ -78,6 +78,11 @@ inline void AccumulateColumn(vtkDoubleArray* source, vtkDoubleArray* target)
 {
   double targetCount = target->GetValue(COUNT_ROW);
   double sourceCount = source->GetValue(COUNT_ROW);
+  if (sourceCount <= 0.0)
+  {
+    // Nothing accumulated, and the average is not a number.
+    return;
+  }
   double totalCount = targetCount + sourceCount;
   double targetTotal = targetCount * target->GetValue(AVERAGE_ROW);
   double sourceTotal = sourceCount * source->GetValue(AVERAGE_ROW);
@@ -98,15 +103,71 @@ vtkStandardNewMacro(vtkTemporalRanges);
 vtkTemporalRanges::vtkTemporalRanges()
 {
   this->CurrentTimeIndex = 0;
+  this->ResumeFromPartialResults = false;
+  this->PartialResults = vtkTable::New();
+  this->InitializeTable(this->PartialResults);
 }
 
 vtkTemporalRanges::~vtkTemporalRanges()
 {
+  this->PartialResults->Delete();
 }
 
 void vtkTemporalRanges::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "ResumeFromPartialResults: " << this->ResumeFromPartialResults << endl;
+  os << indent << "Number of accumulated time steps: " << this->PartialResultsTimeSteps.size()
+     << endl;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTemporalRanges::ResetPartialResults()
+{
+  this->InitializePartialResults();
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+void vtkTemporalRanges::InitializePartialResults()
+{
+  this->InitializeTable(this->PartialResults);
+  this->PartialResultsTimeSteps.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool vtkTemporalRanges::CanResume(vtkInformation* inInfo)
+{
+  // Every accumulated time step must still be in the input.
+  const double* inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  const int numTimes = inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  if (!this->ResumeFromPartialResults || !inTimes)
+  {
+    return false;
+  }
+  std::vector<double> times(inTimes, inTimes + numTimes);
+  std::sort(times.begin(), times.end());
+  return std::includes(times.begin(), times.end(), this->PartialResultsTimeSteps.begin(),
+    this->PartialResultsTimeSteps.end());
+}
+
+//-----------------------------------------------------------------------------
+void vtkTemporalRanges::ComputeTimeIndices(vtkInformation* inInfo)
+{
+  // Data without time is accumulated once.
+  const double* inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  const int numTimes = inTimes ? inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()) : 1;
+
+  this->TimeIndices.clear();
+  for (int i = 0; i < numTimes; i++)
+  {
+    if (!inTimes || !std::binary_search(this->PartialResultsTimeSteps.begin(),
+                      this->PartialResultsTimeSteps.end(), inTimes[i]))
+    {
+      this->TimeIndices.push_back(i);
+    }
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -143,15 +204,25 @@ int vtkTemporalRanges::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
 {
   vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
 
+  if (this->CurrentTimeIndex == 0)
+  {
+    // Beginning of an execution, find the time steps to accumulate.
+    if (!this->CanResume(inInfo))
+    {
+      this->InitializePartialResults();
+    }
+    this->ComputeTimeIndices(inInfo);
+  }
+
   // The RequestData method will tell the pipeline executive to iterate the
   // upstream pipeline to get each time step in order.  The executive in turn
   // will call this method to get the extent request for each iteration (in this
   // case the time step).
   double* inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
-  if (inTimes)
+  if (inTimes && this->CurrentTimeIndex < static_cast<int>(this->TimeIndices.size()))
   {
-    inInfo->Set(
-      vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(), inTimes[this->CurrentTimeIndex]);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(),
+      inTimes[this->TimeIndices[this->CurrentTimeIndex]]);
   }
 
   return 1;
@@ -164,42 +235,59 @@ int vtkTemporalRanges::RequestData(
   vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
   vtkTable* output = vtkTable::GetData(outputVector);
 
-  if (this->CurrentTimeIndex == 0)
+  // The ranges are accumulated in the partial results, which hence hold the
+  // ranges of all the time steps accumulated so far.
+  const int numTimeIndices = static_cast<int>(this->TimeIndices.size());
+  if (this->CurrentTimeIndex < numTimeIndices)
   {
-    // First execution.  Initialize table.
-    this->InitializeTable(output);
-  }
+    vtkCompositeDataSet* compositeInput = vtkCompositeDataSet::GetData(inInfo);
+    vtkDataSet* dsInput = vtkDataSet::GetData(inInfo);
 
-  vtkCompositeDataSet* compositeInput = vtkCompositeDataSet::GetData(inInfo);
-  vtkDataSet* dsInput = vtkDataSet::GetData(inInfo);
+    if (compositeInput)
+    {
+      this->AccumulateCompositeData(compositeInput, this->PartialResults);
+    }
+    else if (dsInput)
+    {
+      this->AccumulateDataSet(dsInput, this->PartialResults);
+    }
+    else
+    {
+      vtkWarningMacro(<< "Unknown data type : "
+                      << vtkDataObject::GetData(inputVector[0])->GetClassName());
+      request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
+      this->CurrentTimeIndex = 0;
+      return 0;
+    }
 
-  if (compositeInput)
-  {
-    this->AccumulateCompositeData(compositeInput, output);
-  }
-  else if (dsInput)
-  {
-    this->AccumulateDataSet(dsInput, output);
-  }
-  else
-  {
-    vtkWarningMacro(<< "Unknown data type : "
-                    << vtkDataObject::GetData(inputVector[0])->GetClassName());
-    return 0;
+    double* inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    if (inTimes)
+    {
+      const double time = inTimes[this->TimeIndices[this->CurrentTimeIndex]];
+      this->PartialResultsTimeSteps.insert(std::upper_bound(this->PartialResultsTimeSteps.begin(),
+                                             this->PartialResultsTimeSteps.end(), time),
+        time);
+    }
   }
 
   this->CurrentTimeIndex++;
+  if (numTimeIndices > 0)
+  {
+    this->UpdateProgress(static_cast<double>(this->CurrentTimeIndex) / numTimeIndices);
+  }
 
-  if (this->CurrentTimeIndex < inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+  if (this->CurrentTimeIndex < numTimeIndices && !this->GetAbortExecute())
   {
     // There is still more to do.
     request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
   }
   else
   {
-    // We are done.  Finish up.
+    // We are done (or aborted, in which case the ranges of the time steps
+    // accumulated so far are kept for ResumeFromPartialResults).  Finish up.
     request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
     this->CurrentTimeIndex = 0;
+    output->DeepCopy(this->PartialResults);
   }
 
   return 1;
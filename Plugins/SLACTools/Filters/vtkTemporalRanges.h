@@ -31,6 +31,10 @@
 // and time, it will also give a single statistics over all blocks in a data
 // set.
 //
+// The ranges can optionally be kept between executions so that a new
+// execution only reads the time steps that have not been accumulated yet (see
+// ResumeFromPartialResults).
+//
 
 #ifndef vtkTemporalRanges_h
 #define vtkTemporalRanges_h
@@ -38,10 +42,13 @@
 #include "vtkSLACFiltersModule.h" // for export macro
 #include "vtkTableAlgorithm.h"
 
+#include <vector> // for std::vector
+
 class vtkCompositeDataSet;
 class vtkDataSet;
 class vtkDoubleArray;
 class vtkFieldData;
+class vtkTable;
 
 class VTKSLACFILTERS_EXPORT vtkTemporalRanges : public vtkTableAlgorithm
 {
@@ -59,12 +66,53 @@ public:
     NUMBER_OF_ROWS
   };
 
+  // Description:
+  // When on, the accumulated ranges and the time steps they cover are kept
+  // between executions, and an execution only reads the time steps that have
+  // not been accumulated yet, e.g. after an aborted execution or when time
+  // steps were appended to the input. The data of the time steps already
+  // accumulated is assumed not to have changed, call ResetPartialResults()
+  // otherwise. Off by default.
+  vtkGetMacro(ResumeFromPartialResults, bool);
+  vtkSetMacro(ResumeFromPartialResults, bool);
+  vtkBooleanMacro(ResumeFromPartialResults, bool);
+
+  // Description:
+  // Discards the ranges kept when ResumeFromPartialResults is on.
+  void ResetPartialResults();
+
 protected:
   vtkTemporalRanges();
   ~vtkTemporalRanges();
 
+  // Position in TimeIndices of the time step being accumulated.
   int CurrentTimeIndex;
 
+  bool ResumeFromPartialResults;
+
+  // Indices of the input time steps accumulated by this process during the
+  // current execution.
+  std::vector<int> TimeIndices;
+
+  // Ranges accumulated by this process and the (sorted) time step values they
+  // cover.
+  vtkTable* PartialResults;
+  std::vector<double> PartialResultsTimeSteps;
+
+  // Description:
+  // Fills TimeIndices with the input time steps to accumulate, skipping the
+  // ones already covered by the partial results. Subclasses override this to
+  // distribute the time steps.
+  virtual void ComputeTimeIndices(vtkInformation* inInfo);
+
+  // Description:
+  // Returns whether the partial results can be used for the given input.
+  virtual bool CanResume(vtkInformation* inInfo);
+
+  // Description:
+  // Discards the partial results.
+  virtual void InitializePartialResults();
+
   virtual int FillInputPortInformation(int port, vtkInformation* info) override;
 
   virtual int RequestInformation(
@@ -252,6 +252,9 @@ Q_GLOBAL_STATIC(pqFileDialogModelIconProvider, Icons);
 namespace
 {
 
+// Number of entries queried at once when listing a directory.
+const int ListingPageSize = 4096;
+
 ///////////////////////////////////////////////////////////////////////
 // CaseInsensitiveSort
 
@@ -316,6 +319,8 @@ class pqFileDialogModel::pqImplementation
 public:
   pqImplementation(pqServer* server)
     : Separator(0)
+    , ListingOffset(0)
+    , TotalNumberOfEntries(0)
     , Server(server)
   {
 
@@ -368,9 +373,10 @@ public:
     return this->GetData(dirListing, this->CurrentPath, path, specialDirs);
   }
 
-  /// query the file system for information
-  vtkPVFileInformation* GetData(
-    bool dirListing, const QString& workingDir, const QString& path, bool specialDirs)
+  /// query the file system for information. Directory listings return the
+  /// page of entries starting at listingOffset.
+  vtkPVFileInformation* GetData(bool dirListing, const QString& workingDir, const QString& path,
+    bool specialDirs, int listingOffset = 0)
   {
     if (this->FileInformationHelperProxy)
     {
@@ -380,6 +386,9 @@ public:
       pqSMAdaptor::setElementProperty(helper->GetProperty("DirectoryListing"), dirListing);
       pqSMAdaptor::setElementProperty(helper->GetProperty("Path"), path.toUtf8());
       pqSMAdaptor::setElementProperty(helper->GetProperty("SpecialDirectories"), specialDirs);
+      pqSMAdaptor::setElementProperty(
+        helper->GetProperty("MaximumNumberOfEntries"), ListingPageSize);
+      pqSMAdaptor::setElementProperty(helper->GetProperty("ListingOffset"), listingOffset);
       helper->UpdateVTKObjects();
 
       // get data from server
@@ -393,16 +402,61 @@ public:
       helper->SetPath(path.toUtf8().data());
       helper->SetSpecialDirectories(specialDirs);
       helper->SetWorkingDirectory(workingDir.toUtf8().data());
+      helper->SetMaximumNumberOfEntries(ListingPageSize);
+      helper->SetListingOffset(listingOffset);
       this->FileInformation->CopyFromObject(helper);
     }
     return this->FileInformation;
   }
 
+  /// query the next page of the current directory listing
+  vtkPVFileInformation* GetNextListingPage()
+  {
+    return this->GetData(true, this->CurrentPath, this->ListingPath, false,
+      this->ListingOffset + ListingPageSize);
+  }
+
+  /// whether the current directory listing has more pages
+  bool HasMoreListingPages() const
+  {
+    return this->ListingOffset + ListingPageSize < this->TotalNumberOfEntries;
+  }
+
+  /// release the remaining pages of the current directory listing
+  void CancelListing()
+  {
+    if (this->HasMoreListingPages())
+    {
+      if (this->FileInformationHelperProxy)
+      {
+        this->FileInformationHelperProxy->InvokeCommand("ClearListing");
+      }
+      else
+      {
+        this->FileInformationHelper->ClearListing();
+      }
+    }
+    this->ListingOffset = 0;
+    this->TotalNumberOfEntries = 0;
+  }
+
   /// put queried information into our model
   void Update(const QString& path, vtkPVFileInformation* dir)
   {
     this->CurrentPath = path;
+    this->ListingPath = QString::fromUtf8(dir->GetFullPath());
     this->FileList.clear();
+    // Reserve room for the complete listing so that appending pages does not
+    // move the items referenced by the indices of group members.
+    this->FileList.reserve(dir->GetTotalNumberOfEntries());
+    this->FileList += this->GetFileList(dir);
+  }
+
+  /// convert a page of queried information into items of our model
+  QVector<pqFileDialogModelFileInfo> GetFileList(vtkPVFileInformation* dir)
+  {
+    this->ListingOffset = dir->GetListingOffset();
+    this->TotalNumberOfEntries = dir->GetTotalNumberOfEntries();
 
     QList<pqFileDialogModelFileInfo> dirs;
     QList<pqFileDialogModelFileInfo> files;
@@ -462,14 +516,17 @@ public:
     std::sort(dirs.begin(), dirs.end(), CaseInsensitiveSort);
     std::sort(files.begin(), files.end(), CaseInsensitiveSort);
 
+    QVector<pqFileDialogModelFileInfo> fileList;
+    fileList.reserve(dirs.size() + files.size());
     for (int i = 0; i != dirs.size(); ++i)
     {
-      this->FileList.push_back(dirs[i]);
+      fileList.push_back(dirs[i]);
     }
     for (int i = 0; i != files.size(); ++i)
     {
-      this->FileList.push_back(files[i]);
+      fileList.push_back(files[i]);
     }
+    return fileList;
   }
 
   QStringList getFilePaths(const QModelIndex& index)
@@ -529,6 +586,11 @@ public:
 
   /// Current path being displayed (server's filesystem).
   QString CurrentPath;
+  /// Full path of the directory being listed, and index of the first entry
+  /// of the last page listed out of the total number of entries.
+  QString ListingPath;
+  int ListingOffset;
+  int TotalNumberOfEntries;
   /// Caches information about the set of files within the current path.
   QVector<pqFileDialogModelFileInfo> FileList; // adjacent memory occupation for QModelIndex
 
@@ -623,6 +685,7 @@ pqServer* pqFileDialogModel::server() const
 void pqFileDialogModel::setCurrentPath(const QString& path)
 {
   this->beginResetModel();
+  this->Implementation->CancelListing();
   QString cPath = this->Implementation->cleanPath(path);
   vtkPVFileInformation* info;
   info = this->Implementation->GetData(true, cPath, false);
@@ -988,6 +1051,40 @@ QModelIndex pqFileDialogModel::index(int row, int column, const QModelIndex& p)
   return QModelIndex();
 }
 
+bool pqFileDialogModel::canFetchMore(const QModelIndex& idx) const
+{
+  return !idx.isValid() && this->Implementation->HasMoreListingPages();
+}
+
+void pqFileDialogModel::fetchMore(const QModelIndex& idx)
+{
+  if (!this->canFetchMore(idx))
+  {
+    return;
+  }
+
+  QVector<pqFileDialogModelFileInfo>& fileList = this->Implementation->FileList;
+  const QVector<pqFileDialogModelFileInfo> page =
+    this->Implementation->GetFileList(this->Implementation->GetNextListingPage());
+  if (page.isEmpty())
+  {
+    return;
+  }
+  if (fileList.size() + page.size() > fileList.capacity())
+  {
+    // Appending moves the existing items, hence their indices are invalidated.
+    this->beginResetModel();
+    fileList += page;
+    this->endResetModel();
+  }
+  else
+  {
+    this->beginInsertRows(QModelIndex(), fileList.size(), fileList.size() + page.size() - 1);
+    fileList += page;
+    this->endInsertRows();
+  }
+}
+
 QModelIndex pqFileDialogModel::parent(const QModelIndex& idx) const
 {
   if (!idx.isValid() || !idx.internalPointer())
@@ -179,6 +179,15 @@ public:
   * returns flags for item
   */
   Qt::ItemFlags flags(const QModelIndex& idx) const override;
+  /**
+  * return whether more entries of the current directory can be listed.
+  * Directories are listed incrementally, one page of entries at a time.
+  */
+  bool canFetchMore(const QModelIndex& p) const override;
+  /**
+  * list the next page of entries of the current directory
+  */
+  void fetchMore(const QModelIndex& p) override;
 
 private:
   class pqImplementation;
@@ -100,6 +100,7 @@ public:
   QItemSelectionModel SelectionModel;
   pqTimer Timer;
   pqTimer SelectionTimer;
+  pqTimer PrefetchTimer;
   int DecimalPrecision;
   bool FixedRepresentation;
   vtkIdType LastRowCount;
@@ -132,6 +133,14 @@ pqSpreadSheetViewModel::pqSpreadSheetViewModel(vtkSMProxy* view, QObject* parent
   this->Internal->Timer.setInterval(500); // milliseconds.
   QObject::connect(&this->Internal->Timer, SIGNAL(timeout()), this, SLOT(delayedUpdate()));
 
+  // Fetching a block blocks the UI until the servers deliver it, so blocks are
+  // only prefetched once scrolling has stopped, one at a time so that the view
+  // remains responsive between fetches.
+  this->Internal->PrefetchTimer.setSingleShot(true);
+  this->Internal->PrefetchTimer.setInterval(500); // milliseconds.
+  QObject::connect(
+    &this->Internal->PrefetchTimer, SIGNAL(timeout()), this, SLOT(prefetchBlock()));
+
   this->Internal->SelectionTimer.setSingleShot(true);
   this->Internal->SelectionTimer.setInterval(100); // milliseconds.
   QObject::connect(
@@ -212,6 +221,7 @@ void pqSpreadSheetViewModel::forceUpdate()
   this->Internal->SelectionModel.clear();
   this->Internal->Timer.stop();
   this->Internal->SelectionTimer.stop();
+  this->Internal->PrefetchTimer.stop();
 
   vtkIdType& rows = this->Internal->LastRowCount;
   vtkIdType& columns = this->Internal->LastColumnCount;
@@ -248,6 +258,21 @@ void pqSpreadSheetViewModel::delayedUpdate()
   }
 }
 
+//-----------------------------------------------------------------------------
+void pqSpreadSheetViewModel::prefetchBlock()
+{
+  // let a pending update fetch the visible rows first.
+  if (this->Internal->Timer.isActive())
+  {
+    this->Internal->PrefetchTimer.start();
+    return;
+  }
+  if (this->Internal->VTKView->PrefetchBlock())
+  {
+    this->Internal->PrefetchTimer.start();
+  }
+}
+
 //-----------------------------------------------------------------------------
 void pqSpreadSheetViewModel::triggerSelectionChanged()
 {
@@ -257,8 +282,17 @@ void pqSpreadSheetViewModel::triggerSelectionChanged()
 //-----------------------------------------------------------------------------
 void pqSpreadSheetViewModel::setActiveRegion(int row_top, int row_bottom)
 {
+  if (this->Internal->ActiveRegion[0] == row_top && this->Internal->ActiveRegion[1] == row_bottom)
+  {
+    // a repaint without scrolling, e.g. after a fetch: keep the scheduled
+    // prefetch.
+    return;
+  }
   this->Internal->ActiveRegion[0] = row_top;
   this->Internal->ActiveRegion[1] = row_bottom;
+  this->Internal->VTKView->SetVisibleRows(row_top, row_bottom);
+  // restarted on every scroll step, so it only fires once scrolling stops.
+  this->Internal->PrefetchTimer.start();
 }
 
 //-----------------------------------------------------------------------------
@@ -221,6 +221,11 @@ private Q_SLOTS:
 
   void triggerSelectionChanged();
 
+  /**
+  * called once scrolling stops to prefetch the blocks around the active region.
+  */
+  void prefetchBlock();
+
   /**
    * Called when the vtkSpreadSheetView fetches a new block, we fire
    * dataChanged signal.
@@ -0,0 +1,102 @@
+# Checks that vtkFileSeriesReader reports the same time steps whether the
+# time queries are distributed and cached or not, and that the cache is
+# invalidated when a file of the series changes.
+
+import os
+import shutil
+import sys
+
+from paraview import smtesting
+from paraview.simple import *
+from paraview import servermanager
+
+from vtkmodules.vtkCommonCore import vtkDoubleArray
+from vtkmodules.vtkCommonDataModel import vtkPolyData
+from vtkmodules.vtkFiltersSources import vtkSphereSource
+from vtkmodules.vtkIOXML import vtkXMLPolyDataWriter
+
+smtesting.ProcessCommandLineArguments()
+
+pm = servermanager.vtkProcessModule.GetProcessModule()
+controller = pm.GetGlobalController()
+rank = controller.GetLocalProcessId() if controller else 0
+symmetric = pm.GetSymmetricMPIMode()
+
+def barrier():
+    if symmetric:
+        controller.Barrier()
+
+# Enough files for the cache to be used.
+numFiles = 70
+datadir = os.path.join(smtesting.TempDir,
+    "FileSeriesTimeCache-Symmetric" if symmetric else "FileSeriesTimeCache")
+cachedir = os.path.join(datadir, "cache")
+fnames = [os.path.join(datadir, "series_%03d.vtp" % i) for i in range(numFiles)]
+
+def writeFile(index, time):
+    sphere = vtkSphereSource()
+    sphere.Update()
+    pd = vtkPolyData()
+    pd.ShallowCopy(sphere.GetOutput())
+    timeValue = vtkDoubleArray()
+    timeValue.SetName("TimeValue")
+    timeValue.InsertNextValue(time)
+    pd.GetFieldData().AddArray(timeValue)
+    writer = vtkXMLPolyDataWriter()
+    writer.SetInputData(pd)
+    writer.SetFileName(fnames[index])
+    writer.Write()
+
+expected = [0.25 * i + 1 for i in range(numFiles)]
+if rank == 0:
+    shutil.rmtree(datadir, ignore_errors=True)
+    os.makedirs(cachedir)
+    for i in range(numFiles):
+        writeFile(i, expected[i])
+barrier()
+
+os.environ["PV_FILE_SERIES_CACHE_DIR"] = cachedir
+
+def readTimes(distribute, cache):
+    reader = XMLPolyDataReader(FileName=fnames,
+        DistributeTimeQueries=int(distribute), UseTimeCache=int(cache))
+    reader.UpdatePipelineInformation()
+    times = list(reader.TimestepValues)
+    Delete(reader)
+    barrier()
+    return times
+
+def check(times, message):
+    if times != expected:
+        print("ERROR: %s: got %s, expected %s" % (message, times, expected))
+        sys.exit(1)
+
+check(readTimes(False, False), "serial queries")
+check(readTimes(True, False), "distributed queries")
+
+check(readTimes(True, True), "distributed queries, writing the cache")
+if rank == 0:
+    entries = os.listdir(cachedir)
+    if len(entries) != 1 or not entries[0].endswith(".pvtimes.json"):
+        print("ERROR: expected a single cache file, got %s" % entries)
+        sys.exit(1)
+barrier()
+check(readTimes(False, True), "reading the cache")
+
+# Changing a file must invalidate the cache. Bump the modification time since
+# the file is rewritten with the same size within the same second.
+expected[-1] = 1000.0
+if rank == 0:
+    writeFile(numFiles - 1, expected[-1])
+    mtime = os.stat(fnames[-1]).st_mtime + 10
+    os.utime(fnames[-1], (mtime, mtime))
+barrier()
+check(readTimes(True, True), "invalidated cache")
+check(readTimes(False, True), "updated cache")
+
+if rank == 0:
+    leftovers = [f for f in os.listdir(cachedir) if f.endswith(".tmp")]
+    if leftovers:
+        print("ERROR: temporary cache files left behind: %s" % leftovers)
+        sys.exit(1)
+    shutil.rmtree(datadir, ignore_errors=True)
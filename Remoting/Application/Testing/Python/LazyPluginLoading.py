@@ -0,0 +1,48 @@
+# Registers the PacMan plugin as deferred and checks that it gets loaded when
+# one of its proxies is created.
+
+from paraview.simple import *
+from paraview import servermanager
+import sys
+
+tracker = servermanager.vtkPVPluginTracker.GetInstance()
+index = None
+for cc in range(tracker.GetNumberOfPlugins()):
+    if tracker.GetPluginName(cc) == "PacMan":
+        index = cc
+        break
+
+if index is None:
+    print("Error: PacMan plugin is not available")
+    sys.exit(1)
+
+if tracker.GetPluginLoaded(index):
+    print("Error: PacMan plugin should not be loaded yet")
+    sys.exit(1)
+
+tracker.LazyLoadingOn()
+if not tracker.RegisterDeferredPlugin(tracker.GetPluginFileName(index)):
+    print("Error: PacMan plugin could not be deferred, is its manifest missing?")
+    sys.exit(1)
+
+if not tracker.GetPluginDeferred(index) or tracker.GetPluginLoaded(index):
+    print("Error: PacMan plugin should be deferred")
+    sys.exit(1)
+
+# The definitions are available from the manifest.
+pxm = servermanager.ActiveConnection.Session.GetSessionProxyManager()
+if not pxm.HasDefinition("sources", "PacMan"):
+    print("Error: PacMan proxy definition should be available from the manifest")
+    sys.exit(1)
+
+proxy = pxm.NewProxy("sources", "PacMan")
+if not tracker.GetPluginLoaded(index) or tracker.GetPluginDeferred(index):
+    print("Error: PacMan plugin should be loaded once one of its proxies is created")
+    sys.exit(1)
+
+proxy.UpdateVTKObjects()
+proxy.UpdatePipeline()
+if proxy.GetDataInformation().GetNumberOfPoints() == 0:
+    print("Error: PacMan source produced no points")
+    sys.exit(1)
+proxy.UnRegister(None)
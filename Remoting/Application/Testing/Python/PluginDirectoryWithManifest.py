@@ -0,0 +1,49 @@
+# Loads the plugins of the PacMan plugin directory, which holds the plugin
+# library and its manifest, and checks that only the library is loaded: the
+# manifest must not be loaded as an XML plugin.
+
+from paraview.simple import *
+from paraview import servermanager
+import os
+import sys
+
+tracker = servermanager.vtkPVPluginTracker.GetInstance()
+index = None
+for cc in range(tracker.GetNumberOfPlugins()):
+    if tracker.GetPluginName(cc) == "PacMan":
+        index = cc
+        break
+
+if index is None:
+    print("Error: PacMan plugin is not available")
+    sys.exit(1)
+
+pluginDir = os.path.dirname(tracker.GetPluginFileName(index))
+manifest = os.path.splitext(tracker.GetPluginFileName(index))[0] + ".manifest.xml"
+if not os.path.exists(manifest):
+    print("Error: PacMan plugin has no manifest")
+    sys.exit(1)
+
+numPlugins = tracker.GetNumberOfPlugins()
+loader = servermanager.vtkPVPluginLoader()
+loader.LoadPluginsFromPath(pluginDir)
+
+if not tracker.GetPluginLoaded(index):
+    print("Error: PacMan plugin should be loaded from its directory")
+    sys.exit(1)
+
+for cc in range(tracker.GetNumberOfPlugins()):
+    if tracker.GetPluginFileName(cc).endswith(".manifest.xml"):
+        print("Error: the manifest was loaded as plugin `%s`" % tracker.GetPluginName(cc))
+        sys.exit(1)
+
+if tracker.GetNumberOfPlugins() != numPlugins:
+    print("Error: loading the plugin directory registered new plugins")
+    sys.exit(1)
+
+pxm = servermanager.ActiveConnection.Session.GetSessionProxyManager()
+proxy = pxm.NewProxy("sources", "PacMan")
+if not proxy:
+    print("Error: PacMan proxy could not be created")
+    sys.exit(1)
+proxy.UnRegister(None)
@@ -0,0 +1,128 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestIncrementalDirectoryListing.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkClientServerStream.h"
+#include "vtkCollection.h"
+#include "vtkNew.h"
+#include "vtkPVFileInformation.h"
+#include "vtkPVFileInformationHelper.h"
+
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemTools.hxx>
+
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <string>
+
+namespace
+{
+std::multiset<std::string> GetNames(vtkPVFileInformation* info)
+{
+  std::multiset<std::string> names;
+  vtkCollection* coll = info->GetContents();
+  coll->InitTraversal();
+  while (vtkObject* obj = coll->GetNextItemAsObject())
+  {
+    names.insert(vtkPVFileInformation::SafeDownCast(obj)->GetName());
+  }
+  return names;
+}
+}
+
+int TestIncrementalDirectoryListing(int, char* [])
+{
+  const std::string dir =
+    vtksys::SystemTools::GetCurrentWorkingDirectory() + "/TestIncrementalDirectoryListing";
+  vtksys::SystemTools::RemoveADirectory(dir);
+  vtksys::SystemTools::MakeDirectory(dir + "/sub");
+  const char* files[] = { "alpha.txt", "beta.txt", "gamma.txt", "data_001.vtk", "data_002.vtk",
+    "data_003.vtk" };
+  for (const char* file : files)
+  {
+    vtksys::ofstream stream(std::string(dir + "/" + file).c_str());
+    stream << file << std::endl;
+  }
+
+  vtkNew<vtkPVFileInformationHelper> helper;
+  helper->SetPath(dir.c_str());
+  helper->SetDirectoryListing(1);
+
+  // Complete listing: "sub", the 3 text files and the "data_..vtk" group.
+  vtkNew<vtkPVFileInformation> complete;
+  complete->CopyFromObject(helper);
+  if (complete->GetContents()->GetNumberOfItems() != 5 ||
+    complete->GetTotalNumberOfEntries() != 5 || complete->GetListingOffset() != 0)
+  {
+    std::cerr << "Unexpected complete listing of " << dir << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Incremental listing, 2 entries at a time.
+  helper->SetMaximumNumberOfEntries(2);
+  std::multiset<std::string> names;
+  for (int offset = 0; offset < 5; offset += 2)
+  {
+    helper->SetListingOffset(offset);
+    vtkNew<vtkPVFileInformation> page;
+    page->CopyFromObject(helper);
+
+    // Pages go through the client/server stream.
+    vtkClientServerStream stream;
+    page->CopyToStream(&stream);
+    vtkNew<vtkPVFileInformation> received;
+    received->CopyFromStream(&stream);
+
+    const int expected = offset < 4 ? 2 : 1;
+    if (received->GetContents()->GetNumberOfItems() != expected ||
+      received->GetListingOffset() != offset || received->GetTotalNumberOfEntries() != 5)
+    {
+      std::cerr << "Unexpected page at offset " << offset << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (offset == 0 &&
+      strcmp(vtkPVFileInformation::SafeDownCast(received->GetContents()->GetItemAsObject(0))
+               ->GetName(),
+        "sub") != 0)
+    {
+      std::cerr << "Directories must be listed first." << std::endl;
+      return EXIT_FAILURE;
+    }
+    const std::multiset<std::string> pageNames = GetNames(received);
+    names.insert(pageNames.begin(), pageNames.end());
+  }
+
+  if (names != GetNames(complete))
+  {
+    std::cerr << "Pages do not match the complete listing." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Cancelling a listing then requesting a page lists the directory again.
+  helper->SetListingOffset(0);
+  vtkNew<vtkPVFileInformation> first;
+  first->CopyFromObject(helper);
+  helper->ClearListing();
+  helper->SetListingOffset(2);
+  vtkNew<vtkPVFileInformation> second;
+  second->CopyFromObject(helper);
+  if (second->GetContents()->GetNumberOfItems() != 2 || second->GetTotalNumberOfEntries() != 5)
+  {
+    std::cerr << "Unexpected page after cancelling the listing." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtksys::SystemTools::RemoveADirectory(dir);
+  return EXIT_SUCCESS;
+}
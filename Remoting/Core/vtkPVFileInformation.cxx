@@ -50,10 +50,12 @@
 #endif
 
 #include <algorithm>
+#include <map>
 #include <set>
 #include <string>
 #include <time.h>
-#include <vtksys/RegularExpression.hxx>
+#include <unordered_map>
+#include <vector>
 #include <vtksys/SystemTools.hxx>
 
 vtkStandardNewMacro(vtkPVFileInformation);
@@ -365,6 +367,8 @@ vtkPVFileInformation::vtkPVFileInformation()
   this->Hidden = false;
   this->Extension = NULL;
   this->Size = 0;
+  this->ListingOffset = 0;
+  this->TotalNumberOfEntries = 0;
 #ifdef _WIN32
   this->ModificationTime = _time64(NULL);
 #else
@@ -466,14 +470,140 @@ void vtkPVFileInformation::CopyFromObject(vtkObject* object)
 
   if (this->IsDirectory(this->Type) && helper->GetDirectoryListing())
   {
-// Since we want a directory listing, we now to platform specific listing
-// with intelligent pattern matching hee-haa.
+    if (helper->GetMaximumNumberOfEntries() > 0)
+    {
+      this->GetIncrementalDirectoryListing(helper);
+      return;
+    }
+
+    // Since we want a directory listing, we now to platform specific listing
+    // with intelligent pattern matching hee-haa.
+    vtkPVFileInformationSet info_set;
 #if defined(_WIN32)
-    this->GetWindowsDirectoryListing();
+    this->GetWindowsDirectoryListing(info_set);
 #else
-    this->GetDirectoryListing();
+    this->GetDirectoryListing(info_set);
 #endif
+    for (vtkPVFileInformationSet::iterator iter = info_set.begin(); iter != info_set.end(); ++iter)
+    {
+      this->AddListingEntry(*iter);
+    }
+    this->TotalNumberOfEntries = this->Contents->GetNumberOfItems();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::GetIncrementalDirectoryListing(vtkPVFileInformationHelper* helper)
+{
+  std::vector<vtkSmartPointer<vtkPVFileInformation> >& listing = helper->Listing;
+  const int offset = helper->GetListingOffset();
+  if (offset == 0 || helper->ListingPath != this->FullPath)
+  {
+    // Read and group the entries, deferring type detection and detailed
+    // information to the requests for the pages they belong to. Entries are
+    // sorted so that pages are stable, with directories first.
+    vtkPVFileInformationSet info_set;
+#if defined(_WIN32)
+    this->GetWindowsDirectoryListing(info_set);
+#else
+    this->GetDirectoryListing(info_set);
+#endif
+    listing.assign(info_set.begin(), info_set.end());
+    std::sort(listing.begin(), listing.end(),
+      [](const vtkPVFileInformation* a, const vtkPVFileInformation* b) {
+        const bool aIsDirectory = IsDirectory(a->Type) || a->Type == DIRECTORY_GROUP;
+        const bool bIsDirectory = IsDirectory(b->Type) || b->Type == DIRECTORY_GROUP;
+        if (aIsDirectory != bIsDirectory)
+        {
+          return aIsDirectory;
+        }
+        return vtksys::SystemTools::Strucmp(a->Name, b->Name) < 0;
+      });
+    helper->ListingPath = this->FullPath;
+  }
+
+  const int total = static_cast<int>(listing.size());
+  const int count = std::min(helper->GetMaximumNumberOfEntries(), std::max(0, total - offset));
+  for (int cc = offset; cc < offset + count; ++cc)
+  {
+    this->AddListingEntry(listing[cc]);
+  }
+  this->ListingOffset = offset;
+  this->TotalNumberOfEntries = total;
+
+  if (offset + count >= total)
+  {
+    // The client got the last page.
+    helper->ClearListing();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::AddListingEntry(vtkPVFileInformation* entry)
+{
+#if defined(_WIN32)
+  // Types and details are known from the listing itself.
+  this->Contents->AddItem(entry);
+#else
+  // We detect the file types for items, dissolving any groups that contain
+  // non-file items.
+  vtkSmartPointer<vtkCollectionIterator> iter;
+  iter.TakeReference(entry->Contents->NewIterator());
+  if (entry->DetectType())
+  {
+    this->Contents->AddItem(entry);
+    if (this->ReadDetailedFileInformation)
+    {
+      entry->ReadDetailedInformation();
+      for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+      {
+        vtkPVFileInformation::SafeDownCast(iter->GetCurrentObject())->ReadDetailedInformation();
+      }
+    }
   }
+  else
+  {
+    // Add children to contents.
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+      vtkPVFileInformation* child = vtkPVFileInformation::SafeDownCast(iter->GetCurrentObject());
+      if (child->DetectType())
+      {
+        this->Contents->AddItem(child);
+        if (this->ReadDetailedFileInformation)
+        {
+          child->ReadDetailedInformation();
+        }
+      }
+    }
+  }
+#endif
+}
+
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::ReadDetailedInformation()
+{
+#if !defined(_WIN32)
+  if (this->Type == FILE_GROUP || this->Type == DIRECTORY_GROUP)
+  {
+    return;
+  }
+  vtksys::SystemTools::Stat_t status;
+  if (vtksys::SystemTools::Stat(this->FullPath, &status) != -1)
+  {
+    if (!S_ISDIR(status.st_mode))
+    {
+      std::string::size_type pos = std::string(this->Name).rfind('.');
+      if (pos != std::string::npos)
+      {
+        std::string ext = std::string(this->Name).substr(pos + 1);
+        this->SetExtension(ext.c_str());
+      }
+    }
+    this->Size = status.st_size;
+    this->ModificationTime = status.st_mtime;
+  }
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -633,11 +763,9 @@ void vtkPVFileInformation::GetSpecialDirectories()
 }
 
 //-----------------------------------------------------------------------------
-void vtkPVFileInformation::GetWindowsDirectoryListing()
+void vtkPVFileInformation::GetWindowsDirectoryListing(vtkPVFileInformationSet& info_set)
 {
 #if defined(_WIN32)
-  vtkPVFileInformationSet info_set;
-
   std::string lfullPath = vtkPVFileInformationHelper::Utf8ToLocalWin32(this->FullPath);
 
   if (IsNetworkPath(lfullPath))
@@ -659,11 +787,6 @@ void vtkPVFileInformation::GetWindowsDirectoryListing()
       }
     }
     this->OrganizeCollection(info_set);
-
-    for (vtkPVFileInformationSet::iterator iter = info_set.begin(); iter != info_set.end(); ++iter)
-    {
-      this->Contents->AddItem(*iter);
-    }
     return;
   }
 
@@ -697,12 +820,6 @@ void vtkPVFileInformation::GetWindowsDirectoryListing()
     if (didListing)
     {
       this->OrganizeCollection(info_set);
-
-      for (vtkPVFileInformationSet::iterator iter = info_set.begin(); iter != info_set.end();
-           ++iter)
-      {
-        this->Contents->AddItem(*iter);
-      }
       return;
     }
     // fall through for normal file listing that works after shares are
@@ -811,12 +928,8 @@ void vtkPVFileInformation::GetWindowsDirectoryListing()
 
   this->OrganizeCollection(info_set);
 
-  for (vtkPVFileInformationSet::iterator iter = info_set.begin(); iter != info_set.end(); ++iter)
-  {
-    this->Contents->AddItem(*iter);
-  }
-
 #else
+  (void)info_set;
   vtkErrorMacro("GetWindowsDirectoryListing cannot be called on non-Windows systems.");
 #endif
 }
@@ -831,16 +944,16 @@ support and glibc/Linux system headers:
 #endif
 
 //-----------------------------------------------------------------------------
-void vtkPVFileInformation::GetDirectoryListing()
+void vtkPVFileInformation::GetDirectoryListing(vtkPVFileInformationSet& info_set)
 {
 #if defined(_WIN32)
 
+  (void)info_set;
   vtkErrorMacro("GetDirectoryListing() cannot be called on Windows systems.");
   return;
 
 #else
 
-  vtkPVFileInformationSet info_set;
   std::string prefix = this->FullPath;
   vtkPVFileInformationAddTerminatingSlash(prefix);
 
@@ -852,7 +965,10 @@ void vtkPVFileInformation::GetDirectoryListing()
     return;
   }
 
-  // Loop through the directory listing.
+  // Loop through the directory listing. Entries are not stat'ed here: the
+  // type is taken from the directory entry when the file system provides it
+  // and is otherwise detected, together with the detailed information, when
+  // the entry is added to the contents.
   while (const dirent* d = readdir(dir))
   {
     // Skip the special directory entries.
@@ -866,43 +982,25 @@ void vtkPVFileInformation::GetDirectoryListing()
     info->Type = INVALID;
     info->SetHiddenFlag();
 
-    vtksys::SystemTools::Stat_t status;
-    int res;
-    if (this->ReadDetailedFileInformation)
-    {
-      // Recover status info
-      res = vtksys::SystemTools::Stat(info->FullPath, &status);
-      if (res != -1)
-      {
-        if (!S_ISDIR(status.st_mode))
-        {
-          std::string::size_type pos = std::string(d->d_name).rfind('.');
-          if (pos != std::string::npos)
-          {
-            std::string ext = std::string(d->d_name).substr(pos + 1);
-            info->SetExtension(ext.c_str());
-          }
-        }
-        info->Size = status.st_size;
-        info->ModificationTime = status.st_mtime;
-      }
-    }
 // fix to bug #09452 such that directories with trailing names can be
 // shown in the file dialog
 #if defined(__SVR4) && defined(__sun)
-    if (!this->ReadDetailedFileInformation)
-    {
-      res = vtksys::SystemTools::Stat(info->FullPath, &status);
-    }
-    if (res != -1 && status.st_mode & S_IFDIR)
+    vtksys::SystemTools::Stat_t status;
+    if (vtksys::SystemTools::Stat(info->FullPath, &status) != -1 && S_ISDIR(status.st_mode))
     {
       info->Type = DIRECTORY;
     }
 #else
-    if (d->d_type & DT_DIR)
+    // Symbolic links and entries of unknown type are left INVALID so that
+    // DetectType() resolves them.
+    if (d->d_type == DT_DIR)
     {
       info->Type = DIRECTORY;
     }
+    else if (d->d_type == DT_REG)
+    {
+      info->Type = SINGLE_FILE;
+    }
 #endif
 
     info->FastFileTypeDetection = this->FastFileTypeDetection;
@@ -912,31 +1010,6 @@ void vtkPVFileInformation::GetDirectoryListing()
   closedir(dir);
 
   this->OrganizeCollection(info_set);
-
-  // Now we detect the file types for items.
-  // We dissolve any groups that contain non-file items.
-
-  for (vtkPVFileInformationSet::iterator iter = info_set.begin(); iter != info_set.end(); ++iter)
-  {
-    vtkPVFileInformation* obj = (*iter);
-    if (obj->DetectType())
-    {
-      this->Contents->AddItem(obj);
-    }
-    else
-    {
-      // Add children to contents.
-      for (int cc = 0; cc < obj->Contents->GetNumberOfItems(); cc++)
-      {
-        vtkPVFileInformation* child =
-          vtkPVFileInformation::SafeDownCast(obj->Contents->GetItemAsObject(cc));
-        if (child->DetectType())
-        {
-          this->Contents->AddItem(child);
-        }
-      }
-    }
-  }
 #endif
 }
 
@@ -993,11 +1066,20 @@ bool vtkPVFileInformation::DetectType()
   }
   else if (this->Type == INVALID)
   {
+#if defined(_WIN32)
     if (vtksys::SystemTools::FileExists(this->FullPath))
     {
       this->Type = (vtksys::SystemTools::FileIsDirectory(this->FullPath)) ? DIRECTORY : SINGLE_FILE;
       return true;
     }
+#else
+    vtksys::SystemTools::Stat_t status;
+    if (vtksys::SystemTools::Stat(this->FullPath, &status) != -1)
+    {
+      this->Type = S_ISDIR(status.st_mode) ? DIRECTORY : SINGLE_FILE;
+      return true;
+    }
+#endif
     return false;
   }
   return true;
@@ -1014,7 +1096,7 @@ struct vtkPVFileInformation::vtkInfo
 //-----------------------------------------------------------------------------
 void vtkPVFileInformation::OrganizeCollection(vtkPVFileInformationSet& info_set)
 {
-  typedef std::map<std::string, vtkInfo> MapOfStringToInfo;
+  typedef std::unordered_map<std::string, vtkInfo> MapOfStringToInfo;
   MapOfStringToInfo fileGroups;
 
   std::string prefix = this->FullPath;
@@ -1101,7 +1183,7 @@ void vtkPVFileInformation::CopyToStream(vtkClientServerStream* stream)
 {
   *stream << vtkClientServerStream::Reply << this->Name << this->FullPath << this->Type
           << this->Hidden << this->Contents->GetNumberOfItems() << this->Extension << this->Size
-          << this->ModificationTime;
+          << this->ModificationTime << this->ListingOffset << this->TotalNumberOfEntries;
 
   vtkSmartPointer<vtkCollectionIterator> iter;
   iter.TakeReference(this->Contents->NewIterator());
@@ -1168,11 +1250,21 @@ void vtkPVFileInformation::CopyFromStream(const vtkClientServerStream* css)
     vtkErrorMacro("Error parsing File extension.");
     return;
   }
+  if (!css->GetArgument(0, 8, &this->ListingOffset))
+  {
+    vtkErrorMacro("Error parsing ListingOffset.");
+    return;
+  }
+  if (!css->GetArgument(0, 9, &this->TotalNumberOfEntries))
+  {
+    vtkErrorMacro("Error parsing TotalNumberOfEntries.");
+    return;
+  }
   for (int cc = 0; cc < num_of_children; cc++)
   {
     vtkPVFileInformation* child = vtkPVFileInformation::New();
     vtkClientServerStream childStream;
-    if (!css->GetArgument(0, 8 + cc, &childStream))
+    if (!css->GetArgument(0, 10 + cc, &childStream))
     {
       vtkErrorMacro("Error parsing child #" << cc);
       return;
@@ -1193,6 +1285,8 @@ void vtkPVFileInformation::Initialize()
   this->Contents->RemoveAllItems();
   this->SetExtension(0);
   this->Size = 0;
+  this->ListingOffset = 0;
+  this->TotalNumberOfEntries = 0;
 #ifdef _WIN32
   this->ModificationTime = _time64(NULL);
 #else
@@ -1264,6 +1358,8 @@ void vtkPVFileInformation::PrintSelf(ostream& os, vtkIndent indent)
   }
   os << indent << "Hidden: " << this->Hidden << endl;
   os << indent << "FastFileTypeDetection: " << this->FastFileTypeDetection << endl;
+  os << indent << "ListingOffset: " << this->ListingOffset << endl;
+  os << indent << "TotalNumberOfEntries: " << this->TotalNumberOfEntries << endl;
 
   for (int cc = 0; cc < this->Contents->GetNumberOfItems(); cc++)
   {
@@ -33,6 +33,7 @@
 #include <string> // Needed for std::string
 
 class vtkCollection;
+class vtkPVFileInformationHelper;
 class vtkPVFileInformationSet;
 class vtkFileSequenceParser;
 
@@ -129,6 +130,21 @@ public:
   vtkGetMacro(ModificationTime, time_t);
   //@}
 
+  //@{
+  /**
+   * When a directory is listed incrementally (see
+   * vtkPVFileInformationHelper::SetMaximumNumberOfEntries), Contents only
+   * holds one page of the listing. ListingOffset is then the index of the
+   * first entry of that page and TotalNumberOfEntries the number of entries in
+   * the complete listing, hence more pages are available as long as
+   * ListingOffset + MaximumNumberOfEntries < TotalNumberOfEntries. For complete
+   * listings, ListingOffset is 0 and TotalNumberOfEntries is the number of
+   * items in Contents.
+   */
+  vtkGetMacro(ListingOffset, int);
+  vtkGetMacro(TotalNumberOfEntries, int);
+  //@}
+
   /**
   * Returns the path to the base data directory path holding various files
   * packaged with ParaView.
@@ -160,12 +176,22 @@ protected:
   long long Size;          // File size
   time_t ModificationTime; // File modification time
 
+  int ListingOffset;        // Index of the first entry of Contents in the listing.
+  int TotalNumberOfEntries; // Number of entries in the complete listing.
+
   vtkSetStringMacro(Extension);
   vtkSetStringMacro(Name);
   vtkSetStringMacro(FullPath);
 
-  void GetWindowsDirectoryListing();
-  void GetDirectoryListing();
+  void GetWindowsDirectoryListing(vtkPVFileInformationSet& info_set);
+  void GetDirectoryListing(vtkPVFileInformationSet& info_set);
+  void GetIncrementalDirectoryListing(vtkPVFileInformationHelper* helper);
+
+  // Detects the type of a listed entry (and of its children for groups),
+  // reads its detailed information if requested and adds it to Contents.
+  // Groups that turn out to contain non-file items are dissolved.
+  void AddListingEntry(vtkPVFileInformation* entry);
+  void ReadDetailedInformation();
 
   // Goes thru the collection of vtkPVFileInformation objects
   // are creates file groups, if possible.
@@ -15,6 +15,7 @@
 #include "vtkPVFileInformationHelper.h"
 
 #include "vtkObjectFactory.h"
+#include "vtkPVFileInformation.h"
 
 #if defined(_WIN32)
 #include <wchar.h>
@@ -33,6 +34,8 @@ vtkPVFileInformationHelper::vtkPVFileInformationHelper()
   , FastFileTypeDetection(1)
   , ReadDetailedFileInformation(false)
   , PathSeparator(nullptr)
+  , MaximumNumberOfEntries(0)
+  , ListingOffset(0)
 {
   this->SetPath(".");
 #if defined(_WIN32) && !defined(__CYGWIN__)
@@ -50,6 +53,14 @@ vtkPVFileInformationHelper::~vtkPVFileInformationHelper()
   this->SetWorkingDirectory(0);
 }
 
+//-----------------------------------------------------------------------------
+void vtkPVFileInformationHelper::ClearListing()
+{
+  this->Listing.clear();
+  this->Listing.shrink_to_fit();
+  this->ListingPath.clear();
+}
+
 //-----------------------------------------------------------------------------
 bool vtkPVFileInformationHelper::GetActiveFileIsReadable()
 {
@@ -76,6 +87,9 @@ void vtkPVFileInformationHelper::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "PathSeparator: " << (this->PathSeparator ? this->PathSeparator : "(null)")
      << endl;
   os << indent << "FastFileTypeDetection: " << this->FastFileTypeDetection << endl;
+  os << indent << "ReadDetailedFileInformation: " << this->ReadDetailedFileInformation << endl;
+  os << indent << "MaximumNumberOfEntries: " << this->MaximumNumberOfEntries << endl;
+  os << indent << "ListingOffset: " << this->ListingOffset << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -30,8 +30,12 @@
 
 #include "vtkObject.h"
 #include "vtkRemotingCoreModule.h" //needed for exports
+#include "vtkSmartPointer.h"       // needed for vtkSmartPointer
 
 #include <string> // needed for std::string
+#include <vector> // needed for std::vector
+
+class vtkPVFileInformation;
 
 class VTKREMOTINGCORE_EXPORT vtkPVFileInformationHelper : public vtkObject
 {
@@ -139,10 +143,35 @@ public:
   vtkSetMacro(ReadDetailedFileInformation, bool);
   //@}
 
+  //@{
+  /**
+   * Get/Set the maximum number of entries returned by a directory listing.
+   * When greater than 0, the directory is listed incrementally: the request
+   * with ListingOffset 0 reads and groups the directory entries and keeps them
+   * on this helper, then each request returns at most MaximumNumberOfEntries
+   * entries starting at ListingOffset. The type and detailed information of
+   * an entry are only read when its page is requested.
+   * Default is 0, i.e. the complete listing is returned at once.
+   */
+  vtkGetMacro(MaximumNumberOfEntries, int);
+  vtkSetClampMacro(MaximumNumberOfEntries, int, 0, VTK_INT_MAX);
+  vtkGetMacro(ListingOffset, int);
+  vtkSetClampMacro(ListingOffset, int, 0, VTK_INT_MAX);
+  //@}
+
+  /**
+   * Release the entries kept for an incremental directory listing. This is
+   * done automatically once the last page has been returned; clients call it
+   * to cancel a listing they are no longer interested in.
+   */
+  void ClearListing();
+
 protected:
   vtkPVFileInformationHelper();
   ~vtkPVFileInformationHelper() override;
 
+  friend class vtkPVFileInformation;
+
   char* Path;
   char* WorkingDirectory;
   int DirectoryListing;
@@ -153,6 +182,13 @@ protected:
   char* PathSeparator;
   vtkSetStringMacro(PathSeparator);
 
+  int MaximumNumberOfEntries;
+  int ListingOffset;
+
+  // Grouped entries of the directory being listed incrementally.
+  std::vector<vtkSmartPointer<vtkPVFileInformation> > Listing;
+  std::string ListingPath;
+
 private:
   vtkPVFileInformationHelper(const vtkPVFileInformationHelper&) = delete;
   void operator=(const vtkPVFileInformationHelper&) = delete;
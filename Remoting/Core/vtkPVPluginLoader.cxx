@@ -383,6 +383,12 @@ void vtkPVPluginLoader::LoadPluginsFromPath(const char* path)
       std::string ext = vtksys::SystemTools::GetFilenameLastExtension(rel_path);
       has_valid_extension =
         (ext == compiled_extension || ext == ".xml" || ext == ".sl" || ext == ".py");
+      // plugin manifests sit next to the libraries they describe but aren't
+      // XML plugins themselves.
+      if (ext == ".xml" && vtksys::SystemTools::StringEndsWith(rel_path, ".manifest.xml"))
+      {
+        has_valid_extension = false;
+      }
       assume_exists = true;
     }
 
@@ -403,8 +409,11 @@ void vtkPVPluginLoader::LoadPluginsFromPath(const char* path)
       continue;
     }
 
-    // Load the plugin.
-    this->LoadPluginSilently(full_file.c_str());
+    // Load the plugin, unless its manifest allows it to be loaded on demand.
+    if (!vtkPVPluginTracker::GetInstance()->RegisterDeferredPlugin(full_file.c_str()))
+    {
+      this->LoadPluginSilently(full_file.c_str());
+    }
   }
 }
 
@@ -37,8 +37,10 @@
 #include "vtksys/SystemTools.hxx"
 
 #include <assert.h>
+#include <map>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #if defined(_WIN32) && !defined(__CYGWIN__)
@@ -59,10 +61,13 @@ public:
   std::string PluginName;
   vtkPVPlugin* Plugin;
   bool AutoLoad;
+  bool Deferred;
+  vtkSmartPointer<vtkPVXMLElement> Manifest;
   vtkItem()
   {
     this->Plugin = NULL;
     this->AutoLoad = false;
+    this->Deferred = false;
   }
 };
 
@@ -198,6 +203,32 @@ std::string vtkLocatePluginOrConfigFile(const char* plugin, const char* hint, bo
   return std::string();
 }
 
+/**
+ * Read the manifest accompanying a plugin library, if any. Returns nullptr if
+ * there's no manifest or if it is invalid.
+ */
+vtkSmartPointer<vtkPVXMLElement> vtkReadPluginManifest(const std::string& filename)
+{
+  const std::string manifest = vtksys::SystemTools::GetFilenamePath(filename) + "/" +
+    vtksys::SystemTools::GetFilenameWithoutLastExtension(filename) + ".manifest.xml";
+  if (!vtksys::SystemTools::FileExists(manifest, true))
+  {
+    return nullptr;
+  }
+
+  vtkNew<vtkPVXMLParser> parser;
+  parser->SetFileName(manifest.c_str());
+  parser->SuppressErrorMessagesOn();
+  if (!parser->Parse() || parser->GetRootElement() == nullptr ||
+    strcmp(parser->GetRootElement()->GetName(), "PluginManifest") != 0)
+  {
+    vtkVLogF(PARAVIEW_LOG_PLUGIN_VERBOSITY(), "Ignoring invalid plugin manifest `%s`.",
+      manifest.c_str());
+    return nullptr;
+  }
+  return parser->GetRootElement();
+}
+
 /**
  * Converts a filename for a plugin to it's name i.e. removes the library
  * prefix and suffix, if any.
@@ -216,6 +247,54 @@ std::string vtkGetPluginNameFromFileName(const std::string& filename)
 class vtkPVPluginTracker::vtkPluginsList : public std::vector<vtkItem>
 {
 public:
+  // (group, name) of the proxies provided by deferred plugins, mapped to the
+  // name of the plugin.
+  std::map<std::pair<std::string, std::string>, std::string> DeferredProxies;
+
+  void AddDeferredProxies(const std::string& pluginname, vtkPVXMLElement* manifest)
+  {
+    for (unsigned int cc = 0; cc < manifest->GetNumberOfNestedElements(); ++cc)
+    {
+      vtkPVXMLElement* child = manifest->GetNestedElement(cc);
+      if (strcmp(child->GetName(), "Proxy") == 0)
+      {
+        this->DeferredProxies[std::make_pair(std::string(child->GetAttributeOrEmpty("group")),
+          std::string(child->GetAttributeOrEmpty("name")))] = pluginname;
+      }
+      else if (strcmp(child->GetName(), "ServerManagerConfiguration") == 0)
+      {
+        for (unsigned int i = 0; i < child->GetNumberOfNestedElements(); ++i)
+        {
+          vtkPVXMLElement* group = child->GetNestedElement(i);
+          const std::string groupname = group->GetAttributeOrEmpty("name");
+          for (unsigned int j = 0; j < group->GetNumberOfNestedElements(); ++j)
+          {
+            const char* proxyname = group->GetNestedElement(j)->GetAttribute("name");
+            if (proxyname)
+            {
+              this->DeferredProxies[std::make_pair(groupname, std::string(proxyname))] = pluginname;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void RemoveDeferredProxies(const std::string& pluginname)
+  {
+    for (auto iter = this->DeferredProxies.begin(); iter != this->DeferredProxies.end();)
+    {
+      if (iter->second == pluginname)
+      {
+        iter = this->DeferredProxies.erase(iter);
+      }
+      else
+      {
+        ++iter;
+      }
+    }
+  }
+
   iterator LocateUsingPluginName(const char* pluginname)
   {
     for (iterator iter = this->begin(); iter != this->end(); ++iter)
@@ -246,6 +325,8 @@ vtkStandardNewMacro(vtkPVPluginTracker);
 vtkPVPluginTracker::vtkPVPluginTracker()
 {
   this->PluginsList = new vtkPluginsList();
+  const char* lazy = vtksys::SystemTools::GetEnv("PV_PLUGIN_LAZY_LOAD");
+  this->LazyLoading = (lazy != nullptr && strcmp(lazy, "0") != 0);
   if (vtksys::SystemTools::GetEnv("PV_PLUGIN_DEBUG") != nullptr)
   {
     vtkWarningMacro("`PV_PLUGIN_DEBUG` environment variable has been deprecated. "
@@ -491,7 +572,8 @@ void vtkPVPluginTracker::LoadPluginConfigurationXMLHinted(
       }
       vtkVLogF(PARAVIEW_LOG_PLUGIN_VERBOSITY(), "found `%s`", plugin_filename.c_str());
       unsigned int index = this->RegisterAvailablePlugin(plugin_filename.c_str());
-      if ((auto_load || forceLoad) && !this->GetPluginLoaded(index))
+      if ((auto_load || forceLoad) && !this->GetPluginLoaded(index) &&
+        !this->GetPluginDeferred(index) && !this->RegisterDeferredPlugin(plugin_filename.c_str()))
       {
         // load the plugin.
         vtkPVPluginLoader* loader = vtkPVPluginLoader::New();
@@ -560,6 +642,13 @@ void vtkPVPluginTracker::RegisterPlugin(vtkPVPlugin* plugin)
     }
   }
 
+  // The plugin may have been registered as deferred and loaded explicitly.
+  if (iter != this->PluginsList->end() && iter->Deferred)
+  {
+    iter->Deferred = false;
+    this->PluginsList->RemoveDeferredProxies(iter->PluginName);
+  }
+
   // Do some basic processing of the plugin here itself.
 
   // If this plugin has functions for initializing the interpreter, we set them
@@ -656,6 +745,125 @@ bool vtkPVPluginTracker::GetPluginAutoLoad(unsigned int index)
   return (*this->PluginsList)[index].AutoLoad;
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVPluginTracker::GetPluginDeferred(unsigned int index)
+{
+  if (index >= this->GetNumberOfPlugins())
+  {
+    vtkWarningMacro("Invalid index: " << index);
+    return false;
+  }
+  return (*this->PluginsList)[index].Deferred;
+}
+
+//----------------------------------------------------------------------------
+vtkPVXMLElement* vtkPVPluginTracker::GetPluginManifest(unsigned int index)
+{
+  if (index >= this->GetNumberOfPlugins())
+  {
+    vtkWarningMacro("Invalid index: " << index);
+    return NULL;
+  }
+  return (*this->PluginsList)[index].Manifest;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVPluginTracker::RegisterDeferredPlugin(const char* filename)
+{
+  if (!this->LazyLoading || !filename)
+  {
+    return false;
+  }
+
+  const std::string ext = vtksys::SystemTools::GetFilenameLastExtension(filename);
+  if (ext == ".xml" || ext == ".py")
+  {
+    // nothing to gain by deferring plugins that are not shared libraries.
+    return false;
+  }
+
+  vtkSmartPointer<vtkPVXMLElement> manifest = vtkReadPluginManifest(filename);
+  int defer = 1;
+  if (!manifest || (manifest->GetScalarAttribute("defer", &defer) && defer == 0))
+  {
+    return false;
+  }
+
+  unsigned int index = this->RegisterAvailablePlugin(filename);
+  vtkItem& item = (*this->PluginsList)[index];
+  if (item.Plugin != NULL || item.Deferred)
+  {
+    return item.Deferred;
+  }
+  if (const char* name = manifest->GetAttribute("name"))
+  {
+    item.PluginName = name;
+  }
+  item.Manifest = manifest;
+  item.Deferred = true;
+  item.AutoLoad = true;
+  this->PluginsList->AddDeferredProxies(item.PluginName, manifest);
+
+  vtkVLogF(PARAVIEW_LOG_PLUGIN_VERBOSITY(), "Deferring load of plugin `%s` (%s).",
+    item.PluginName.c_str(), filename);
+  this->InvokeEvent(vtkPVPluginTracker::RegisterDeferredPluginEvent, manifest.GetPointer());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVPluginTracker::LoadDeferredPluginForProxy(const char* group, const char* name)
+{
+  if (this->PluginsList->DeferredProxies.empty() || !group || !name)
+  {
+    return false;
+  }
+
+  auto iter = this->PluginsList->DeferredProxies.find(std::make_pair(group, name));
+  if (iter == this->PluginsList->DeferredProxies.end())
+  {
+    return false;
+  }
+  const std::string pluginname = iter->second;
+  return this->LoadDeferredPlugin(pluginname.c_str());
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVPluginTracker::LoadDeferredPlugin(const char* pluginname)
+{
+  vtkPluginsList::iterator iter = this->PluginsList->LocateUsingPluginName(pluginname);
+  if (iter == this->PluginsList->end() || !iter->Deferred)
+  {
+    return false;
+  }
+
+  // Clear the flag first, this guards against cyclic dependencies.
+  iter->Deferred = false;
+  this->PluginsList->RemoveDeferredProxies(iter->PluginName);
+  const std::string filename = iter->FileName;
+  vtkSmartPointer<vtkPVXMLElement> manifest = iter->Manifest;
+
+  vtkVLogScopeF(PARAVIEW_LOG_PLUGIN_VERBOSITY(), "loading deferred plugin `%s`", pluginname);
+  for (unsigned int cc = 0; cc < manifest->GetNumberOfNestedElements(); ++cc)
+  {
+    vtkPVXMLElement* child = manifest->GetNestedElement(cc);
+    const char* dependency = child->GetAttribute("name");
+    if (strcmp(child->GetName(), "Requires") == 0 && dependency &&
+      !this->LoadDeferredPlugin(dependency))
+    {
+      vtkPluginsList::iterator dep = this->PluginsList->LocateUsingPluginName(dependency);
+      if (dep == this->PluginsList->end() || dep->Plugin == NULL)
+      {
+        vtkNew<vtkPVPluginLoader> loader;
+        loader->LoadPluginByName(dependency);
+      }
+    }
+  }
+
+  // `iter` may have been invalidated while loading the dependencies.
+  vtkNew<vtkPVPluginLoader> loader;
+  return loader->LoadPlugin(filename.c_str());
+}
+
 //-----------------------------------------------------------------------------
 void vtkPVPluginTracker::RegisterStaticPluginSearchFunction(vtkPluginSearchFunction function)
 {
@@ -75,6 +75,57 @@ public:
    */
   unsigned int RegisterAvailablePlugin(const char* filename);
 
+  //@{
+  /**
+   * Lazy plugin loading. A plugin shared library can be accompanied by a
+   * manifest, a file next to the library named after it with the extension
+   * replaced by `.manifest.xml` (e.g. `Foo.manifest.xml`), describing the plugin
+   * without requiring to load it. `paraview_add_plugin` generates it at build
+   * time from the plugin's server-manager XML files:
+   * @code
+   * <PluginManifest name="[plugin name]" defer="[bool]">
+   *   <Requires name="[plugin name]" />
+   *   <Proxy group="[group]" name="[name]" />
+   *   <ServerManagerConfiguration> ... </ServerManagerConfiguration>
+   * </PluginManifest>
+   * @endcode
+   * When LazyLoading is enabled (off by default, unless the
+   * `PV_PLUGIN_LAZY_LOAD` environment variable is set to `1`), plugins that
+   * would have been loaded at startup and that provide such a manifest are
+   * registered as deferred instead: the server-manager configurations of the
+   * manifest are made available right away, but the library itself is only
+   * loaded the first time a proxy listed in the manifest (or defined in its
+   * configurations) is instantiated, see LoadDeferredPluginForProxy(). Plugins
+   * with client-side components, such as Qt panels, need to be loaded eagerly
+   * and are given `defer="0"`.
+   */
+  vtkSetMacro(LazyLoading, bool);
+  vtkGetMacro(LazyLoading, bool);
+  vtkBooleanMacro(LazyLoading, bool);
+  //@}
+
+  /**
+   * Register the plugin library \c filename as a deferred plugin if lazy
+   * loading is enabled and the plugin provides a manifest allowing it.
+   * Returns true on success, in which case the caller must not load the
+   * library. Fires `vtkPVPluginTracker::RegisterDeferredPluginEvent` with the
+   * manifest (vtkPVXMLElement) as call data.
+   */
+  bool RegisterDeferredPlugin(const char* filename);
+
+  /**
+   * Load the deferred plugin, if any, that provides the proxy (group, name).
+   * Dependencies listed in the manifest are loaded first. Returns true if a
+   * plugin was loaded. This is cheap when no plugin is deferred.
+   */
+  bool LoadDeferredPluginForProxy(const char* group, const char* name);
+
+  /**
+   * Load a deferred plugin, given its name. Returns false if there is no
+   * deferred plugin with that name or if loading failed.
+   */
+  bool LoadDeferredPlugin(const char* pluginname);
+
   //@{
   /**
    * Called to load application-specific configuration xml. The xml is of the
@@ -119,8 +170,15 @@ public:
   const char* GetPluginFileName(unsigned int index);
   bool GetPluginLoaded(unsigned int index);
   bool GetPluginAutoLoad(unsigned int index);
+  bool GetPluginDeferred(unsigned int index);
   //@}
 
+  /**
+   * Returns the manifest of the plugin, if any. Only available for plugins
+   * that have been registered with RegisterDeferredPlugin().
+   */
+  vtkPVXMLElement* GetPluginManifest(unsigned int index);
+
   //@{
   /**
    * Sets the function used to load static plugins.
@@ -134,13 +192,16 @@ public:
 
   enum
   {
-    RegisterAvailablePluginEvent = vtkCommand::UserEvent + 91
+    RegisterAvailablePluginEvent = vtkCommand::UserEvent + 91,
+    RegisterDeferredPluginEvent = vtkCommand::UserEvent + 92
   };
 
 protected:
   vtkPVPluginTracker();
   ~vtkPVPluginTracker() override;
 
+  bool LazyLoading;
+
 private:
   vtkPVPluginTracker(const vtkPVPluginTracker&) = delete;
   void operator=(const vtkPVPluginTracker&) = delete;
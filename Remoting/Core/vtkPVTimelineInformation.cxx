@@ -0,0 +1,149 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTimelineInformation.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVTimelineInformation.h"
+
+#include "vtkClientServerStream.h"
+#include "vtkMultiProcessController.h"
+#include "vtkMultiProcessStream.h"
+#include "vtkObjectFactory.h"
+#include "vtkPVTimeline.h"
+#include "vtkProcessModule.h"
+
+#include "vtksys/FStream.hxx"
+
+#include <sstream>
+
+vtkStandardNewMacro(vtkPVTimelineInformation);
+//----------------------------------------------------------------------------
+vtkPVTimelineInformation::vtkPVTimelineInformation()
+  : ClearEvents(false)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVTimelineInformation::~vtkPVTimelineInformation()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimelineInformation::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ClearEvents: " << this->ClearEvents << endl;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimelineInformation::CopyFromObject(vtkObject*)
+{
+  vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
+  const int rank = controller ? controller->GetLocalProcessId() : 0;
+
+  const char* typeName = "process";
+  const int type = vtkProcessModule::GetProcessType();
+  switch (type)
+  {
+    case vtkProcessModule::PROCESS_CLIENT:
+      typeName = "client";
+      break;
+    case vtkProcessModule::PROCESS_SERVER:
+      typeName = "server";
+      break;
+    case vtkProcessModule::PROCESS_DATA_SERVER:
+      typeName = "data-server";
+      break;
+    case vtkProcessModule::PROCESS_RENDER_SERVER:
+      typeName = "render-server";
+      break;
+    case vtkProcessModule::PROCESS_BATCH:
+      typeName = "batch";
+      break;
+  }
+
+  std::ostringstream name;
+  name << typeName << " (rank " << rank << ")";
+
+  // Use a pid that keeps processes of the same type together, sorted by rank.
+  const int pid = (type + 1) * 1000000 + rank;
+  this->TraceEvents = vtkPVTimeline::GetTraceEvents(pid, name.str().c_str());
+  if (this->ClearEvents)
+  {
+    vtkPVTimeline::Clear();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimelineInformation::AddInformation(vtkPVInformation* pvinfo)
+{
+  vtkPVTimelineInformation* info = vtkPVTimelineInformation::SafeDownCast(pvinfo);
+  if (!info || info->TraceEvents.empty())
+  {
+    return;
+  }
+  if (!this->TraceEvents.empty())
+  {
+    this->TraceEvents += ",\n";
+  }
+  this->TraceEvents += info->TraceEvents;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimelineInformation::CopyToStream(vtkClientServerStream* css)
+{
+  css->Reset();
+  *css << vtkClientServerStream::Reply << this->TraceEvents << vtkClientServerStream::End;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimelineInformation::CopyFromStream(const vtkClientServerStream* css)
+{
+  css->GetArgument(0, 0, &this->TraceEvents);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimelineInformation::CopyParametersToStream(vtkMultiProcessStream& str)
+{
+  str << 847521 << (this->ClearEvents ? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimelineInformation::CopyParametersFromStream(vtkMultiProcessStream& str)
+{
+  int magic_number, clear;
+  str >> magic_number >> clear;
+  if (magic_number != 847521)
+  {
+    vtkErrorMacro("Magic number mismatch.");
+  }
+  this->ClearEvents = (clear != 0);
+}
+
+//----------------------------------------------------------------------------
+std::string vtkPVTimelineInformation::GetChromeTrace()
+{
+  return vtkPVTimeline::GetChromeTrace(this->TraceEvents);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVTimelineInformation::WriteChromeTrace(const char* filename)
+{
+  vtksys::ofstream file(filename, ios::out | ios::binary);
+  if (!file)
+  {
+    vtkErrorMacro("Failed to open file for writing: " << (filename ? filename : "(null)"));
+    return false;
+  }
+  file << this->GetChromeTrace();
+  return static_cast<bool>(file);
+}
@@ -0,0 +1,100 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTimelineInformation.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPVTimelineInformation
+ * @brief   gathers the vtkPVTimeline events from all processes.
+ *
+ * vtkPVTimelineInformation collects the events recorded by vtkPVTimeline on
+ * each process it is gathered from and merges them into a single Chrome trace.
+ * Each process shows up as a separate track, labelled with its type and rank.
+ * The object passed to CopyFromObject() is ignored.
+ */
+
+#ifndef vtkPVTimelineInformation_h
+#define vtkPVTimelineInformation_h
+
+#include "vtkPVInformation.h"
+#include "vtkRemotingCoreModule.h" // needed for exports
+
+#include <string> // for std::string
+
+class VTKREMOTINGCORE_EXPORT vtkPVTimelineInformation : public vtkPVInformation
+{
+public:
+  static vtkPVTimelineInformation* New();
+  vtkTypeMacro(vtkPVTimelineInformation, vtkPVInformation);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * When set, events are cleared on each process once gathered. This must be
+   * set before calling GatherInformation(). Default is false.
+   */
+  vtkSetMacro(ClearEvents, bool);
+  vtkGetMacro(ClearEvents, bool);
+  vtkBooleanMacro(ClearEvents, bool);
+  //@}
+
+  /**
+   * Transfer information about a single object into this object.
+   */
+  void CopyFromObject(vtkObject*) override;
+
+  /**
+   * Merge another information object.
+   */
+  void AddInformation(vtkPVInformation*) override;
+
+  //@{
+  /**
+   * Manage a serialized version of the information.
+   */
+  void CopyToStream(vtkClientServerStream*) override;
+  void CopyFromStream(const vtkClientServerStream*) override;
+  //@}
+
+  //@{
+  /**
+   * Serialize/Deserialize the parameters that control how/what information is
+   * gathered.
+   */
+  void CopyParametersToStream(vtkMultiProcessStream&) override;
+  void CopyParametersFromStream(vtkMultiProcessStream&) override;
+  //@}
+
+  /**
+   * Returns the gathered events as a Chrome trace JSON document.
+   */
+  std::string GetChromeTrace();
+
+  /**
+   * Write the gathered events as a Chrome trace JSON document. Returns false if
+   * the file could not be written.
+   */
+  bool WriteChromeTrace(const char* filename);
+
+protected:
+  vtkPVTimelineInformation();
+  ~vtkPVTimelineInformation() override;
+
+  bool ClearEvents;
+  std::string TraceEvents;
+
+private:
+  vtkPVTimelineInformation(const vtkPVTimelineInformation&) = delete;
+  void operator=(const vtkPVTimelineInformation&) = delete;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestProxyDefinitionCache.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkNew.h"
+#include "vtkPVXMLElement.h"
+#include "vtkPVXMLParser.h"
+#include "vtkSIProxyDefinitionCache.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/FStream.hxx>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+const char* testdefinition =
+  "<ServerManagerConfiguration>"
+  "   <ProxyGroup name=\"sources\">"
+  "     <SourceProxy name=\"CachedSphere\" class=\"vtkSphereSource\">"
+  "       <DoubleVectorProperty name=\"Radius\" command=\"SetRadius\" "
+  "number_of_elements=\"1\" default_values=\"0.5\" />"
+  "       <Documentation>Sphere &amp; co.</Documentation>"
+  "     </SourceProxy>"
+  "   </ProxyGroup>"
+  "</ServerManagerConfiguration>";
+}
+
+int TestProxyDefinitionCache(int argc, char* argv[])
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+  {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+  }
+  std::string path = tempDir;
+  path += "/TestProxyDefinitionCache";
+  delete[] tempDir;
+
+  vtkNew<vtkPVXMLParser> parser;
+  if (!parser->Parse(testdefinition))
+  {
+    cerr << "Failed to parse test definition." << endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::string> xmls(1, testdefinition);
+  const std::string key = vtkSIProxyDefinitionCache::ComputeKey("TestPlugin", xmls);
+  if (key == vtkSIProxyDefinitionCache::ComputeKey("OtherPlugin", xmls))
+  {
+    cerr << "Key does not depend on the plugin name." << endl;
+    return EXIT_FAILURE;
+  }
+  xmls.push_back("<ServerManagerConfiguration/>");
+  if (key == vtkSIProxyDefinitionCache::ComputeKey("TestPlugin", xmls))
+  {
+    cerr << "Key does not depend on the XML contents." << endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkSIProxyDefinitionCache> cache;
+  cache->SetDirectory(path.c_str());
+
+  std::vector<vtkSmartPointer<vtkPVXMLElement> > roots;
+  roots.push_back(parser->GetRootElement());
+  if (!cache->Store(key, roots))
+  {
+    cerr << "Failed to store cache entry." << endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<vtkSmartPointer<vtkPVXMLElement> > loaded;
+  if (!cache->Load(key, loaded) || loaded.size() != 1 || !loaded[0]->Equals(roots[0]))
+  {
+    cerr << "Cached definition does not match the parsed one." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // A truncated entry must be rejected.
+  const std::string fname = path + "/" + key + ".pvsmc";
+  {
+    vtksys::ofstream file(fname.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    file << "PVSMXMLC";
+  }
+  if (cache->Load(key, loaded) || !loaded.empty())
+  {
+    cerr << "Invalid cache entry was not rejected." << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
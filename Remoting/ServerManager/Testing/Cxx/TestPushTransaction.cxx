@@ -0,0 +1,101 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestPushTransaction.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkInitializationHelper.h"
+#include "vtkNew.h"
+#include "vtkProcessModule.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSMSourceProxy.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <vector>
+
+int TestPushTransaction(int argc, char* argv[])
+{
+  (void)argc;
+
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  // Create a new session.
+  vtkNew<vtkSMSession> session;
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+
+  std::vector<vtkSmartPointer<vtkSMSourceProxy> > spheres;
+  for (int cc = 0; cc < 10; ++cc)
+  {
+    vtkSmartPointer<vtkSMSourceProxy> sphere;
+    sphere.TakeReference(vtkSMSourceProxy::SafeDownCast(pxm->NewProxy("sources", "SphereSource")));
+    sphere->UpdateVTKObjects();
+    spheres.push_back(sphere);
+  }
+
+  int exitCode = EXIT_SUCCESS;
+  try
+  {
+    session->BeginPushTransaction();
+    session->BeginPushTransaction();
+    for (size_t cc = 0; cc < spheres.size(); ++cc)
+    {
+      vtkSMPropertyHelper(spheres[cc], "Radius").Set(static_cast<double>(cc + 1));
+      spheres[cc]->UpdateVTKObjects();
+    }
+    session->CommitPushTransaction();
+
+    // Still inside the outer transaction: nothing should have been pushed yet.
+    if (!session->IsInPushTransaction())
+    {
+      throw "ERROR: Nested transaction closed the outer one!!!";
+    }
+    for (size_t cc = 0; cc < spheres.size(); ++cc)
+    {
+      if (vtkSphereSource::SafeDownCast(spheres[cc]->GetClientSideObject())->GetRadius() != 0.5)
+      {
+        throw "ERROR: State pushed before the transaction was committed!!!";
+      }
+    }
+
+    session->CommitPushTransaction();
+    for (size_t cc = 0; cc < spheres.size(); ++cc)
+    {
+      if (vtkSphereSource::SafeDownCast(spheres[cc]->GetClientSideObject())->GetRadius() !=
+        static_cast<double>(cc + 1))
+      {
+        throw "ERROR: State not pushed on commit!!!";
+      }
+    }
+
+    // Requests that need the server to be in sync must flush the queue.
+    session->BeginPushTransaction();
+    vtkSMPropertyHelper(spheres[0], "Radius").Set(42);
+    spheres[0]->UpdateVTKObjects();
+    spheres[0]->UpdatePipeline();
+    if (vtkSphereSource::SafeDownCast(spheres[0]->GetClientSideObject())->GetRadius() != 42)
+    {
+      throw "ERROR: Pending state not flushed before executing the pipeline!!!";
+    }
+    session->CommitPushTransaction();
+  }
+  catch (const char* msg)
+  {
+    cerr << msg << endl;
+    exitCode = EXIT_FAILURE;
+  }
+  spheres.clear();
+  vtkInitializationHelper::Finalize();
+  return exitCode;
+}
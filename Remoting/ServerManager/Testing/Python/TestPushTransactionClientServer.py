@@ -0,0 +1,51 @@
+# Checks that push transactions send every state to the server exactly once
+# in client-server sessions, batched or not depending on the collaboration
+# mode.
+from paraview import servermanager
+import paraview.simple as smp
+
+# Make sure the test driver know that process has properly started
+print ("Process started")
+
+
+def getHost(url):
+   return url.split(':')[1][2:]
+
+
+def getPort(url):
+   return int(url.split(':')[2])
+
+
+options = servermanager.vtkProcessModule.GetProcessModule().GetOptions()
+url = options.GetServerURL()
+smp.Connect(getHost(url), getPort(url))
+
+session = servermanager.ActiveConnection.Session
+collaboration = session.IsMultiClients()
+
+spheres = [smp.Sphere() for i in range(5)]
+
+session.BeginPushTransaction()
+for i, sphere in enumerate(spheres):
+    sphere.ThetaResolution = 8 + i
+    sphere.UpdateVTKObjects()
+
+if collaboration:
+    # Each state must be shared with the other clients as it is pushed.
+    assert session.GetNumberOfPendingPushStates() == 0, \
+        "States must not be queued in collaboration mode"
+else:
+    assert session.GetNumberOfPendingPushStates() > 0, \
+        "States must be queued while a transaction is open"
+
+session.CommitPushTransaction()
+assert session.GetNumberOfPendingPushStates() == 0, "Commit must flush the queue"
+
+for i, sphere in enumerate(spheres):
+    sphere.UpdatePipeline()
+    npts = sphere.GetDataInformation().GetNumberOfPoints()
+    expected = (8 + i) * (8 - 2) + 2
+    assert npts == expected, \
+        "Sphere %d has %d points, expected %d" % (i, npts, expected)
+
+smp.Disconnect()
@@ -142,6 +142,18 @@ void vtkPVSessionBase::PushState(vtkSMMessage* msg)
   this->DeActivate();
 }
 
+//----------------------------------------------------------------------------
+void vtkPVSessionBase::PushStateCollection(vtkSMMessageCollection* collection)
+{
+  this->Activate();
+
+  // This class does not handle remote sessions, so all messages are directly
+  // processes locally.
+  this->SessionCore->PushStateCollection(collection);
+
+  this->DeActivate();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSessionBase::PullState(vtkSMMessage* msg)
 {
@@ -88,6 +88,12 @@ public:
    */
   virtual void PushState(vtkSMMessage* msg);
 
+  /**
+   * Push a collection of state messages. The messages are processed in order
+   * as a single request.
+   */
+  virtual void PushStateCollection(vtkSMMessageCollection* collection);
+
   /**
    * Pull the state message.
    */
@@ -27,8 +27,10 @@
 #include "vtkObjectFactory.h"
 #include "vtkPVInformation.h"
 #include "vtkPVOptions.h"
+#include "vtkPVPluginTracker.h"
 #include "vtkPVSession.h"
 #include "vtkPVSessionCoreInterpreterHelper.h"
+#include "vtkPVTimeline.h"
 #include "vtkProcessModule.h"
 #include "vtkReservedRemoteObjectIds.h"
 #include "vtkSIProxy.h"
@@ -62,6 +64,10 @@ void RMICallback(
       sessioncore->PushStateSatelliteCallback();
       break;
 
+    case vtkPVSessionCore::PUSH_STATE_COLLECTION:
+      sessioncore->PushStateCollectionSatelliteCallback();
+      break;
+
     case vtkPVSessionCore::GATHER_INFORMATION:
       sessioncore->GatherInformationStatelliteCallback();
       break;
@@ -431,6 +437,14 @@ void vtkPVSessionCore::PushStateInternal(vtkSMMessage* message)
       return;
       // abort();
     }
+    // The SI class may be provided by a plugin that hasn't been loaded yet.
+    if (message->HasExtension(ProxyState::xml_group))
+    {
+      vtkPVPluginTracker::GetInstance()->LoadDeferredPluginForProxy(
+        message->GetExtension(ProxyState::xml_group).c_str(),
+        message->GetExtension(ProxyState::xml_name).c_str());
+    }
+
     // Create the corresponding SI object.
     std::string classname = message->GetExtension(DefinitionHeader::server_class);
     vtkObjectBase* object;
@@ -526,6 +540,85 @@ void vtkPVSessionCore::PushStateSatelliteCallback()
   delete[] raw_data;
 }
 
+//----------------------------------------------------------------------------
+void vtkPVSessionCore::PushStateCollection(vtkSMMessageCollection* collection)
+{
+  // This can only be called on the root node.
+  assert(this->ParallelController == NULL || this->ParallelController->GetLocalProcessId() == 0 ||
+    this->SymmetricMPIMode);
+
+  const int nbItems = collection->item_size();
+  if (nbItems == 0)
+  {
+    return;
+  }
+
+  LOG(<< "----------------------------------------------------------------\n"
+      << "Push State Collection ( " << nbItems << " messages, " << collection->ByteSizeLong()
+      << " bytes )\n"
+      << "----------------------------------------------------------------\n");
+
+  bool forwardToSatellites = false;
+  if (!this->SymmetricMPIMode && this->ParallelController &&
+    this->ParallelController->GetNumberOfProcesses() > 1 &&
+    this->ParallelController->GetLocalProcessId() == 0)
+  {
+    for (int cc = 0; cc < nbItems && !forwardToSatellites; ++cc)
+    {
+      forwardToSatellites = (collection->item(cc).location() & vtkProcessModule::SERVERS) != 0;
+    }
+  }
+
+  if (forwardToSatellites)
+  {
+    // Same logic as PushState(), but the satellites receive the whole
+    // collection at once and filter out the messages that are not meant for
+    // them.
+    unsigned char type = PUSH_STATE_COLLECTION;
+    this->ParallelController->TriggerRMIOnAllChildren(&type, 1, ROOT_SATELLITE_RMI_TAG);
+
+    vtkIdType byte_size = static_cast<vtkIdType>(collection->ByteSizeLong());
+    unsigned char* raw_data = new unsigned char[byte_size + 1];
+    collection->SerializeToArray(raw_data, byte_size);
+    this->ParallelController->Broadcast(&byte_size, 1, 0);
+    this->ParallelController->Broadcast(raw_data, byte_size, 0);
+    delete[] raw_data;
+  }
+
+  for (int cc = 0; cc < nbItems; ++cc)
+  {
+    this->PushStateInternal(collection->mutable_item(cc));
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSessionCore::PushStateCollectionSatelliteCallback()
+{
+  vtkIdType byte_size = 0;
+  this->ParallelController->Broadcast(&byte_size, 1, 0);
+
+  unsigned char* raw_data = new unsigned char[byte_size + 1];
+  this->ParallelController->Broadcast(raw_data, byte_size, 0);
+
+  vtkSMMessageCollection collection;
+  if (!collection.ParseFromArray(raw_data, byte_size))
+  {
+    vtkErrorMacro("Failed to parse protobuf message collection.");
+  }
+  else
+  {
+    for (int cc = 0, max = collection.item_size(); cc < max; ++cc)
+    {
+      vtkSMMessage* message = collection.mutable_item(cc);
+      if ((message->location() & vtkProcessModule::SERVERS) != 0)
+      {
+        this->PushStateInternal(message);
+      }
+    }
+  }
+  delete[] raw_data;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSessionCore::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -900,6 +993,8 @@ bool vtkPVSessionCore::CollectInformation(vtkPVInformation* info)
   // Sanity checks
   assert("pre: NULL PV information!" && (info != NULL));
 
+  PARAVIEW_TIMELINE_SCOPE("mpi", "CollectInformation");
+
   // STEP 0: temporary variables
   int rank = this->ParallelController->GetLocalProcessId();
   int nranks = this->ParallelController->GetNumberOfProcesses();
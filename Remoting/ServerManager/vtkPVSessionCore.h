@@ -66,6 +66,13 @@ public:
    */
   virtual void PushState(vtkSMMessage* message);
 
+  /**
+   * Push a collection of state messages. The items are processed in order,
+   * exactly as if PushState() had been called on each one of them, but the
+   * whole collection is forwarded to the MPI satellites in a single broadcast.
+   */
+  virtual void PushStateCollection(vtkSMMessageCollection* collection);
+
   /**
    * Pull the state message from the local SI object instances.
    */
@@ -167,9 +174,11 @@ public:
     GATHER_INFORMATION = 15,
     REGISTER_SI = 16,
     UNREGISTER_SI = 17,
+    PUSH_STATE_COLLECTION = 18,
   };
   // Methods used to managed MPI satellite
   void PushStateSatelliteCallback();
+  void PushStateCollectionSatelliteCallback();
   void ExecuteStreamSatelliteCallback();
   void GatherInformationStatelliteCallback();
   void RegisterSIObjectSatelliteCallback();
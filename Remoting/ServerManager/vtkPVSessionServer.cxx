@@ -556,6 +556,33 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
     }
     break;
 
+    case vtkPVSessionServer::PUSH_COLLECTION:
+    {
+      std::string string;
+      stream >> string;
+      vtkSMMessageCollection collection;
+      collection.ParseFromString(string);
+
+      // Process all the messages at once, skipping the share-only ones just
+      // like PUSH does.
+      vtkSMMessageCollection toProcess;
+      for (int cc = 0, max = collection.item_size(); cc < max; ++cc)
+      {
+        vtkSMMessage* msg = collection.mutable_item(cc);
+        if (!this->Internal->StoreShareOnly(msg))
+        {
+          toProcess.add_item()->CopyFrom(*msg);
+        }
+      }
+      this->PushStateCollection(&toProcess);
+
+      for (int cc = 0, max = collection.item_size(); cc < max; ++cc)
+      {
+        this->NotifyOtherClients(collection.mutable_item(cc));
+      }
+    }
+    break;
+
     case vtkPVSessionServer::PULL:
     {
       std::string string;
@@ -22,6 +22,7 @@
 #include "vtkLogger.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVPluginTracker.h"
 #include "vtkPVSessionCore.h"
 #include "vtkPVXMLElement.h"
 #include "vtkPVXMLParser.h"
@@ -310,6 +311,10 @@ bool vtkSIProxy::InitializeAndCreateVTKObjects(vtkSMMessage* message)
       ? message->GetExtension(ProxyState::xml_sub_proxy_name).c_str()
       : NULL);
 
+  // Ensure the plugin providing the proxy is loaded, if it was deferred.
+  vtkPVPluginTracker::GetInstance()->LoadDeferredPluginForProxy(
+    this->GetXMLGroup(), this->GetXMLName());
+
   vtkSIProxyDefinitionManager* pdm = this->GetProxyDefinitionManager();
   vtkPVXMLElement* element = pdm->GetCollapsedProxyDefinition(
     message->GetExtension(ProxyState::xml_group).c_str(),
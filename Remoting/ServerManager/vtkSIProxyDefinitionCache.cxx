@@ -0,0 +1,296 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkSIProxyDefinitionCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSIProxyDefinitionCache.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkPVConfig.h"
+#include "vtkPVXMLElement.h"
+
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemTools.hxx>
+
+#include <cstring>
+#include <sstream>
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#include <process.h>
+#define vtkSIProxyDefinitionCacheGetPid _getpid
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define vtkSIProxyDefinitionCacheGetPid getpid
+#define VTK_SI_PROXY_DEFINITION_CACHE_USE_MMAP
+#endif
+
+namespace
+{
+// Bump this whenever the layout of the file or of
+// vtkPVXMLElement::WriteBinary() changes.
+const vtkTypeUInt32 FORMAT_VERSION = 1;
+const vtkTypeUInt32 BYTE_ORDER_MARK = 0x01020304;
+const char MAGIC[8] = { 'P', 'V', 'S', 'M', 'X', 'M', 'L', 'C' };
+
+struct FileHeader
+{
+  char Magic[8];
+  vtkTypeUInt32 FormatVersion;
+  vtkTypeUInt32 ByteOrderMark;
+  vtkTypeUInt32 NumberOfRoots;
+  vtkTypeUInt32 KeyLength;
+  vtkTypeUInt64 PayloadSize;
+  vtkTypeUInt64 PayloadChecksum;
+};
+
+//----------------------------------------------------------------------------
+// Read-only view of a whole file. Uses mmap when available so that processes
+// on the same node share the pages of the cache.
+class MappedFile
+{
+public:
+  MappedFile()
+    : Data(NULL)
+    , Size(0)
+#ifdef VTK_SI_PROXY_DEFINITION_CACHE_USE_MMAP
+    , Mapping(NULL)
+#endif
+  {
+  }
+
+  ~MappedFile()
+  {
+#ifdef VTK_SI_PROXY_DEFINITION_CACHE_USE_MMAP
+    if (this->Mapping)
+    {
+      munmap(this->Mapping, this->Size);
+    }
+#endif
+  }
+
+  bool Open(const std::string& fname)
+  {
+#ifdef VTK_SI_PROXY_DEFINITION_CACHE_USE_MMAP
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+      close(fd);
+      return false;
+    }
+    void* mapping = mmap(NULL, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+      return false;
+    }
+    this->Mapping = mapping;
+    this->Size = static_cast<size_t>(info.st_size);
+    this->Data = static_cast<const char*>(mapping);
+    return true;
+#else
+    vtksys::ifstream file(fname.c_str(), std::ios::in | std::ios::binary);
+    if (!file)
+    {
+      return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    this->Buffer = contents.str();
+    this->Data = this->Buffer.data();
+    this->Size = this->Buffer.size();
+    return this->Size > 0;
+#endif
+  }
+
+  const char* Data;
+  size_t Size;
+
+private:
+#ifdef VTK_SI_PROXY_DEFINITION_CACHE_USE_MMAP
+  void* Mapping;
+#else
+  std::string Buffer;
+#endif
+};
+}
+
+vtkStandardNewMacro(vtkSIProxyDefinitionCache);
+//----------------------------------------------------------------------------
+vtkSIProxyDefinitionCache::vtkSIProxyDefinitionCache()
+{
+  this->Directory = NULL;
+  this->SetDirectory(vtksys::SystemTools::GetEnv("PV_PROXY_DEFINITION_CACHE_DIR"));
+}
+
+//----------------------------------------------------------------------------
+vtkSIProxyDefinitionCache::~vtkSIProxyDefinitionCache()
+{
+  this->SetDirectory(NULL);
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSIProxyDefinitionCache::ComputeKey(
+  const char* pluginName, const std::vector<std::string>& xmls)
+{
+  vtkTypeUInt64 hash = vtkPVXMLElement::HashSeed();
+  const std::string version = PARAVIEW_VERSION_FULL;
+  hash = vtkPVXMLElement::Hash(hash, version.c_str(), version.size() + 1);
+  hash = vtkPVXMLElement::Hash(
+    hash, pluginName ? pluginName : "", pluginName ? strlen(pluginName) + 1 : 1);
+  for (size_t cc = 0; cc < xmls.size(); ++cc)
+  {
+    // hash the length too so that concatenations of different splits of the
+    // same text do not collide.
+    vtkTypeUInt64 length = static_cast<vtkTypeUInt64>(xmls[cc].size());
+    hash = vtkPVXMLElement::Hash(hash, reinterpret_cast<const char*>(&length), sizeof(length));
+    hash = vtkPVXMLElement::Hash(hash, xmls[cc].c_str(), xmls[cc].size());
+  }
+
+  std::ostringstream key;
+  key << std::hex;
+  key.width(16);
+  key.fill('0');
+  key << hash;
+  return key.str();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSIProxyDefinitionCache::GetFileName(const std::string& key) const
+{
+  return std::string(this->Directory) + "/" + key + ".pvsmc";
+}
+
+//----------------------------------------------------------------------------
+bool vtkSIProxyDefinitionCache::Load(
+  const std::string& key, std::vector<vtkSmartPointer<vtkPVXMLElement> >& roots)
+{
+  roots.clear();
+  if (!this->IsEnabled())
+  {
+    return false;
+  }
+
+  MappedFile file;
+  if (!file.Open(this->GetFileName(key)) || file.Size < sizeof(FileHeader))
+  {
+    return false;
+  }
+
+  FileHeader header;
+  memcpy(&header, file.Data, sizeof(header));
+  const char* data = file.Data + sizeof(header);
+  const char* end = file.Data + file.Size;
+  if (memcmp(header.Magic, MAGIC, sizeof(MAGIC)) != 0 || header.FormatVersion != FORMAT_VERSION ||
+    header.ByteOrderMark != BYTE_ORDER_MARK || header.KeyLength != key.size() ||
+    static_cast<vtkTypeUInt64>(end - data) != header.KeyLength + header.PayloadSize ||
+    key.compare(0, key.size(), data, header.KeyLength) != 0)
+  {
+    vtkDebugMacro("Ignoring invalid cache entry " << key);
+    return false;
+  }
+  data += header.KeyLength;
+
+  if (vtkPVXMLElement::Hash(vtkPVXMLElement::HashSeed(), data,
+        static_cast<size_t>(header.PayloadSize)) != header.PayloadChecksum)
+  {
+    vtkDebugMacro("Ignoring corrupted cache entry " << key);
+    return false;
+  }
+
+  for (vtkTypeUInt32 cc = 0; cc < header.NumberOfRoots; ++cc)
+  {
+    vtkPVXMLElement* root = vtkPVXMLElement::ReadBinary(data, end);
+    if (!root)
+    {
+      roots.clear();
+      return false;
+    }
+    roots.push_back(root);
+    root->Delete();
+  }
+  return data == end;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSIProxyDefinitionCache::Store(
+  const std::string& key, const std::vector<vtkSmartPointer<vtkPVXMLElement> >& roots)
+{
+  if (!this->IsEnabled())
+  {
+    return false;
+  }
+
+  if (!vtksys::SystemTools::FileIsDirectory(this->Directory) &&
+    !vtksys::SystemTools::MakeDirectory(this->Directory))
+  {
+    vtkWarningMacro("Failed to create proxy definition cache directory: " << this->Directory);
+    return false;
+  }
+
+  std::string payload;
+  for (size_t cc = 0; cc < roots.size(); ++cc)
+  {
+    roots[cc]->WriteBinary(payload);
+  }
+
+  FileHeader header;
+  memcpy(header.Magic, MAGIC, sizeof(MAGIC));
+  header.FormatVersion = FORMAT_VERSION;
+  header.ByteOrderMark = BYTE_ORDER_MARK;
+  header.NumberOfRoots = static_cast<vtkTypeUInt32>(roots.size());
+  header.KeyLength = static_cast<vtkTypeUInt32>(key.size());
+  header.PayloadSize = static_cast<vtkTypeUInt64>(payload.size());
+  header.PayloadChecksum =
+    vtkPVXMLElement::Hash(vtkPVXMLElement::HashSeed(), payload.data(), payload.size());
+
+  const std::string fname = this->GetFileName(key);
+  std::ostringstream tmpname;
+  tmpname << fname << "." << vtkSIProxyDefinitionCacheGetPid() << ".tmp";
+  {
+    vtksys::ofstream file(tmpname.str().c_str(), std::ios::out | std::ios::binary);
+    if (!file)
+    {
+      return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(key.c_str(), key.size());
+    file.write(payload.data(), payload.size());
+    if (!file)
+    {
+      file.close();
+      vtksys::SystemTools::RemoveFile(tmpname.str());
+      return false;
+    }
+  }
+
+  if (!vtksys::SystemTools::RenameFile(tmpname.str().c_str(), fname.c_str()))
+  {
+    vtksys::SystemTools::RemoveFile(tmpname.str());
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkSIProxyDefinitionCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Directory: " << (this->Directory ? this->Directory : "(none)") << endl;
+}
@@ -0,0 +1,103 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkSIProxyDefinitionCache.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkSIProxyDefinitionCache
+ * @brief   on-disk binary cache for server-manager XML definitions
+ *
+ * vtkSIProxyDefinitionCache is used by vtkSIProxyDefinitionManager to avoid
+ * parsing the same server-manager configuration XMLs on every process at
+ * startup. The parsed XML trees of a plugin are saved in a versioned binary
+ * file named after a hash of the plugin name, the ParaView version and the XML
+ * contents. Changing any of those produces a new key, hence stale entries are
+ * never used. Cache files are memory mapped when the platform supports it, so
+ * that all the processes running on a node share the same pages.
+ *
+ * The cache is disabled unless a directory is provided, either with
+ * SetDirectory() or through the `PV_PROXY_DEFINITION_CACHE_DIR` environment
+ * variable.
+*/
+
+#ifndef vtkSIProxyDefinitionCache_h
+#define vtkSIProxyDefinitionCache_h
+
+#include "vtkObject.h"
+#include "vtkRemotingServerManagerModule.h" //needed for exports
+
+#ifndef __WRAP__
+#include "vtkSmartPointer.h" // needed for vtkSmartPointer
+#include <string>            // needed for std::string
+#include <vector>            // needed for std::vector
+#endif
+
+class vtkPVXMLElement;
+
+class VTKREMOTINGSERVERMANAGER_EXPORT vtkSIProxyDefinitionCache : public vtkObject
+{
+public:
+  static vtkSIProxyDefinitionCache* New();
+  vtkTypeMacro(vtkSIProxyDefinitionCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Get/Set the directory in which the cache files are read and written.
+   * Initialized from the `PV_PROXY_DEFINITION_CACHE_DIR` environment variable.
+   * When empty or NULL, the cache is disabled.
+   */
+  vtkSetStringMacro(Directory);
+  vtkGetStringMacro(Directory);
+  //@}
+
+  /**
+   * Returns true if a cache directory has been set.
+   */
+  bool IsEnabled() const { return this->Directory != NULL && this->Directory[0] != '\0'; }
+
+#ifndef __WRAP__
+  /**
+   * Compute the key identifying the definitions provided by a plugin.
+   */
+  static std::string ComputeKey(const char* pluginName, const std::vector<std::string>& xmls);
+
+  /**
+   * Load the XML trees saved under \c key. Returns false if there is no such
+   * entry or if it is invalid, in which case \c roots is left empty.
+   */
+  bool Load(const std::string& key, std::vector<vtkSmartPointer<vtkPVXMLElement> >& roots);
+
+  /**
+   * Save the XML trees under \c key. The file is written under a temporary
+   * name and then renamed so that concurrent readers never see a partially
+   * written entry.
+   */
+  bool Store(const std::string& key, const std::vector<vtkSmartPointer<vtkPVXMLElement> >& roots);
+#endif
+
+protected:
+  vtkSIProxyDefinitionCache();
+  ~vtkSIProxyDefinitionCache() override;
+
+#ifndef __WRAP__
+  std::string GetFileName(const std::string& key) const;
+#endif
+
+  char* Directory;
+
+private:
+  vtkSIProxyDefinitionCache(const vtkSIProxyDefinitionCache&) = delete;
+  void operator=(const vtkSIProxyDefinitionCache&) = delete;
+};
+
+#endif
@@ -29,6 +29,7 @@
 #include "vtkPVXMLParser.h"
 #include "vtkProcessModule.h"
 #include "vtkReservedRemoteObjectIds.h"
+#include "vtkSIProxyDefinitionCache.h"
 #include "vtkSMMessage.h"
 #include "vtkSmartPointer.h"
 #include "vtkStringList.h"
@@ -59,6 +60,9 @@ public:
   StrToStrToXmlMap CoreDefinitions;
   // Keep track of custom definition
   StrToStrToXmlMap CustomsDefinitions;
+  // Deferred plugins whose definitions have already been loaded from their
+  // manifest.
+  std::set<std::string> DeferredPlugins;
   //-------------------------------------------------------------------------
   vtkInternals()
     : EnableXMLProxyDefinitionUpdate(true)
@@ -191,6 +195,52 @@ public:
     }
   }
 };
+//****************************************************************************/
+namespace
+{
+// Parse the server-manager XMLs provided by a plugin, using the on-disk cache
+// when one is available. Entries that fail to parse are skipped.
+void ParseConfigurationXMLs(const char* pluginName, const std::vector<std::string>& xmls,
+  std::vector<vtkSmartPointer<vtkPVXMLElement> >& roots)
+{
+  vtkNew<vtkSIProxyDefinitionCache> cache;
+  std::string key;
+  if (cache->IsEnabled() && !xmls.empty())
+  {
+    key = vtkSIProxyDefinitionCache::ComputeKey(pluginName, xmls);
+    if (cache->Load(key, roots) && roots.size() == xmls.size())
+    {
+      return;
+    }
+    roots.clear();
+  }
+
+  vtkTimerLog::MarkStartEvent("vtkSIProxyDefinitionManager Parse XMLs");
+  bool success = true;
+  for (size_t cc = 0; cc < xmls.size(); cc++)
+  {
+    vtkNew<vtkPVXMLParser> parser;
+    if (parser->Parse(xmls[cc].c_str()) && parser->GetRootElement())
+    {
+      roots.push_back(parser->GetRootElement());
+    }
+    else
+    {
+      success = false;
+    }
+  }
+  vtkTimerLog::MarkEndEvent("vtkSIProxyDefinitionManager Parse XMLs");
+
+  // Only one process per job populates the cache, the others will pick the
+  // entry up on the next run.
+  vtkProcessModule* pm = vtkProcessModule::GetProcessModule();
+  if (success && !key.empty() && (pm == NULL || pm->GetPartitionId() == 0))
+  {
+    cache->Store(key, roots);
+  }
+}
+}
+
 //****************************************************************************/
 class vtkInternalDefinitionIterator : public vtkPVProxyDefinitionIterator
 {
@@ -446,7 +496,14 @@ vtkStandardNewMacro(vtkSIProxyDefinitionManager) vtkStandardNewMacro(vtkInternal
       continue;
     }
 
-    this->HandlePlugin(plugin);
+    if (plugin)
+    {
+      this->HandlePlugin(plugin);
+    }
+    else if (tracker->GetPluginDeferred(cc))
+    {
+      this->HandlePluginManifest(tracker->GetPluginManifest(cc));
+    }
   }
 
   // Register with the plugin tracker, so that when new plugins are loaded,
@@ -454,6 +511,8 @@ vtkStandardNewMacro(vtkSIProxyDefinitionManager) vtkStandardNewMacro(vtkInternal
   // definitions.
   tracker->AddObserver(
     vtkCommand::RegisterEvent, this, &vtkSIProxyDefinitionManager::OnPluginLoaded);
+  tracker->AddObserver(vtkPVPluginTracker::RegisterDeferredPluginEvent, this,
+    &vtkSIProxyDefinitionManager::OnDeferredPluginRegistered);
 }
 
 //---------------------------------------------------------------------------
@@ -1183,6 +1242,12 @@ void vtkSIProxyDefinitionManager::HandlePlugin(vtkPVPlugin* plugin)
 {
   vtkPVServerManagerPluginInterface* smplugin =
     dynamic_cast<vtkPVServerManagerPluginInterface*>(plugin);
+  if (smplugin && plugin->GetPluginName() &&
+    this->Internals->DeferredPlugins.erase(plugin->GetPluginName()) > 0)
+  {
+    // definitions were already loaded from the plugin manifest.
+    return;
+  }
   if (smplugin)
   {
     std::vector<std::string> xmls;
@@ -1191,12 +1256,15 @@ void vtkSIProxyDefinitionManager::HandlePlugin(vtkPVPlugin* plugin)
     // Make sure only the SERVER is processing the XML proxy definition
     if (this->Internals->EnableXMLProxyDefinitionUpdate)
     {
-      for (size_t cc = 0; cc < xmls.size(); cc++)
+      // if GetPluginName() == vtkPVInitializerPlugin, it implies that it's
+      // the ParaView core and should not be treated as plugin.
+      const bool attachHints = strcmp(plugin->GetPluginName(), "vtkPVInitializerPlugin") != 0;
+
+      std::vector<vtkSmartPointer<vtkPVXMLElement> > roots;
+      ParseConfigurationXMLs(plugin->GetPluginName(), xmls, roots);
+      for (size_t cc = 0; cc < roots.size(); cc++)
       {
-        this->LoadConfigurationXMLFromString(xmls[cc].c_str(),
-          // if GetPluginName() == vtkPVInitializerPlugin, it implies that it's
-          // the ParaView core and should not be treated as plugin.
-          strcmp(plugin->GetPluginName(), "vtkPVInitializerPlugin") != 0);
+        this->LoadConfigurationXML(roots[cc], attachHints);
       }
 
       // Make sure we invalidate any cached flatten version of our proxy definition
@@ -1204,6 +1272,43 @@ void vtkSIProxyDefinitionManager::HandlePlugin(vtkPVPlugin* plugin)
     }
   }
 }
+
+//---------------------------------------------------------------------------
+void vtkSIProxyDefinitionManager::OnDeferredPluginRegistered(
+  vtkObject*, unsigned long, void* calldata)
+{
+  this->HandlePluginManifest(reinterpret_cast<vtkPVXMLElement*>(calldata));
+}
+
+//---------------------------------------------------------------------------
+void vtkSIProxyDefinitionManager::HandlePluginManifest(vtkPVXMLElement* manifest)
+{
+  if (!manifest || !this->Internals->EnableXMLProxyDefinitionUpdate)
+  {
+    return;
+  }
+
+  bool loaded = false;
+  for (unsigned int cc = 0; cc < manifest->GetNumberOfNestedElements(); ++cc)
+  {
+    vtkPVXMLElement* child = manifest->GetNestedElement(cc);
+    if (strcmp(child->GetName(), "ServerManagerConfiguration") == 0)
+    {
+      this->LoadConfigurationXML(child, /*attachHints=*/true);
+      loaded = true;
+    }
+  }
+
+  // When the manifest doesn't describe the definitions, they will be loaded
+  // along with the plugin.
+  const char* name = manifest->GetAttribute("name");
+  if (loaded && name)
+  {
+    this->Internals->DeferredPlugins.insert(name);
+    this->InternalsFlatten->Clear();
+  }
+}
+
 //---------------------------------------------------------------------------
 bool vtkSIProxyDefinitionManager::HasDefinition(const char* groupName, const char* proxyName)
 {
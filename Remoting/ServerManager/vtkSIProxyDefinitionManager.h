@@ -278,6 +278,15 @@ protected:
   void HandlePlugin(vtkPVPlugin*);
   //@}
 
+  //@{
+  /**
+   * Callback called when a plugin is registered as deferred, i.e. when its
+   * manifest is available but the plugin itself hasn't been loaded yet.
+   */
+  void OnDeferredPluginRegistered(vtkObject* caller, unsigned long event, void* calldata);
+  void HandlePluginManifest(vtkPVXMLElement* manifest);
+  //@}
+
   /**
    * Called by the XML parser to add an element from which a proxy
    * can be created. Called during parsing.
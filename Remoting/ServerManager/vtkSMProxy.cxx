@@ -639,6 +639,14 @@ void vtkSMProxy::UpdateVTKObjects()
     return;
   }
 
+  // Send the state of this proxy and of all its sub-proxies as a single
+  // request.
+  vtkSMSession* session = this->GetSession();
+  if (session)
+  {
+    session->BeginPushTransaction();
+  }
+
   if (this->PropertiesModified)
   {
     this->InUpdateVTKObjects = 1;
@@ -723,6 +731,11 @@ void vtkSMProxy::UpdateVTKObjects()
     it2->second.GetPointer()->UpdateVTKObjects();
   }
 
+  if (session)
+  {
+    session->CommitPushTransaction();
+  }
+
   this->MarkModified(this);
   this->InvokeEvent(vtkCommand::UpdateEvent, 0);
 }
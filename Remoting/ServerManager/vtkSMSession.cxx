@@ -72,6 +72,8 @@ vtkSMSession::vtkSMSession(
   this->SessionProxyManager = NULL;
   this->StateLocator = vtkSMStateLocator::New();
   this->IsAutoMPI = false;
+  this->PushTransactionDepth = 0;
+  this->PendingPushStates = NULL;
 
   // Create and setup deserializer for the local ProxyLocator
   vtkNew<vtkSMDeserializerProtobuf> deserializer;
@@ -100,6 +102,9 @@ vtkSMSession::~vtkSMSession()
     vtkSMProxyManager::GetProxyManager()->GetPluginManager()->UnRegisterSession(this);
   }
 
+  delete this->PendingPushStates;
+  this->PendingPushStates = NULL;
+
   this->StateLocator->Delete();
   this->ProxyLocator->Delete();
   if (this->SessionProxyManager)
@@ -128,9 +133,113 @@ void vtkSMSession::PushState(vtkSMMessage* msg)
   // Manage Undo/Redo if possible
   this->UpdateStateHistory(msg);
 
+  if (this->QueuePushState(msg))
+  {
+    return;
+  }
+
   this->Superclass::PushState(msg);
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSession::PullState(vtkSMMessage* msg)
+{
+  this->FlushPendingPushStates();
+  this->Superclass::PullState(msg);
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSession::ExecuteStream(
+  vtkTypeUInt32 location, const vtkClientServerStream& stream, bool ignore_errors)
+{
+  this->FlushPendingPushStates();
+  this->Superclass::ExecuteStream(location, stream, ignore_errors);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSMSession::GatherInformation(
+  vtkTypeUInt32 location, vtkPVInformation* information, vtkTypeUInt32 globalid)
+{
+  this->FlushPendingPushStates();
+  return this->Superclass::GatherInformation(location, information, globalid);
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSession::UnRegisterSIObject(vtkSMMessage* msg)
+{
+  this->FlushPendingPushStates();
+  this->Superclass::UnRegisterSIObject(msg);
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSession::RegisterSIObject(vtkSMMessage* msg)
+{
+  this->FlushPendingPushStates();
+  this->Superclass::RegisterSIObject(msg);
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSession::BeginPushTransaction()
+{
+  this->PushTransactionDepth++;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSession::CommitPushTransaction()
+{
+  if (this->PushTransactionDepth <= 0)
+  {
+    vtkWarningMacro("CommitPushTransaction() called without a matching BeginPushTransaction().");
+    return;
+  }
+
+  this->PushTransactionDepth--;
+  if (this->PushTransactionDepth == 0)
+  {
+    this->FlushPendingPushStates();
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkSMSession::GetNumberOfPendingPushStates() const
+{
+  return this->PendingPushStates ? this->PendingPushStates->item_size() : 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSMSession::QueuePushState(vtkSMMessage* msg)
+{
+  // In collaboration mode, each state has to be shared with the other clients
+  // as it gets pushed, hence we never batch pushes. Deciding it here ensures a
+  // state is either sent right away or queued, never both.
+  if (this->PushTransactionDepth == 0 || this->IsMultiClients())
+  {
+    return false;
+  }
+
+  if (this->PendingPushStates == NULL)
+  {
+    this->PendingPushStates = new vtkSMMessageCollection();
+  }
+  this->PendingPushStates->add_item()->CopyFrom(*msg);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSession::FlushPendingPushStates()
+{
+  if (this->PendingPushStates == NULL || this->PendingPushStates->item_size() == 0)
+  {
+    return;
+  }
+
+  // Swap the queue out first: pushing the states may trigger observers that
+  // push new states of their own.
+  vtkSMMessageCollection collection;
+  collection.Swap(this->PendingPushStates);
+  this->PushStateCollection(&collection);
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSession::UpdateStateHistory(vtkSMMessage* msg)
 {
@@ -121,6 +121,35 @@ public:
   vtkGetObjectMacro(StateLocator, vtkSMStateLocator);
   //@}
 
+  //---------------------------------------------------------------------------
+  // API for batching state pushes.
+  //---------------------------------------------------------------------------
+
+  //@{
+  /**
+   * Begin/commit a push transaction. While a transaction is open, the state
+   * messages pushed through this session (e.g. by vtkSMProxy::UpdateVTKObjects)
+   * are not sent right away but queued. On commit, all the queued messages are
+   * sent as a single compound message which is executed in order on the
+   * server(s) and broadcast once to the MPI satellites.
+   *
+   * Transactions can be nested: the queue is only flushed when the outermost
+   * transaction is committed. Any call that needs the server(s) to be in sync
+   * with the client (PullState, ExecuteStream, GatherInformation etc.) flushes
+   * the queue first, so batching never changes the order in which requests are
+   * processed.
+   */
+  void BeginPushTransaction();
+  void CommitPushTransaction();
+  bool IsInPushTransaction() const { return this->PushTransactionDepth > 0; }
+  //@}
+
+  /**
+   * Returns the number of state messages queued by the current push
+   * transaction and not sent yet. Collaboration sessions never queue states.
+   */
+  int GetNumberOfPendingPushStates() const;
+
   //---------------------------------------------------------------------------
   // Superclass Implementations
   //---------------------------------------------------------------------------
@@ -145,6 +174,20 @@ public:
    */
   void PushState(vtkSMMessage* msg) override;
 
+  //@{
+  /**
+   * Overridden to flush pending state pushes, if any, before forwarding the
+   * request to the superclass.
+   */
+  void PullState(vtkSMMessage* msg) override;
+  void ExecuteStream(vtkTypeUInt32 location, const vtkClientServerStream& stream,
+    bool ignore_errors = false) override;
+  bool GatherInformation(
+    vtkTypeUInt32 location, vtkPVInformation* information, vtkTypeUInt32 globalid) override;
+  void UnRegisterSIObject(vtkSMMessage* msg) override;
+  void RegisterSIObject(vtkSMMessage* msg) override;
+  //@}
+
   /**
    * Sends the message to all clients.
    */
@@ -281,6 +324,18 @@ protected:
    */
   void UpdateStateHistory(vtkSMMessage* msg);
 
+  /**
+   * Queue the message if a push transaction is in progress and the session is
+   * not a collaboration session. Returns true if the message has been queued,
+   * in which case the caller must not push it.
+   */
+  bool QueuePushState(vtkSMMessage* msg);
+
+  /**
+   * Send the queued state messages, if any, using PushStateCollection().
+   */
+  void FlushPendingPushStates();
+
   vtkSMSessionProxyManager* SessionProxyManager;
   vtkSMStateLocator* StateLocator;
   vtkSMProxyLocator* ProxyLocator;
@@ -293,6 +348,9 @@ private:
 
   // AutoMPI helper class
   static vtkSmartPointer<vtkProcessModuleAutoMPI> AutoMPI;
+
+  int PushTransactionDepth;
+  vtkSMMessageCollection* PendingPushStates;
 };
 
 #endif
@@ -499,6 +499,15 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
 
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
+
+  if (this->QueuePushState(message))
+  {
+    // Keep track of the State History for Undo/Redo now, since the full state
+    // of the remote object may change before the queue is flushed.
+    this->UpdateStateHistory(message);
+    return;
+  }
+
   int num_controllers = 0;
   vtkMultiProcessController* controllers[2] = { NULL, NULL };
 
@@ -580,9 +589,65 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::PushStateCollection(vtkSMMessageCollection* collection)
+{
+  // Prevent to push anything during the Quit process
+  if (this->NoMoreDelete)
+  {
+    return;
+  }
+
+  // Locations have already been resolved by PushState() when the messages
+  // were queued. Split the collection per destination, preserving the order.
+  vtkSMMessageCollection dataServerItems;
+  vtkSMMessageCollection renderServerItems;
+  vtkSMMessageCollection localItems;
+  for (int cc = 0, max = collection->item_size(); cc < max; ++cc)
+  {
+    const vtkSMMessage& message = collection->item(cc);
+    vtkTypeUInt32 location = message.location();
+    if ((location & (vtkPVSession::DATA_SERVER | vtkPVSession::DATA_SERVER_ROOT)) != 0)
+    {
+      dataServerItems.add_item()->CopyFrom(message);
+    }
+    if ((location & (vtkPVSession::RENDER_SERVER | vtkPVSession::RENDER_SERVER_ROOT)) != 0)
+    {
+      renderServerItems.add_item()->CopyFrom(message);
+    }
+    if ((location & vtkPVSession::CLIENT) != 0)
+    {
+      localItems.add_item()->CopyFrom(message);
+    }
+  }
+
+  vtkSMMessageCollection* items[2] = { &dataServerItems, &renderServerItems };
+  vtkMultiProcessController* controllers[2] = { this->DataServerController,
+    this->RenderServerController };
+  for (int cc = 0; cc < 2; cc++)
+  {
+    if (items[cc]->item_size() > 0 && controllers[cc] != NULL)
+    {
+      vtkMultiProcessStream stream;
+      stream << static_cast<int>(vtkPVSessionServer::PUSH_COLLECTION);
+      stream << items[cc]->SerializeAsString();
+      std::vector<unsigned char> raw_message;
+      stream.GetRawData(raw_message);
+      controllers[cc]->TriggerRMIOnAllChildren(&raw_message[0],
+        static_cast<int>(raw_message.size()), vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+    }
+  }
+
+  if (localItems.item_size() > 0)
+  {
+    this->Superclass::PushStateCollection(&localItems);
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PullState(vtkSMMessage* message)
 {
+  this->FlushPendingPushStates();
   this->StartBusyWork();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
@@ -639,6 +704,7 @@ void vtkSMSessionClient::ExecuteStream(
     return;
   }
 
+  this->FlushPendingPushStates();
   location = this->GetRealLocation(location);
 
   vtkMultiProcessController* controllers[2] = { NULL, NULL };
@@ -730,6 +796,7 @@ const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 loc
 bool vtkSMSessionClient::GatherInformation(
   vtkTypeUInt32 location, vtkPVInformation* information, vtkTypeUInt32 globalid)
 {
+  this->FlushPendingPushStates();
   this->StartBusyWork();
   if (this->RenderServerController == NULL)
   {
@@ -829,6 +896,8 @@ void vtkSMSessionClient::UnRegisterSIObject(vtkSMMessage* message)
     return;
   }
 
+  this->FlushPendingPushStates();
+
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
   message->set_client_id(this->GetServerInformation()->GetClientId());
@@ -870,6 +939,8 @@ void vtkSMSessionClient::RegisterSIObject(vtkSMMessage* message)
     return;
   }
 
+  this->FlushPendingPushStates();
+
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
   message->set_client_id(this->GetServerInformation()->GetClientId());
@@ -102,6 +102,7 @@ public:
    * Push the state.
    */
   void PushState(vtkSMMessage* msg) override;
+  void PushStateCollection(vtkSMMessageCollection* collection) override;
   void PullState(vtkSMMessage* message) override;
   void ExecuteStream(vtkTypeUInt32 location, const vtkClientServerStream& stream,
     bool ignore_errors = false) override;
@@ -21,6 +21,7 @@
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVConfig.h" // for PARAVIEW_VERSION_*
+#include "vtkPVPluginTracker.h"
 #include "vtkPVProxyDefinitionIterator.h"
 #include "vtkPVXMLElement.h"
 #include "vtkPVXMLParser.h"
@@ -285,6 +286,9 @@ vtkSMProxy* vtkSMSessionProxyManager::NewProxy(
   {
     return 0;
   }
+  // Load the plugin providing the proxy, if it was deferred.
+  vtkPVPluginTracker::GetInstance()->LoadDeferredPluginForProxy(groupName, proxyName);
+
   // Find the XML element from which the proxy can be instantiated and
   // initialized
   vtkPVXMLElement* element = this->GetProxyElement(groupName, proxyName, subProxyName);
@@ -0,0 +1,283 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestProminentValuesInformation.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks vtkPVProminentValuesInformation against
+// vtkAbstractArray::GetProminentComponentValues, for single datasets, for
+// composite datasets whose blocks are merged, and across a stream.
+
+#include "vtkClientServerStream.h"
+#include "vtkIntArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPVProminentValuesInformation.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTrivialProducer.h"
+#include "vtkVariantArray.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#define expect(x, msg)                                                                             \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << __LINE__ << ": " msg << endl;                                                          \
+    return false;                                                                                  \
+  }
+
+namespace
+{
+using ValueSet = std::set<std::vector<std::string> >;
+
+ValueSet ToSet(vtkAbstractArray* values)
+{
+  ValueSet result;
+  if (!values)
+  {
+    return result;
+  }
+  const int nc = values->GetNumberOfComponents();
+  for (vtkIdType t = 0; t < values->GetNumberOfTuples(); ++t)
+  {
+    std::vector<std::string> tuple;
+    for (int c = 0; c < nc; ++c)
+    {
+      tuple.push_back(values->GetVariantValue(t * nc + c).ToString());
+    }
+    result.insert(tuple);
+  }
+  return result;
+}
+
+// The exact prominent values, as computed by vtkAbstractArray.
+ValueSet ExactValues(vtkAbstractArray* array, int component)
+{
+  vtkNew<vtkVariantArray> values;
+  array->GetProminentComponentValues(component, values, 0., 0.);
+  return ToSet(values);
+}
+
+vtkSmartPointer<vtkIntArray> MakeArray(int numComps, vtkIdType numTuples, int numValues, int seed)
+{
+  auto array = vtkSmartPointer<vtkIntArray>::New();
+  array->SetName("values");
+  array->SetNumberOfComponents(numComps);
+  array->SetNumberOfTuples(numTuples);
+  for (vtkIdType cc = 0; cc < numTuples * numComps; ++cc)
+  {
+    array->SetValue(cc, static_cast<int>((cc * 7 + seed) % numValues));
+  }
+  return array;
+}
+
+vtkSmartPointer<vtkPolyData> MakeDataSet(vtkAbstractArray* array)
+{
+  auto polydata = vtkSmartPointer<vtkPolyData>::New();
+  polydata->GetPointData()->AddArray(array);
+  return polydata;
+}
+
+vtkSmartPointer<vtkPVProminentValuesInformation> Gather(
+  vtkDataObject* dobj, int numComps, bool force = false)
+{
+  vtkNew<vtkTrivialProducer> producer;
+  producer->SetOutput(dobj);
+  auto info = vtkSmartPointer<vtkPVProminentValuesInformation>::New();
+  info->SetFieldAssociation("POINTS");
+  info->SetFieldName("values");
+  info->SetNumberOfComponents(numComps);
+  info->SetFraction(1e-3);
+  info->SetUncertainty(1e-6);
+  info->SetForce(force);
+  info->CopyFromObject(producer);
+  return info;
+}
+
+bool CheckValues(vtkPVProminentValuesInformation* info, const ValueSet expected[], int numComps)
+{
+  expect(info->GetValid(), "information is not valid");
+  for (int c = numComps > 1 ? -1 : 0; c < numComps; ++c)
+  {
+    vtkSmartPointer<vtkAbstractArray> values;
+    values.TakeReference(info->GetProminentComponentValues(c));
+    if (ToSet(values) != expected[c + 1])
+    {
+      cerr << "wrong prominent values for component " << c << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestEquivalence()
+{
+  for (int numComps : { 1, 3 })
+  {
+    auto array = MakeArray(numComps, 1000, 5, 0);
+    ValueSet expected[4];
+    for (int c = numComps > 1 ? -1 : 0; c < numComps; ++c)
+    {
+      expected[c + 1] = ExactValues(array, c);
+    }
+    auto dataset = MakeDataSet(array);
+    auto info = Gather(dataset, numComps);
+    if (!CheckValues(info, expected, numComps))
+    {
+      return false;
+    }
+
+    // Through a stream, as between the server and the client.
+    vtkClientServerStream stream;
+    info->CopyToStream(&stream);
+    vtkNew<vtkPVProminentValuesInformation> copy;
+    copy->CopyFromStream(&stream);
+    if (!CheckValues(copy, expected, numComps))
+    {
+      cerr << "stream round trip failed" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestMerge()
+{
+  // Blocks with overlapping sets of values, merged in different orders.
+  const int numBlocks = 4;
+  vtkNew<vtkMultiBlockDataSet> blocks;
+  vtkNew<vtkIntArray> all;
+  all->SetName("values");
+  std::vector<vtkSmartPointer<vtkPVProminentValuesInformation> > infos;
+  for (int cc = 0; cc < numBlocks; ++cc)
+  {
+    auto array = MakeArray(1, 100 + cc, 6, 3 * cc);
+    for (vtkIdType t = 0; t < array->GetNumberOfTuples(); ++t)
+    {
+      all->InsertNextValue(array->GetValue(t));
+    }
+    auto dataset = MakeDataSet(array);
+    blocks->SetBlock(cc, dataset);
+    infos.push_back(Gather(dataset, 1));
+  }
+  ValueSet expected[2];
+  expected[1] = ExactValues(all, 0);
+
+  auto merged = Gather(blocks, 1);
+  if (!CheckValues(merged, expected, 1))
+  {
+    cerr << "merging blocks failed" << endl;
+    return false;
+  }
+
+  vtkNew<vtkPVProminentValuesInformation> forward;
+  vtkNew<vtkPVProminentValuesInformation> backward;
+  for (int cc = 0; cc < numBlocks; ++cc)
+  {
+    forward->AddInformation(infos[cc]);
+    backward->AddInformation(infos[numBlocks - 1 - cc]);
+  }
+  if (!CheckValues(forward, expected, 1) || !CheckValues(backward, expected, 1))
+  {
+    cerr << "merging information failed" << endl;
+    return false;
+  }
+
+  // A union with too many values is invalid, unless forced.
+  auto shifted = MakeArray(1, 1000, 20, 0);
+  for (vtkIdType t = 0; t < shifted->GetNumberOfTuples(); ++t)
+  {
+    shifted->SetValue(t, shifted->GetValue(t) + 100);
+  }
+  vtkNew<vtkMultiBlockDataSet> many;
+  many->SetBlock(0, MakeDataSet(MakeArray(1, 1000, 20, 0)));
+  many->SetBlock(1, MakeDataSet(shifted));
+  expect(Gather(many->GetBlock(0), 1)->GetValid(), "block with few values is not valid");
+  expect(!Gather(many, 1)->GetValid(), "union of too many values is valid");
+  expect(Gather(many, 1, true)->GetValid(), "forced union of many values is not valid");
+  return true;
+}
+
+bool TestValidity()
+{
+  expect(!Gather(MakeDataSet(MakeArray(1, 0, 5, 0)), 1)->GetValid(), "empty array is valid");
+  expect(
+    !Gather(MakeDataSet(MakeArray(1, 1000, 100, 0)), 1)->GetValid(), "too many values is valid");
+
+  // Every component must have prominent values: the first one has too many
+  // distinct values, the second one only a few.
+  vtkNew<vtkIntArray> mixed;
+  mixed->SetName("values");
+  mixed->SetNumberOfComponents(2);
+  for (int t = 0; t < 1000; ++t)
+  {
+    mixed->InsertNextTuple2(t % 100, t % 5);
+  }
+  expect(!Gather(MakeDataSet(mixed), 2)->GetValid(), "component with too many values is valid");
+  expect(Gather(MakeDataSet(mixed), 2, true)->GetValid(), "forced components are not valid");
+  vtkNew<vtkIntArray> reversed;
+  reversed->SetName("values");
+  reversed->SetNumberOfComponents(2);
+  for (int t = 0; t < 1000; ++t)
+  {
+    reversed->InsertNextTuple2(t % 5, t % 100);
+  }
+  expect(
+    !Gather(MakeDataSet(reversed), 2)->GetValid(), "component with too many values is valid");
+
+  auto forced = Gather(MakeDataSet(MakeArray(1, 1000, 100, 0)), 1, true);
+  expect(forced->GetValid(), "forced information is not valid");
+  vtkSmartPointer<vtkAbstractArray> values;
+  values.TakeReference(forced->GetProminentComponentValues(0));
+  expect(values && values->GetNumberOfTuples() == 100, "forced information misses values");
+  return true;
+}
+
+bool TestSampling()
+{
+  // Half of the values are 7, the others are mostly distinct.
+  vtkNew<vtkIntArray> array;
+  array->SetName("values");
+  array->SetNumberOfTuples(100000);
+  for (vtkIdType cc = 0; cc < array->GetNumberOfTuples(); ++cc)
+  {
+    array->SetValue(cc, cc % 2 ? 7 : static_cast<int>(1000 + cc));
+  }
+  auto dataset = MakeDataSet(array);
+
+  vtkNew<vtkTrivialProducer> producer;
+  producer->SetOutput(dataset);
+  vtkNew<vtkPVProminentValuesInformation> info;
+  info->SetFieldAssociation("POINTS");
+  info->SetFieldName("values");
+  info->SetNumberOfComponents(1);
+  info->SetFraction(0.1);
+  info->SetUncertainty(1e-6);
+  expect(!info->GetSampling(), "sampling should be off by default");
+  info->SamplingOn();
+  info->CopyFromObject(producer);
+  expect(info->GetValid(), "sampled information is not valid");
+  vtkSmartPointer<vtkAbstractArray> values;
+  values.TakeReference(info->GetProminentComponentValues(0));
+  expect(ToSet(values).count(std::vector<std::string>(1, "7")) == 1, "prominent value missed");
+  return true;
+}
+}
+
+int TestProminentValuesInformation(int, char* [])
+{
+  return TestEquivalence() && TestMerge() && TestValidity() && TestSampling() ? EXIT_SUCCESS
+                                                                               : EXIT_FAILURE;
+}
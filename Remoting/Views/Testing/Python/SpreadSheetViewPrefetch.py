@@ -0,0 +1,69 @@
+from paraview.simple import *
+from paraview import smtesting
+smtesting.ProcessCommandLineArguments()
+
+# 25 blocks of 1000 rows, all of the same size.
+wavelet = Wavelet(WholeExtent=[0, 49, 0, 49, 0, 9])
+
+view = CreateView("SpreadSheetView")
+view.BlockSize = 1000
+view.NumberOfPrefetchBlocks = 2
+Show()
+Render()
+
+pvview = view.GetClientSideObject()
+assert pvview.GetNumberOfRows() == 25000
+
+# budget for 3 blocks, but not 4.
+pvview.GetValue(0, 0)
+blockSize = pvview.GetCacheMemorySize()
+assert blockSize > 0
+view.CacheMemoryLimit = 3 * blockSize + blockSize // 2
+
+def prefetch():
+    """Prefetches until there is nothing left to prefetch. With a server, a
+    request returns before the block is received, so more calls are needed."""
+    count = 0
+    while pvview.PrefetchBlock():
+        count += 1
+    return count
+
+# scroll down to block 5: blocks 6 and 7 are prefetched, and block 0, the
+# least recently used one, is released for block 7.
+pvview.SetVisibleRows(0, 20)
+pvview.GetValue(5000, 0)
+pvview.SetVisibleRows(5000, 5020)
+assert prefetch() >= 2
+assert pvview.GetCacheMemorySize() <= view.CacheMemoryLimit
+assert pvview.IsAvailable(6000)
+assert pvview.IsAvailable(7000)
+assert not pvview.IsAvailable(0)
+
+# scroll up to blocks 4 and 5: blocks 4 and 3 are prefetched. Prefetched blocks
+# go behind the visible ones, so blocks 6 and 7 are released.
+pvview.GetValue(5000, 0)
+pvview.SetVisibleRows(4990, 5010)
+assert prefetch() >= 2
+assert pvview.GetCacheMemorySize() <= view.CacheMemoryLimit
+
+assert not pvview.IsAvailable(6000)
+assert not pvview.IsAvailable(7000)
+assert not pvview.IsAvailable(0)
+assert pvview.IsAvailable(3000)
+assert pvview.IsAvailable(4000)
+assert pvview.IsAvailable(5000)
+
+# blocks 4 and 5 are visible, block 4 was accessed before block 9, which is
+# released for the prefetched block 3 rather than the visible block 4.
+pvview.ClearCache()
+pvview.SetVisibleRows(4000, 5020)
+pvview.GetValue(4000, 0)
+pvview.GetValue(9000, 0)
+pvview.GetValue(5000, 0)
+assert prefetch() >= 1
+assert pvview.GetCacheMemorySize() <= view.CacheMemoryLimit
+
+assert not pvview.IsAvailable(9000)
+assert pvview.IsAvailable(3000)
+assert pvview.IsAvailable(4000)
+assert pvview.IsAvailable(5000)
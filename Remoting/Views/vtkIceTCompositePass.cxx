@@ -32,6 +32,7 @@
 #include "vtkOpenGLState.h"
 #include "vtkOrderedCompositingHelper.h"
 #include "vtkPVLogger.h"
+#include "vtkPVTimeline.h"
 #include "vtkPixelBufferObject.h"
 #include "vtkRenderState.h"
 #include "vtkRenderWindow.h"
@@ -352,6 +353,7 @@ void vtkIceTCompositePass::CleanupContext(const vtkRenderState*)
 void vtkIceTCompositePass::Render(const vtkRenderState* render_state)
 {
   vtkVLogScopeF(PARAVIEW_LOG_RENDERING_VERBOSITY(), "%s: Render", vtkLogIdentifier(this));
+  PARAVIEW_TIMELINE_SCOPE("compositing", "IceTComposite");
   vtkOpenGLRenderUtilities::MarkDebugEvent("vtkIceTCompositePass::Render Start");
   this->IceTContext->SetController(this->Controller);
   if (!this->IceTContext->IsValid())
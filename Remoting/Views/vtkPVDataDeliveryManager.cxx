@@ -21,6 +21,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPVDataRepresentation.h"
 #include "vtkPVLogger.h"
+#include "vtkPVTimeline.h"
 #include "vtkPVView.h"
 #include "vtkSmartPointer.h"
 #include "vtkWeakPointer.h"
@@ -244,6 +245,7 @@ void vtkPVDataDeliveryManager::Deliver(int low_res, unsigned int size, unsigned
 
   vtkVLogScopeF(PARAVIEW_LOG_DATA_MOVEMENT_VERBOSITY(), "%s data migration",
     (low_res ? "low-resolution" : "full resolution"));
+  PARAVIEW_TIMELINE_SCOPE("delivery", low_res ? "DeliverLowRes" : "Deliver");
   for (unsigned int cc = 0; cc < size; cc += 2)
   {
     const unsigned int id = values[cc];
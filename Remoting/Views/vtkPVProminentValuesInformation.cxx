@@ -16,11 +16,13 @@
 
 #include "vtkAbstractArray.h"
 #include "vtkAlgorithmOutput.h"
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
 #include "vtkClientServerStream.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayRange.h"
 #include "vtkDataSet.h"
 #include "vtkDataSetAttributes.h"
 #include "vtkExecutive.h"
@@ -39,20 +41,317 @@
 #include "vtkVariant.h"
 #include "vtkVariantArray.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
 #include <map>
-#include <set>
+#include <random>
 #include <sstream>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
-#define VTK_MAX_CATEGORICAL_VALS (32)
+// Maximum number of counters kept per component when not forced.
+#define VTK_PROMINENT_MAX_COUNTERS (65536)
 
 namespace
 {
-typedef std::map<int, std::set<std::vector<vtkVariant> > > vtkInternalDistinctValuesBase;
+//----------------------------------------------------------------------------
+// Counts of the distinct values (or tuples) an array component takes on.
+//
+// When there are more distinct values than counters, the counts are those of
+// a Misra-Gries heavy-hitters summary: each count underestimates the actual
+// count by at most Error, and a value that is not present occurs at most
+// Error times. Summaries are merged by adding the counts and errors, which is
+// associative, so blocks and ranks can be combined in any order.
+class vtkProminentValuesSketch
+{
+public:
+  typedef std::vector<vtkVariant> KeyType;
+  typedef std::map<KeyType, vtkTypeInt64> CountsType;
+
+  vtkProminentValuesSketch()
+    : NumberOfSamples(0)
+    , Error(0)
+  {
+  }
+
+  // Keep at most capacity counters, subtracting the (capacity+1)-th largest
+  // count from all of them.
+  void Reduce(size_t capacity)
+  {
+    if (this->Counts.size() <= capacity)
+    {
+      return;
+    }
+    std::vector<vtkTypeInt64> counts;
+    counts.reserve(this->Counts.size());
+    for (const auto& item : this->Counts)
+    {
+      counts.push_back(item.second);
+    }
+    std::nth_element(counts.begin(), counts.begin() + capacity, counts.end(),
+      std::greater<vtkTypeInt64>());
+    const vtkTypeInt64 decrement = counts[capacity];
+    for (auto iter = this->Counts.begin(); iter != this->Counts.end();)
+    {
+      iter->second -= decrement;
+      if (iter->second <= 0)
+      {
+        iter = this->Counts.erase(iter);
+      }
+      else
+      {
+        ++iter;
+      }
+    }
+    this->Error += decrement;
+  }
+
+  // Remove the values that certainly make up less than a fraction of the
+  // samples. Used to keep the summaries sent between ranks small.
+  void Prune(double fraction)
+  {
+    const double threshold = fraction * this->NumberOfSamples;
+    if (fraction <= 0. || threshold < 1.)
+    {
+      return;
+    }
+    bool pruned = false;
+    for (auto iter = this->Counts.begin(); iter != this->Counts.end();)
+    {
+      if (iter->second + this->Error < threshold)
+      {
+        iter = this->Counts.erase(iter);
+        pruned = true;
+      }
+      else
+      {
+        ++iter;
+      }
+    }
+    if (pruned)
+    {
+      this->Error = std::max(this->Error, static_cast<vtkTypeInt64>(std::ceil(threshold)));
+    }
+  }
+
+  void Merge(const vtkProminentValuesSketch& other, size_t capacity)
+  {
+    for (const auto& item : other.Counts)
+    {
+      this->Counts[item.first] += item.second;
+    }
+    this->NumberOfSamples += other.NumberOfSamples;
+    this->Error += other.Error;
+    this->Reduce(capacity);
+  }
+
+  // Returns false if the prominent values cannot be listed, either because
+  // there are too many of them or because the summary is not precise enough.
+  bool GetProminentValues(double fraction, bool force, std::vector<const KeyType*>& values) const
+  {
+    values.clear();
+    if (this->Error > 0 && fraction <= 0.)
+    {
+      // Too many distinct values to list them all.
+      return false;
+    }
+    const double threshold = this->Error > 0 ? fraction * this->NumberOfSamples : 0.;
+    for (const auto& item : this->Counts)
+    {
+      if (item.second + this->Error >= threshold)
+      {
+        values.push_back(&item.first);
+      }
+    }
+    return force || values.size() <= vtkAbstractArray::MAX_DISCRETE_VALUES;
+  }
+
+  CountsType Counts;
+  vtkTypeInt64 NumberOfSamples;
+  vtkTypeInt64 Error;
+};
+
+//----------------------------------------------------------------------------
+inline size_t vtkProminentValuesHash(const vtkVariant& value)
+{
+  return std::hash<std::string>()(value.ToString());
+}
+
+template <typename ValueType>
+inline size_t vtkProminentValuesHash(const ValueType& value)
+{
+  return std::hash<ValueType>()(value);
+}
+
+inline vtkVariant vtkProminentValuesToVariant(const std::string& value)
+{
+  return vtkVariant(vtkStdString(value));
+}
+
+template <typename ValueType>
+inline vtkVariant vtkProminentValuesToVariant(const ValueType& value)
+{
+  return vtkVariant(value);
+}
+
+//----------------------------------------------------------------------------
+// Misra-Gries counters with typed keys, used while traversing an array.
+template <typename ValueType>
+class vtkProminentValuesCounter
+{
+public:
+  typedef std::vector<ValueType> KeyType;
+
+  struct KeyHash
+  {
+    size_t operator()(const KeyType& key) const
+    {
+      size_t hash = key.size();
+      for (const ValueType& value : key)
+      {
+        hash ^= vtkProminentValuesHash(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      }
+      return hash;
+    }
+  };
+
+  explicit vtkProminentValuesCounter(size_t capacity)
+    : Capacity(capacity)
+    , NumberOfSamples(0)
+    , Error(0)
+  {
+  }
+
+  void Add(const KeyType& key)
+  {
+    ++this->NumberOfSamples;
+    auto iter = this->Counts.find(key);
+    if (iter != this->Counts.end())
+    {
+      ++iter->second;
+    }
+    else if (this->Counts.size() < this->Capacity)
+    {
+      this->Counts.emplace(key, 1);
+    }
+    else
+    {
+      // Decrement every counter, the new value's included.
+      for (iter = this->Counts.begin(); iter != this->Counts.end();)
+      {
+        if (--iter->second == 0)
+        {
+          iter = this->Counts.erase(iter);
+        }
+        else
+        {
+          ++iter;
+        }
+      }
+      ++this->Error;
+    }
+  }
+
+  bool HasOverflowed() const { return this->Error > 0; }
+
+  void CopyTo(vtkProminentValuesSketch& sketch) const
+  {
+    vtkProminentValuesSketch::KeyType variantKey;
+    for (const auto& item : this->Counts)
+    {
+      variantKey.resize(item.first.size());
+      std::transform(item.first.begin(), item.first.end(), variantKey.begin(),
+        [](const ValueType& value) { return vtkProminentValuesToVariant(value); });
+      sketch.Counts[variantKey] += item.second;
+    }
+    sketch.NumberOfSamples += this->NumberOfSamples;
+    sketch.Error += this->Error;
+  }
+
+private:
+  size_t Capacity;
+  vtkTypeInt64 NumberOfSamples;
+  vtkTypeInt64 Error;
+  std::unordered_map<KeyType, vtkTypeInt64, KeyHash> Counts;
+};
+
+//----------------------------------------------------------------------------
+// Which tuples to traverse and how many counters to use.
+struct vtkProminentValuesSampling
+{
+  vtkIdType NumberOfTuples;
+  // Tuples to traverse, all of them if empty.
+  std::vector<vtkIdType> TupleIds;
+  size_t Capacity;
+  // Stop as soon as every component has more distinct values than counters.
+  bool StopOnOverflow;
+};
+
+// Count the values of each component, and of the tuples when there are
+// several components, in a single traversal. Component -1 holds tuples.
+template <typename ValueType, typename GetValueFunctor>
+void vtkCountProminentValues(GetValueFunctor getValue, int numComps,
+  const vtkProminentValuesSampling& sampling, std::map<int, vtkProminentValuesSketch>& sketches)
+{
+  const int first = numComps > 1 ? -1 : 0;
+  std::vector<vtkProminentValuesCounter<ValueType> > counters(
+    numComps - first, vtkProminentValuesCounter<ValueType>(sampling.Capacity));
+  std::vector<ValueType> tuple(numComps);
+  std::vector<ValueType> single(1);
+
+  const bool allTuples = sampling.TupleIds.empty();
+  const vtkIdType numSamples =
+    allTuples ? sampling.NumberOfTuples : static_cast<vtkIdType>(sampling.TupleIds.size());
+  for (vtkIdType ii = 0; ii < numSamples; ++ii)
+  {
+    const vtkIdType tupleId = allTuples ? ii : sampling.TupleIds[ii];
+    for (int c = 0; c < numComps; ++c)
+    {
+      tuple[c] = getValue(tupleId, c);
+      single[0] = tuple[c];
+      counters[c - first].Add(single);
+    }
+    if (first < 0)
+    {
+      counters[0].Add(tuple);
+    }
+
+    if (sampling.StopOnOverflow && (ii & 0xfff) == 0xfff &&
+      std::all_of(counters.begin(), counters.end(),
+        [](const vtkProminentValuesCounter<ValueType>& counter) {
+          return counter.HasOverflowed();
+        }))
+    {
+      break;
+    }
+  }
+
+  for (int c = first; c < numComps; ++c)
+  {
+    counters[c - first].CopyTo(sketches[c]);
+  }
+}
+
+struct vtkProminentValuesDataArrayWorker
+{
+  template <typename ArrayT>
+  void operator()(ArrayT* array, const vtkProminentValuesSampling& sampling,
+    std::map<int, vtkProminentValuesSketch>& sketches)
+  {
+    using ValueType = vtk::GetAPIType<ArrayT>;
+    const auto tuples = vtk::DataArrayTupleRange(array);
+    vtkCountProminentValues<ValueType>(
+      [&](vtkIdType tupleId, int comp) -> ValueType { return tuples[tupleId][comp]; },
+      array->GetNumberOfComponents(), sampling, sketches);
+  }
+};
 }
 
 class vtkPVProminentValuesInformation::vtkInternalDistinctValues
-  : public vtkInternalDistinctValuesBase
+  : public std::map<int, vtkProminentValuesSketch>
 {
 };
 
@@ -68,6 +367,7 @@ vtkPVProminentValuesInformation::vtkPVProminentValuesInformation()
   this->InitializeParameters();
   this->Initialize();
   this->Force = false;
+  this->Sampling = false;
   this->Valid = true;
 }
 
@@ -122,16 +422,18 @@ void vtkPVProminentValuesInformation::PrintSelf(ostream& os, vtkIndent indent)
     for (vtkInternalDistinctValues::iterator cit = this->DistinctValues->begin();
          cit != this->DistinctValues->end(); ++cit)
     {
-      os << i2 << "Component " << cit->first << " (" << cit->second.size() << " values )" << endl;
-      for (vtkInternalDistinctValues::mapped_type::iterator eit = cit->second.begin();
-           eit != cit->second.end(); ++eit)
+      os << i2 << "Component " << cit->first << " (" << cit->second.Counts.size() << " values, "
+         << cit->second.NumberOfSamples << " samples, error " << cit->second.Error << " )"
+         << endl;
+      for (const auto& item : cit->second.Counts)
       {
         os << i3;
-        for (std::vector<vtkVariant>::const_iterator vit = eit->begin(); vit != eit->end(); ++vit)
+        for (std::vector<vtkVariant>::const_iterator vit = item.first.begin();
+             vit != item.first.end(); ++vit)
         {
           os << " " << vit->ToString();
         }
-        os << endl;
+        os << " : " << item.second << endl;
       }
     }
   }
@@ -141,6 +443,7 @@ void vtkPVProminentValuesInformation::PrintSelf(ostream& os, vtkIndent indent)
   }
   os << "Fraction: " << this->Fraction << endl;
   os << "Uncertainty: " << this->Uncertainty << endl;
+  os << "Sampling: " << this->Sampling << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -162,6 +465,12 @@ void vtkPVProminentValuesInformation::SetNumberOfComponents(int numComps)
   }
 }
 
+//----------------------------------------------------------------------------
+double vtkPVProminentValuesInformation::GetSampledFraction()
+{
+  return this->Sampling && this->Fraction > 0. ? this->Fraction : 0.;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVProminentValuesInformation::DeepCopy(vtkPVProminentValuesInformation* info)
 {
@@ -249,6 +558,7 @@ void vtkPVProminentValuesInformation::DeepCopyParameters(vtkPVProminentValuesInf
   this->Fraction = other->Fraction;
   this->Uncertainty = other->Uncertainty;
   this->Force = other->Force;
+  this->Sampling = other->Sampling;
   this->Valid = other->Valid;
 }
 
@@ -314,6 +624,26 @@ void vtkPVProminentValuesInformation::CopyFromLeafDataObject(vtkDataObject* dobj
   }
 }
 
+//----------------------------------------------------------------------------
+size_t vtkPVProminentValuesInformation::GetSketchCapacity()
+{
+  if (this->Force)
+  {
+    return std::numeric_limits<size_t>::max();
+  }
+  // Enough counters to tell whether there are too many distinct values and,
+  // when sampling, to find the values making up a quarter of the fraction.
+  size_t capacity = vtkAbstractArray::MAX_DISCRETE_VALUES + 1;
+  const double fraction = this->GetSampledFraction();
+  if (fraction > 0. && fraction <= 1.)
+  {
+    capacity = std::max(capacity,
+      static_cast<size_t>(
+        std::min(std::ceil(4. / fraction), static_cast<double>(VTK_PROMINENT_MAX_COUNTERS))));
+  }
+  return capacity;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVProminentValuesInformation::CopyDistinctValuesFromObject(vtkAbstractArray* array)
 {
@@ -331,51 +661,86 @@ void vtkPVProminentValuesInformation::CopyDistinctValuesFromObject(vtkAbstractAr
     this->DistinctValues = new vtkInternalDistinctValues;
   }
   int nc = this->GetNumberOfComponents();
-  vtkNew<vtkVariantArray> cvalues;
-  std::vector<vtkVariant> tuple;
-  // bool tooManyValues;
-  for (int c = (nc > 1 ? -1 : 0); c < nc; ++c)
-  {
-    int tupleSize = c < 0 ? nc : 1;
-    tuple.resize(tupleSize);
-    std::set<std::vector<vtkVariant> >& compDistincts((*this->DistinctValues)[c]);
-    cvalues->Initialize();
-    unsigned int maxDiscreteValues = array->GetMaxDiscreteValues();
-    if (this->Force)
-    {
-      array->SetMaxDiscreteValues(VTK_UNSIGNED_INT_MAX);
-    }
-    array->GetProminentComponentValues(c, cvalues.GetPointer(), 0., 0.);
-    array->SetMaxDiscreteValues(maxDiscreteValues);
-    vtkIdType nt = cvalues->GetNumberOfTuples();
-    if (nt > 0)
+  if (nc != array->GetNumberOfComponents())
+  {
+    vtkErrorMacro("Array has " << array->GetNumberOfComponents() << " components, expected "
+                               << nc << ".");
+    this->Valid = false;
+    return;
+  }
+
+  vtkProminentValuesSampling sampling;
+  sampling.NumberOfTuples = array->GetNumberOfTuples();
+  sampling.Capacity = this->GetSketchCapacity();
+  sampling.StopOnOverflow = !this->Force && !(this->GetSampledFraction() > 0.);
+
+  // Values making up at least Fraction of the array are sampled at least
+  // once with a probability of 1 - Uncertainty after this many samples.
+  if (this->Sampling && !this->Force && this->Fraction > 0. && this->Fraction < 1. &&
+    this->Uncertainty > 0. && this->Uncertainty < 1.)
+  {
+    const double numSamples =
+      std::ceil(std::log(this->Uncertainty) / std::log1p(-this->Fraction));
+    if (numSamples < sampling.NumberOfTuples)
     {
-      for (vtkIdType t = 0; t < nt; ++t)
+      // Fixed seed, so that the information is reproducible.
+      std::minstd_rand generator(static_cast<unsigned int>(sampling.NumberOfTuples));
+      std::uniform_int_distribution<vtkIdType> tupleIds(0, sampling.NumberOfTuples - 1);
+      sampling.TupleIds.resize(static_cast<size_t>(numSamples));
+      for (auto& tupleId : sampling.TupleIds)
       {
-        for (int i = 0; i < tupleSize; ++i)
-        {
-          tuple[i] = cvalues->GetValue(i + t * tupleSize);
-        }
-        compDistincts.insert(tuple);
-        /*
-        if (compDistincts.insert(tuple).second)
-          {
-          if ((tooManyValues =
-            compDistincts.size() > vtkAbstractArray::MAX_DISCRETE_VALUES))
-            break;
-          }
-          */
+        tupleId = tupleIds(generator);
       }
-      this->Valid = true;
+      std::sort(sampling.TupleIds.begin(), sampling.TupleIds.end());
     }
-    else
+  }
+
+  vtkInternalDistinctValues& sketches = *this->DistinctValues;
+  if (vtkDataArray* da = vtkDataArray::SafeDownCast(array))
+  {
+    vtkProminentValuesDataArrayWorker worker;
+    if (!vtkArrayDispatch::Dispatch::Execute(da, worker, sampling, sketches))
     {
-      // if there is no tuples provided, it means we were unable
-      // to determine the prominent values and this information
-      // is invalid
-      this->Valid = false;
+      vtkCountProminentValues<vtkVariant>(
+        [&](vtkIdType tupleId, int comp) { return da->GetVariantValue(tupleId * nc + comp); }, nc,
+        sampling, sketches);
+    }
+  }
+  else if (vtkStringArray* sa = vtkStringArray::SafeDownCast(array))
+  {
+    vtkCountProminentValues<std::string>(
+      [&](vtkIdType tupleId, int comp) -> std::string { return sa->GetValue(tupleId * nc + comp); },
+      nc, sampling, sketches);
+  }
+  else
+  {
+    vtkCountProminentValues<vtkVariant>(
+      [&](vtkIdType tupleId, int comp) { return array->GetVariantValue(tupleId * nc + comp); }, nc,
+      sampling, sketches);
+  }
+
+  // Only keep what may still be prominent once merged with other blocks or
+  // ranks, so that the summaries remain small.
+  if (!this->Force)
+  {
+    for (auto& component : sketches)
+    {
+      component.second.Prune(this->GetSampledFraction() / 4.);
     }
   }
+
+  // As with vtkAbstractArray::GetProminentComponentValues, the information
+  // is invalid when no prominent values could be found for a component, e.g.
+  // for an empty array or one with too many distinct values.
+  std::vector<const vtkProminentValuesSketch::KeyType*> values;
+  this->Valid = !sketches.empty();
+  for (const auto& component : sketches)
+  {
+    const bool found =
+      component.second.GetProminentValues(this->GetSampledFraction(), this->Force, values) &&
+      !values.empty();
+    this->Valid = this->Valid && found;
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -414,7 +779,7 @@ void vtkPVProminentValuesInformation::CopyToStream(vtkClientServerStream* css)
   // Copy parameter values to stream.
   *css << this->PortNumber << std::string(this->FieldAssociation) << std::string(this->FieldName)
        << this->NumberOfComponents << this->Fraction << this->Uncertainty << this->Force
-       << this->Valid;
+       << this->Sampling << this->Valid;
 
   // Now copy results to stream.
   int numberOfDistinctValueComponents =
@@ -426,16 +791,16 @@ void vtkPVProminentValuesInformation::CopyToStream(vtkClientServerStream* css)
     vtkInternalDistinctValues::iterator cit;
     for (cit = this->DistinctValues->begin(); cit != this->DistinctValues->end(); ++cit)
     {
-      unsigned nuv = static_cast<unsigned>(cit->second.size());
-      *css << cit->first << nuv;
-      vtkInternalDistinctValues::mapped_type::iterator eit;
-      for (eit = cit->second.begin(); eit != cit->second.end(); ++eit)
+      unsigned nuv = static_cast<unsigned>(cit->second.Counts.size());
+      *css << cit->first << cit->second.NumberOfSamples << cit->second.Error << nuv;
+      for (const auto& item : cit->second.Counts)
       {
         std::vector<vtkVariant>::const_iterator vit;
-        for (vit = eit->begin(); vit != eit->end(); ++vit)
+        for (vit = item.first.begin(); vit != item.first.end(); ++vit)
         {
           *css << *vit;
         }
+        *css << item.second;
       }
     }
   }
@@ -493,6 +858,12 @@ void vtkPVProminentValuesInformation::CopyFromStream(const vtkClientServerStream
     return;
   }
 
+  if (!css->GetArgument(0, pos++, &this->Sampling))
+  {
+    vtkErrorMacro("Error parsing sampling flag from message.");
+    return;
+  }
+
   if (!css->GetArgument(0, pos++, &this->Valid))
   {
     vtkErrorMacro("Error parsing valid flag from message.");
@@ -527,6 +898,13 @@ void vtkPVProminentValuesInformation::CopyFromStream(const vtkClientServerStream
         vtkErrorMacro("Error decoding the " << i << "-th unique-value component ID.");
         return;
       }
+      vtkProminentValuesSketch& sketch = (*this->DistinctValues)[component];
+      if (!css->GetArgument(0, pos++, &sketch.NumberOfSamples) ||
+        !css->GetArgument(0, pos++, &sketch.Error))
+      {
+        vtkErrorMacro("Error decoding the counts summary for component " << i);
+        return;
+      }
       unsigned nuv;
       if (!css->GetArgument(0, pos++, &nuv))
       {
@@ -540,14 +918,22 @@ void vtkPVProminentValuesInformation::CopyFromStream(const vtkClientServerStream
       {
         for (int k = 0; k < tupleSize; ++k)
         {
-          if (!css->GetArgument(0, pos, &tuple[k]))
+          if (!css->GetArgument(0, pos++, &tuple[k]))
           {
             vtkErrorMacro("Error decoding the " << k << "-th entry of the " << j
                                                 << "-th unique tuple for component " << i);
             return;
           }
         }
-        (*this->DistinctValues)[component].insert(tuple);
+        vtkTypeInt64 count;
+        if (!css->GetArgument(0, pos++, &count))
+        {
+          vtkErrorMacro("Error decoding the count of the " << j
+                                                           << "-th unique tuple for component "
+                                                           << i);
+          return;
+        }
+        sketch.Counts[tuple] = count;
       }
     }
   }
@@ -561,7 +947,7 @@ void vtkPVProminentValuesInformation::CopyParametersToStream(vtkMultiProcessStre
   vtkTypeUInt32 magic_number = VTK_PROMINENT_MAGIC_NUMBER;
   mps << magic_number << this->PortNumber << std::string(this->FieldAssociation)
       << std::string(this->FieldName) << this->NumberOfComponents << this->Fraction
-      << this->Uncertainty << this->Force << this->Valid;
+      << this->Uncertainty << this->Force << this->Sampling << this->Valid;
 }
 
 //-----------------------------------------------------------------------------
@@ -572,7 +958,7 @@ void vtkPVProminentValuesInformation::CopyParametersFromStream(vtkMultiProcessSt
   std::string fieldAssoc;
   std::string fieldName;
   mps >> magic_number >> this->PortNumber >> fieldAssoc >> fieldName >> this->NumberOfComponents >>
-    this->Fraction >> this->Uncertainty >> this->Force >> this->Valid;
+    this->Fraction >> this->Uncertainty >> this->Force >> this->Sampling >> this->Valid;
   if (magic_number != VTK_PROMINENT_MAGIC_NUMBER)
   {
     vtkErrorMacro("Magic number mismatch.");
@@ -589,30 +975,15 @@ void vtkPVProminentValuesInformation::AddDistinctValues(vtkPVProminentValuesInfo
     return;
   }
 
-  for (int i = 0; i <= this->NumberOfComponents; ++i)
+  const size_t capacity = this->GetSketchCapacity();
+  std::vector<const vtkProminentValuesSketch::KeyType*> values;
+  for (const auto& component : *info->DistinctValues)
   {
-    vtkInternalDistinctValues::iterator bit = info->DistinctValues->find(i);
-    vtkInternalDistinctValues::mapped_type::iterator
-      eit; // iterator over entries of component [ab]it->second.
-    bool tooManyValues = false;
-    if (bit != info->DistinctValues->end())
-    { // Add info's values to our list of unique keys
-      for (eit = bit->second.begin(); eit != bit->second.end(); ++eit)
-      {
-        if ((*this->DistinctValues)[i].insert(*eit).second &&
-          ((*this->DistinctValues)[i].size() > vtkAbstractArray::MAX_DISCRETE_VALUES &&
-              !this->Force))
-        {
-          tooManyValues = true;
-          break;
-        }
-      }
-    }
-
-    // If the union of values is too large, delete the list of values
-    if (tooManyValues)
+    vtkProminentValuesSketch& sketch = (*this->DistinctValues)[component.first];
+    sketch.Merge(component.second, capacity);
+    // If the union of values is too large, the information is invalid.
+    if (!sketch.GetProminentValues(this->GetSampledFraction(), this->Force, values))
     {
-      this->DistinctValues->erase(i);
       this->Valid = false;
     }
   }
@@ -623,28 +994,29 @@ vtkAbstractArray* vtkPVProminentValuesInformation::GetProminentComponentValues(i
 {
   vtkVariantArray* va = 0;
   vtkInternalDistinctValues::iterator compEntry;
-  vtkIdType nt = 0;
   if (component < 0 && this->NumberOfComponents == 1)
   {
     component = 0;
   }
+  std::vector<const vtkProminentValuesSketch::KeyType*> values;
   if (!this->DistinctValues ||
     (compEntry = this->DistinctValues->find(component)) == this->DistinctValues->end() ||
-    (nt = static_cast<vtkIdType>(compEntry->second.size())) == 0)
+    !compEntry->second.GetProminentValues(this->GetSampledFraction(), this->Force, values) ||
+    values.empty())
   {
     return va;
   }
 
+  vtkIdType nt = static_cast<vtkIdType>(values.size());
   va = vtkVariantArray::New();
   int nc = (component < 0 ? this->NumberOfComponents : 1);
   va->SetNumberOfComponents(nc);
   va->Allocate(nt * nc);
-  vtkInternalDistinctValues::mapped_type::iterator eit;
-  for (eit = compEntry->second.begin(); eit != compEntry->second.end(); ++eit)
+  for (const auto* value : values)
   {
     for (int i = 0; i < nc; ++i)
     {
-      va->InsertNextValue((*eit)[i]);
+      va->InsertNextValue((*value)[i]);
     }
   }
   return va;
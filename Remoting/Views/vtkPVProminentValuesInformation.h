@@ -26,7 +26,12 @@
  * given confidence that dictates the number of samples required), then
  * the prominent values are also made available.
  *
- * This class uses vtkAbstractArray::GetProminentComponentValues().
+ * Values are counted with typed hash maps. Unless forced, the number of
+ * counters is bounded: when an array takes on more distinct values, the
+ * counts are those of a Misra-Gries heavy-hitters summary, which only keeps
+ * the values that may be prominent. When Sampling is on, only as many randomly
+ * chosen tuples as needed to meet the Fraction and Uncertainty bounds are
+ * inspected. Summaries from blocks and ranks are merged associatively.
 */
 
 #ifndef vtkPVProminentValuesInformation_h
@@ -114,6 +119,18 @@ public:
   vtkSetMacro(Force, bool);
   vtkGetMacro(Force, bool);
 
+  //@{
+  /**
+   * Set/get whether to only inspect a random subset of the tuples, large
+   * enough to find the values making up at least Fraction of the array with
+   * the given Uncertainty. Only these values are then reported. When off, the
+   * default, every tuple is inspected and every value is reported.
+   */
+  vtkSetMacro(Sampling, bool);
+  vtkGetMacro(Sampling, bool);
+  vtkBooleanMacro(Sampling, bool);
+  //@}
+
   //@{
   /**
    * Get the validity of the information. The flag has a meaning after trying to recover
@@ -203,6 +220,16 @@ protected:
   void CopyFromCompositeDataSet(vtkCompositeDataSet*);
   void CopyFromLeafDataObject(vtkDataObject*);
 
+  /**
+   * Maximum number of distinct values counted per component.
+   */
+  size_t GetSketchCapacity();
+
+  /**
+   * Fraction used to discard values, 0 when not sampling.
+   */
+  double GetSampledFraction();
+
   /// Information parameters
   //@{
   int PortNumber;
@@ -212,6 +239,7 @@ protected:
   double Fraction;
   double Uncertainty;
   bool Force;
+  bool Sampling;
   bool Valid;
   //@}
 
@@ -69,6 +69,7 @@
 #include "vtkPVSession.h"
 #include "vtkPVStreamingMacros.h"
 #include "vtkPVSynchronizedRenderer.h"
+#include "vtkPVTimeline.h"
 #include "vtkPVTrackballMultiRotate.h"
 #include "vtkPVTrackballRoll.h"
 #include "vtkPVTrackballRotate.h"
@@ -1436,6 +1437,7 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
 
   vtkVLogScopeF(PARAVIEW_LOG_RENDERING_VERBOSITY(), "Render(interactive=%s, skip_rendering=%s)",
     (interactive ? "true" : "false"), (skip_rendering ? "true" : "false"));
+  PARAVIEW_TIMELINE_SCOPE("rendering", interactive ? "InteractiveRender" : "StillRender");
 
   this->UpdateStereoProperties();
 
@@ -36,6 +36,7 @@
 #include "vtkPVServerInformation.h"
 #include "vtkPVSession.h"
 #include "vtkPVStreamingMacros.h"
+#include "vtkPVTimeline.h"
 #include "vtkProcessModule.h"
 #include "vtkRenderWindow.h"
 #include "vtkRendererCollection.h"
@@ -662,6 +663,7 @@ void vtkPVView::AllReduce(const vtkBoundingBox& arg_source, vtkBoundingBox& dest
   assert(this->Session);
 
   vtkVLogScopeF(PARAVIEW_LOG_RENDERING_VERBOSITY(), "all-reduce-bounds");
+  PARAVIEW_TIMELINE_SCOPE("mpi", "AllReduceBounds");
 
   vtkBoundingBox source = arg_source;
   if (!arg_source.IsValid())
@@ -770,6 +772,7 @@ void vtkPVView::AllReduce(
 {
   assert(this->Session);
   vtkVLogScopeF(PARAVIEW_LOG_RENDERING_VERBOSITY(), "all-reduce (op=%d)", operation);
+  PARAVIEW_TIMELINE_SCOPE("mpi", "AllReduce");
 
   auto evaluator = [operation](vtkTypeUInt64 a, vtkTypeUInt64 b) {
     switch (operation)
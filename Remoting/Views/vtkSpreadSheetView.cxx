@@ -21,6 +21,7 @@
 #include "vtkCommunicator.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkCompositeMultiProcessController.h"
 #include "vtkDataArrayRange.h"
 #include "vtkDataSetAttributes.h"
 #include "vtkFieldData.h"
@@ -31,12 +32,15 @@
 #include "vtkMemberFunctionCommand.h"
 #include "vtkMultiProcessController.h"
 #include "vtkMultiProcessStream.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVMergeTables.h"
 #include "vtkPVSession.h"
 #include "vtkProcessModule.h"
 #include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
+#include "vtkSocket.h"
+#include "vtkSocketCommunicator.h"
 #include "vtkSortedTableStreamer.h"
 #include "vtkSplitColumnComponents.h"
 #include "vtkSpreadSheetRepresentation.h"
@@ -48,9 +52,11 @@
 #include <algorithm>
 #include <cstring>
 #include <iterator>
+#include <list>
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace
@@ -329,16 +335,26 @@ class vtkSpreadSheetView::vtkInternals
   {
   public:
     vtkSmartPointer<vtkTable> Dataobject;
-    vtkTimeStamp RecentUseTime;
+    vtkIdType MemorySize; // in KiB
+    std::list<vtkIdType>::iterator RecentUsePosition;
   };
 
-  typedef std::map<vtkIdType, CacheInfo> CacheType;
+  typedef std::unordered_map<vtkIdType, CacheInfo> CacheType;
   CacheType CachedBlocks;
 
+  // cached block ids, from the most to the least recently used.
+  std::list<vtkIdType> RecentlyUsedBlocks;
+  vtkIdType CachedMemorySize = 0; // in KiB
+
 public:
   void ClearCache()
   {
     this->CachedBlocks.clear();
+    this->RecentlyUsedBlocks.clear();
+    this->CachedMemorySize = 0;
+    // blocks still on their way are out of date.
+    ++this->Generation;
+    this->PendingPrefetchBlock = -1;
     this->ColumnMetaData.clear();
     this->ColumnIndexMap.clear();
   }
@@ -388,34 +404,51 @@ public:
     CacheType::iterator iter = this->CachedBlocks.find(blockId);
     if (iter != this->CachedBlocks.end())
     {
-      iter->second.RecentUseTime.Modified();
+      this->RecentlyUsedBlocks.splice(
+        this->RecentlyUsedBlocks.begin(), this->RecentlyUsedBlocks, iter->second.RecentUsePosition);
       this->MostRecentlyAccessedBlock = blockId;
       return iter->second.Dataobject.GetPointer();
     }
     return NULL;
   }
 
-  vtkTable* AddToCache(vtkIdType blockId, vtkTable* data, vtkIdType max)
+  vtkIdType GetMostRecentBlockMemorySize() const
   {
-    CacheType::iterator iter = this->CachedBlocks.find(blockId);
-    if (iter != this->CachedBlocks.end())
+    if (this->RecentlyUsedBlocks.empty())
     {
-      this->CachedBlocks.erase(iter);
+      return 0;
     }
+    auto iter = this->CachedBlocks.find(this->RecentlyUsedBlocks.front());
+    return std::max<vtkIdType>(iter->second.MemorySize, 1);
+  }
+
+  vtkIdType GetCacheMemorySize() const { return this->CachedMemorySize; }
+
+  bool IsCached(vtkIdType blockId) const
+  {
+    return this->CachedBlocks.find(blockId) != this->CachedBlocks.end();
+  }
+
+  void RemoveFromCache(CacheType::iterator iter)
+  {
+    this->CachedMemorySize -= iter->second.MemorySize;
+    this->RecentlyUsedBlocks.erase(iter->second.RecentUsePosition);
+    this->CachedBlocks.erase(iter);
+  }
 
-    if (static_cast<vtkIdType>(this->CachedBlocks.size()) == max)
+  /**
+   * Adds a block to the cache, releasing least-recently-used blocks beyond
+   * memoryLimit. Prefetched blocks are not shown yet: they do not replace the
+   * most recently accessed block and go behind the visible blocks, which are
+   * all kept along with the new one.
+   */
+  vtkTable* AddToCache(
+    vtkIdType blockId, vtkTable* data, vtkIdType memoryLimit, bool prefetched = false)
+  {
+    CacheType::iterator iter = this->CachedBlocks.find(blockId);
+    if (iter != this->CachedBlocks.end())
     {
-      // remove least-recent-used block.
-      iter = this->CachedBlocks.begin();
-      CacheType::iterator iterToRemove = this->CachedBlocks.begin();
-      for (; iter != this->CachedBlocks.end(); ++iter)
-      {
-        if (iterToRemove->second.RecentUseTime > iter->second.RecentUseTime)
-        {
-          iterToRemove = iter;
-        }
-      }
-      this->CachedBlocks.erase(iterToRemove);
+      this->RemoveFromCache(iter);
     }
 
     CacheInfo info;
@@ -446,9 +479,47 @@ public:
     }
     info.Dataobject = clone;
     clone->FastDelete();
-    info.RecentUseTime.Modified();
+    info.MemorySize = static_cast<vtkIdType>(clone->GetActualMemorySize());
+    auto position = this->RecentlyUsedBlocks.begin();
+    if (prefetched)
+    {
+      for (vtkIdType visibleId = this->VisibleBlocks[1]; visibleId >= this->VisibleBlocks[0];
+           --visibleId)
+      {
+        auto visibleIter = this->CachedBlocks.find(visibleId);
+        if (visibleIter != this->CachedBlocks.end())
+        {
+          this->RecentlyUsedBlocks.splice(this->RecentlyUsedBlocks.begin(),
+            this->RecentlyUsedBlocks, visibleIter->second.RecentUsePosition);
+        }
+      }
+      position = std::find_if(this->RecentlyUsedBlocks.begin(), this->RecentlyUsedBlocks.end(),
+        [this](vtkIdType id) { return !this->IsVisible(id); });
+    }
+    info.RecentUsePosition = this->RecentlyUsedBlocks.insert(position, blockId);
     this->CachedBlocks[blockId] = info;
-    this->MostRecentlyAccessedBlock = blockId;
+    this->CachedMemorySize += info.MemorySize;
+
+    if (!prefetched || this->MostRecentlyAccessedBlock < 0)
+    {
+      this->MostRecentlyAccessedBlock = blockId;
+    }
+
+    // release least-recently-used blocks, but always keep the new one, the
+    // most recently accessed one and, for prefetched blocks, the visible ones.
+    auto lruIter = this->RecentlyUsedBlocks.end();
+    while (this->CachedMemorySize > memoryLimit && lruIter != this->RecentlyUsedBlocks.begin())
+    {
+      const vtkIdType lruId = *(--lruIter);
+      if (lruId != blockId && lruId != this->MostRecentlyAccessedBlock &&
+        !(prefetched && this->IsVisible(lruId)))
+      {
+        // step back to the next block first, erasing invalidates this iterator.
+        ++lruIter;
+        this->RemoveFromCache(this->CachedBlocks.find(lruId));
+      }
+    }
+
     if (this->CachedBlocks.size() == 1)
     {
       this->UpdateColumnMetaData(clone);
@@ -479,7 +550,78 @@ public:
     return self->FetchBlock(mrbId);
   }
 
+  /**
+   * Updates the range of visible blocks from the visible rows.
+   */
+  void UpdateVisibleBlocks(vtkSpreadSheetView* self)
+  {
+    const vtkIdType blockSize = self->TableStreamer->GetBlockSize();
+    const vtkIdType numRows = self->GetNumberOfRows();
+    if (this->VisibleRows[0] < 0 || numRows <= 0 || blockSize <= 0)
+    {
+      this->VisibleBlocks[0] = this->VisibleBlocks[1] = -1;
+      return;
+    }
+    const vtkIdType maxBlockId = (numRows - 1) / blockSize;
+    this->VisibleBlocks[0] = std::min(this->VisibleRows[0] / blockSize, maxBlockId);
+    this->VisibleBlocks[1] =
+      std::max(this->VisibleBlocks[0], std::min(this->VisibleRows[1] / blockSize, maxBlockId));
+  }
+
+  bool IsVisible(vtkIdType blockId) const
+  {
+    return blockId >= this->VisibleBlocks[0] && blockId <= this->VisibleBlocks[1];
+  }
+
+  /**
+   * Returns the blocks that should be cached: first the visible ones, then the
+   * ones that will be shown next when scrolling in the same direction, then
+   * one block in the opposite direction. UpdateVisibleBlocks() must be called
+   * first.
+   */
+  std::vector<vtkIdType> GetBlocksToPrefetch(vtkSpreadSheetView* self) const
+  {
+    std::vector<vtkIdType> blocks;
+    if (this->VisibleBlocks[0] < 0)
+    {
+      return blocks;
+    }
+
+    const vtkIdType blockSize = self->TableStreamer->GetBlockSize();
+    const vtkIdType maxBlockId = (self->GetNumberOfRows() - 1) / blockSize;
+    const vtkIdType firstBlock = this->VisibleBlocks[0];
+    const vtkIdType lastBlock = this->VisibleBlocks[1];
+    for (vtkIdType blockId = firstBlock; blockId <= lastBlock; ++blockId)
+    {
+      blocks.push_back(blockId);
+    }
+
+    const int numberOfPrefetchBlocks = self->GetNumberOfPrefetchBlocks();
+    const vtkIdType ahead = this->ScrollDirection > 0 ? lastBlock : firstBlock;
+    const vtkIdType behind = this->ScrollDirection > 0 ? firstBlock : lastBlock;
+    for (int cc = 1; cc <= numberOfPrefetchBlocks; ++cc)
+    {
+      blocks.push_back(ahead + cc * this->ScrollDirection);
+    }
+    if (numberOfPrefetchBlocks > 0)
+    {
+      blocks.push_back(behind - this->ScrollDirection);
+    }
+
+    blocks.erase(std::remove_if(blocks.begin(), blocks.end(),
+                   [maxBlockId](vtkIdType blockId) { return blockId < 0 || blockId > maxBlockId; }),
+      blocks.end());
+    return blocks;
+  }
+
   vtkIdType MostRecentlyAccessedBlock;
+  vtkIdType VisibleRows[2] = { -1, -1 };
+  vtkIdType VisibleBlocks[2] = { -1, -1 };
+  // block requested from the server and not received yet, if any.
+  vtkIdType PendingPrefetchBlock = -1;
+  // incremented when the cache is cleared, to drop blocks requested before.
+  vtkTypeUInt64 Generation = 0;
+  int ScrollDirection = 1;
   vtkWeakPointer<vtkSpreadSheetRepresentation> ActiveRepresentation;
   vtkCommand* Observer;
 
@@ -502,6 +644,53 @@ void FetchRMI(void* localArg, void* remoteArg, int remoteArgLength, int)
   }
 }
 
+// On the data server root: sends a prefetched block to the client.
+void PrefetchRMI(void* localArg, void* remoteArg, int remoteArgLength, int)
+{
+  assert(remoteArgLength == sizeof(vtkTypeUInt64) * 3);
+  (void)remoteArgLength;
+
+  auto arg = reinterpret_cast<vtkTypeUInt64*>(remoteArg);
+  vtkSpreadSheetView* self = reinterpret_cast<vtkSpreadSheetView*>(localArg);
+  if (static_cast<vtkTypeUInt32>(self->GetIdentifier()) == arg[0])
+  {
+    self->PrefetchBlockCallback(static_cast<vtkIdType>(arg[1]), arg[2]);
+  }
+}
+
+// On the client: receives a prefetched block, the { identifier, block,
+// generation } header is followed by the marshaled table, if any.
+void PrefetchedRMI(void* localArg, void* remoteArg, int remoteArgLength, int)
+{
+  const int headerLength = static_cast<int>(sizeof(vtkTypeUInt64) * 3);
+  assert(remoteArgLength >= headerLength);
+
+  vtkTypeUInt64 arg[3];
+  memcpy(arg, remoteArg, headerLength);
+  vtkSpreadSheetView* self = reinterpret_cast<vtkSpreadSheetView*>(localArg);
+  if (static_cast<vtkTypeUInt32>(self->GetIdentifier()) != arg[0])
+  {
+    return;
+  }
+
+  // without a table, the block is only no longer pending.
+  vtkSmartPointer<vtkTable> block;
+  if (remoteArgLength > headerLength)
+  {
+    vtkNew<vtkCharArray> buffer;
+    buffer->SetNumberOfValues(remoteArgLength - headerLength);
+    memcpy(buffer->GetPointer(0), reinterpret_cast<char*>(remoteArg) + headerLength,
+      remoteArgLength - headerLength);
+    block = vtkSmartPointer<vtkTable>::New();
+    if (!vtkCommunicator::UnMarshalDataObject(buffer, block))
+    {
+      vtkLogF(ERROR, "Could not read prefetched block %d.", static_cast<int>(arg[1]));
+      block = nullptr;
+    }
+  }
+  self->OnBlockPrefetched(static_cast<vtkIdType>(arg[1]), arg[2], block);
+}
+
 unsigned long vtkCountNumberOfRows(vtkDataObject* dobj)
 {
   vtkTable* table = vtkTable::SafeDownCast(dobj);
@@ -568,7 +757,11 @@ vtkSpreadSheetView::vtkSpreadSheetView()
   , ReductionFilter(vtkReductionFilter::New())
   , DeliveryFilter(vtkClientServerMoveData::New())
   , NumberOfRows(0)
+  , CacheMemoryLimit(65536)
+  , NumberOfPrefetchBlocks(2)
   , CRMICallbackTag(0)
+  , CRMIPrefetchCallbackTag(0)
+  , DRMICallbackTag(0)
   , PRMICallbackTag(0)
   , Identifier(0)
   , Internals(new vtkSpreadSheetView::vtkInternals())
@@ -589,6 +782,13 @@ vtkSpreadSheetView::vtkSpreadSheetView()
   if (auto cController = session->GetController(vtkPVSession::CLIENT))
   {
     this->CRMICallbackTag = cController->AddRMICallback(::FetchRMI, this, FETCH_BLOCK_TAG);
+    this->CRMIPrefetchCallbackTag =
+      cController->AddRMICallback(::PrefetchRMI, this, PREFETCH_BLOCK_TAG);
+  }
+  if (auto dController = session->GetController(vtkPVSession::DATA_SERVER_ROOT))
+  {
+    this->DRMICallbackTag =
+      dController->AddRMICallback(::PrefetchedRMI, this, PREFETCHED_BLOCK_TAG);
   }
   if (auto pController = vtkMultiProcessController::GetGlobalController())
   {
@@ -603,7 +803,15 @@ vtkSpreadSheetView::~vtkSpreadSheetView()
   if (auto cController = session ? session->GetController(vtkPVSession::CLIENT) : nullptr)
   {
     cController->RemoveRMICallback(this->CRMICallbackTag);
+    cController->RemoveRMICallback(this->CRMIPrefetchCallbackTag);
     this->CRMICallbackTag = 0;
+    this->CRMIPrefetchCallbackTag = 0;
+  }
+  if (auto dController =
+        session ? session->GetController(vtkPVSession::DATA_SERVER_ROOT) : nullptr)
+  {
+    dController->RemoveRMICallback(this->DRMICallbackTag);
+    this->DRMICallbackTag = 0;
   }
   if (auto pController = session ? vtkMultiProcessController::GetGlobalController() : nullptr)
   {
@@ -824,12 +1032,179 @@ vtkTable* vtkSpreadSheetView::FetchBlock(vtkIdType blockindex)
     block = this->FetchBlockCallback(blockindex);
     // use the block returned from the AddToCache since that is cleaned up
     // to have columns in correct order.
-    block = this->Internals->AddToCache(blockindex, block, 10);
+    block = this->Internals->AddToCache(blockindex, block, this->CacheMemoryLimit);
     this->InvokeEvent(vtkCommand::UpdateEvent, &blockindex);
   }
   return block;
 }
 
+//----------------------------------------------------------------------------
+vtkIdType vtkSpreadSheetView::GetCacheMemorySize()
+{
+  return this->Internals->GetCacheMemorySize();
+}
+
+//----------------------------------------------------------------------------
+void vtkSpreadSheetView::SetVisibleRows(vtkIdType firstRow, vtkIdType lastRow)
+{
+  auto& internals = *this->Internals;
+  if (firstRow >= 0 && internals.VisibleRows[0] >= 0 && firstRow != internals.VisibleRows[0])
+  {
+    internals.ScrollDirection = firstRow > internals.VisibleRows[0] ? 1 : -1;
+  }
+  internals.VisibleRows[0] = firstRow;
+  internals.VisibleRows[1] = std::max(firstRow, lastRow);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSpreadSheetView::PrefetchBlock()
+{
+  auto& internals = *this->Internals;
+  if (!internals.ActiveRepresentation)
+  {
+    return false;
+  }
+
+  // receive the blocks the data server has sent since the last call, without
+  // waiting for more.
+  auto dController = this->GetSession()->GetController(vtkPVSession::DATA_SERVER_ROOT);
+  auto dCommunicator =
+    dController ? vtkSocketCommunicator::SafeDownCast(dController->GetCommunicator()) : nullptr;
+  vtkSocket* dSocket = dCommunicator ? dCommunicator->GetSocket() : nullptr;
+  while (internals.PendingPrefetchBlock >= 0 && dSocket && dSocket->GetConnected())
+  {
+    int descriptor = dSocket->GetSocketDescriptor();
+    int selected = -1;
+    if (!dCommunicator->HasBufferredMessages() &&
+      vtkSocket::SelectSockets(&descriptor, 1, 1, &selected) <= 0)
+    {
+      break;
+    }
+    if (dController->ProcessRMIs(0, 1) != vtkMultiProcessController::RMI_NO_ERROR)
+    {
+      break;
+    }
+  }
+  if (internals.PendingPrefetchBlock >= 0)
+  {
+    // only one block is requested at a time.
+    return true;
+  }
+
+  internals.UpdateVisibleBlocks(this);
+  std::vector<vtkIdType> blocks = internals.GetBlocksToPrefetch(this);
+
+  // only prefetch as many blocks as the cache can hold, otherwise prefetched
+  // blocks would evict each other.
+  const vtkIdType blockMemorySize = internals.GetMostRecentBlockMemorySize();
+  if (blockMemorySize > 0)
+  {
+    const size_t maxBlocks =
+      static_cast<size_t>(std::max<vtkIdType>(this->CacheMemoryLimit / blockMemorySize, 1));
+    if (blocks.size() > maxBlocks)
+    {
+      blocks.resize(maxBlocks);
+    }
+  }
+
+  for (vtkIdType blockId : blocks)
+  {
+    if (!internals.IsCached(blockId))
+    {
+      if (dController)
+      {
+        // the data server root sends the block back once it is ready.
+        vtkTypeUInt64 data[3] = { this->Identifier, static_cast<vtkTypeUInt64>(blockId),
+          internals.Generation };
+        dController->TriggerRMIOnAllChildren(data, sizeof(vtkTypeUInt64) * 3, PREFETCH_BLOCK_TAG);
+        internals.PendingPrefetchBlock = blockId;
+      }
+      else
+      {
+        this->OnBlockPrefetched(blockId, internals.Generation, this->FetchBlockCallback(blockId));
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void vtkSpreadSheetView::PrefetchBlockCallback(vtkIdType blockindex, vtkTypeUInt64 generation)
+{
+  std::vector<char> message(sizeof(vtkTypeUInt64) * 3);
+  vtkTypeUInt64 header[3] = { this->Identifier, static_cast<vtkTypeUInt64>(blockindex),
+    generation };
+  memcpy(message.data(), header, sizeof(header));
+
+  if (this->Internals->ActiveRepresentation)
+  {
+    // satellites run the usual fetch, only the delivery differs on the root.
+    auto pController = vtkMultiProcessController::GetGlobalController();
+    if (pController && pController->GetLocalProcessId() == 0 &&
+      pController->GetNumberOfProcesses() > 1)
+    {
+      vtkTypeUInt64 data[2] = { this->Identifier, static_cast<vtkTypeUInt64>(blockindex) };
+      pController->TriggerRMIOnAllChildren(data, sizeof(vtkTypeUInt64) * 2, FETCH_BLOCK_TAG);
+    }
+
+    this->TableStreamer->SetBlock(blockindex);
+    this->TableStreamer->Modified();
+    this->TableSelectionMarker->SetFieldAssociation(this->FieldAssociation);
+    this->ReductionFilter->Modified();
+    this->ReductionFilter->Update();
+
+    vtkNew<vtkCharArray> buffer;
+    if (vtkCommunicator::MarshalDataObject(this->ReductionFilter->GetOutputDataObject(0), buffer))
+    {
+      message.insert(message.end(), buffer->GetPointer(0),
+        buffer->GetPointer(0) + buffer->GetNumberOfValues());
+    }
+  }
+
+  // always reply, so that the client does not wait for the block forever.
+  vtkMultiProcessController* cController = this->GetSession()->GetController(vtkPVSession::CLIENT);
+  if (auto composite = vtkCompositeMultiProcessController::SafeDownCast(cController))
+  {
+    // reply to the client that requested the block only.
+    cController = composite->GetActiveController();
+  }
+  if (cController)
+  {
+    cController->TriggerRMIOnAllChildren(
+      message.data(), static_cast<int>(message.size()), PREFETCHED_BLOCK_TAG);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkSpreadSheetView::OnBlockPrefetched(
+  vtkIdType blockindex, vtkTypeUInt64 generation, vtkTable* block)
+{
+  auto& internals = *this->Internals;
+  if (generation != internals.Generation)
+  {
+    // requested before the cache was cleared.
+    return;
+  }
+  if (internals.PendingPrefetchBlock == blockindex)
+  {
+    internals.PendingPrefetchBlock = -1;
+  }
+  if (!block || internals.IsCached(blockindex))
+  {
+    return;
+  }
+
+  internals.UpdateVisibleBlocks(this);
+  internals.AddToCache(blockindex, block, this->CacheMemoryLimit, /*prefetched=*/true);
+
+  // only rows that are shown need to be refreshed.
+  if (internals.IsVisible(blockindex))
+  {
+    this->InvokeEvent(vtkCommand::UpdateEvent, &blockindex);
+  }
+}
+
 //----------------------------------------------------------------------------
 vtkTable* vtkSpreadSheetView::FetchBlockCallback(vtkIdType blockindex)
 {
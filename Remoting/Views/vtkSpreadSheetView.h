@@ -191,6 +191,57 @@ public:
    */
   virtual bool IsDataValid(vtkIdType row, vtkIdType col);
 
+  //@{
+  /**
+   * Get/Set the memory budget, in KiB, for the blocks of rows cached on the
+   * client. When the budget is exceeded, the least recently used blocks are
+   * released; the most recently fetched block is always kept. The budget
+   * should allow for a few blocks more than the visible ones and the ones
+   * prefetched. Default is 65536 (64 MiB).
+   */
+  vtkSetClampMacro(CacheMemoryLimit, vtkIdType, 0, VTK_ID_MAX);
+  vtkGetMacro(CacheMemoryLimit, vtkIdType);
+  //@}
+
+  /**
+   * Returns the memory used by the blocks cached on the client, in KiB.
+   * \note CallOnClient
+   */
+  vtkIdType GetCacheMemorySize();
+
+  //@{
+  /**
+   * Get/Set the number of blocks to prefetch beyond the visible rows, in the
+   * direction the rows are scrolled. One block is also prefetched in the
+   * opposite direction. Set to 0 to disable prefetching. Default is 2.
+   */
+  vtkSetClampMacro(NumberOfPrefetchBlocks, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPrefetchBlocks, int);
+  //@}
+
+  /**
+   * Set the range of rows currently visible. This is used to guess the scroll
+   * direction and the blocks to prefetch.
+   * \note CallOnClient
+   */
+  void SetVisibleRows(vtkIdType firstRow, vtkIdType lastRow);
+
+  /**
+   * Prefetches the first block, among the visible ones and the ones expected
+   * to become visible next, that is not cached yet. Returns true if a block
+   * was requested or is still on its way, false if there is nothing left to
+   * prefetch, so this is meant to be called once scrolling has stopped, until
+   * it returns false. When connected to a server, the request does not wait
+   * for the block: the block is added to the cache by a later call, once the
+   * server has sent it. In builtin mode, the block is fetched right away.
+   * Prefetched blocks do not count as accessed and go behind the visible
+   * blocks in the cache: neither the visible blocks nor the block last
+   * accessed through GetValue() or IsAvailable() are released to make room
+   * for them.
+   * \note CallOnClient
+   */
+  bool PrefetchBlock();
+
   //***************************************************************************
   // Forwarded to vtkSortedTableStreamer.
   /**
@@ -226,6 +277,12 @@ public:
   // INTERNAL METHOD. Don't call directly.
   vtkTable* FetchBlockCallback(vtkIdType blockindex);
 
+  // INTERNAL METHOD. Don't call directly.
+  void PrefetchBlockCallback(vtkIdType blockindex, vtkTypeUInt64 generation);
+
+  // INTERNAL METHOD. Don't call directly.
+  void OnBlockPrefetched(vtkIdType blockindex, vtkTypeUInt64 generation, vtkTable* block);
+
 protected:
   vtkSpreadSheetView();
   ~vtkSpreadSheetView() override;
@@ -249,14 +306,20 @@ protected:
   vtkReductionFilter* ReductionFilter;
   vtkClientServerMoveData* DeliveryFilter;
   vtkIdType NumberOfRows;
+  vtkIdType CacheMemoryLimit;
+  int NumberOfPrefetchBlocks;
 
   unsigned long CRMICallbackTag;
+  unsigned long CRMIPrefetchCallbackTag;
+  unsigned long DRMICallbackTag;
   unsigned long PRMICallbackTag;
   vtkTypeUInt32 Identifier;
 
   enum
   {
-    FETCH_BLOCK_TAG = 394732
+    FETCH_BLOCK_TAG = 394732,
+    PREFETCH_BLOCK_TAG = 394733,
+    PREFETCHED_BLOCK_TAG = 394734
   };
 
 private:
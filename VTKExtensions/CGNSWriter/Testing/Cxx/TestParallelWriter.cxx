@@ -0,0 +1,119 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestParallelWriter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that each rank writes its piece as a separate zone of the same file.
+
+#include "TestFunctions.h"
+#include "vtkCGNSReader.h"
+#include "vtkCGNSWriter.h"
+#include "vtkMPIController.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPVTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+// the size of the piece of each rank is different, to check that each zone
+// holds the data of the right rank.
+int PieceSize(int rank)
+{
+  return 4 + rank;
+}
+
+int WriteAndRead(vtkDataObject* piece, const char* filename, int rank, int numRanks,
+  int (*check)(vtkMultiBlockDataSet*, int))
+{
+  vtkNew<vtkCGNSWriter> w;
+  w->SetFileName(filename);
+  w->SetInputData(piece);
+  int rc = w->Write();
+  if (rc != 1)
+  {
+    return EXIT_FAILURE;
+  }
+
+  if (rank != 0)
+  {
+    return EXIT_SUCCESS;
+  }
+
+  // read everything on the root process.
+  vtkNew<vtkCGNSReader> r;
+  r->SetController(nullptr);
+  r->SetFileName(filename);
+  r->EnableAllBases();
+  r->Update();
+
+  vtkMultiBlockDataSet* read = r->GetOutput();
+  vtk_assert(nullptr != read);
+  vtk_assert(1 == read->GetNumberOfBlocks());
+  vtkMultiBlockDataSet* base = vtkMultiBlockDataSet::SafeDownCast(read->GetBlock(0));
+  vtk_assert(nullptr != base);
+  vtk_assert(static_cast<unsigned int>(numRanks) == base->GetNumberOfBlocks());
+  for (int cc = 0; cc < numRanks; ++cc)
+  {
+    if (check(read, cc) != EXIT_SUCCESS)
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+int CheckUnstructuredGrid(vtkMultiBlockDataSet* read, int rank)
+{
+  return UnstructuredGridTest(read, 0, rank, PieceSize(rank));
+}
+
+int CheckPolyhedral(vtkMultiBlockDataSet* read, int rank)
+{
+  return PolyhedralTest(read, 0, rank);
+}
+}
+
+int TestParallelWriter(int argc, char* argv[])
+{
+  vtkMPIController* contr = vtkMPIController::New();
+  contr->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(contr);
+
+  const int rank = contr->GetLocalProcessId();
+  const int numRanks = contr->GetNumberOfProcesses();
+
+  vtkNew<vtkPVTestUtilities> u;
+  u->Initialize(argc, argv);
+
+  // hexahedra are written through the parallel CGNS API when available.
+  vtkNew<vtkUnstructuredGrid> ug;
+  Create(ug, PieceSize(rank));
+  const char* filename = u->GetTempFilePath("parallel_unstructured_grid.cgns");
+  int success = WriteAndRead(ug, filename, rank, numRanks, CheckUnstructuredGrid) == EXIT_SUCCESS;
+  delete[] filename;
+
+  // polyhedra are always gathered and written by the root process.
+  vtkNew<vtkUnstructuredGrid> ph;
+  CreatePolyhedral(ph);
+  filename = u->GetTempFilePath("parallel_polyhedral.cgns");
+  success = WriteAndRead(ph, filename, rank, numRanks, CheckPolyhedral) == EXIT_SUCCESS && success;
+  delete[] filename;
+
+  int allSuccess = 0;
+  contr->AllReduce(&success, &allSuccess, 1, vtkCommunicator::LOGICAL_AND_OP);
+
+  vtkMultiProcessController::SetGlobalController(nullptr);
+  contr->Finalize();
+  contr->Delete();
+  return allSuccess ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -19,12 +19,14 @@ See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
 
 #include "vtkCGNSWriter.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkArrayIteratorIncludes.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellTypes.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkDataArrayRange.h"
 #include "vtkDataObject.h"
 #include "vtkDataObjectTreeIterator.h"
 #include "vtkDoubleArray.h"
@@ -36,10 +38,13 @@ See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
 #include "vtkIntArray.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiPieceDataSet.h"
+#include "vtkMultiProcessController.h"
+#include "vtkMultiProcessStream.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
 #include "vtkStructuredGrid.h"
@@ -49,8 +54,19 @@ See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
 
 #include "vtk_cgns.h"
 
+// parallel writing through the cgp_* API requires a CGNS library built with
+// parallel support, and access to the MPI communicator.
+#if VTK_MODULE_ENABLE_VTK_ParallelMPI && defined(CG_BUILD_PARALLEL) && CG_BUILD_PARALLEL
+#define VTK_CGNS_WRITER_USE_PARALLEL_CGNS 1
+#include "vtkMPICommunicator.h"
+#else
+#define VTK_CGNS_WRITER_USE_PARALLEL_CGNS 0
+#endif
+
+#include <algorithm>
 #include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 using namespace std;
@@ -82,6 +98,116 @@ struct write_info
   }
 };
 
+// the elements of one type in an unstructured zone
+struct section_info
+{
+  CGNS_ENUMT(ElementType_t) Type;
+  cgsize_t Count;
+  vector<cgsize_t> Connectivity; // only set on the process that owns the zone
+  int Id;                        // node id, when writing in parallel
+  cgsize_t Start;
+
+  section_info()
+  {
+    Type = CGNS_ENUMV(ElementTypeNull);
+    Count = 0;
+    Id = 0;
+    Start = 0;
+  }
+};
+
+// a single component of a data array, written as a separate CGNS field
+struct field_info
+{
+  string Name;
+  vtkDataArray* Array; // only set on the process that owns the zone
+  int Component;
+  int Id; // node id, when writing in parallel
+
+  field_info(const string& name, vtkDataArray* array, int component)
+  {
+    Name = name;
+    Array = array;
+    Component = component;
+    Id = 0;
+  }
+};
+
+// a zone written by one of the processes when writing in parallel.
+// All processes know about all zones, only the owner has the data.
+struct zone_info
+{
+  string Name;
+  bool Structured;
+  bool Polygonal;
+  int IndexDim;
+  cgsize_t Dim[9]; // vertex sizes, followed by cell sizes, see cg_zone_write
+  vector<section_info> Sections;
+  vector<field_info> PointFields;
+  vector<field_info> CellFields;
+  vtkPointSet* Object; // only set on the process that owns the zone
+
+  // node ids, when writing in parallel. All processes create the same
+  // nodes, hence get the same ids.
+  int Id;
+  int CoordinateIds[3];
+  int PointSolutionId;
+  int CellSolutionId;
+
+  zone_info()
+  {
+    Structured = Polygonal = false;
+    IndexDim = 1;
+    std::fill(Dim, Dim + 9, 0);
+    Object = nullptr;
+    Id = PointSolutionId = CellSolutionId = 0;
+    std::fill(CoordinateIds, CoordinateIds + 3, 0);
+  }
+};
+
+struct base_info
+{
+  string Name;
+  int CellDim;
+  int Id; // node id, when writing in parallel
+  vector<zone_info> Zones;
+
+  base_info(const string& name, int cellDim)
+  {
+    Name = name;
+    CellDim = cellDim;
+    Id = 0;
+  }
+};
+
+namespace
+{
+struct CopyComponentWorker
+{
+  template <typename ArrayT>
+  void operator()(ArrayT* array, int comp, double* values)
+  {
+    for (const auto tuple : vtk::DataArrayTupleRange(array))
+    {
+      *values++ = static_cast<double>(tuple[comp]);
+    }
+  }
+};
+
+// copy one component of all tuples of an array to a contiguous buffer.
+// Always use double precision, even if data type is single precision,
+// see https://gitlab.kitware.com/paraview/paraview/-/issues/18827
+void CopyComponent(vtkDataArray* da, int comp, vector<double>& values)
+{
+  values.resize(static_cast<size_t>(da->GetNumberOfTuples()));
+  CopyComponentWorker worker;
+  if (!vtkArrayDispatch::Dispatch::Execute(da, worker, comp, values.data()))
+  {
+    worker(da, comp, values.data());
+  }
+}
+}
+
 class vtkCGNSWriter::vtkPrivate
 {
 public:
@@ -97,6 +223,13 @@ public:
   static bool WriteMultiBlock(vtkMultiBlockDataSet* mb, const char* file, string& error);
   static bool WriteMultiPiece(vtkMultiPieceDataSet* mp, const char* file, string& error);
 
+  // write the pieces of all processes to a file, with one zone per piece
+  static bool WriteParallel(vtkDataObject* input, const char* file, bool useHDF5,
+    vtkMultiProcessController* controller, string& error);
+
+  // the highest dimension of the cells in a data set
+  static int GetCellDimension(vtkDataSet* ds);
+
 protected:
   static bool WriteMultiBlock(write_info& info, vtkMultiBlockDataSet*, string& error);
   static bool WritePoints(write_info& info, vtkPoints* pts, string& error);
@@ -110,90 +243,268 @@ protected:
     write_info& info, vtkPointSet* grid, const char* zonename, string& error);
   static bool WritePolygonalZone(write_info& info, vtkPointSet* grid, string& error);
   static bool WriteCells(write_info& info, vtkPointSet* grid, string& error);
+
+  static CGNS_ENUMT(ElementType_t) GetElementType(unsigned char cellType);
+  static const char* GetSectionName(CGNS_ENUMT(ElementType_t) cg_elem);
+  static void BuildSections(vtkPointSet* grid, vector<section_info>& sections);
+  static void CollectFields(vtkDataSetAttributes* dsa, vector<field_info>& fields);
+  static bool IsPolygonal(vtkPointSet* grid);
+  static int GetStructuredDimensions(vtkStructuredGrid* sg, cgsize_t dim[9]);
+
+  static void InitializeBases(vtkDataObject* input, vector<base_info>& bases);
+  static void CollectZones(vtkDataObject* input, int rank, vector<base_info>& bases);
+  static void DescribeZone(zone_info& zone);
+  static void ExchangeZones(vtkMultiProcessController* controller, vector<base_info>& bases);
+  static bool WriteBases(write_info& info, vector<base_info>& bases, bool parallel, string& error);
+  static bool WriteGathered(
+    vtkDataObject* input, const char* file, vtkMultiProcessController* controller, string& error);
+#if VTK_CGNS_WRITER_USE_PARALLEL_CGNS
+  static bool AllSucceeded(vtkMultiProcessController* controller, bool success, string& error);
+  static bool WriteParallelCGNS(vtkMultiProcessController* controller,
+    vtkMPICommunicator* communicator, vector<base_info>& bases, const char* file, string& error);
+  static bool CreateZoneNodes(write_info& info, zone_info& zone, string& error);
+  static bool CreateFieldNodes(write_info& info, const char* solution,
+    CGNS_ENUMT(GridLocation_t) location, vector<field_info>& fields, int& solutionId,
+    string& error);
+  static bool WriteZoneData(
+    write_info& info, const base_info& base, const zone_info& zone, string& error);
+  static bool WriteFieldData(write_info& info, int solutionId, const vector<field_info>& fields,
+    const cgsize_t* size, string& error);
+#endif
 };
 
-bool vtkCGNSWriter::vtkPrivate::WriteCells(write_info& info, vtkPointSet* grid, string& error)
+CGNS_ENUMT(ElementType_t) vtkCGNSWriter::vtkPrivate::GetElementType(unsigned char cellType)
 {
-  if (!grid)
+  switch (cellType)
   {
-    error = "Grid pointer not valid.";
-    return false;
+    case VTK_TRIANGLE:
+      return CGNS_ENUMV(TRI_3);
+    case VTK_QUAD:
+      return CGNS_ENUMV(QUAD_4);
+    case VTK_PYRAMID:
+      return CGNS_ENUMV(PYRA_5);
+    case VTK_WEDGE:
+      return CGNS_ENUMV(PENTA_6);
+    case VTK_TETRA:
+      return CGNS_ENUMV(TETRA_4);
+    case VTK_HEXAHEDRON:
+      return CGNS_ENUMV(HEXA_8);
+    default:
+      return CGNS_ENUMV(ElementTypeNull);
   }
+}
 
-  if (info.WritePolygonalZone)
+const char* vtkCGNSWriter::vtkPrivate::GetSectionName(CGNS_ENUMT(ElementType_t) cg_elem)
+{
+  switch (cg_elem)
   {
-    return WritePolygonalZone(info, grid, error);
+    case CGNS_ENUMV(TRI_3):
+      return "Elem_Triangles";
+    case CGNS_ENUMV(QUAD_4):
+      return "Elem_Quads";
+    case CGNS_ENUMV(PYRA_5):
+      return "Elem_Pyramids";
+    case CGNS_ENUMV(PENTA_6):
+      return "Elem_Wedges";
+    case CGNS_ENUMV(TETRA_4):
+      return "Elem_Tetras";
+    case CGNS_ENUMV(HEXA_8):
+      return "Elem_Hexas";
+    default:
+      return nullptr;
   }
+}
 
+void vtkCGNSWriter::vtkPrivate::BuildSections(vtkPointSet* grid, vector<section_info>& sections)
+{
   // create a mapping of celltype to a list of cells of that type
-  // then, write each cell type into a different section of the zone.
+  // then, each cell type becomes a different section of the zone.
   map<unsigned char, vector<vtkIdType> > cellTypeMap;
-  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+  const vtkIdType nCells = grid->GetNumberOfCells();
+  for (vtkIdType i = 0; i < nCells; ++i)
   {
-    unsigned char cellType = grid->GetCellType(i);
-    cellTypeMap[cellType].push_back(i);
+    cellTypeMap[grid->GetCellType(i)].push_back(i);
   }
 
-  cgsize_t nCellsWritten(CGNS_COUNTING_OFFSET);
+  vtkNew<vtkIdList> ptIds;
   for (auto& entry : cellTypeMap)
   {
-    unsigned char cellType = entry.first;
-    CGNS_ENUMT(ElementType_t) cg_elem(CGNS_ENUMV(ElementTypeNull));
-    const char* sectionname(nullptr);
-    switch (cellType)
-    {
-      case VTK_TRIANGLE:
-        cg_elem = CGNS_ENUMV(TRI_3);
-        sectionname = "Elem_Triangles";
-        break;
-      case VTK_QUAD:
-        cg_elem = CGNS_ENUMV(QUAD_4);
-        sectionname = "Elem_Quads";
-        break;
-      case VTK_PYRAMID:
-        cg_elem = CGNS_ENUMV(PYRA_5);
-        sectionname = "Elem_Pyramids";
-        break;
-      case VTK_WEDGE:
-        cg_elem = CGNS_ENUMV(PENTA_6);
-        sectionname = "Elem_Wedges";
-        break;
-      case VTK_TETRA:
-        cg_elem = CGNS_ENUMV(TETRA_4);
-        sectionname = "Elem_Tetras";
-        break;
-      case VTK_HEXAHEDRON:
-        cg_elem = CGNS_ENUMV(HEXA_8);
-        sectionname = "Elem_Hexas";
-        break;
-      default:
-        // report error?
-        continue;
+    CGNS_ENUMT(ElementType_t) cg_elem = GetElementType(entry.first);
+    if (cg_elem == CGNS_ENUMV(ElementTypeNull))
+    {
+      // report error?
+      continue;
     }
 
-    const vector<vtkIdType>& cellIdsOfType = entry.second;
-    vector<cgsize_t> cellsOfTypeArray;
+    int nPtsPerCell(0);
+    cg_npe(cg_elem, &nPtsPerCell);
 
+    const vector<vtkIdType>& cellIdsOfType = entry.second;
+    section_info section;
+    section.Type = cg_elem;
+    section.Count = static_cast<cgsize_t>(cellIdsOfType.size());
+    section.Connectivity.resize(cellIdsOfType.size() * nPtsPerCell);
+
+    // copy the point ids straight from the cells' connectivity, instead of
+    // instantiating a vtkCell for every cell.
+    cgsize_t* connectivity = section.Connectivity.data();
     for (auto& cellId : cellIdsOfType)
     {
-      vtkCell* cell = grid->GetCell(cellId);
-      int nIds = cell->GetNumberOfPoints();
+      grid->GetCellPoints(cellId, ptIds);
+      const vtkIdType* ids = ptIds->GetPointer(0);
+      connectivity = std::transform(ids, ids + nPtsPerCell, connectivity,
+        [](vtkIdType id) { return static_cast<cgsize_t>(id + CGNS_COUNTING_OFFSET); });
+    }
+    sections.push_back(std::move(section));
+  }
+}
+
+void vtkCGNSWriter::vtkPrivate::CollectFields(
+  vtkDataSetAttributes* dsa, vector<field_info>& fields)
+{
+  for (int i = 0; i < dsa->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* da = dsa->GetArray(i);
+    if (!da)
+      continue;
+
+    if (da->GetNumberOfComponents() == 1)
+    {
+      fields.push_back(field_info(da->GetName(), da, 0));
+    }
+    else if (da->GetNumberOfComponents() == 3)
+    {
+      // here we have to stripe the XYZ values, same as with the vertices.
+      const char* const components[3] = { "X", "Y", "Z" };
+      string fieldName = da->GetName();
+      for (int idx = 0; idx < 3; ++idx)
+      {
+        fields.push_back(field_info(fieldName + components[idx], da, idx));
+      }
+    }
+    else
+    {
+      vtkWarningWithObjectMacro(nullptr, << " Field " << da->GetName() << " has "
+                                         << da->GetNumberOfComponents()
+                                         << " components, which is not supported. Skipping...");
+    }
+  }
+}
+
+bool vtkCGNSWriter::vtkPrivate::IsPolygonal(vtkPointSet* grid)
+{
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+  {
+    unsigned char cellType = grid->GetCellType(i);
+    if (cellType == VTK_POLYHEDRON || cellType == VTK_POLYGON)
+    {
+      return true;
+    }
+  }
+  return false;
+}
 
-      for (int j = 0; j < nIds; ++j)
+int vtkCGNSWriter::vtkPrivate::GetCellDimension(vtkDataSet* ds)
+{
+  int cellDim = 3;
+  if (ds->IsA("vtkPolyData"))
+  {
+    cellDim = 2;
+  }
+  else if (ds->IsA("vtkStructuredGrid"))
+  {
+    int* dims = vtkStructuredGrid::SafeDownCast(ds)->GetDimensions();
+    cellDim = 0;
+    for (int n = 0; n < 3; n++)
+    {
+      if (dims[n] > 1)
+      {
+        cellDim += 1;
+      }
+    }
+  }
+  else if (ds->IsA("vtkUnstructuredGrid"))
+  {
+    cellDim = 1;
+    for (vtkIdType n = 0; n < ds->GetNumberOfCells(); ++n)
+    {
+      vtkCell* cell = ds->GetCell(n);
+      int curCellDim = cell->GetCellDimension();
+      if (cellDim < curCellDim)
       {
-        cellsOfTypeArray.push_back(
-          static_cast<cgsize_t>(cell->GetPointId(j) + CGNS_COUNTING_OFFSET));
+        cellDim = curCellDim;
       }
     }
+  }
+  return cellDim;
+}
+
+int vtkCGNSWriter::vtkPrivate::GetStructuredDimensions(vtkStructuredGrid* sg, cgsize_t dim[9])
+{
+  int* pointDims = sg->GetDimensions();
+  int cellDims[3];
+  int j;
+
+  sg->GetCellDims(cellDims);
+
+  // init dimensions
+  for (int i = 0; i < 3; ++i)
+  {
+    dim[0 * 3 + i] = 1;
+    dim[1 * 3 + i] = 0;
+    dim[2 * 3 + i] = 0; // always 0 for structured
+  }
+  j = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    // skip unitary index dimension
+    if (pointDims[i] == 1)
+    {
+      continue;
+    }
+    dim[0 * 3 + j] = pointDims[i];
+    dim[1 * 3 + j] = cellDims[i];
+    j++;
+  }
+  // Repacking dimension in case j < 3 because CGNS expects a resized dim matrix
+  // For instance if j == 2 then move from 3x3 matrix to 3x2 matrix
+  for (int k = 1; (k < 3) && (j < 3); ++k)
+  {
+    for (int i = 0; i < j; ++i)
+    {
+      dim[j * k + i] = dim[3 * k + i];
+    }
+  }
+  return j;
+}
 
+bool vtkCGNSWriter::vtkPrivate::WriteCells(write_info& info, vtkPointSet* grid, string& error)
+{
+  if (!grid)
+  {
+    error = "Grid pointer not valid.";
+    return false;
+  }
+
+  if (info.WritePolygonalZone)
+  {
+    return WritePolygonalZone(info, grid, error);
+  }
+
+  vector<section_info> sections;
+  BuildSections(grid, sections);
+
+  cgsize_t nCellsWritten(CGNS_COUNTING_OFFSET);
+  for (auto& section : sections)
+  {
     int dummy(0);
     cgsize_t start(nCellsWritten);
-    cgsize_t end(static_cast<cgsize_t>(nCellsWritten + cellIdsOfType.size() - 1));
+    cgsize_t end(nCellsWritten + section.Count - 1);
     int nBoundary(0);
-    cg_check_operation(cg_section_write(info.F, info.B, info.Z, sectionname, cg_elem, start, end,
-      nBoundary, cellsOfTypeArray.data(), &dummy));
+    cg_check_operation(cg_section_write(info.F, info.B, info.Z, GetSectionName(section.Type),
+      section.Type, start, end, nBoundary, section.Connectivity.data(), &dummy));
 
-    nCellsWritten += cellIdsOfType.size();
+    nCellsWritten += section.Count;
   }
 
   return true;
@@ -317,16 +628,7 @@ bool vtkCGNSWriter::vtkPrivate::WritePointSet(
   cgsize_t nCells = static_cast<cgsize_t>(grid->GetNumberOfCells());
   cgsize_t dim[3] = { nPts, nCells, 0 };
 
-  bool isPolygonal(false);
-  for (int i = 0; i < grid->GetNumberOfCells(); ++i)
-  {
-    vtkCell* cell = grid->GetCell(i);
-    unsigned char cellType = cell->GetCellType();
-
-    isPolygonal |= cellType == VTK_POLYHEDRON;
-    isPolygonal |= cellType == VTK_POLYGON;
-  }
-  info.WritePolygonalZone = isPolygonal;
+  info.WritePolygonalZone = IsPolygonal(grid);
 
   cg_check_operation(
     cg_zone_write(info.F, info.B, zonename, dim, CGNS_ENUMV(Unstructured), &(info.Z)));
@@ -359,23 +661,7 @@ bool vtkCGNSWriter::vtkPrivate::WritePointSet(
 bool vtkCGNSWriter::vtkPrivate::WritePointSet(vtkPointSet* grid, const char* file, string& error)
 {
   write_info info;
-  if (grid->IsA("vtkPolyData"))
-  {
-    info.CellDim = 2;
-  }
-  else if (grid->IsA("vtkUnstructuredGrid"))
-  {
-    info.CellDim = 1;
-    for (int i = 0; i < grid->GetNumberOfCells(); ++i)
-    {
-      vtkCell* cell = grid->GetCell(i);
-      int cellDim = cell->GetCellDimension();
-      if (info.CellDim < cellDim)
-      {
-        info.CellDim = cellDim;
-      }
-    }
-  }
+  info.CellDim = GetCellDimension(grid);
 
   if (!InitCGNSFile(info, file, error))
   {
@@ -400,66 +686,19 @@ bool vtkCGNSWriter::vtkPrivate::WriteFieldArray(write_info& info, const char* so
     return false;
   }
 
-  int nArr = dsa->GetNumberOfArrays();
-  if (nArr > 0)
+  vector<field_info> fields;
+  CollectFields(dsa, fields);
+  if (!fields.empty())
   {
     vector<double> temp;
 
     int dummy(0);
     cg_check_operation(cg_sol_write(info.F, info.B, info.Z, solution, location, &(info.Sol)));
-    for (int i = 0; i < nArr; ++i)
+    for (auto& field : fields)
     {
-      vtkDataArray* da = dsa->GetArray(i);
-      if (!da)
-        continue;
-
-      temp.reserve(da->GetNumberOfTuples());
-      if (da->GetNumberOfComponents() != 1)
-      {
-        string fieldName = da->GetName();
-        if (da->GetNumberOfComponents() == 3)
-        {
-          // here we have to stripe the XYZ values, same as with the vertices.
-          const char* const components[3] = { "X", "Y", "Z" };
-
-          for (int idx = 0; idx < 3; ++idx)
-          {
-            for (vtkIdType t = 0; t < da->GetNumberOfTuples(); ++t)
-            {
-              double* tpl = da->GetTuple(t);
-              temp.push_back(tpl[idx]);
-            }
-
-            string fieldComponentName = fieldName + components[idx];
-
-            cg_check_operation(cg_field_write(info.F, info.B, info.Z, info.Sol,
-              CGNS_ENUMV(RealDouble), fieldComponentName.c_str(), temp.data(), &dummy));
-
-            temp.clear();
-          }
-        }
-        else
-        {
-          vtkWarningWithObjectMacro(nullptr, << " Field " << da->GetName() << " has "
-                                             << da->GetNumberOfComponents()
-                                             << " components, which is not supported. Skipping...");
-        }
-      }
-      else // 1-component field data.
-      {
-        // force to double precision, even if data type is single precision,
-        // see https://gitlab.kitware.com/paraview/paraview/-/issues/18827
-        for (vtkIdType t = 0; t < da->GetNumberOfTuples(); ++t)
-        {
-          double* tpl = da->GetTuple(t);
-          temp.push_back(*tpl);
-        }
-
-        cg_check_operation(cg_field_write(info.F, info.B, info.Z, info.Sol, CGNS_ENUMV(RealDouble),
-          da->GetName(), temp.data(), &dummy));
-
-        temp.clear();
-      }
+      CopyComponent(field.Array, field.Component, temp);
+      cg_check_operation(cg_field_write(info.F, info.B, info.Z, info.Sol, CGNS_ENUMV(RealDouble),
+        field.Name.c_str(), temp.data(), &dummy));
     }
   }
   return true;
@@ -467,36 +706,17 @@ bool vtkCGNSWriter::vtkPrivate::WriteFieldArray(write_info& info, const char* so
 
 bool vtkCGNSWriter::vtkPrivate::WritePoints(write_info& info, vtkPoints* pts, string& error)
 {
-  // is there a better way to do this, other than creating temp array and striping X, Y an Z into
-  // separate arrays?
-  // maybe using the low-level API where I think a stride can be given while writing.
+  // CGNS stores each coordinate in a separate array, so stripe X, Y and Z.
   const char* names[3] = { "CoordinateX", "CoordinateY", "CoordinateZ" };
 
-  double* temp = new (nothrow) double[pts->GetNumberOfPoints()];
-  if (!temp)
-  {
-    error = "Failed to allocate temporary array";
-    return false;
-  }
-
+  vector<double> temp;
   for (int idx = 0; idx < 3; ++idx)
   {
-    for (vtkIdType i = 0; i < pts->GetNumberOfPoints(); ++i)
-    {
-      double* xyz = pts->GetPoint(i);
-      temp[i] = xyz[idx];
-    }
+    CopyComponent(pts->GetData(), idx, temp);
     int dummy(0);
-    if (CG_OK !=
-      cg_coord_write(info.F, info.B, info.Z, CGNS_ENUMV(RealDouble), names[idx], temp, &dummy))
-    {
-      delete[] temp; // don't leak
-      error = cg_get_error();
-      return false;
-    }
+    cg_check_operation(cg_coord_write(
+      info.F, info.B, info.Z, CGNS_ENUMV(RealDouble), names[idx], temp.data(), &dummy));
   }
-
-  delete[] temp; // don't leak
   return true;
 }
 
@@ -518,46 +738,12 @@ bool vtkCGNSWriter::vtkPrivate::WriteStructuredGrid(
   cgsize_t dim[9];
 
   // set the dimensions
-  int* pointDims = sg->GetDimensions();
-  int cellDims[3];
-  int j;
-
-  sg->GetCellDims(cellDims);
-
-  if (!pointDims)
+  if (!sg->GetDimensions())
   {
     error = "Failed to get vertex dimensions.";
     return false;
   }
-
-  // init dimensions
-  for (int i = 0; i < 3; ++i)
-  {
-    dim[0 * 3 + i] = 1;
-    dim[1 * 3 + i] = 0;
-    dim[2 * 3 + i] = 0; // always 0 for structured
-  }
-  j = 0;
-  for (int i = 0; i < 3; ++i)
-  {
-    // skip unitary index dimension
-    if (pointDims[i] == 1)
-    {
-      continue;
-    }
-    dim[0 * 3 + j] = pointDims[i];
-    dim[1 * 3 + j] = cellDims[i];
-    j++;
-  }
-  // Repacking dimension in case j < 3 because CGNS expects a resized dim matrix
-  // For instance if j == 2 then move from 3x3 matrix to 3x2 matrix
-  for (int k = 1; (k < 3) && (j < 3); ++k)
-  {
-    for (int i = 0; i < j; ++i)
-    {
-      dim[j * k + i] = dim[3 * k + i];
-    }
-  }
+  GetStructuredDimensions(sg, dim);
 
   // create the structured zone. Cells are implicit
   cg_check_operation(
@@ -586,15 +772,7 @@ bool vtkCGNSWriter::vtkPrivate::WriteStructuredGrid(
   vtkStructuredGrid* sg, const char* file, string& error)
 {
   write_info info;
-  int* dims = sg->GetDimensions();
-  info.CellDim = 0;
-  for (int n = 0; n < 3; n++)
-  {
-    if (dims[n] > 1)
-    {
-      info.CellDim += 1;
-    }
-  }
+  info.CellDim = GetCellDimension(sg);
   if (!InitCGNSFile(info, file, error) || !WriteBase(info, "Base", error))
   {
     return false;
@@ -676,32 +854,10 @@ void Flatten(vtkMultiBlockDataSet* mb, vector<entry>& o2d, vector<entry>& o3d, i
     else if (block)
     {
       int CellDim = 3;
-      if (block->IsA("vtkStructuredGrid"))
-      {
-        vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(block);
-        int* dims = sg->GetDimensions();
-        CellDim = 0;
-        for (int n = 0; n < 3; n++)
-        {
-          if (dims[n] > 1)
-          {
-            CellDim += 1;
-          }
-        }
-      }
-      else if (block->IsA("vtkUnstructuredGrid"))
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(block);
+      if (ds)
       {
-        vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(block);
-        CellDim = 1;
-        for (int n = 0; n < ug->GetNumberOfCells(); ++n)
-        {
-          vtkCell* cell = ug->GetCell(n);
-          int curCellDim = cell->GetCellDimension();
-          if (CellDim < curCellDim)
-          {
-            CellDim = curCellDim;
-          }
-        }
+        CellDim = vtkCGNSWriter::vtkPrivate::GetCellDimension(ds);
       }
       if (CellDim == 3)
       {
@@ -814,13 +970,483 @@ bool vtkCGNSWriter::vtkPrivate::WriteMultiPiece(
   return false;
 }
 
+void vtkCGNSWriter::vtkPrivate::InitializeBases(vtkDataObject* input, vector<base_info>& bases)
+{
+  if (vtkMultiBlockDataSet::SafeDownCast(input))
+  {
+    bases.push_back(base_info("Base_Volume_Elements", 3));
+    bases.push_back(base_info("Base_Surface_Elements", 2));
+  }
+  else
+  {
+    // the cell dimension is the highest dimension of all pieces.
+    bases.push_back(base_info("Base", 0));
+  }
+}
+
+void vtkCGNSWriter::vtkPrivate::CollectZones(
+  vtkDataObject* input, int rank, vector<base_info>& bases)
+{
+  // zones must be unique in a base, hence the rank is appended to the name
+  // of the zones of a multi-block dataset.
+  const string suffix = "_" + to_string(rank);
+  auto addZones = [&suffix](const vector<entry>& blocks, base_info& base) {
+    for (auto& e : blocks)
+    {
+      vtkPointSet* ps = vtkPointSet::SafeDownCast(e.obj);
+      if (!ps)
+      {
+        vtkWarningWithObjectMacro(nullptr, << "Writing of block type '" << e.obj->GetClassName()
+                                           << "' not supported. Skipping...");
+        continue;
+      }
+      // empty pieces are not written, CGNS does not allow empty zones.
+      if (ps->GetNumberOfPoints() == 0)
+      {
+        continue;
+      }
+      zone_info zone;
+      zone.Name = e.name.substr(0, 32 - suffix.length()) + suffix;
+      zone.Object = ps;
+      base.Zones.push_back(zone);
+    }
+  };
+
+  if (vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(input))
+  {
+    vector<entry> surfaceBlocks, volumeBlocks;
+    Flatten(mb, surfaceBlocks, volumeBlocks, 0);
+    addZones(volumeBlocks, bases[0]);
+    addZones(surfaceBlocks, bases[1]);
+  }
+  else if (vtkPointSet* ps = vtkPointSet::SafeDownCast(input))
+  {
+    if (ps->GetNumberOfPoints() > 0)
+    {
+      bases[0].CellDim = std::max(bases[0].CellDim, GetCellDimension(ps));
+
+      zone_info zone;
+      zone.Name = "Zone " + to_string(rank + 1);
+      zone.Object = ps;
+      bases[0].Zones.push_back(zone);
+    }
+  }
+}
+
+void vtkCGNSWriter::vtkPrivate::DescribeZone(zone_info& zone)
+{
+  vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(zone.Object);
+  if (sg)
+  {
+    zone.Structured = true;
+    zone.IndexDim = GetStructuredDimensions(sg, zone.Dim);
+  }
+  else
+  {
+    zone.IndexDim = 1;
+    zone.Dim[0] = static_cast<cgsize_t>(zone.Object->GetNumberOfPoints());
+    zone.Dim[1] = static_cast<cgsize_t>(zone.Object->GetNumberOfCells());
+    zone.Dim[2] = 0;
+    zone.Polygonal = IsPolygonal(zone.Object);
+    if (!zone.Polygonal)
+    {
+      BuildSections(zone.Object, zone.Sections);
+    }
+  }
+  CollectFields(zone.Object->GetPointData(), zone.PointFields);
+  CollectFields(zone.Object->GetCellData(), zone.CellFields);
+}
+
+void vtkCGNSWriter::vtkPrivate::ExchangeZones(
+  vtkMultiProcessController* controller, vector<base_info>& bases)
+{
+  // every process needs the description of all zones, since the CGNS
+  // nodes are created collectively.
+  vtkMultiProcessStream stream;
+  for (auto& base : bases)
+  {
+    stream << base.CellDim << static_cast<int>(base.Zones.size());
+    for (auto& zone : base.Zones)
+    {
+      stream << zone.Name << zone.Structured << zone.Polygonal << zone.IndexDim;
+      for (int i = 0; i < 3 * zone.IndexDim; ++i)
+      {
+        stream << static_cast<vtkTypeInt64>(zone.Dim[i]);
+      }
+      stream << static_cast<int>(zone.Sections.size());
+      for (auto& section : zone.Sections)
+      {
+        stream << static_cast<int>(section.Type) << static_cast<vtkTypeInt64>(section.Count);
+      }
+      for (auto fields : { &zone.PointFields, &zone.CellFields })
+      {
+        stream << static_cast<int>(fields->size());
+        for (auto& field : *fields)
+        {
+          stream << field.Name;
+        }
+      }
+    }
+  }
+
+  vector<vtkMultiProcessStream> streams;
+  controller->AllGather(stream, streams);
+
+  const int rank = controller->GetLocalProcessId();
+  vector<base_info> allBases;
+  for (auto& base : bases)
+  {
+    allBases.push_back(base_info(base.Name, base.CellDim));
+  }
+  for (int r = 0; r < static_cast<int>(streams.size()); ++r)
+  {
+    vtkMultiProcessStream& rstream = streams[r];
+    for (size_t b = 0; b < allBases.size(); ++b)
+    {
+      int cellDim, nZones;
+      rstream >> cellDim >> nZones;
+      allBases[b].CellDim = std::max(allBases[b].CellDim, cellDim);
+      for (int z = 0; z < nZones; ++z)
+      {
+        zone_info zone;
+        rstream >> zone.Name >> zone.Structured >> zone.Polygonal >> zone.IndexDim;
+        for (int i = 0; i < 3 * zone.IndexDim; ++i)
+        {
+          vtkTypeInt64 dim;
+          rstream >> dim;
+          zone.Dim[i] = static_cast<cgsize_t>(dim);
+        }
+        int nSections;
+        rstream >> nSections;
+        zone.Sections.resize(nSections);
+        for (auto& section : zone.Sections)
+        {
+          int type;
+          vtkTypeInt64 count;
+          rstream >> type >> count;
+          section.Type = static_cast<CGNS_ENUMT(ElementType_t)>(type);
+          section.Count = static_cast<cgsize_t>(count);
+        }
+        for (auto fields : { &zone.PointFields, &zone.CellFields })
+        {
+          int nFields;
+          rstream >> nFields;
+          for (int f = 0; f < nFields; ++f)
+          {
+            string name;
+            rstream >> name;
+            fields->push_back(field_info(name, nullptr, 0));
+          }
+        }
+
+        // the local zones keep their data.
+        allBases[b].Zones.push_back(r == rank ? std::move(bases[b].Zones[z]) : std::move(zone));
+      }
+    }
+  }
+  bases.swap(allBases);
+}
+
+bool vtkCGNSWriter::vtkPrivate::WriteBases(
+  write_info& info, vector<base_info>& bases, bool parallel, string& error)
+{
+#if !VTK_CGNS_WRITER_USE_PARALLEL_CGNS
+  (void)parallel;
+#endif
+  for (auto& base : bases)
+  {
+    if (base.Zones.empty())
+    {
+      continue;
+    }
+
+    info.CellDim = base.CellDim;
+    if (!WriteBase(info, base.Name.c_str(), error))
+    {
+      return false;
+    }
+    base.Id = info.B;
+
+    for (auto& zone : base.Zones)
+    {
+#if VTK_CGNS_WRITER_USE_PARALLEL_CGNS
+      if (parallel)
+      {
+        if (!CreateZoneNodes(info, zone, error))
+        {
+          return false;
+        }
+        continue;
+      }
+#endif
+      vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(zone.Object);
+      if (sg ? !WriteStructuredGrid(info, sg, zone.Name.c_str(), error)
+             : !WritePointSet(info, zone.Object, zone.Name.c_str(), error))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool vtkCGNSWriter::vtkPrivate::WriteGathered(
+  vtkDataObject* input, const char* file, vtkMultiProcessController* controller, string& error)
+{
+  // the root process writes the pieces of all processes, one zone per piece.
+  vector<vtkSmartPointer<vtkDataObject> > pieces;
+  controller->Gather(input, pieces, 0);
+
+  int rc = 1;
+  if (controller->GetLocalProcessId() == 0)
+  {
+    vector<base_info> bases;
+    InitializeBases(input, bases);
+    for (size_t r = 0; r < pieces.size(); ++r)
+    {
+      CollectZones(pieces[r], static_cast<int>(r), bases);
+    }
+
+    write_info info;
+    rc = InitCGNSFile(info, file, error) && WriteBases(info, bases, false, error) ? 1 : 0;
+    if (info.F != 0 && CG_OK != cg_close(info.F) && rc)
+    {
+      error = cg_get_error();
+      rc = 0;
+    }
+  }
+
+  controller->Broadcast(&rc, 1, 0);
+  if (!rc && error.empty())
+  {
+    error = "Writing failed on the root process.";
+  }
+  return rc != 0;
+}
+
+#if VTK_CGNS_WRITER_USE_PARALLEL_CGNS
+bool vtkCGNSWriter::vtkPrivate::AllSucceeded(
+  vtkMultiProcessController* controller, bool success, string& error)
+{
+  // all processes go on with the next collective step, or all stop.
+  int local(success ? 1 : 0), global(0);
+  controller->AllReduce(&local, &global, 1, vtkCommunicator::MIN_OP);
+  if (success && !global)
+  {
+    error = "Writing failed on another process.";
+  }
+  return global != 0;
+}
+
+bool vtkCGNSWriter::vtkPrivate::WriteParallelCGNS(vtkMultiProcessController* controller,
+  vtkMPICommunicator* communicator, vector<base_info>& bases, const char* file, string& error)
+{
+  // a process leaving a collective call out would hang the others, hence the
+  // processes agree on the outcome of each step, and always close the file.
+  write_info info;
+  bool opened = CG_OK == cgp_mpi_comm(*communicator->GetMPIComm()->GetHandle()) &&
+    CG_OK == cgp_pio_mode(CGP_COLLECTIVE) && CG_OK == cgp_open(file, CG_MODE_WRITE, &(info.F));
+  if (!opened)
+  {
+    error = cg_get_error();
+  }
+  if (!AllSucceeded(controller, opened, error))
+  {
+    if (opened)
+    {
+      cgp_close(info.F);
+    }
+    return false;
+  }
+
+  // the nodes of all zones are created collectively. Every process has the
+  // same description of the zones, hence creates the same nodes.
+  bool written = AllSucceeded(controller, WriteBases(info, bases, true, error), error);
+
+  // the data of a zone is then written by its owner alone.
+  if (written)
+  {
+    written = CG_OK == cgp_pio_mode(CGP_INDEPENDENT);
+    if (!written)
+    {
+      error = cg_get_error();
+    }
+    for (auto& base : bases)
+    {
+      for (auto& zone : base.Zones)
+      {
+        if (written && zone.Object)
+        {
+          written = WriteZoneData(info, base, zone, error);
+        }
+      }
+    }
+    written = AllSucceeded(controller, written, error);
+  }
+
+  const bool closed = CG_OK == cgp_close(info.F);
+  if (written && !closed)
+  {
+    error = cg_get_error();
+  }
+  return AllSucceeded(controller, written && closed, error);
+}
+
+bool vtkCGNSWriter::vtkPrivate::CreateZoneNodes(write_info& info, zone_info& zone, string& error)
+{
+  cg_check_operation(cg_zone_write(info.F, info.B, zone.Name.c_str(), zone.Dim,
+    zone.Structured ? CGNS_ENUMV(Structured) : CGNS_ENUMV(Unstructured), &(zone.Id)));
+  info.Z = zone.Id;
+
+  const char* names[3] = { "CoordinateX", "CoordinateY", "CoordinateZ" };
+  for (int idx = 0; idx < 3; ++idx)
+  {
+    cg_check_operation(cgp_coord_write(
+      info.F, info.B, info.Z, CGNS_ENUMV(RealDouble), names[idx], &(zone.CoordinateIds[idx])));
+  }
+
+  cgsize_t start(CGNS_COUNTING_OFFSET);
+  for (auto& section : zone.Sections)
+  {
+    const cgsize_t end(start + section.Count - 1);
+    int nBoundary(0);
+    cg_check_operation(cgp_section_write(info.F, info.B, info.Z, GetSectionName(section.Type),
+      section.Type, start, end, nBoundary, &(section.Id)));
+    section.Start = start;
+    start = end + 1;
+  }
+
+  return CreateFieldNodes(
+           info, "PointData", CGNS_ENUMV(Vertex), zone.PointFields, zone.PointSolutionId, error) &&
+    CreateFieldNodes(
+      info, "CellData", CGNS_ENUMV(CellCenter), zone.CellFields, zone.CellSolutionId, error);
+}
+
+bool vtkCGNSWriter::vtkPrivate::CreateFieldNodes(write_info& info, const char* solution,
+  CGNS_ENUMT(GridLocation_t) location, vector<field_info>& fields, int& solutionId,
+  string& error)
+{
+  if (fields.empty())
+  {
+    return true;
+  }
+
+  cg_check_operation(cg_sol_write(info.F, info.B, info.Z, solution, location, &solutionId));
+  for (auto& field : fields)
+  {
+    cg_check_operation(cgp_field_write(info.F, info.B, info.Z, solutionId,
+      CGNS_ENUMV(RealDouble), field.Name.c_str(), &(field.Id)));
+  }
+  return true;
+}
+
+bool vtkCGNSWriter::vtkPrivate::WriteZoneData(
+  write_info& info, const base_info& base, const zone_info& zone, string& error)
+{
+  info.B = base.Id;
+  info.Z = zone.Id;
+
+  const cgsize_t rmin[3] = { 1, 1, 1 };
+  const cgsize_t* vertexSize = zone.Dim;
+  const cgsize_t* cellSize = zone.Dim + zone.IndexDim;
+
+  vector<double> temp;
+  for (int idx = 0; idx < 3; ++idx)
+  {
+    CopyComponent(zone.Object->GetPoints()->GetData(), idx, temp);
+    cg_check_operation(cgp_coord_write_data(
+      info.F, info.B, info.Z, zone.CoordinateIds[idx], rmin, vertexSize, temp.data()));
+  }
+
+  for (auto& section : zone.Sections)
+  {
+    cg_check_operation(cgp_elements_write_data(info.F, info.B, info.Z, section.Id, section.Start,
+      section.Start + section.Count - 1, section.Connectivity.data()));
+  }
+
+  return WriteFieldData(info, zone.PointSolutionId, zone.PointFields, vertexSize, error) &&
+    WriteFieldData(info, zone.CellSolutionId, zone.CellFields, cellSize, error);
+}
+
+bool vtkCGNSWriter::vtkPrivate::WriteFieldData(write_info& info, int solutionId,
+  const vector<field_info>& fields, const cgsize_t* size, string& error)
+{
+  const cgsize_t rmin[3] = { 1, 1, 1 };
+  vector<double> temp;
+  for (auto& field : fields)
+  {
+    CopyComponent(field.Array, field.Component, temp);
+    cg_check_operation(cgp_field_write_data(
+      info.F, info.B, info.Z, solutionId, field.Id, rmin, size, temp.data()));
+  }
+  return true;
+}
+#endif
+
+bool vtkCGNSWriter::vtkPrivate::WriteParallel(vtkDataObject* input, const char* file,
+  bool useHDF5, vtkMultiProcessController* controller, string& error)
+{
+  // all processes must take the same path, since each of them takes part in
+  // the writing.
+  int supported(vtkMultiBlockDataSet::SafeDownCast(input) || vtkPointSet::SafeDownCast(input));
+  int allSupported(0);
+  controller->AllReduce(&supported, &allSupported, 1, vtkCommunicator::MIN_OP);
+  if (!allSupported)
+  {
+    error = supported ? string("Unsupported input on another process.")
+                      : string("Unsupported class type '") + input->GetClassName() +
+        "' on input.\nSupported types are vtkStructuredGrid, vtkPointSet, their subclasses and "
+        "multi-block datasets of said classes.";
+    return false;
+  }
+
+#if VTK_CGNS_WRITER_USE_PARALLEL_CGNS
+  // parallel CGNS is only available for HDF5 files.
+  vtkMPICommunicator* communicator =
+    vtkMPICommunicator::SafeDownCast(controller->GetCommunicator());
+  if (useHDF5 && communicator)
+  {
+    vector<base_info> bases;
+    InitializeBases(input, bases);
+    CollectZones(input, controller->GetLocalProcessId(), bases);
+    bool polygonal(false);
+    for (auto& base : bases)
+    {
+      for (auto& zone : base.Zones)
+      {
+        DescribeZone(zone);
+        polygonal |= zone.Polygonal;
+      }
+    }
+
+    int anyPolygonal(polygonal ? 1 : 0), globalPolygonal(0);
+    controller->AllReduce(&anyPolygonal, &globalPolygonal, 1, vtkCommunicator::MAX_OP);
+
+    // NGON_n and NFACE_n sections have no fixed size, which the parallel
+    // API does not support.
+    if (!globalPolygonal)
+    {
+      ExchangeZones(controller, bases);
+      return WriteParallelCGNS(controller, communicator, bases, file, error);
+    }
+  }
+#else
+  (void)useHDF5;
+#endif
+
+  return WriteGathered(input, file, controller, error);
+}
+
 vtkStandardNewMacro(vtkCGNSWriter);
+vtkCxxSetObjectMacro(vtkCGNSWriter, Controller, vtkMultiProcessController);
 
 vtkCGNSWriter::vtkCGNSWriter()
 {
   this->FileName = (nullptr);
   this->OriginalInput = (nullptr);
   this->SetUseHDF5(true); // use the method, this will call the corresponding library method.
+  this->Controller = nullptr;
+  this->SetController(vtkMultiProcessController::GetGlobalController());
 }
 
 vtkCGNSWriter::~vtkCGNSWriter()
@@ -830,12 +1456,14 @@ vtkCGNSWriter::~vtkCGNSWriter()
   {
     this->OriginalInput->UnRegister(this);
   }
+  this->SetController(nullptr);
 }
 
 void vtkCGNSWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "FileName " << (this->FileName ? this->FileName : "(none)") << endl;
+  os << indent << "Controller: " << this->Controller << endl;
 }
 
 int vtkCGNSWriter::ProcessRequest(
@@ -877,8 +1505,18 @@ int vtkCGNSWriter::RequestInformation(vtkInformation* vtkNotUsed(request),
 }
 
 int vtkCGNSWriter::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
-  vtkInformationVector** vtkNotUsed(inputVector), vtkInformationVector* vtkNotUsed(outputVector))
+  vtkInformationVector** inputVector, vtkInformationVector* vtkNotUsed(outputVector))
 {
+  // in parallel, each process writes its own piece of the input.
+  if (this->Controller && this->Controller->GetNumberOfProcesses() > 1)
+  {
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(),
+      this->Controller->GetLocalProcessId());
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(),
+      this->Controller->GetNumberOfProcesses());
+  }
+
   // todo: support writing time steps
   // vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
   // if (this->WriteAllTimeSteps &&
@@ -936,7 +1574,12 @@ void vtkCGNSWriter::WriteData()
     return;
 
   string error;
-  if (this->OriginalInput->IsA("vtkMultiBlockDataSet"))
+  if (this->Controller && this->Controller->GetNumberOfProcesses() > 1)
+  {
+    WasWritingSuccessful = vtkCGNSWriter::vtkPrivate::WriteParallel(
+      this->OriginalInput, this->FileName, this->UseHDF5, this->Controller, error);
+  }
+  else if (this->OriginalInput->IsA("vtkMultiBlockDataSet"))
   {
     vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(this->OriginalInput);
     WasWritingSuccessful = vtkCGNSWriter::vtkPrivate::WriteMultiBlock(mb, this->FileName, error);
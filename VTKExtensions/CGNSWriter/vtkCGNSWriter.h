@@ -27,6 +27,14 @@ See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
  *   - vtkPolydata
  *   - vtkMultiBlockDataSet
  *   - vtkMultiPieceDataSet (currently not implemented)
+ *
+ * When running with more than one process, each rank writes its own piece of
+ * the input as separate zone(s) of the same file. If the CGNS library is built
+ * with parallel support and UseHDF5 is on, zones are written collectively
+ * through the parallel CGNS API (`cgp_*`), where every rank writes the data of
+ * its own zones. Otherwise, or when some of the zones contain polygonal or
+ * polyhedral cells (which the parallel API cannot write), the pieces are
+ * gathered to the root process which writes the same zones serially.
 */
 
 #ifndef vtkCGNSWriter_h
@@ -35,6 +43,8 @@ See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
 #include "vtkPVVTKExtensionsCGNSWriterModule.h" // for export macro
 #include "vtkWriter.h"
 
+class vtkMultiProcessController;
+
 class VTKPVVTKEXTENSIONSCGNSWRITER_EXPORT vtkCGNSWriter : public vtkWriter
 {
 public:
@@ -43,10 +53,8 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
   /**
-  * Name for the output file.  If writing in parallel, the number
-  * of processes and the process rank will be appended to the name,
-  * so each process is writing out a separate file.
-  * If not set, this class will make up a file name.
+  * Name for the output file. When writing in parallel, all processes
+  * write to this file.
   */
 
   vtkSetStringMacro(FileName);
@@ -54,6 +62,15 @@ public:
   vtkBooleanMacro(UseHDF5, bool);
   void SetUseHDF5(bool);
 
+  //@{
+  /**
+   * Get/Set the controller used to write in parallel. Default is the global
+   * controller.
+   */
+  virtual void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+  //@}
+
 protected:
   vtkCGNSWriter();
   ~vtkCGNSWriter() override;
@@ -61,6 +78,7 @@ protected:
   char* FileName;
   vtkDataObject* OriginalInput;
   bool UseHDF5; //
+  vtkMultiProcessController* Controller;
 
   int ProcessRequest(vtkInformation* request, vtkInformationVector** inputVector,
     vtkInformationVector* outputVector) override;
@@ -13,6 +13,7 @@
 
 =========================================================================*/
 
+#include "vtkCell.h"
 #include "vtkCellData.h"
 #include "vtkConduitSource.h"
 #include "vtkImageData.h"
@@ -28,6 +29,8 @@
 
 #include <conduit_blueprint.hpp>
 
+#include <vector>
+
 #define VERIFY(x, ...)                                                                             \
   if ((x) == false)                                                                                \
   {                                                                                                \
@@ -125,12 +128,98 @@ bool ValidateMeshTypeUnstructured()
   VERIFY(ug->GetCellData()->GetArray("field") != nullptr, "missing 'field' cell-data array");
   return true;
 }
+
+bool ValidateMeshTypePolyhedra()
+{
+  conduit::Node mesh;
+  conduit::blueprint::mesh::examples::basic("polyhedra", 3, 3, 3, mesh);
+
+  auto pds = vtkPartitionedDataSet::SafeDownCast(Convert(mesh));
+  VERIFY(pds != nullptr && pds->GetNumberOfPartitions() == 1, "incorrect output");
+  auto ug = vtkUnstructuredGrid::SafeDownCast(pds->GetPartition(0));
+  VERIFY(ug != nullptr, "missing partition 0");
+  VERIFY(ug->GetNumberOfCells() == 8, "incorrect number of cells, expected 8, got %lld",
+    ug->GetNumberOfCells());
+  VERIFY(ug->GetCellType(0) == VTK_POLYHEDRON, "incorrect cell type %d", ug->GetCellType(0));
+  VERIFY(ug->GetCell(0)->GetNumberOfFaces() == 6, "incorrect number of faces, expected 6, got %d",
+    ug->GetCell(0)->GetNumberOfFaces());
+  VERIFY(ug->GetCell(0)->GetNumberOfPoints() == 8,
+    "incorrect number of points, expected 8, got %lld", ug->GetCell(0)->GetNumberOfPoints());
+  return true;
+}
+
+bool ValidateMeshTypeMixed()
+{
+  // a quad and two triangles.
+  conduit::Node mesh;
+  mesh["coordsets/coords/type"] = "explicit";
+  mesh["coordsets/coords/values/x"].set(std::vector<double>{ 0, 1, 2, 0, 1, 2 });
+  mesh["coordsets/coords/values/y"].set(std::vector<double>{ 0, 0, 0, 1, 1, 1 });
+  mesh["topologies/mesh/type"] = "unstructured";
+  mesh["topologies/mesh/coordset"] = "coords";
+  mesh["topologies/mesh/elements/shape"] = "mixed";
+  mesh["topologies/mesh/elements/shape_map/quad"] = VTK_QUAD;
+  mesh["topologies/mesh/elements/shape_map/tri"] = VTK_TRIANGLE;
+  mesh["topologies/mesh/elements/shapes"].set(std::vector<int>{ VTK_QUAD, VTK_TRIANGLE,
+    VTK_TRIANGLE });
+  mesh["topologies/mesh/elements/sizes"].set(std::vector<int>{ 4, 3, 3 });
+  mesh["topologies/mesh/elements/offsets"].set(std::vector<int>{ 0, 4, 7 });
+  mesh["topologies/mesh/elements/connectivity"].set(
+    std::vector<int>{ 0, 1, 4, 3, 1, 2, 5, 1, 5, 4 });
+  mesh["fields/field/association"] = "element";
+  mesh["fields/field/topology"] = "mesh";
+  mesh["fields/field/values"].set(std::vector<double>{ 0, 1, 2 });
+
+  auto pds = vtkPartitionedDataSet::SafeDownCast(Convert(mesh));
+  VERIFY(pds != nullptr && pds->GetNumberOfPartitions() == 1, "incorrect output");
+  auto ug = vtkUnstructuredGrid::SafeDownCast(pds->GetPartition(0));
+  VERIFY(ug != nullptr, "missing partition 0");
+  VERIFY(ug->GetNumberOfCells() == 3, "incorrect number of cells, expected 3, got %lld",
+    ug->GetNumberOfCells());
+  VERIFY(ug->GetCellType(0) == VTK_QUAD && ug->GetCellType(1) == VTK_TRIANGLE &&
+      ug->GetCellType(2) == VTK_TRIANGLE,
+    "incorrect cell types");
+  VERIFY(ug->GetCell(2)->GetPointId(1) == 5, "incorrect connectivity");
+  VERIFY(ug->GetCellData()->GetArray("field") != nullptr, "missing 'field' cell-data array");
+  return true;
+}
+
+bool ValidateInvalidSizes()
+{
+  // sizes add up to the connectivity length but one of them is negative.
+  conduit::Node mesh;
+  mesh["coordsets/coords/type"] = "explicit";
+  mesh["coordsets/coords/values/x"].set(std::vector<double>{ 0, 1, 2, 0, 1, 2 });
+  mesh["coordsets/coords/values/y"].set(std::vector<double>{ 0, 0, 0, 1, 1, 1 });
+  mesh["topologies/mesh/type"] = "unstructured";
+  mesh["topologies/mesh/coordset"] = "coords";
+  mesh["topologies/mesh/elements/shape"] = "mixed";
+  mesh["topologies/mesh/elements/shape_map/quad"] = VTK_QUAD;
+  mesh["topologies/mesh/elements/shape_map/tri"] = VTK_TRIANGLE;
+  mesh["topologies/mesh/elements/shapes"].set(std::vector<int>{ VTK_QUAD, VTK_TRIANGLE,
+    VTK_TRIANGLE });
+  mesh["topologies/mesh/elements/sizes"].set(std::vector<int>{ 4, -1, 7 });
+  mesh["topologies/mesh/elements/connectivity"].set(
+    std::vector<int>{ 0, 1, 4, 3, 1, 2, 5, 1, 5, 4 });
+
+  // the errors are expected, don't let them fail the test.
+  const auto verbosity = vtkLogger::GetCurrentVerbosityCutoff();
+  vtkLogger::SetStderrVerbosity(vtkLogger::VERBOSITY_OFF);
+  vtkObject::GlobalWarningDisplayOff();
+  auto pds = vtkPartitionedDataSet::SafeDownCast(Convert(mesh));
+  vtkObject::GlobalWarningDisplayOn();
+  vtkLogger::SetStderrVerbosity(static_cast<vtkLogger::Verbosity>(verbosity));
+
+  VERIFY(pds == nullptr || pds->GetNumberOfPartitions() == 0, "negative sizes were accepted");
+  return true;
+}
 }
 
 int TestConduitSource(int, char* [])
 {
   return ValidateMeshTypeUniform() && ValidateMeshTypeRectilinear() &&
-      ValidateMeshTypeStructured() && ValidateMeshTypeUnstructured()
+      ValidateMeshTypeStructured() && ValidateMeshTypeUnstructured() &&
+      ValidateMeshTypePolyhedra() && ValidateMeshTypeMixed() && ValidateInvalidSizes()
     ? EXIT_SUCCESS
     : EXIT_FAILURE;
 }
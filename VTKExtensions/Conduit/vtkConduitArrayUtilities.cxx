@@ -34,6 +34,8 @@
 #include <conduit_blueprint_mcarray.hpp>
 #include <conduit_cpp_to_c.hpp>
 
+#include <algorithm>
+#include <stdexcept>
 #include <vector>
 
 namespace internals
@@ -201,6 +203,93 @@ conduit::index_t GetTypeId(conduit::index_t type, bool force_signed)
   }
 }
 
+//----------------------------------------------------------------------------
+// Reads a node with integer values as vtkIdType.
+static std::vector<vtkIdType> ToIdVector(const conduit::Node& node)
+{
+  conduit::Node values;
+  node.to_int64_array(values);
+  const conduit::int64* ptr = values.as_int64_ptr();
+  return std::vector<vtkIdType>(ptr, ptr + values.dtype().number_of_elements());
+}
+
+//----------------------------------------------------------------------------
+// Computes the VTK offsets (one per cell plus the total size) of a Blueprint
+// o2mrelation whose leaf array has `leafSize` values.
+static std::vector<vtkIdType> GetO2MOffsets(const conduit::Node& o2mrelation, vtkIdType leafSize)
+{
+  std::vector<vtkIdType> offsets;
+  if (o2mrelation.has_child("offsets"))
+  {
+    offsets = ToIdVector(o2mrelation["offsets"]);
+    if (o2mrelation.has_child("sizes"))
+    {
+      // offsets can describe an arbitrary layout; VTK needs packed cells.
+      const std::vector<vtkIdType> sizes = ToIdVector(o2mrelation["sizes"]);
+      if (sizes.size() != offsets.size())
+      {
+        throw std::runtime_error("mismatched 'sizes' and 'offsets'!");
+      }
+      if ((!offsets.empty() && offsets.front() != 0) ||
+        std::any_of(sizes.begin(), sizes.end(), [](vtkIdType size) { return size < 0; }))
+      {
+        throw std::runtime_error("non-contiguous o2mrelation is not supported!");
+      }
+      for (size_t cc = 0; cc + 1 < offsets.size(); ++cc)
+      {
+        if (offsets[cc] + sizes[cc] != offsets[cc + 1])
+        {
+          throw std::runtime_error("non-contiguous o2mrelation is not supported!");
+        }
+      }
+      if (!offsets.empty() && offsets.back() + sizes.back() != leafSize)
+      {
+        throw std::runtime_error("non-contiguous o2mrelation is not supported!");
+      }
+    }
+    else if ((!offsets.empty() && offsets.front() != 0) ||
+      !std::is_sorted(offsets.begin(), offsets.end()) ||
+      (!offsets.empty() && offsets.back() > leafSize))
+    {
+      throw std::runtime_error("non-contiguous o2mrelation is not supported!");
+    }
+  }
+  else if (o2mrelation.has_child("sizes"))
+  {
+    const std::vector<vtkIdType> sizes = ToIdVector(o2mrelation["sizes"]);
+    offsets.resize(sizes.size());
+    vtkIdType offset = 0;
+    for (size_t cc = 0; cc < sizes.size(); ++cc)
+    {
+      if (sizes[cc] < 0 || sizes[cc] > leafSize - offset)
+      {
+        throw std::runtime_error("'sizes' do not match the connectivity!");
+      }
+      offsets[cc] = offset;
+      offset += sizes[cc];
+    }
+    if (offset != leafSize)
+    {
+      throw std::runtime_error("'sizes' do not match the connectivity!");
+    }
+  }
+  else
+  {
+    throw std::runtime_error("o2mrelation needs 'sizes' or 'offsets'!");
+  }
+  offsets.push_back(leafSize);
+  return offsets;
+}
+
+template <typename ArrayT>
+vtkSmartPointer<vtkDataArray> CreateOffsetsArray(const std::vector<vtkIdType>& offsets)
+{
+  auto array = vtkSmartPointer<ArrayT>::New();
+  array->SetNumberOfTuples(static_cast<vtkIdType>(offsets.size()));
+  std::copy(offsets.begin(), offsets.end(), array->GetPointer(0));
+  return array;
+}
+
 } // internals
 
 vtkStandardNewMacro(vtkConduitArrayUtilities);
@@ -450,6 +539,57 @@ vtkSmartPointer<vtkCellArray> vtkConduitArrayUtilities::MCArrayToVTKCellArray(
   return cellArray;
 }
 
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkCellArray> vtkConduitArrayUtilities::O2MRelationToVTKCellArray(
+  const conduit_node* c_o2mrelation, const std::string& leafname)
+{
+  const conduit::Node& o2mrelation = (*conduit::cpp_node(c_o2mrelation));
+  auto connectivity = vtkConduitArrayUtilities::MCArrayToVTKArrayImpl(
+    conduit::c_node(&o2mrelation[leafname]), /*force_signed*/ true);
+  if (!connectivity || connectivity->GetNumberOfComponents() != 1)
+  {
+    return nullptr;
+  }
+
+  // vtkCellArray can only use 32 or 64 bit integer arrays as is.
+  if (!vtkArrayDownCast<vtkTypeInt32Array>(connectivity) &&
+    !vtkArrayDownCast<vtkTypeInt64Array>(connectivity))
+  {
+    vtkLogF(TRACE, "deep-copying connectivity of type '%s'", connectivity->GetClassName());
+    auto converted = vtkSmartPointer<vtkTypeInt64Array>::New();
+    converted->DeepCopy(connectivity);
+    connectivity = converted;
+  }
+
+  std::vector<vtkIdType> offsets;
+  try
+  {
+    offsets = internals::GetO2MOffsets(o2mrelation, connectivity->GetNumberOfTuples());
+  }
+  catch (std::exception& e)
+  {
+    vtkLogF(ERROR, "%s", e.what());
+    return nullptr;
+  }
+  auto offsetsArray = vtkArrayDownCast<vtkTypeInt32Array>(connectivity)
+    ? internals::CreateOffsetsArray<vtkTypeInt32Array>(offsets)
+    : internals::CreateOffsetsArray<vtkTypeInt64Array>(offsets);
+
+  vtkNew<vtkCellArray> cellArray;
+  if (!cellArray->SetData(offsetsArray, connectivity))
+  {
+    vtkLogF(ERROR, "failed to create cell array.");
+    return nullptr;
+  }
+  return cellArray;
+}
+
+//----------------------------------------------------------------------------
+std::vector<vtkIdType> vtkConduitArrayUtilities::MCArrayToIdVector(const conduit_node* c_mcarray)
+{
+  return internals::ToIdVector(*conduit::cpp_node(c_mcarray));
+}
+
 //----------------------------------------------------------------------------
 void vtkConduitArrayUtilities::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -32,6 +32,7 @@
 #include "vtkPVVTKExtensionsConduitModule.h" // for exports
 #include "vtkSmartPointer.h"                 // for vtkSmartPointer
 #include <string>                            // for std::string
+#include <vector>                            // for std::vector
 
 class vtkCellArray;
 class vtkDataArray;
@@ -65,6 +66,25 @@ public:
   static vtkSmartPointer<vtkCellArray> MCArrayToVTKCellArray(
     vtkIdType cellSize, const conduit_node* mcarray);
 
+  /**
+   * Converts a Blueprint `o2mrelation` (a `leafname` array with `sizes` and/or
+   * `offsets`) describing cells of varying sizes to vtkCellArray.
+   *
+   * The connectivity is used without copying when it is a 32 or 64 bit integer
+   * array. The offsets are always copied since VTK expects one more offset
+   * than the number of cells. The cells must be stored contiguously, in order.
+   */
+  static vtkSmartPointer<vtkCellArray> O2MRelationToVTKCellArray(
+    const conduit_node* o2mrelation, const std::string& leafname);
+
+#ifndef __WRAP__
+  /**
+   * Returns the values of a conduit node holding integers as vtkIdType. The
+   * values are always copied.
+   */
+  static std::vector<vtkIdType> MCArrayToIdVector(const conduit_node* mcarray);
+#endif
+
   /**
    * If the number of components in the array does not match the target, a new
    * array is created.
@@ -18,6 +18,7 @@
 #include "vtkConduitArrayUtilities.h"
 #include "vtkDataArray.h"
 #include "vtkDataSetAttributes.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -29,6 +30,7 @@
 #include "vtkRectilinearGrid.h"
 #include "vtkSmartPointer.h"
 #include "vtkStructuredGrid.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <conduit.hpp>
@@ -36,6 +38,9 @@
 #include <conduit_cpp_to_c.hpp>
 
 #include <algorithm>
+#include <map>
+#include <vector>
+
 namespace internals
 {
 
@@ -81,6 +86,22 @@ int GetCellType(const std::string& shape)
   {
     return VTK_HEXAHEDRON;
   }
+  else if (shape == "wedge")
+  {
+    return VTK_WEDGE;
+  }
+  else if (shape == "pyramid")
+  {
+    return VTK_PYRAMID;
+  }
+  else if (shape == "polygonal")
+  {
+    return VTK_POLYGON;
+  }
+  else if (shape == "polyhedral")
+  {
+    return VTK_POLYHEDRON;
+  }
   else
   {
     throw std::runtime_error("unsupported shape " + shape);
@@ -102,6 +123,10 @@ static vtkIdType GetNumberOfPointsInCellType(int vtk_cell_type)
     case VTK_QUAD:
     case VTK_TETRA:
       return 4;
+    case VTK_PYRAMID:
+      return 5;
+    case VTK_WEDGE:
+      return 6;
     case VTK_HEXAHEDRON:
       return 8;
     default:
@@ -109,6 +134,142 @@ static vtkIdType GetNumberOfPointsInCellType(int vtk_cell_type)
   }
 }
 
+//----------------------------------------------------------------------------
+static std::vector<vtkIdType> GetIdValues(const conduit::Node& node)
+{
+  return vtkConduitArrayUtilities::MCArrayToIdVector(conduit::c_node(&node));
+}
+
+//----------------------------------------------------------------------------
+// internal: sizes and offsets of each element of a o2mrelation.
+static void GetElementSizesAndOffsets(
+  const conduit::Node& o2mrelation, std::vector<vtkIdType>& sizes, std::vector<vtkIdType>& offsets)
+{
+  sizes = GetIdValues(o2mrelation["sizes"]);
+  if (std::any_of(sizes.begin(), sizes.end(), [](vtkIdType size) { return size < 0; }))
+  {
+    throw std::runtime_error("negative 'sizes' in o2mrelation!");
+  }
+  if (o2mrelation.has_child("offsets"))
+  {
+    offsets = GetIdValues(o2mrelation["offsets"]);
+    if (offsets.size() != sizes.size() ||
+      std::any_of(offsets.begin(), offsets.end(), [](vtkIdType offset) { return offset < 0; }))
+    {
+      throw std::runtime_error("mismatched 'sizes' and 'offsets'!");
+    }
+    return;
+  }
+  offsets.assign(sizes.size(), 0);
+  for (size_t cc = 1; cc < sizes.size(); ++cc)
+  {
+    offsets[cc] = offsets[cc - 1] + sizes[cc - 1];
+  }
+}
+
+//----------------------------------------------------------------------------
+// internal: set polyhedral cells. Blueprint stores polyhedra as a list of
+// faces indexing into "subelements"; VTK needs the cell's points and a face
+// stream per cell, hence this cannot be zero-copy.
+void SetPolyhedralCells(vtkUnstructuredGrid* ug, const conduit::Node& topologyNode)
+{
+  auto& elements = topologyNode["elements"];
+  auto& subelements = topologyNode["subelements"];
+  if (subelements["shape"].as_string() != "polygonal")
+  {
+    throw std::runtime_error("unsupported polyhedral subelement shape " +
+      subelements["shape"].as_string());
+  }
+
+  const auto cellFaces = GetIdValues(elements["connectivity"]);
+  std::vector<vtkIdType> cellSizes, cellOffsets;
+  GetElementSizesAndOffsets(elements, cellSizes, cellOffsets);
+  const auto facePoints = GetIdValues(subelements["connectivity"]);
+  std::vector<vtkIdType> faceSizes, faceOffsets;
+  GetElementSizesAndOffsets(subelements, faceSizes, faceOffsets);
+
+  const vtkIdType numCells = static_cast<vtkIdType>(cellSizes.size());
+  vtkNew<vtkCellArray> cells;
+  cells->AllocateEstimate(numCells, 8);
+  vtkNew<vtkIdTypeArray> faceLocations;
+  faceLocations->SetNumberOfTuples(numCells);
+  vtkNew<vtkIdTypeArray> faces;
+  std::vector<vtkIdType> cellPoints;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    faceLocations->SetValue(cellId, faces->GetNumberOfTuples());
+    faces->InsertNextValue(cellSizes[cellId]);
+    cellPoints.clear();
+    for (vtkIdType cc = 0; cc < cellSizes[cellId]; ++cc)
+    {
+      const vtkIdType faceId = cellFaces.at(cellOffsets[cellId] + cc);
+      const vtkIdType faceSize = faceSizes.at(faceId);
+      faces->InsertNextValue(faceSize);
+      for (vtkIdType pt = 0; pt < faceSize; ++pt)
+      {
+        const vtkIdType ptId = facePoints.at(faceOffsets[faceId] + pt);
+        faces->InsertNextValue(ptId);
+        if (std::find(cellPoints.begin(), cellPoints.end(), ptId) == cellPoints.end())
+        {
+          cellPoints.push_back(ptId);
+        }
+      }
+    }
+    cells->InsertNextCell(static_cast<vtkIdType>(cellPoints.size()), cellPoints.data());
+  }
+
+  vtkNew<vtkUnsignedCharArray> cellTypes;
+  cellTypes->SetNumberOfTuples(numCells);
+  cellTypes->FillValue(VTK_POLYHEDRON);
+  ug->SetCells(cellTypes, cells, faceLocations, faces);
+}
+
+//----------------------------------------------------------------------------
+// internal: set cells of a "mixed" topology, whose elements' shapes are
+// given by "shapes" using the ids from "shape_map".
+void SetMixedCells(vtkUnstructuredGrid* ug, const conduit::Node& topologyNode)
+{
+  auto& elements = topologyNode["elements"];
+  std::map<vtkIdType, unsigned char> shapeMap;
+  auto iter = elements["shape_map"].children();
+  while (iter.has_next())
+  {
+    auto& idNode = iter.next();
+    const int vtk_cell_type = GetCellType(iter.name());
+    if (vtk_cell_type == VTK_POLYHEDRON)
+    {
+      throw std::runtime_error("polyhedral elements are not supported in mixed topologies");
+    }
+    shapeMap[static_cast<vtkIdType>(idNode.to_int64())] = static_cast<unsigned char>(vtk_cell_type);
+  }
+
+  auto cellArray = vtkConduitArrayUtilities::O2MRelationToVTKCellArray(
+    &elements, "connectivity");
+  if (!cellArray)
+  {
+    throw std::runtime_error("failed to convert mixed connectivity!");
+  }
+
+  const auto shapes = GetIdValues(elements["shapes"]);
+  if (static_cast<vtkIdType>(shapes.size()) != cellArray->GetNumberOfCells())
+  {
+    throw std::runtime_error("mismatched 'shapes' and 'sizes'!");
+  }
+  vtkNew<vtkUnsignedCharArray> cellTypes;
+  cellTypes->SetNumberOfTuples(static_cast<vtkIdType>(shapes.size()));
+  unsigned char* types = cellTypes->GetPointer(0);
+  for (size_t cc = 0; cc < shapes.size(); ++cc)
+  {
+    auto found = shapeMap.find(shapes[cc]);
+    if (found == shapeMap.end())
+    {
+      throw std::runtime_error("unknown shape id " + std::to_string(shapes[cc]));
+    }
+    types[cc] = found->second;
+  }
+  ug->SetCells(cellTypes, cellArray);
+}
+
 //----------------------------------------------------------------------------
 vtkSmartPointer<vtkPoints> CreatePoints(const conduit::Node& coords)
 {
@@ -202,10 +363,36 @@ vtkSmartPointer<vtkDataSet> GetMesh(
   {
     vtkNew<vtkUnstructuredGrid> ug;
     ug->SetPoints(CreatePoints(coords));
-    const auto vtk_cell_type = GetCellType(topologyNode["elements/shape"].as_string());
-    const auto cell_size = GetNumberOfPointsInCellType(vtk_cell_type);
-    auto cellArray = vtkConduitArrayUtilities::MCArrayToVTKCellArray(
-      cell_size, &topologyNode["elements/connectivity"]);
+    const auto shape = topologyNode["elements/shape"].as_string();
+    if (shape == "mixed")
+    {
+      SetMixedCells(ug, topologyNode);
+      return ug;
+    }
+
+    const auto vtk_cell_type = GetCellType(shape);
+    if (vtk_cell_type == VTK_POLYHEDRON)
+    {
+      SetPolyhedralCells(ug, topologyNode);
+      return ug;
+    }
+
+    vtkSmartPointer<vtkCellArray> cellArray;
+    if (vtk_cell_type == VTK_POLYGON)
+    {
+      cellArray = vtkConduitArrayUtilities::O2MRelationToVTKCellArray(
+        &topologyNode["elements"], "connectivity");
+    }
+    else
+    {
+      const auto cell_size = GetNumberOfPointsInCellType(vtk_cell_type);
+      cellArray = vtkConduitArrayUtilities::MCArrayToVTKCellArray(
+        cell_size, &topologyNode["elements/connectivity"]);
+    }
+    if (!cellArray)
+    {
+      throw std::runtime_error("failed to convert connectivity!");
+    }
     ug->SetCells(vtk_cell_type, cellArray);
     return ug;
   }
@@ -0,0 +1,64 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVTimeline.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVTimeline.h"
+
+#include <string>
+
+#define TEST_ASSERT(x)                                                                             \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << "ERROR: failed at line " << __LINE__ << ": " #x << endl;                               \
+    return EXIT_FAILURE;                                                                           \
+  }
+
+int TestPVTimeline(int, char* [])
+{
+  vtkPVTimeline::SetEnabled(false);
+  vtkPVTimeline::Clear();
+  {
+    PARAVIEW_TIMELINE_SCOPE("test", "Disabled");
+  }
+  TEST_ASSERT(vtkPVTimeline::GetNumberOfEvents() == 0);
+
+  vtkPVTimeline::SetEnabled(true);
+  vtkPVTimeline::SetCapacity(2);
+  {
+    PARAVIEW_TIMELINE_SCOPE("test", "First");
+  }
+  {
+    PARAVIEW_TIMELINE_SCOPE("test", "Second");
+  }
+  {
+    PARAVIEW_TIMELINE_SCOPE("test", "Third \"quoted\"");
+  }
+  TEST_ASSERT(vtkPVTimeline::GetNumberOfEvents() == 2);
+
+  // the oldest event has been overwritten, events are ordered oldest first.
+  const std::string events = vtkPVTimeline::GetTraceEvents(7, "test process");
+  TEST_ASSERT(events.find("\"First\"") == std::string::npos);
+  TEST_ASSERT(events.find("\"Second\"") != std::string::npos);
+  TEST_ASSERT(events.find("\"Third \\\"quoted\\\"\"") > events.find("\"Second\""));
+  TEST_ASSERT(events.find("\"test process\"") != std::string::npos);
+  TEST_ASSERT(events.find("\"pid\":7") != std::string::npos);
+
+  const std::string trace = vtkPVTimeline::GetChromeTrace(events);
+  TEST_ASSERT(trace.find("\"traceEvents\":[") != std::string::npos);
+
+  vtkPVTimeline::Clear();
+  TEST_ASSERT(vtkPVTimeline::GetNumberOfEvents() == 0);
+  TEST_ASSERT(vtkPVTimeline::GetTraceEvents(7, "test process").empty());
+  vtkPVTimeline::SetEnabled(false);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,89 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVXMLParser.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkNew.h"
+#include "vtkPVXMLElement.h"
+#include "vtkPVXMLParser.h"
+#include "vtkSmartPointer.h"
+
+#include <string>
+#include <vector>
+
+#define TEST_ASSERT(x)                                                                             \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << "ERROR: failed at line " << __LINE__ << ": " #x << endl;                               \
+    return EXIT_FAILURE;                                                                           \
+  }
+
+namespace
+{
+const char* TestXML = "<State version=\"5.8\">"
+                      "  <Proxy group=\"sources\" type=\"SphereSource\" id=\"257\">"
+                      "    <Property name=\"Radius\" id=\"257.Radius\"/>"
+                      "  </Proxy>"
+                      "  <Proxy group=\"filters\" type=\"Shrink\" id=\"258\"/>"
+                      "  <Proxy group=\"filters\" type=\"Clip\" id=\"259\"/>"
+                      "</State>";
+}
+
+int TestPVXMLParser(int, char* [])
+{
+  // attribute access.
+  vtkSmartPointer<vtkPVXMLElement> root = vtkPVXMLParser::ParseXML(TestXML);
+  TEST_ASSERT(root != nullptr);
+  TEST_ASSERT(strcmp(root->GetAttribute("version"), "5.8") == 0);
+  TEST_ASSERT(root->GetAttribute("unknown-attribute-name") == nullptr);
+  TEST_ASSERT(root->GetNumberOfNestedElements() == 3);
+
+  vtkPVXMLElement* proxy = root->GetNestedElement(0);
+  TEST_ASSERT(strcmp(proxy->GetAttribute("type"), "SphereSource") == 0);
+  proxy->SetAttribute("type", "ConeSource");
+  proxy->SetAttribute("label", "cone");
+  TEST_ASSERT(strcmp(proxy->GetAttribute("type"), "ConeSource") == 0);
+  TEST_ASSERT(strcmp(proxy->GetAttribute("label"), "cone") == 0);
+  proxy->RemoveAttribute("group");
+  TEST_ASSERT(proxy->GetAttribute("group") == nullptr);
+  TEST_ASSERT(strcmp(proxy->GetAttribute("id"), "257") == 0);
+
+  vtkNew<vtkPVXMLElement> copy;
+  proxy->CopyTo(copy);
+  TEST_ASSERT(copy->Equals(proxy));
+
+  vtkNew<vtkPVXMLElement> other;
+  other->SetName("Proxy");
+  other->AddAttribute("label", "merged");
+  other->AddAttribute("group", "sources");
+  copy->Merge(other, nullptr);
+  TEST_ASSERT(strcmp(copy->GetAttribute("label"), "merged") == 0);
+  TEST_ASSERT(strcmp(copy->GetAttribute("group"), "sources") == 0);
+  TEST_ASSERT(strcmp(copy->GetAttribute("type"), "ConeSource") == 0);
+
+  // streaming mode.
+  std::vector<std::string> types;
+  std::vector<unsigned int> nested;
+  vtkNew<vtkPVXMLParser> parser;
+  parser->SetElementCallback([&](vtkPVXMLElement* elem) {
+    types.push_back(elem->GetAttributeOrEmpty("type"));
+    nested.push_back(elem->GetNumberOfNestedElements());
+  });
+  TEST_ASSERT(parser->Parse(TestXML) != 0);
+  TEST_ASSERT(types.size() == 3);
+  TEST_ASSERT(types[0] == "SphereSource" && types[1] == "Shrink" && types[2] == "Clip");
+  TEST_ASSERT(nested[0] == 1 && nested[1] == 0);
+  TEST_ASSERT(parser->GetRootElement() != nullptr);
+  TEST_ASSERT(parser->GetRootElement()->GetNumberOfNestedElements() == 0);
+  TEST_ASSERT(strcmp(parser->GetRootElement()->GetAttribute("version"), "5.8") == 0);
+  return EXIT_SUCCESS;
+}
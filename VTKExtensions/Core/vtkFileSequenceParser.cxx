@@ -16,37 +16,38 @@
 
 #include "vtkObjectFactory.h"
 
-#include <set>
+#include <algorithm>
+#include <cstdlib>
 #include <string>
-#include <vtksys/RegularExpression.hxx>
 #include <vtksys/SystemTools.hxx>
 
+namespace
+{
+inline bool IsIndexCharacter(char c)
+{
+  return (c >= '0' && c <= '9') || c == '.';
+}
+
+inline bool IsDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+inline bool IsSeparator(char c)
+{
+  return c == '.' || c == '_' || c == '-';
+}
+
+inline bool IsLetter(char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+}
+
 vtkStandardNewMacro(vtkFileSequenceParser);
 //-----------------------------------------------------------------------------
 vtkFileSequenceParser::vtkFileSequenceParser()
-  : // sequence ending with numbers.
-  reg_ex(new vtksys::RegularExpression("^(.*)\\.([0-9.]+)$"))
-  ,
-  // sequence ending with extension.
-  reg_ex2(new vtksys::RegularExpression("^(.*)(\\.|_|-)([0-9.]+)\\.(.*)$"))
-  ,
-  // sequence ending with extension, but with no ". or _" before
-  // the series number.
-  reg_ex3(new vtksys::RegularExpression("^(.*)([a-zA-Z])([0-9.]+)\\.(.*)$"))
-  ,
-  // sequence ending with extension, and starting with series number
-  // followed by ". or _".
-  reg_ex4(new vtksys::RegularExpression("^([0-9.]+)(\\.|_|-)(.*)\\.(.*)$"))
-  ,
-  // sequence ending with extension, and starting with series number,
-  // but not followed by ". or _".
-  reg_ex5(new vtksys::RegularExpression("^([0-9.]+)([a-zA-Z])(.*)\\.(.*)$"))
-
-  ,
-  // fallback: any sequence with a number in the middle (taking the last number
-  // if multiple exist).
-  reg_ex_last(new vtksys::RegularExpression("^(.*[^0-9])([0-9]+)([^0-9]*)$"))
-  , SequenceIndex(-1)
+  : SequenceIndex(-1)
   , SequenceName(NULL)
 {
 }
@@ -54,72 +55,147 @@ vtkFileSequenceParser::vtkFileSequenceParser()
 //-----------------------------------------------------------------------------
 vtkFileSequenceParser::~vtkFileSequenceParser()
 {
-  delete this->reg_ex;
-  delete this->reg_ex2;
-  delete this->reg_ex3;
-  delete this->reg_ex4;
-  delete this->reg_ex5;
-  delete this->reg_ex_last;
-
   this->SetSequenceName(NULL);
 }
 
 //-----------------------------------------------------------------------------
+// The file name is split into tokens with a single backward scan instead of
+// matching it against a series of regular expressions. The patterns, tried in
+// order, are (with `I` an index made of digits and dots):
+//
+// 1. `name.I`: sequence ending with numbers.
+// 2. `name(.|_|-)I.ext`: sequence ending with an extension.
+// 3. `name[a-zA-Z]I.ext`: same, but with no separator before the index.
+// 4. `I(.|_|-)name.ext`: sequence starting with the index.
+// 5. `I[a-zA-Z]name.ext`: same, but with no separator after the index.
+// 6. fallback: the last number in the file name without its extension.
+//
+// When several splits are possible, the longest name prefix wins.
 bool vtkFileSequenceParser::ParseFileSequence(const char* file)
 {
-  bool match = false;
-  if (this->reg_ex->find(file))
-  {
-    this->SetSequenceName(this->reg_ex->match(1).c_str());
-    this->SequenceIndexString = this->reg_ex->match(2);
-    match = true;
-  }
-  else if (this->reg_ex2->find(file))
-  {
-    this->SetSequenceName(std::string(this->reg_ex2->match(1) + this->reg_ex2->match(2) + ".." +
-                            this->reg_ex2->match(4))
-                            .c_str());
-    this->SequenceIndexString = this->reg_ex2->match(3);
-    match = true;
-  }
-  else if (this->reg_ex3->find(file))
+  const std::string fname(file ? file : "");
+  const std::string::size_type npos = std::string::npos;
+  const std::string::size_type length = fname.size();
+
+  // Position of the last '.' of the trailing index run, if any (pattern 1).
+  std::string::size_type trailingDot = npos;
+  bool inTrailingRun = true;
+  // Separator (or letter) positions followed by an index and a '.' (patterns 2 and 3).
+  std::string::size_type separator = npos, separatorDot = npos;
+  std::string::size_type letter = npos, letterDot = npos;
+  // The last '.' in the name.
+  std::string::size_type lastDot = npos;
+  // End of, and last '.' in, the index run starting right after the current position.
+  std::string::size_type runEnd = length;
+  std::string::size_type runDot = npos;
+
+  for (std::string::size_type cc = length; cc-- > 0;)
   {
-    this->SetSequenceName(std::string(this->reg_ex3->match(1) + this->reg_ex3->match(2) + ".." +
-                            this->reg_ex3->match(4))
-                            .c_str());
-    this->SequenceIndexString = this->reg_ex3->match(3);
-    match = true;
+    const char c = fname[cc];
+    if (runDot != npos && runDot > cc + 1)
+    {
+      if (separator == npos && IsSeparator(c))
+      {
+        separator = cc;
+        separatorDot = runDot;
+      }
+      if (letter == npos && IsLetter(c))
+      {
+        letter = cc;
+        letterDot = runDot;
+      }
+    }
+    if (c == '.' && lastDot == npos)
+    {
+      lastDot = cc;
+    }
+    if (IsIndexCharacter(c))
+    {
+      if (c == '.' && runDot == npos)
+      {
+        runDot = cc;
+      }
+      if (inTrailingRun && c == '.' && trailingDot == npos && cc + 1 < length)
+      {
+        trailingDot = cc;
+      }
+    }
+    else
+    {
+      inTrailingRun = false;
+      runEnd = cc;
+      runDot = npos;
+    }
   }
-  else if (this->reg_ex4->find(file))
+  // runEnd is now the length of the index run the name starts with.
+  const std::string::size_type leadingRun = length > 0 && IsIndexCharacter(fname[0]) ? runEnd : 0;
+
+  std::string sequenceName;
+  bool match = true;
+  if (trailingDot != npos)
   {
-    this->SetSequenceName(std::string(".." + this->reg_ex4->match(2) + this->reg_ex4->match(3) +
-                            "." + this->reg_ex4->match(4))
-                            .c_str());
-    this->SequenceIndexString = this->reg_ex4->match(1);
-    match = true;
+    sequenceName = fname.substr(0, trailingDot);
+    this->SequenceIndexString = fname.substr(trailingDot + 1);
   }
-  else if (this->reg_ex5->find(file))
+  else if (separator != npos || letter != npos)
   {
-    this->SetSequenceName(std::string(".." + this->reg_ex5->match(2) + this->reg_ex5->match(3) +
-                            "." + this->reg_ex5->match(4))
-                            .c_str());
-    this->SequenceIndexString = this->reg_ex5->match(1);
-    match = true;
+    const std::string::size_type pos = separator != npos ? separator : letter;
+    const std::string::size_type dot = separator != npos ? separatorDot : letterDot;
+    sequenceName = fname.substr(0, pos + 1) + ".." + fname.substr(dot + 1);
+    this->SequenceIndexString = fname.substr(pos + 1, dot - pos - 1);
   }
   else
   {
-    std::string fname_wo_ext = vtksys::SystemTools::GetFilenameWithoutExtension(file);
-    std::string ext = vtksys::SystemTools::GetFilenameExtension(file);
-    if (this->reg_ex_last->find(fname_wo_ext))
+    // Leading index followed by a separator, or else by a letter, with a '.'
+    // after it.
+    std::string::size_type pos = npos;
+    for (std::string::size_type cc = std::min(leadingRun, length - 1); leadingRun > 0 && cc > 0;
+         --cc)
     {
-      this->SetSequenceName(
-        (this->reg_ex_last->match(1) + ".." + this->reg_ex_last->match(3) + ext).c_str());
-      this->SequenceIndexString = this->reg_ex_last->match(2);
-      match = true;
+      if (lastDot != npos && lastDot > cc && IsSeparator(fname[cc]))
+      {
+        pos = cc;
+        break;
+      }
+    }
+    if (pos == npos && leadingRun > 0 && leadingRun < length && lastDot != npos &&
+      lastDot > leadingRun && IsLetter(fname[leadingRun]))
+    {
+      pos = leadingRun;
+    }
+    if (pos != npos)
+    {
+      sequenceName = ".." + fname.substr(pos);
+      this->SequenceIndexString = fname.substr(0, pos);
+    }
+    else
+    {
+      // Fallback: the last number of the file name without its extension.
+      const std::string fname_wo_ext = vtksys::SystemTools::GetFilenameWithoutExtension(fname);
+      const std::string ext = vtksys::SystemTools::GetFilenameExtension(fname);
+      std::string::size_type numberEnd = fname_wo_ext.size();
+      while (numberEnd > 0 && !IsDigit(fname_wo_ext[numberEnd - 1]))
+      {
+        --numberEnd;
+      }
+      std::string::size_type numberStart = numberEnd;
+      while (numberStart > 0 && IsDigit(fname_wo_ext[numberStart - 1]))
+      {
+        --numberStart;
+      }
+      match = numberStart > 0 && numberStart < numberEnd;
+      if (match)
+      {
+        sequenceName =
+          fname_wo_ext.substr(0, numberStart) + ".." + fname_wo_ext.substr(numberEnd) + ext;
+        this->SequenceIndexString = fname_wo_ext.substr(numberStart, numberEnd - numberStart);
+      }
     }
   }
+
   if (match)
   {
+    this->SetSequenceName(sequenceName.c_str());
     this->SequenceIndex = atoi(this->SequenceIndexString.c_str());
   }
   return match;
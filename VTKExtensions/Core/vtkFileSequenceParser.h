@@ -20,7 +20,8 @@
  * Given a file name (without path). I will
  * extract the base portion of the file name that is common to all the files
  * in the sequence. It will also provide the current sequence index of the
- * provided file name.
+ * provided file name. The file name is tokenized in a single pass, which is
+ * cheap enough to group the contents of very large directories.
  * by several vtkPVUpdateSuppressor objects.
 */
 
@@ -32,11 +33,6 @@
 
 #include <string>
 
-namespace vtksys
-{
-class RegularExpression;
-}
-
 class VTKPVVTKEXTENSIONSCORE_EXPORT vtkFileSequenceParser : public vtkObject
 {
 public:
@@ -74,13 +70,6 @@ protected:
   vtkFileSequenceParser();
   ~vtkFileSequenceParser() override;
 
-  vtksys::RegularExpression* reg_ex;
-  vtksys::RegularExpression* reg_ex2;
-  vtksys::RegularExpression* reg_ex3;
-  vtksys::RegularExpression* reg_ex4;
-  vtksys::RegularExpression* reg_ex5;
-  vtksys::RegularExpression* reg_ex_last;
-
   // Used internal so char * allocations are done automatically.
   vtkSetStringMacro(SequenceName);
 
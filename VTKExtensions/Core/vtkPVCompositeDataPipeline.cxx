@@ -24,6 +24,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVPostFilterExecutive.h"
+#include "vtkPVTimeline.h"
 
 #include <assert.h>
 
@@ -38,6 +39,14 @@ vtkPVCompositeDataPipeline::~vtkPVCompositeDataPipeline()
 {
 }
 
+//----------------------------------------------------------------------------
+int vtkPVCompositeDataPipeline::ExecuteData(
+  vtkInformation* request, vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec)
+{
+  PARAVIEW_TIMELINE_SCOPE("pipeline", this->Algorithm->GetClassName());
+  return this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
+}
+
 //----------------------------------------------------------------------------
 void vtkPVCompositeDataPipeline::CopyDefaultInformation(vtkInformation* request, int direction,
   vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec)
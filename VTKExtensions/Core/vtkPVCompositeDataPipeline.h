@@ -49,6 +49,10 @@ protected:
   // Remove update/whole extent when resetting pipeline information.
   void ResetPipelineInformation(int port, vtkInformation*) override;
 
+  // Overridden to record the execution in the vtkPVTimeline.
+  int ExecuteData(vtkInformation* request, vtkInformationVector** inInfoVec,
+    vtkInformationVector* outInfoVec) override;
+
 private:
   vtkPVCompositeDataPipeline(const vtkPVCompositeDataPipeline&) = delete;
   void operator=(const vtkPVCompositeDataPipeline&) = delete;
@@ -0,0 +1,273 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTimeline.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVTimeline.h"
+
+#include "vtkObjectFactory.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+struct vtkTimelineEvent
+{
+  const char* Category;
+  char Name[64];
+  double Start;
+  double Duration;
+  unsigned int ThreadId;
+};
+
+// Small, stable identifiers for threads; easier to read in trace viewers than
+// hashed std::thread::id.
+unsigned int vtkTimelineThreadId()
+{
+  static std::atomic<unsigned int> NextId(0);
+  static thread_local unsigned int Id = NextId++;
+  return Id;
+}
+
+std::atomic<bool>& vtkTimelineEnabled()
+{
+  static std::atomic<bool> Enabled(
+    vtksys::SystemTools::HasEnv("PARAVIEW_TIMELINE") &&
+    strcmp(vtksys::SystemTools::GetEnv("PARAVIEW_TIMELINE"), "0") != 0);
+  return Enabled;
+}
+
+class vtkTimelineBuffer
+{
+public:
+  static vtkTimelineBuffer& GetInstance()
+  {
+    static vtkTimelineBuffer Instance;
+    return Instance;
+  }
+
+  void Add(const vtkTimelineEvent& event)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (this->Events.size() < this->Capacity)
+    {
+      this->Events.push_back(event);
+    }
+    else if (this->Capacity > 0)
+    {
+      this->Events[this->Head] = event;
+      this->Head = (this->Head + 1) % this->Capacity;
+    }
+  }
+
+  void SetCapacity(size_t capacity)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Capacity = capacity;
+    this->Events.clear();
+    this->Events.shrink_to_fit();
+    this->Head = 0;
+  }
+
+  size_t GetCapacity()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    return this->Capacity;
+  }
+
+  void Clear()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Events.clear();
+    this->Head = 0;
+  }
+
+  size_t GetNumberOfEvents()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    return this->Events.size();
+  }
+
+  // Returns the events, oldest first.
+  std::vector<vtkTimelineEvent> GetEvents()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    std::vector<vtkTimelineEvent> events;
+    events.reserve(this->Events.size());
+    events.insert(events.end(), this->Events.begin() + this->Head, this->Events.end());
+    events.insert(events.end(), this->Events.begin(), this->Events.begin() + this->Head);
+    return events;
+  }
+
+private:
+  vtkTimelineBuffer()
+    : Capacity(65536)
+    , Head(0)
+  {
+    if (const char* capacity = vtksys::SystemTools::GetEnv("PARAVIEW_TIMELINE_CAPACITY"))
+    {
+      this->Capacity = static_cast<size_t>(std::max(0, atoi(capacity)));
+    }
+  }
+
+  std::mutex Mutex;
+  std::vector<vtkTimelineEvent> Events;
+  size_t Capacity;
+  size_t Head;
+};
+
+void vtkTimelineWriteJSONString(std::ostream& os, const char* str)
+{
+  os << '"';
+  for (; *str; ++str)
+  {
+    const unsigned char c = static_cast<unsigned char>(*str);
+    if (c == '"' || c == '\\')
+    {
+      os << '\\' << c;
+    }
+    else if (c < 0x20)
+    {
+      os << ' ';
+    }
+    else
+    {
+      os << c;
+    }
+  }
+  os << '"';
+}
+}
+
+vtkStandardNewMacro(vtkPVTimeline);
+//----------------------------------------------------------------------------
+vtkPVTimeline::vtkPVTimeline()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVTimeline::~vtkPVTimeline()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimeline::SetEnabled(bool enable)
+{
+  vtkTimelineEnabled().store(enable);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVTimeline::GetEnabled()
+{
+  return vtkTimelineEnabled().load(std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimeline::SetCapacity(int capacity)
+{
+  vtkTimelineBuffer::GetInstance().SetCapacity(static_cast<size_t>(std::max(0, capacity)));
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTimeline::GetCapacity()
+{
+  return static_cast<int>(vtkTimelineBuffer::GetInstance().GetCapacity());
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimeline::Clear()
+{
+  vtkTimelineBuffer::GetInstance().Clear();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTimeline::GetNumberOfEvents()
+{
+  return static_cast<int>(vtkTimelineBuffer::GetInstance().GetNumberOfEvents());
+}
+
+//----------------------------------------------------------------------------
+double vtkPVTimeline::GetTimeStamp()
+{
+  return std::chrono::duration<double, std::micro>(
+    std::chrono::system_clock::now().time_since_epoch())
+    .count();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimeline::AddEvent(const char* category, const char* name, double start)
+{
+  if (!vtkPVTimeline::GetEnabled())
+  {
+    return;
+  }
+
+  vtkTimelineEvent event;
+  event.Category = category ? category : "";
+  strncpy(event.Name, name ? name : "", sizeof(event.Name) - 1);
+  event.Name[sizeof(event.Name) - 1] = '\0';
+  event.Start = start;
+  event.Duration = vtkPVTimeline::GetTimeStamp() - start;
+  event.ThreadId = vtkTimelineThreadId();
+  vtkTimelineBuffer::GetInstance().Add(event);
+}
+
+//----------------------------------------------------------------------------
+std::string vtkPVTimeline::GetTraceEvents(int pid, const char* processName)
+{
+  const std::vector<vtkTimelineEvent> events = vtkTimelineBuffer::GetInstance().GetEvents();
+  if (events.empty())
+  {
+    return std::string();
+  }
+
+  std::ostringstream os;
+  os.precision(17);
+  os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"args\":{\"name\":";
+  vtkTimelineWriteJSONString(os, processName ? processName : "");
+  os << "}},\n{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << pid
+     << ",\"args\":{\"sort_index\":" << pid << "}}";
+  for (const auto& event : events)
+  {
+    os << ",\n{\"name\":";
+    vtkTimelineWriteJSONString(os, event.Name);
+    os << ",\"cat\":";
+    vtkTimelineWriteJSONString(os, event.Category);
+    os << ",\"ph\":\"X\",\"ts\":" << event.Start << ",\"dur\":" << event.Duration
+       << ",\"pid\":" << pid << ",\"tid\":" << event.ThreadId << "}";
+  }
+  return os.str();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkPVTimeline::GetChromeTrace(const std::string& traceEvents)
+{
+  return "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" + traceEvents + "\n]}\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimeline::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << vtkPVTimeline::GetEnabled() << endl;
+  os << indent << "Capacity: " << vtkPVTimeline::GetCapacity() << endl;
+  os << indent << "NumberOfEvents: " << vtkPVTimeline::GetNumberOfEvents() << endl;
+}
@@ -0,0 +1,159 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTimeline.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class vtkPVTimeline
+ * @brief records a timeline of pipeline execution, communication and rendering
+ *
+ * vtkPVTimeline is a low-overhead, process-wide recorder for timed events. It
+ * is used to understand what each rank is doing over time: which algorithm
+ * executes when, how long collectives and data delivery take and how long
+ * rendering and compositing take. Events are stored in a fixed-capacity ring
+ * buffer, hence when the buffer is full the oldest events are overwritten.
+ *
+ * Code records events using the `PARAVIEW_TIMELINE_SCOPE` macro, which records
+ * a single event spanning the enclosing scope:
+ *
+ * @code{cpp}
+ * PARAVIEW_TIMELINE_SCOPE("rendering", "StillRender");
+ * @endcode
+ *
+ * The recorder is disabled by default, in which case recording an event
+ * costs a single atomic load. It can be enabled using `SetEnabled` or by
+ * setting the environment variable `PARAVIEW_TIMELINE` to `1`. The buffer
+ * capacity can be changed using `SetCapacity` or the environment variable
+ * `PARAVIEW_TIMELINE_CAPACITY`.
+ *
+ * Events are exported in the Chrome trace event format, which can be loaded
+ * in `chrome://tracing` or https://ui.perfetto.dev. Use
+ * vtkPVTimelineInformation to gather the events from all processes.
+ */
+
+#ifndef vtkPVTimeline_h
+#define vtkPVTimeline_h
+
+#include "vtkObject.h"
+#include "vtkPVVTKExtensionsCoreModule.h" // needed for export macro
+
+#include <string> // for std::string
+
+class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPVTimeline : public vtkObject
+{
+public:
+  static vtkPVTimeline* New();
+  vtkTypeMacro(vtkPVTimeline, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Enable/disable recording on this process.
+   */
+  static void SetEnabled(bool enable);
+  static bool GetEnabled();
+  //@}
+
+  //@{
+  /**
+   * Set/get the maximum number of events kept on this process. Changing the
+   * capacity clears the recorded events. Default is 65536.
+   */
+  static void SetCapacity(int capacity);
+  static int GetCapacity();
+  //@}
+
+  /**
+   * Clear all recorded events on this process.
+   */
+  static void Clear();
+
+  /**
+   * Returns the number of events currently recorded on this process.
+   */
+  static int GetNumberOfEvents();
+
+  /**
+   * Returns the current time in microseconds, as used for the events' time
+   * stamps. This is wall-clock time so that events recorded on different
+   * hosts can be compared.
+   */
+  static double GetTimeStamp();
+
+  /**
+   * Record an event that started at \c start (see GetTimeStamp()) and ended
+   * now. \c category must be a string literal, \c name is copied (and
+   * truncated if too long). Does nothing if recording is disabled.
+   */
+  static void AddEvent(const char* category, const char* name, double start);
+
+  /**
+   * Returns the recorded events as a comma separated list of Chrome trace
+   * event objects, suitable to be placed in the `traceEvents` array of a trace
+   * file. All events are tagged with \c pid and the process is labelled
+   * \c processName. Returns an empty string if there are no events.
+   */
+  static std::string GetTraceEvents(int pid, const char* processName);
+
+  /**
+   * Wraps trace events as returned by GetTraceEvents() in a Chrome trace JSON
+   * document.
+   */
+  static std::string GetChromeTrace(const std::string& traceEvents);
+
+protected:
+  vtkPVTimeline();
+  ~vtkPVTimeline() override;
+
+private:
+  vtkPVTimeline(const vtkPVTimeline&) = delete;
+  void operator=(const vtkPVTimeline&) = delete;
+};
+
+#ifndef __WRAP__
+/**
+ * Helper that records a timeline event spanning its lifetime. \c category and
+ * \c name must remain valid for the lifetime of the scope.
+ */
+class vtkPVTimelineScope
+{
+public:
+  vtkPVTimelineScope(const char* category, const char* name)
+    : Category(category)
+    , Name(name)
+    , Start(vtkPVTimeline::GetEnabled() ? vtkPVTimeline::GetTimeStamp() : -1.0)
+  {
+  }
+  ~vtkPVTimelineScope()
+  {
+    if (this->Start >= 0.0)
+    {
+      vtkPVTimeline::AddEvent(this->Category, this->Name, this->Start);
+    }
+  }
+
+private:
+  vtkPVTimelineScope(const vtkPVTimelineScope&) = delete;
+  void operator=(const vtkPVTimelineScope&) = delete;
+
+  const char* Category;
+  const char* Name;
+  double Start;
+};
+
+#define PARAVIEW_TIMELINE_SCOPE_CONCAT_(a, b) a##b
+#define PARAVIEW_TIMELINE_SCOPE_CONCAT(a, b) PARAVIEW_TIMELINE_SCOPE_CONCAT_(a, b)
+#define PARAVIEW_TIMELINE_SCOPE(category, name)                                                    \
+  vtkPVTimelineScope PARAVIEW_TIMELINE_SCOPE_CONCAT(timelineScope, __LINE__)(category, name)
+#endif
+
+#endif
@@ -20,9 +20,15 @@
 
 vtkStandardNewMacro(vtkPVXMLElement);
 
+#include <algorithm>
 #include <ctype.h>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 #if defined(_WIN32) && !defined(__CYGWIN__)
 #define SNPRINTF _snprintf
@@ -30,15 +36,144 @@ vtkStandardNewMacro(vtkPVXMLElement);
 #define SNPRINTF snprintf
 #endif
 
+namespace
+{
+//----------------------------------------------------------------------------
+// Hash used to look attributes up without allocating or locking.
+size_t vtkPVXMLAttributeNameHash(const char* name)
+{
+  return static_cast<size_t>(
+    vtkPVXMLElement::Hash(vtkPVXMLElement::HashSeed(), name, strlen(name)));
+}
+
+//----------------------------------------------------------------------------
+// Process-wide pool of attribute names. The vocabulary of attribute names is
+// small, hence elements only keep a pointer to the pooled name instead of a
+// copy of it. The pool is split in shards selected by the name's hash, each
+// with its own lock, so that concurrent parsers seldom contend.
+class vtkPVXMLAttributeNamePool
+{
+public:
+  static const std::string* Intern(const char* name, size_t hash)
+  {
+    static vtkPVXMLAttributeNamePool Pool;
+    Shard& shard = Pool.Shards[hash % NumberOfShards];
+    std::lock_guard<std::mutex> lock(shard.Mutex);
+    // node-based container: pointers to the elements remain valid.
+    return &*shard.Names.insert(name).first;
+  }
+
+private:
+  static const size_t NumberOfShards = 16;
+  struct Shard
+  {
+    std::mutex Mutex;
+    std::unordered_set<std::string> Names;
+  };
+  Shard Shards[NumberOfShards];
+};
+}
+
 struct vtkPVXMLElementInternals
 {
-  std::vector<std::string> AttributeNames;
-  std::vector<std::string> AttributeValues;
+  struct Attribute
+  {
+    size_t Hash;
+    const std::string* Name; // interned, see vtkPVXMLAttributeNamePool.
+    std::string Value;
+  };
+  typedef std::vector<Attribute> VectorOfAttributes;
+  VectorOfAttributes Attributes;
   typedef std::vector<vtkSmartPointer<vtkPVXMLElement> > VectorOfElements;
   VectorOfElements NestedElements;
   std::string CharacterData;
+
+  Attribute* FindAttribute(const char* name)
+  {
+    const size_t hash = vtkPVXMLAttributeNameHash(name);
+    for (auto& attribute : this->Attributes)
+    {
+      if (attribute.Hash == hash && *attribute.Name == name)
+      {
+        return &attribute;
+      }
+    }
+    return NULL;
+  }
+
+  void AddAttribute(const char* name, const char* value)
+  {
+    Attribute attribute;
+    attribute.Hash = vtkPVXMLAttributeNameHash(name);
+    attribute.Name = vtkPVXMLAttributeNamePool::Intern(name, attribute.Hash);
+    attribute.Value = value;
+    this->Attributes.push_back(std::move(attribute));
+  }
+
+  void MergeAttribute(const Attribute& other)
+  {
+    for (auto& attribute : this->Attributes)
+    {
+      if (attribute.Name == other.Name)
+      {
+        attribute.Value = other.Value;
+        return;
+      }
+    }
+    this->Attributes.push_back(other);
+  }
 };
 
+namespace
+{
+//----------------------------------------------------------------------------
+void vtkPVXMLElementWriteBinary(std::string& buffer, vtkTypeUInt32 value)
+{
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+//----------------------------------------------------------------------------
+void vtkPVXMLElementWriteBinary(std::string& buffer, const char* str)
+{
+  vtkTypeUInt32 length = str ? static_cast<vtkTypeUInt32>(strlen(str)) : 0;
+  vtkPVXMLElementWriteBinary(buffer, length);
+  buffer.append(str ? str : "", length);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVXMLElementWriteBinary(std::string& buffer, const std::string& str)
+{
+  vtkPVXMLElementWriteBinary(buffer, static_cast<vtkTypeUInt32>(str.size()));
+  buffer.append(str);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVXMLElementReadBinary(const char*& data, const char* end, vtkTypeUInt32& value)
+{
+  if (end - data < static_cast<std::ptrdiff_t>(sizeof(value)))
+  {
+    return false;
+  }
+  memcpy(&value, data, sizeof(value));
+  data += sizeof(value);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVXMLElementReadBinary(const char*& data, const char* end, std::string& str)
+{
+  vtkTypeUInt32 length;
+  if (!vtkPVXMLElementReadBinary(data, end, length) ||
+    end - data < static_cast<std::ptrdiff_t>(length))
+  {
+    return false;
+  }
+  str.assign(data, length);
+  data += length;
+  return true;
+}
+}
+
 // Function to check if a string is full of whitespace characters.
 static bool vtkIsSpace(const std::string& str)
 {
@@ -144,8 +279,7 @@ void vtkPVXMLElement::AddAttribute(const char* attrName, const char* attrValue)
     return;
   }
 
-  this->Internal->AttributeNames.push_back(attrName);
-  this->Internal->AttributeValues.push_back(attrValue);
+  this->Internal->AddAttribute(attrName, attrValue);
 }
 
 //----------------------------------------------------------------------------
@@ -156,26 +290,20 @@ void vtkPVXMLElement::SetAttribute(const char* attrName, const char* attrValue)
     return;
   }
 
-  // iterate over the names, and find if the attribute name exists.
-  size_t numAttributes = this->Internal->AttributeNames.size();
-  size_t i;
-  for (i = 0; i < numAttributes; ++i)
+  // find if the attribute name exists.
+  if (vtkPVXMLElementInternals::Attribute* attribute = this->Internal->FindAttribute(attrName))
   {
-    if (strcmp(this->Internal->AttributeNames[i].c_str(), attrName) == 0)
-    {
-      this->Internal->AttributeValues[i] = attrValue;
-      return;
-    }
+    attribute->Value = attrValue;
+    return;
   }
   // add the attribute.
-  this->AddAttribute(attrName, attrValue);
+  this->Internal->AddAttribute(attrName, attrValue);
 }
 
 //----------------------------------------------------------------------------
 void vtkPVXMLElement::ReadXMLAttributes(const char** atts)
 {
-  this->Internal->AttributeNames.clear();
-  this->Internal->AttributeValues.clear();
+  this->Internal->Attributes.clear();
 
   if (atts)
   {
@@ -186,6 +314,7 @@ void vtkPVXMLElement::ReadXMLAttributes(const char** atts)
       ++count;
     }
     unsigned int numberOfAttributes = count / 2;
+    this->Internal->Attributes.reserve(numberOfAttributes);
 
     unsigned int i;
     for (i = 0; i < numberOfAttributes; ++i)
@@ -255,16 +384,9 @@ void vtkPVXMLElement::AddCharacterData(const char* data, int length)
 //----------------------------------------------------------------------------
 const char* vtkPVXMLElement::GetAttributeOrDefault(const char* name, const char* notFound)
 {
-  size_t numAttributes = this->Internal->AttributeNames.size();
-  size_t i;
-  for (i = 0; i < numAttributes; ++i)
-  {
-    if (strcmp(this->Internal->AttributeNames[i].c_str(), name) == 0)
-    {
-      return this->Internal->AttributeValues[i].c_str();
-    }
-  }
-  return notFound;
+  const vtkPVXMLElementInternals::Attribute* attribute =
+    name ? this->Internal->FindAttribute(name) : NULL;
+  return attribute ? attribute->Value.c_str() : notFound;
 }
 //----------------------------------------------------------------------------
 const char* vtkPVXMLElement::GetCharacterData()
@@ -282,12 +404,10 @@ void vtkPVXMLElement::PrintXML()
 void vtkPVXMLElement::PrintXML(ostream& os, vtkIndent indent)
 {
   os << indent << "<" << (this->Name ? this->Name : "NoName");
-  size_t numAttributes = this->Internal->AttributeNames.size();
-  size_t i;
-  for (i = 0; i < numAttributes; ++i)
+  for (const auto& attribute : this->Internal->Attributes)
   {
-    const char* aName = this->Internal->AttributeNames[i].c_str();
-    const char* aValue = this->Internal->AttributeValues[i].c_str();
+    const char* aName = attribute.Name->c_str();
+    const char* aValue = attribute.Value.c_str();
 
     // we always print the encoded value. The expat parser processes encoded
     // values when reading them, hence we don't need any decoding when reading
@@ -660,26 +780,9 @@ void vtkPVXMLElement::Merge(vtkPVXMLElement* element, const char* attributeName)
   }
 
   // add attributes from element to this, or override attribute values on this
-  size_t numAttributes = element->Internal->AttributeNames.size();
-  size_t numAttributes2 = this->Internal->AttributeNames.size();
-
-  for (size_t i = 0; i < numAttributes; ++i)
+  for (const auto& attribute : element->Internal->Attributes)
   {
-    bool found = false;
-    for (size_t j = 0; !found && j < numAttributes2; ++j)
-    {
-      if (element->Internal->AttributeNames[i] == this->Internal->AttributeNames[j])
-      {
-        this->Internal->AttributeValues[j] = element->Internal->AttributeValues[i];
-        found = true;
-      }
-    }
-    // if not found, add it
-    if (!found)
-    {
-      this->AddAttribute(element->Internal->AttributeNames[i].c_str(),
-        element->Internal->AttributeValues[i].c_str());
-    }
+    this->Internal->MergeAttribute(attribute);
   }
 
   // now recursively merge the children with the same names
@@ -709,8 +812,7 @@ void vtkPVXMLElement::Merge(vtkPVXMLElement* element, const char* attributeName)
       vtkSmartPointer<vtkPVXMLElement> newElement = vtkSmartPointer<vtkPVXMLElement>::New();
       newElement->SetName((*iter)->GetName());
       newElement->SetId((*iter)->GetId());
-      newElement->Internal->AttributeNames = (*iter)->Internal->AttributeNames;
-      newElement->Internal->AttributeValues = (*iter)->Internal->AttributeValues;
+      newElement->Internal->Attributes = (*iter)->Internal->Attributes;
       this->AddNestedElement(newElement);
       newElement->Merge(*iter, attributeName);
     }
@@ -722,8 +824,7 @@ void vtkPVXMLElement::CopyTo(vtkPVXMLElement* other)
 {
   other->SetName(GetName());
   other->SetId(GetId());
-  other->Internal->AttributeNames = this->Internal->AttributeNames;
-  other->Internal->AttributeValues = this->Internal->AttributeValues;
+  other->Internal->Attributes = this->Internal->Attributes;
   other->AddCharacterData(
     this->Internal->CharacterData.c_str(), static_cast<int>(this->Internal->CharacterData.size()));
 
@@ -743,8 +844,7 @@ void vtkPVXMLElement::CopyAttributesTo(vtkPVXMLElement* other)
 {
   other->SetName(GetName());
   other->SetId(GetId());
-  other->Internal->AttributeNames = this->Internal->AttributeNames;
-  other->Internal->AttributeValues = this->Internal->AttributeValues;
+  other->Internal->Attributes = this->Internal->Attributes;
   other->AddCharacterData(
     this->Internal->CharacterData.c_str(), static_cast<int>(this->Internal->CharacterData.size()));
 }
@@ -770,19 +870,94 @@ bool vtkPVXMLElement::Equals(vtkPVXMLElement* other)
 //----------------------------------------------------------------------------
 void vtkPVXMLElement::RemoveAttribute(const char* name)
 {
-  std::vector<std::string>::iterator nameIterator = this->Internal->AttributeNames.begin();
-  std::vector<std::string>::iterator valueIterator = this->Internal->AttributeValues.begin();
-  while (nameIterator != this->Internal->AttributeNames.end())
+  if (vtkPVXMLElementInternals::Attribute* attribute = this->Internal->FindAttribute(name))
   {
-    if (strcmp(nameIterator->c_str(), name) == 0)
-    {
-      this->Internal->AttributeNames.erase(nameIterator);
-      this->Internal->AttributeValues.erase(valueIterator);
-      return;
-    }
-    nameIterator++;
-    valueIterator++;
+    this->Internal->Attributes.erase(
+      this->Internal->Attributes.begin() + (attribute - this->Internal->Attributes.data()));
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkTypeUInt64 vtkPVXMLElement::Hash(vtkTypeUInt64 hash, const char* data, size_t length)
+{
+  for (size_t cc = 0; cc < length; ++cc)
+  {
+    hash ^= static_cast<unsigned char>(data[cc]);
+    hash *= 1099511628211ull;
   }
+  return hash;
 }
 
 //----------------------------------------------------------------------------
+void vtkPVXMLElement::WriteBinary(std::string& buffer)
+{
+  vtkPVXMLElementWriteBinary(buffer, this->Name);
+  vtkPVXMLElementWriteBinary(buffer, this->Id);
+
+  vtkPVXMLElementWriteBinary(
+    buffer, static_cast<vtkTypeUInt32>(this->Internal->Attributes.size()));
+  for (const auto& attribute : this->Internal->Attributes)
+  {
+    vtkPVXMLElementWriteBinary(buffer, *attribute.Name);
+    vtkPVXMLElementWriteBinary(buffer, attribute.Value);
+  }
+  vtkPVXMLElementWriteBinary(buffer, this->Internal->CharacterData);
+
+  vtkPVXMLElementWriteBinary(
+    buffer, static_cast<vtkTypeUInt32>(this->Internal->NestedElements.size()));
+  vtkPVXMLElementInternals::VectorOfElements::iterator iter;
+  for (iter = this->Internal->NestedElements.begin(); iter != this->Internal->NestedElements.end();
+       ++iter)
+  {
+    (*iter)->WriteBinary(buffer);
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkPVXMLElement* vtkPVXMLElement::ReadBinary(const char*& data, const char* end)
+{
+  std::string name, id;
+  vtkTypeUInt32 numAttributes;
+  if (!vtkPVXMLElementReadBinary(data, end, name) || !vtkPVXMLElementReadBinary(data, end, id) ||
+    !vtkPVXMLElementReadBinary(data, end, numAttributes))
+  {
+    return NULL;
+  }
+
+  vtkSmartPointer<vtkPVXMLElement> element = vtkSmartPointer<vtkPVXMLElement>::New();
+  element->SetName(name.empty() ? NULL : name.c_str());
+  element->SetId(id.empty() ? NULL : id.c_str());
+  // each attribute takes at least 8 bytes, don't trust the count blindly.
+  element->Internal->Attributes.reserve(
+    std::min<size_t>(numAttributes, static_cast<size_t>(end - data) / 8));
+  std::string attrName, attrValue;
+  for (vtkTypeUInt32 i = 0; i < numAttributes; ++i)
+  {
+    if (!vtkPVXMLElementReadBinary(data, end, attrName) ||
+      !vtkPVXMLElementReadBinary(data, end, attrValue))
+    {
+      return NULL;
+    }
+    element->Internal->AddAttribute(attrName.c_str(), attrValue.c_str());
+  }
+
+  vtkTypeUInt32 numNested;
+  if (!vtkPVXMLElementReadBinary(data, end, element->Internal->CharacterData) ||
+    !vtkPVXMLElementReadBinary(data, end, numNested))
+  {
+    return NULL;
+  }
+  for (vtkTypeUInt32 i = 0; i < numNested; ++i)
+  {
+    vtkPVXMLElement* nested = vtkPVXMLElement::ReadBinary(data, end);
+    if (!nested)
+    {
+      return NULL;
+    }
+    element->AddNestedElement(nested);
+    nested->Delete();
+  }
+
+  element->Register(NULL);
+  return element;
+}
@@ -263,6 +263,28 @@ public:
    */
   void CopyAttributesTo(vtkPVXMLElement* other);
 
+  //@{
+  /**
+   * Compact binary representation of the element and all its nested elements.
+   * WriteBinary() appends the representation to \c buffer. ReadBinary()
+   * rebuilds an element from the bytes in [\c data, \c end), advances \c data
+   * past the element and returns a new instance (the caller owns the
+   * reference), or NULL if the buffer is truncated or malformed.
+   * The representation is meant for caches local to a node: it uses the
+   * native byte order.
+   */
+  void WriteBinary(std::string& buffer);
+  static vtkPVXMLElement* ReadBinary(const char*& data, const char* end);
+  //@}
+
+  /**
+   * 64-bit FNV-1a hash of \c length bytes of \c data, continued from \c hash.
+   * Pass HashSeed() to start a new hash. Used for the attribute names and for
+   * keying and checking caches of binary representations.
+   */
+  static vtkTypeUInt64 Hash(vtkTypeUInt64 hash, const char* data, size_t length);
+  static vtkTypeUInt64 HashSeed() { return 14695981039346656037ull; }
+
 protected:
   vtkPVXMLElement();
   ~vtkPVXMLElement() override;
@@ -17,7 +17,9 @@
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVXMLElement.h"
-#include <sstream>
+
+#include <string>
+#include <utility>
 
 vtkStandardNewMacro(vtkPVXMLParser);
 
@@ -31,6 +33,7 @@ vtkPVXMLParser::vtkPVXMLParser()
   this->ElementIdIndex = 0;
   this->RootElement = 0;
   this->SuppressErrorMessages = 0;
+  this->StreamingDepth = 1;
 }
 
 //----------------------------------------------------------------------------
@@ -53,6 +56,14 @@ void vtkPVXMLParser::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "SuppressErrorMessages: " << this->SuppressErrorMessages << "\n";
+  os << indent << "StreamingDepth: " << this->StreamingDepth << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkPVXMLParser::SetElementCallback(ElementCallback callback)
+{
+  this->StreamingCallback = std::move(callback);
+  this->Modified();
 }
 
 //----------------------------------------------------------------------------
@@ -68,9 +79,7 @@ void vtkPVXMLParser::StartElement(const char* name, const char** atts)
   }
   else
   {
-    std::ostringstream idstr;
-    idstr << this->ElementIdIndex++ << ends;
-    element->SetId(idstr.str().c_str());
+    element->SetId(std::to_string(this->ElementIdIndex++).c_str());
   }
   this->PushOpenElement(element);
 }
@@ -80,7 +89,12 @@ void vtkPVXMLParser::EndElement(const char* vtkNotUsed(name))
 {
   vtkPVXMLElement* finished = this->PopOpenElement();
   unsigned int numOpen = this->NumberOfOpenElements;
-  if (numOpen > 0)
+  if (this->StreamingCallback && static_cast<int>(numOpen) == this->StreamingDepth)
+  {
+    this->StreamingCallback(finished);
+    finished->Delete();
+  }
+  else if (numOpen > 0)
   {
     this->OpenElements[numOpen - 1]->AddNestedElement(finished);
     finished->Delete();
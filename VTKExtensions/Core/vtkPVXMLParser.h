@@ -26,6 +26,10 @@
 #include "vtkSmartPointer.h"              // needed for vtkSmartPointer.
 #include "vtkXMLParser.h"
 
+#ifndef __WRAP__
+#include <functional> // for std::function
+#endif
+
 class vtkPVXMLElement;
 
 class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPVXMLParser : public vtkXMLParser
@@ -64,11 +68,36 @@ public:
   static vtkSmartPointer<vtkPVXMLElement> ParseXML(
     const char* xmlcontents, bool suppress_errors = false);
 
+  //@{
+  /**
+   * Streaming mode for consumers that don't need the full tree. When an
+   * element callback is set, every element closed at depth StreamingDepth (the
+   * root element is at depth 0) is passed to the callback, complete with its
+   * nested elements, as soon as its end tag is parsed. It is then released
+   * instead of being added to its parent, so the memory used while parsing is
+   * bounded by the largest such element rather than by the document.
+   * Ancestors of the streamed elements are still available through
+   * GetRootElement(), without the streamed children. The callback holds no
+   * reference to the element; it must register it to keep it around.
+   * StreamingDepth is 1 by default.
+   */
+#ifndef __WRAP__
+  using ElementCallback = std::function<void(vtkPVXMLElement*)>;
+  void SetElementCallback(ElementCallback callback);
+#endif
+  vtkSetClampMacro(StreamingDepth, int, 0, VTK_INT_MAX);
+  vtkGetMacro(StreamingDepth, int);
+  //@}
+
 protected:
   vtkPVXMLParser();
   ~vtkPVXMLParser() override;
 
   int SuppressErrorMessages;
+  int StreamingDepth;
+#ifndef __WRAP__
+  ElementCallback StreamingCallback;
+#endif
 
   void StartElement(const char* name, const char** atts) override;
   void EndElement(const char* name) override;
@@ -0,0 +1,217 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestHaloFinderSMPScaling.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Runs center and subhalo finding on a synthetic particle cloud with an
+// increasing number of threads, reports the timings and checks that the
+// results do not depend on the number of threads.
+
+#include <vtk_mpi.h>
+
+#include "vtkCellType.h"
+#include "vtkDataArray.h"
+#include "vtkFloatArray.h"
+#include "vtkMPIController.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPANLHaloFinder.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+#include "vtkTimerLog.h"
+#include "vtkTypeInt64Array.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+const double BoxSize = 64.0;
+
+// Clumps of particles, each made of a few sub-clumps, over a sparse uniform
+// background.
+void CreateParticleCloud(vtkUnstructuredGrid* cloud)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  auto uniform = [&random](double min, double max) {
+    random->Next();
+    return random->GetRangeValue(min, max);
+  };
+  auto gaussian = [&uniform](double mean, double sigma) {
+    // Box-Muller transform
+    const double u1 = std::max(uniform(0.0, 1.0), 1e-12);
+    const double u2 = uniform(0.0, 1.0);
+    return mean + sigma * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * 3.14159265358979 * u2);
+  };
+  auto wrap = [](double x) { return std::min(std::max(x, 0.0), BoxSize - 1e-6); };
+
+  std::vector<double> positions;
+  for (int clump = 0; clump < 48; ++clump)
+  {
+    const double center[3] = { uniform(4, BoxSize - 4), uniform(4, BoxSize - 4),
+      uniform(4, BoxSize - 4) };
+    const int numParticles = static_cast<int>(1000 * std::pow(2.0, uniform(0.0, 3.5)));
+    for (int sub = 0; sub < 3; ++sub)
+    {
+      const double subCenter[3] = { gaussian(center[0], 0.3), gaussian(center[1], 0.3),
+        gaussian(center[2], 0.3) };
+      const double sigma = sub == 0 ? 0.25 : 0.08;
+      const int count = sub == 0 ? numParticles : numParticles / 8;
+      for (int i = 0; i < count; ++i)
+      {
+        for (int c = 0; c < 3; ++c)
+        {
+          positions.push_back(wrap(gaussian(subCenter[c], sigma)));
+        }
+      }
+    }
+  }
+  for (int i = 0; i < 20000; ++i)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      positions.push_back(uniform(0, BoxSize - 1e-6));
+    }
+  }
+
+  const vtkIdType numPoints = static_cast<vtkIdType>(positions.size() / 3);
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(numPoints);
+  const char* velocityNames[] = { "vx", "vy", "vz" };
+  vtkNew<vtkFloatArray> velocities[3];
+  for (int c = 0; c < 3; ++c)
+  {
+    velocities[c]->SetName(velocityNames[c]);
+    velocities[c]->SetNumberOfTuples(numPoints);
+    cloud->GetPointData()->AddArray(velocities[c]);
+  }
+  vtkNew<vtkTypeInt64Array> ids;
+  ids->SetName("id");
+  ids->SetNumberOfTuples(numPoints);
+  cloud->GetPointData()->AddArray(ids);
+
+  cloud->Allocate(numPoints);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+  {
+    points->SetPoint(i, &positions[3 * i]);
+    for (int c = 0; c < 3; ++c)
+    {
+      velocities[c]->SetValue(i, static_cast<float>(gaussian(0.0, 100.0)));
+    }
+    ids->SetValue(i, i);
+    cloud->InsertNextCell(VTK_VERTEX, 1, &i);
+  }
+  cloud->SetPoints(points);
+}
+
+bool SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+    a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfValues(); ++i)
+  {
+    if (a->GetComponent(i / a->GetNumberOfComponents(), i % a->GetNumberOfComponents()) !=
+      b->GetComponent(i / b->GetNumberOfComponents(), i % b->GetNumberOfComponents()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+int RunScaling()
+{
+  vtkNew<vtkUnstructuredGrid> cloud;
+  CreateParticleCloud(cloud);
+  std::cout << "Particles: " << cloud->GetNumberOfPoints() << std::endl;
+
+  std::vector<int> threadCounts = { 1, 2, 4, vtkSMPTools::GetEstimatedNumberOfThreads() };
+  std::sort(threadCounts.begin(), threadCounts.end());
+  threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+  vtkSmartPointer<vtkDataArray> referenceCenters, referenceSubhalos, referenceSubhaloMass;
+  for (int numThreads : threadCounts)
+  {
+    // Some SMP backends only honor the first initialization; the reported
+    // thread count tells what was actually used.
+    vtkSMPTools::Initialize(numThreads);
+
+    vtkNew<vtkPANLHaloFinder> haloFinder;
+    haloFinder->SetInputData(cloud);
+    haloFinder->SetRL(BoxSize);
+    haloFinder->SetNP(static_cast<int>(BoxSize));
+    haloFinder->SetBB(0.2);
+    haloFinder->SetPMin(200);
+    haloFinder->SetCenterFindingMode(vtkPANLHaloFinder::MOST_BOUND_PARTICLE);
+    haloFinder->SetRunSubHaloFinder(true);
+    haloFinder->SetMinFOFSubhaloSize(2000);
+    haloFinder->SetMinCandidateSize(20);
+
+    vtkNew<vtkTimerLog> timer;
+    timer->StartTimer();
+    haloFinder->Update();
+    timer->StopTimer();
+
+    vtkUnstructuredGrid* halos = haloFinder->GetOutput(1);
+    vtkUnstructuredGrid* subhalos = haloFinder->GetOutput(2);
+    std::cout << "Threads: " << vtkSMPTools::GetEstimatedNumberOfThreads()
+              << " halos: " << halos->GetNumberOfPoints()
+              << " subhalos: " << subhalos->GetNumberOfPoints()
+              << " time: " << timer->GetElapsedTime() << "s" << std::endl;
+
+    vtkDataArray* centers = halos->GetPointData()->GetArray("fof_center");
+    vtkDataArray* subhaloTags = haloFinder->GetOutput(0)->GetPointData()->GetArray("subhalo_tag");
+    vtkDataArray* subhaloMass = subhalos->GetPointData()->GetArray("subhalo_mass");
+    if (!centers || !subhaloTags || !subhaloMass || halos->GetNumberOfPoints() == 0)
+    {
+      std::cerr << "Missing halo finder outputs." << std::endl;
+      return 0;
+    }
+    if (!referenceCenters)
+    {
+      referenceCenters = centers;
+      referenceSubhalos = subhaloTags;
+      referenceSubhaloMass = subhaloMass;
+    }
+    else if (!SameArrays(referenceCenters, centers) ||
+      !SameArrays(referenceSubhalos, subhaloTags) ||
+      !SameArrays(referenceSubhaloMass, subhaloMass))
+    {
+      std::cerr << "Results differ with " << numThreads << " threads." << std::endl;
+      return 0;
+    }
+  }
+  return 1;
+}
+}
+
+int TestHaloFinderSMPScaling(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+
+  vtkNew<vtkMPIController> controller;
+  controller->Initialize();
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+
+  int retVal = RunScaling();
+
+  controller->Finalize();
+  return !retVal;
+}
@@ -25,6 +25,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTypeInt64Array.h"
 #include "vtkUnstructuredGrid.h"
 
@@ -36,7 +38,10 @@
 #include "Partition.h"
 #include "SubHaloFinder.h"
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace
@@ -49,33 +54,29 @@ static const ID_T MCP_THRESHOLD = 100;
 class ExtractHalo
 {
 public:
-  ExtractHalo(int numHalos, int* haloCounts, cosmotk::FOFHaloProperties* fof)
+  ExtractHalo(int* haloCounts, cosmotk::FOFHaloProperties* fof)
   {
     this->size = 0;
     this->counts = haloCounts;
     this->fofProperties = fof;
-    int maxNumParticles = 0;
-    for (int i = 0; i < numHalos; ++i)
-    {
-      if (haloCounts[i] > maxNumParticles)
-      {
-        maxNumParticles = haloCounts[i];
-      }
-    }
-    this->actualIndex.resize(maxNumParticles);
-    this->xLoc.resize(maxNumParticles);
-    this->yLoc.resize(maxNumParticles);
-    this->zLoc.resize(maxNumParticles);
-    this->xVel.resize(maxNumParticles);
-    this->yVel.resize(maxNumParticles);
-    this->zVel.resize(maxNumParticles);
-    this->mass.resize(maxNumParticles);
-    this->id.resize(maxNumParticles);
   }
 
+  // Thread safe as long as each thread uses its own ExtractHalo.
   void SetCurrentHalo(int haloIdx)
   {
     this->size = this->counts[haloIdx];
+    if (this->actualIndex.size() < static_cast<size_t>(this->size))
+    {
+      this->actualIndex.resize(this->size);
+      this->xLoc.resize(this->size);
+      this->yLoc.resize(this->size);
+      this->zLoc.resize(this->size);
+      this->xVel.resize(this->size);
+      this->yVel.resize(this->size);
+      this->zVel.resize(this->size);
+      this->mass.resize(this->size);
+      this->id.resize(this->size);
+    }
 
     fofProperties->extractInformation(haloIdx, &this->actualIndex[0], &this->xLoc[0],
       &this->yLoc[0], &this->zLoc[0], &this->xVel[0], &this->yVel[0], &this->zVel[0],
@@ -119,6 +120,28 @@ private:
   std::vector<POSVEL_T> mass;
   std::vector<ID_T> id;
 };
+
+// Returns the given halos sorted by decreasing particle count, so that the
+// most expensive halos are scheduled first when processed in parallel.
+std::vector<int> SortHalosBySize(std::vector<int> halos, const int* haloCounts)
+{
+  std::stable_sort(halos.begin(), halos.end(),
+    [haloCounts](int a, int b) { return haloCounts[a] > haloCounts[b]; });
+  return halos;
+}
+
+// Results of the subhalo finder for one FOF halo.
+struct SubhaloResult
+{
+  std::vector<long> Count;
+  std::vector<POSVEL_T> Mass;
+  std::vector<POSVEL_T> CofMassX, CofMassY, CofMassZ;
+  std::vector<POSVEL_T> PosX, PosY, PosZ;
+  std::vector<POSVEL_T> VelX, VelY, VelZ;
+  std::vector<POSVEL_T> VelDisp;
+  // (particle index, subhalo id) for the particles of the halo.
+  std::vector<std::pair<int, ID_T> > ParticleSubhaloIds;
+};
 }
 
 class vtkPANLHaloFinder::vtkInternals
@@ -494,11 +517,8 @@ void vtkPANLHaloFinder::ExecuteSubHaloFinder(
 {
   std::vector<ID_T> parentHaloTag, subHaloTag;
   std::vector<long> parentFOFCount, subCount;
-  std::vector<POSVEL_T> subRadius, subMass, subCenterOfMassX, subCenterOfMassY, subCenterOfMassZ,
-    subAvgX, subAvgY, subAvgZ, subAvgVX, subAvgVY, subAvgVZ, subVelDisp;
-
-  std::vector<POSVEL_T> shX, shY, shZ, shVX, shVY, shVZ;
-  std::vector<ID_T> shTag, shHID, shID;
+  std::vector<POSVEL_T> subMass, subCenterOfMassX, subCenterOfMassY, subCenterOfMassZ, subAvgX,
+    subAvgY, subAvgZ, subAvgVX, subAvgVY, subAvgVZ, subVelDisp;
 
   vtkNew<vtkTypeInt64Array> subhaloId;
   subhaloId->SetName("subhalo_tag");
@@ -510,20 +530,38 @@ void vtkPANLHaloFinder::ExecuteSubHaloFinder(
 
   int numberOfFOFHalos = this->Internal->haloFinder->getNumberOfHalos();
   int* fofHaloCount = this->Internal->haloFinder->getHaloCount();
-  ExtractHalo haloData(numberOfFOFHalos, fofHaloCount, this->Internal->fof);
 
+  std::vector<int> largeHalos;
   for (int halo = 0; halo < numberOfFOFHalos; ++halo)
   {
-    long particleCount = fofHaloCount[halo];
-    if (particleCount > this->MinFOFSubhaloSize)
+    if (fofHaloCount[halo] > this->MinFOFSubhaloSize)
     {
-      haloData.SetCurrentHalo(halo);
+      largeHalos.push_back(halo);
+    }
+  }
+
+  // Halos are independent: find the subhalos of each in parallel, biggest
+  // first, and merge the results in halo order afterwards.
+  std::vector<SubhaloResult> results(numberOfFOFHalos);
+  const std::vector<int> order = SortHalosBySize(largeHalos, fofHaloCount);
+  vtkSMPThreadLocal<std::shared_ptr<ExtractHalo> > localHaloData;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(order.size()), 1, [&](vtkIdType begin, vtkIdType end) {
+    std::shared_ptr<ExtractHalo>& haloData = localHaloData.Local();
+    if (!haloData)
+    {
+      haloData = std::make_shared<ExtractHalo>(fofHaloCount, this->Internal->fof);
+    }
+    for (vtkIdType cc = begin; cc < end; ++cc)
+    {
+      const int halo = order[cc];
+      SubhaloResult& result = results[halo];
+      haloData->SetCurrentHalo(halo);
 
       cosmotk::SubHaloFinder subFinder;
       subFinder.setParameters(this->ParticleMass, GRAVITY_C, this->AlphaFactor, this->BetaFactor,
         this->MinCandidateSize, this->NumSPHNeighbors, this->NumNeighbors);
 
-      haloData.SetParticles(subFinder);
+      haloData->SetParticles(subFinder);
       subFinder.findSubHalos();
 
       int numberOfSubHalos = subFinder.getNumberOfSubhalos();
@@ -534,58 +572,55 @@ void vtkPANLHaloFinder::ExecuteSubHaloFinder(
       cosmotk::FOFHaloProperties subhaloProperties;
       subhaloProperties.setHalos(numberOfSubHalos, fofSubHalos, fofSubHaloCount, fofSubHaloList);
       subhaloProperties.setParameters("", this->RL, this->DeadSize, this->BB);
-      haloData.SetParticles(subhaloProperties);
-
-      std::vector<POSVEL_T> subhaloMass;
-      subhaloProperties.FOFHaloMass(&subhaloMass);
+      haloData->SetParticles(subhaloProperties);
 
-      std::vector<POSVEL_T> subhaloXPos;
-      std::vector<POSVEL_T> subhaloYPos;
-      std::vector<POSVEL_T> subhaloZPos;
-      subhaloProperties.FOFPosition(&subhaloXPos, &subhaloYPos, &subhaloZPos);
-
-      std::vector<POSVEL_T> subhaloXCofMass;
-      std::vector<POSVEL_T> subhaloYCofMass;
-      std::vector<POSVEL_T> subhaloZCofMass;
-      subhaloProperties.FOFCenterOfMass(&subhaloXCofMass, &subhaloYCofMass, &subhaloZCofMass);
-
-      std::vector<POSVEL_T> subhaloXVel;
-      std::vector<POSVEL_T> subhaloYVel;
-      std::vector<POSVEL_T> subhaloZVel;
-      subhaloProperties.FOFVelocity(&subhaloXVel, &subhaloYVel, &subhaloZVel);
-
-      std::vector<POSVEL_T> subhaloVelDisp;
+      subhaloProperties.FOFHaloMass(&result.Mass);
+      subhaloProperties.FOFPosition(&result.PosX, &result.PosY, &result.PosZ);
+      subhaloProperties.FOFCenterOfMass(&result.CofMassX, &result.CofMassY, &result.CofMassZ);
+      subhaloProperties.FOFVelocity(&result.VelX, &result.VelY, &result.VelZ);
       subhaloProperties.FOFVelocityDispersion(
-        &subhaloXVel, &subhaloYVel, &subhaloZVel, &subhaloVelDisp);
-
-      for (int sidx = 0; sidx < numberOfSubHalos; ++sidx)
-      {
-        parentHaloTag.push_back(this->Internal->haloFinder->getHaloID(halo));
-        parentFOFCount.push_back(particleCount);
-        subHaloTag.push_back(sidx);
-        subCount.push_back(fofSubHaloCount[sidx]);
-        subMass.push_back(subhaloMass[sidx]);
-        subCenterOfMassX.push_back(subhaloXCofMass[sidx]);
-        subCenterOfMassY.push_back(subhaloYCofMass[sidx]);
-        subCenterOfMassZ.push_back(subhaloZCofMass[sidx]);
-        subAvgX.push_back(subhaloXPos[sidx]);
-        subAvgY.push_back(subhaloYPos[sidx]);
-        subAvgZ.push_back(subhaloZPos[sidx]);
-        subAvgVX.push_back(subhaloXVel[sidx]);
-        subAvgVY.push_back(subhaloYVel[sidx]);
-        subAvgVZ.push_back(subhaloZVel[sidx]);
-        subVelDisp.push_back(subhaloVelDisp[sidx]);
-      }
+        &result.VelX, &result.VelY, &result.VelZ, &result.VelDisp);
+      result.Count.assign(fofSubHaloCount, fofSubHaloCount + numberOfSubHalos);
 
-      size_t pointsBefore = shX.size();
+      std::vector<POSVEL_T> shX, shY, shZ, shVX, shVY, shVZ;
+      std::vector<ID_T> shTag, shHID, shID;
       subFinder.getSubhaloCosmoData(this->Internal->haloFinder->getHaloID(halo), shX, shY, shZ,
         shVX, shVY, shVZ, shTag, shHID, shID);
-
-      for (size_t i = 0; pointsBefore + i < shX.size(); ++i)
+      result.ParticleSubhaloIds.reserve(shID.size());
+      for (size_t i = 0; i < shID.size(); ++i)
       {
-        subhaloId->SetValue(haloData.GetActualIndex(i), shID[pointsBefore + i]);
+        result.ParticleSubhaloIds.push_back(std::make_pair(haloData->GetActualIndex(i), shID[i]));
       }
     }
+  });
+
+  for (int halo : largeHalos)
+  {
+    const SubhaloResult& result = results[halo];
+    const long particleCount = fofHaloCount[halo];
+    const ID_T haloTag = this->Internal->haloFinder->getHaloID(halo);
+    for (size_t sidx = 0; sidx < result.Count.size(); ++sidx)
+    {
+      parentHaloTag.push_back(haloTag);
+      parentFOFCount.push_back(particleCount);
+      subHaloTag.push_back(static_cast<ID_T>(sidx));
+      subCount.push_back(result.Count[sidx]);
+      subMass.push_back(result.Mass[sidx]);
+      subCenterOfMassX.push_back(result.CofMassX[sidx]);
+      subCenterOfMassY.push_back(result.CofMassY[sidx]);
+      subCenterOfMassZ.push_back(result.CofMassZ[sidx]);
+      subAvgX.push_back(result.PosX[sidx]);
+      subAvgY.push_back(result.PosY[sidx]);
+      subAvgZ.push_back(result.PosZ[sidx]);
+      subAvgVX.push_back(result.VelX[sidx]);
+      subAvgVY.push_back(result.VelY[sidx]);
+      subAvgVZ.push_back(result.VelZ[sidx]);
+      subVelDisp.push_back(result.VelDisp[sidx]);
+    }
+    for (const auto& particle : result.ParticleSubhaloIds)
+    {
+      subhaloId->SetValue(particle.first, particle.second);
+    }
   }
 
   allParticles->GetPointData()->AddArray(subhaloId.GetPointer());
@@ -672,55 +707,76 @@ void vtkPANLHaloFinder::FindCenters(
   centers->SetNumberOfComponents(3);
   centers->SetNumberOfTuples(numberOfFOFHalos);
 
-  ExtractHalo haloData(numberOfFOFHalos, fofHaloCount, this->Internal->fof);
+  if (this->CenterFindingMode != MOST_BOUND_PARTICLE &&
+    this->CenterFindingMode != MOST_CONNECTED_PARTICLE &&
+    this->CenterFindingMode != HIST_CENTER_FINDING)
+  {
+    return;
+  }
+
+  std::vector<int> halos(numberOfFOFHalos);
   for (int halo = 0; halo < numberOfFOFHalos; ++halo)
   {
-    haloData.SetCurrentHalo(halo);
-    cosmotk::HaloCenterFinder centerFinder;
-    haloData.SetParticles(centerFinder);
-    centerFinder.setParameters(this->BB, this->SmoothingLength, this->DistanceConvertFactor,
-      this->RL, this->NP, OmegaMatter, OmegaCB, this->Hubble, this->RedShift);
-    int centerIndex = -1;
-    if (this->CenterFindingMode == MOST_BOUND_PARTICLE)
+    halos[halo] = halo;
+  }
+  const std::vector<int> order = SortHalosBySize(halos, fofHaloCount);
+
+  // Each halo writes its own tuple, so the result does not depend on the
+  // scheduling.
+  vtkSMPThreadLocal<std::shared_ptr<ExtractHalo> > localHaloData;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(order.size()), 1, [&](vtkIdType begin, vtkIdType end) {
+    std::shared_ptr<ExtractHalo>& haloData = localHaloData.Local();
+    if (!haloData)
+    {
+      haloData = std::make_shared<ExtractHalo>(fofHaloCount, this->Internal->fof);
+    }
+    for (vtkIdType cc = begin; cc < end; ++cc)
     {
-      float minPotential;
-      if (haloData.GetNumberOfParticlesInCurrentHalo() < MBP_THRESHOLD)
+      const int halo = order[cc];
+      haloData->SetCurrentHalo(halo);
+      cosmotk::HaloCenterFinder centerFinder;
+      haloData->SetParticles(centerFinder);
+      centerFinder.setParameters(this->BB, this->SmoothingLength, this->DistanceConvertFactor,
+        this->RL, this->NP, OmegaMatter, OmegaCB, this->Hubble, this->RedShift);
+      int centerIndex = -1;
+      if (this->CenterFindingMode == MOST_BOUND_PARTICLE)
       {
-        centerIndex = centerFinder.mostBoundParticleN2(&minPotential);
+        float minPotential;
+        if (haloData->GetNumberOfParticlesInCurrentHalo() < MBP_THRESHOLD)
+        {
+          centerIndex = centerFinder.mostBoundParticleN2(&minPotential);
+        }
+        else
+        {
+          centerIndex = centerFinder.mostBoundParticleAStar(&minPotential);
+        }
       }
-      else
+      else if (this->CenterFindingMode == MOST_CONNECTED_PARTICLE)
       {
-        centerIndex = centerFinder.mostBoundParticleAStar(&minPotential);
+        if (haloData->GetNumberOfParticlesInCurrentHalo() < MCP_THRESHOLD)
+        {
+          centerIndex = centerFinder.mostConnectedParticleN2();
+        }
+        else
+        {
+          centerIndex = centerFinder.mostConnectedParticleChainMesh();
+        }
       }
-    }
-    else if (this->CenterFindingMode == MOST_CONNECTED_PARTICLE)
-    {
-      if (haloData.GetNumberOfParticlesInCurrentHalo() < MCP_THRESHOLD)
+      else
       {
-        centerIndex = centerFinder.mostConnectedParticleN2();
+        centerIndex = centerFinder.mostConnectedParticleHist();
       }
-      else
+      float center[] = { 0.0, 0.0, 0.0 };
+      if (centerIndex >= 0)
       {
-        centerIndex = centerFinder.mostConnectedParticleChainMesh();
+        double point[3];
+        allParticles->GetPoint(haloData->GetActualIndex(centerIndex), point);
+        center[0] = point[0];
+        center[1] = point[1];
+        center[2] = point[2];
       }
+      centers->SetTypedTuple(halo, center);
     }
-    else if (this->CenterFindingMode == HIST_CENTER_FINDING)
-    {
-      centerIndex = centerFinder.mostConnectedParticleHist();
-    }
-    else
-    {
-      return;
-    }
-    float center[] = { 0.0, 0.0, 0.0 };
-    if (centerIndex >= 0)
-    {
-      double* point = allParticles->GetPoint(haloData.GetActualIndex(centerIndex));
-      center[0] = point[0];
-      center[1] = point[1];
-      center[2] = point[2];
-    }
-    centers->SetTypedTuple(halo, center);
-  }
+  });
   fofProperties->GetPointData()->AddArray(centers.GetPointer());
 }
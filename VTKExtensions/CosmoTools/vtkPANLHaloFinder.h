@@ -34,6 +34,10 @@
  * The third output is empty unless subhalo finding is turned on.  If subhalo
  * finding is on, this output is similar to the second output except with data
  * for each subhalo rather than each halo.  It contains one point per subhalo.
+ *
+ * Center finding and subhalo finding process the halos of a rank in parallel
+ * using vtkSMPTools, largest halos first. The outputs do not depend on the
+ * number of threads.
 */
 
 #include "vtkPVVTKExtensionsCosmoToolsModule.h" // For export macro
@@ -0,0 +1,257 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestCleanUnstructuredGrid.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the multithreaded point merging of vtkCleanUnstructuredGrid
+// gives the same results as the locator, and that merging can be restricted
+// to points of different partitions.
+
+#include "vtkCellType.h"
+#include "vtkCleanUnstructuredGrid.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vector>
+
+namespace
+{
+const int Size = 6;
+
+// Appends a Size^3 lattice of hexahedra of unit spacing, starting at xOrigin,
+// to the grid. Points are jittered by at most jitter.
+void AppendLattice(vtkUnstructuredGrid* grid, double xOrigin, int partition, double jitter)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(partition + 1);
+  vtkPoints* points = grid->GetPoints();
+  vtkIntArray* partitions =
+    vtkIntArray::SafeDownCast(grid->GetPointData()->GetArray("vtkProcessId"));
+  vtkDoubleArray* values = vtkDoubleArray::SafeDownCast(grid->GetPointData()->GetArray("values"));
+  vtkIdType offset = points->GetNumberOfPoints();
+  const int numPts = Size + 1;
+  for (int k = 0; k < numPts; ++k)
+  {
+    for (int j = 0; j < numPts; ++j)
+    {
+      for (int i = 0; i < numPts; ++i)
+      {
+        double x[3] = { xOrigin + i, static_cast<double>(j), static_cast<double>(k) };
+        for (int comp = 0; comp < 3; ++comp)
+        {
+          random->Next();
+          x[comp] += random->GetRangeValue(-jitter, jitter);
+        }
+        points->InsertNextPoint(x);
+        partitions->InsertNextValue(partition);
+        values->InsertNextValue(x[0] + 10 * partition);
+      }
+    }
+  }
+  auto id = [&](int i, int j, int k) { return offset + i + numPts * (j + numPts * k); };
+  for (int k = 0; k < Size; ++k)
+  {
+    for (int j = 0; j < Size; ++j)
+    {
+      for (int i = 0; i < Size; ++i)
+      {
+        vtkIdType hex[8] = { id(i, j, k), id(i + 1, j, k), id(i + 1, j + 1, k), id(i, j + 1, k),
+          id(i, j, k + 1), id(i + 1, j, k + 1), id(i + 1, j + 1, k + 1), id(i, j + 1, k + 1) };
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+      }
+    }
+  }
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> CreateGrid(const std::vector<double>& xOrigins,
+  const std::vector<int>& partitions, double jitter)
+{
+  auto grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  grid->SetPoints(points);
+  grid->Allocate();
+  vtkNew<vtkIntArray> partitionArray;
+  partitionArray->SetName("vtkProcessId");
+  grid->GetPointData()->AddArray(partitionArray);
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("values");
+  grid->GetPointData()->AddArray(values);
+  for (size_t cc = 0; cc < xOrigins.size(); ++cc)
+  {
+    AppendLattice(grid, xOrigins[cc], partitions[cc], jitter);
+  }
+  return grid;
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> Clean(vtkUnstructuredGrid* input, double absoluteTolerance,
+  bool multithreaded, bool acrossPartitions)
+{
+  vtkNew<vtkCleanUnstructuredGrid> clean;
+  clean->SetInputData(input);
+  clean->SetToleranceIsAbsolute(absoluteTolerance > 0.0);
+  clean->SetAbsoluteTolerance(absoluteTolerance);
+  clean->SetUseMultithreadedMerge(multithreaded);
+  clean->SetMergeOnlyAcrossPartitions(acrossPartitions);
+  clean->Update();
+  return vtkUnstructuredGrid::SafeDownCast(clean->GetOutput());
+}
+
+// A vertex at the origin, nine vertices near x = 0.5 and a last one at
+// x = 0.9: with a unit tolerance, the nine vertices are closer to the last
+// one than the origin, the only point kept, which it is merged with.
+vtkSmartPointer<vtkUnstructuredGrid> CreateCluster()
+{
+  auto grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  grid->SetPoints(points);
+  grid->Allocate();
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("values");
+  grid->GetPointData()->AddArray(values);
+  points->InsertNextPoint(0.0, 0.0, 0.0);
+  for (int cc = 1; cc < 10; ++cc)
+  {
+    points->InsertNextPoint(0.5, 0.001 * cc, 0.0);
+  }
+  points->InsertNextPoint(0.9, 0.0, 0.0);
+  for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ++ptId)
+  {
+    values->InsertNextValue(ptId);
+    grid->InsertNextCell(VTK_VERTEX, 1, &ptId);
+  }
+  return grid;
+}
+
+bool Compare(vtkUnstructuredGrid* expected, vtkUnstructuredGrid* actual, const char* label)
+{
+  if (expected->GetNumberOfPoints() != actual->GetNumberOfPoints() ||
+    expected->GetNumberOfCells() != actual->GetNumberOfCells())
+  {
+    cerr << label << ": expected " << expected->GetNumberOfPoints() << " points and "
+         << expected->GetNumberOfCells() << " cells, got " << actual->GetNumberOfPoints()
+         << " points and " << actual->GetNumberOfCells() << " cells." << endl;
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < expected->GetNumberOfPoints(); ++ptId)
+  {
+    double e[3], a[3];
+    expected->GetPoint(ptId, e);
+    actual->GetPoint(ptId, a);
+    if (e[0] != a[0] || e[1] != a[1] || e[2] != a[2] ||
+      expected->GetPointData()->GetArray("values")->GetTuple1(ptId) !=
+        actual->GetPointData()->GetArray("values")->GetTuple1(ptId))
+    {
+      cerr << label << ": point " << ptId << " mismatch." << endl;
+      return false;
+    }
+  }
+  vtkNew<vtkIdList> expectedIds;
+  vtkNew<vtkIdList> actualIds;
+  for (vtkIdType cellId = 0; cellId < expected->GetNumberOfCells(); ++cellId)
+  {
+    expected->GetCellPoints(cellId, expectedIds);
+    actual->GetCellPoints(cellId, actualIds);
+    if (expected->GetCellType(cellId) != actual->GetCellType(cellId) ||
+      expectedIds->GetNumberOfIds() != actualIds->GetNumberOfIds())
+    {
+      cerr << label << ": cell " << cellId << " mismatch." << endl;
+      return false;
+    }
+    for (vtkIdType ii = 0; ii < expectedIds->GetNumberOfIds(); ++ii)
+    {
+      if (expectedIds->GetId(ii) != actualIds->GetId(ii))
+      {
+        cerr << label << ": cell " << cellId << " connectivity mismatch." << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+int TestCleanUnstructuredGrid(int, char*[])
+{
+  const vtkIdType latticePoints = (Size + 1) * (Size + 1) * (Size + 1);
+  const vtkIdType seamPoints = (Size + 1) * (Size + 1);
+  bool success = true;
+
+  // Two lattices sharing a face.
+  vtkSmartPointer<vtkUnstructuredGrid> grid = CreateGrid({ 0.0, Size }, { 0, 1 }, 0.0);
+  vtkSmartPointer<vtkUnstructuredGrid> expected = Clean(grid, 0.0, false, false);
+  vtkSmartPointer<vtkUnstructuredGrid> actual = Clean(grid, 0.0, true, false);
+  success = Compare(expected, actual, "exact") && success;
+  if (actual->GetNumberOfPoints() != 2 * latticePoints - seamPoints)
+  {
+    cerr << "exact: wrong number of merged points." << endl;
+    success = false;
+  }
+
+  // Same with points jittered well within tolerance.
+  grid = CreateGrid({ 0.0, Size }, { 0, 1 }, 0.01);
+  expected = Clean(grid, 0.1, false, false);
+  actual = Clean(grid, 0.1, true, false);
+  success = Compare(expected, actual, "tolerance") && success;
+
+  // A point whose closest candidates within tolerance are all merged points.
+  grid = CreateCluster();
+  expected = Clean(grid, 1.0, false, false);
+  actual = Clean(grid, 1.0, true, false);
+  success = Compare(expected, actual, "cluster") && success;
+  if (actual->GetNumberOfPoints() != 1)
+  {
+    cerr << "cluster: expected 1 point, got " << actual->GetNumberOfPoints() << endl;
+    success = false;
+  }
+
+  // A lattice duplicated in partition 0, next to a lattice in partition 1:
+  // only the points of the shared face of partition 1 are merged.
+  grid = CreateGrid({ 0.0, 0.0, Size }, { 0, 0, 1 }, 0.0);
+  actual = Clean(grid, 0.0, false, true);
+  if (actual->GetNumberOfPoints() != 3 * latticePoints - seamPoints)
+  {
+    cerr << "partitions: expected " << 3 * latticePoints - seamPoints << " points, got "
+         << actual->GetNumberOfPoints() << endl;
+    success = false;
+  }
+
+  // Partition 0 duplicates coinciding with a lattice of partition 1 that
+  // comes first: only one of them is merged with it, exactly or within
+  // tolerance.
+  grid = CreateGrid({ 0.0, 0.0, 0.0 }, { 1, 0, 0 }, 0.0);
+  actual = Clean(grid, 0.0, false, true);
+  if (actual->GetNumberOfPoints() != 2 * latticePoints)
+  {
+    cerr << "coincident partitions: expected " << 2 * latticePoints << " points, got "
+         << actual->GetNumberOfPoints() << endl;
+    success = false;
+  }
+  grid = CreateGrid({ 0.0, 0.0, 0.0 }, { 1, 0, 0 }, 0.01);
+  actual = Clean(grid, 0.1, false, true);
+  if (actual->GetNumberOfPoints() != 2 * latticePoints)
+  {
+    cerr << "coincident partitions with tolerance: expected " << 2 * latticePoints
+         << " points, got " << actual->GetNumberOfPoints() << endl;
+    success = false;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
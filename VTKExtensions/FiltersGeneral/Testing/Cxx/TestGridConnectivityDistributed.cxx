@@ -0,0 +1,238 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestGridConnectivityDistributed.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkGridConnectivity finds the same fragments, volumes and
+// integrated attributes with DistributedResolution as with the process 0
+// path, for fragments spanning several processes.
+
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkGridConnectivity.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMPIController.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#define expect(x, msg)                                                                             \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << __LINE__ << ": " msg << endl;                                                          \
+    return EXIT_FAILURE;                                                                           \
+  }
+
+namespace
+{
+// Each process owns a slab of CellsPerProcess x 3 x 1 unit voxels along x.
+// Row j = 0 is full and spans all the processes.  Row j = 2 is cut every
+// fourth cell, so its pieces straddle process boundaries at varying places.
+// Row j = 1 only has the last cell, which joins the last piece of row 2 to
+// row 0.
+const int CellsPerProcess = 3;
+
+bool IsKept(int i, int j, int numCellsX)
+{
+  switch (j)
+  {
+    case 0:
+      return true;
+    case 1:
+      return i == numCellsX - 1;
+    default:
+      return i % 4 != 3;
+  }
+}
+
+vtkIdType PointId(int i, int j, int k, int numCellsX)
+{
+  return i + (numCellsX + 1) * (j + 4 * k);
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> MakePiece(int rank, int numProcs)
+{
+  const int numCellsX = CellsPerProcess * numProcs;
+  const int iMin = CellsPerProcess * rank;
+  const int iMax = iMin + CellsPerProcess;
+
+  auto grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkIdTypeArray> globalIds;
+  globalIds->SetName("GlobalNodeId");
+  for (int k = 0; k <= 1; ++k)
+  {
+    for (int j = 0; j <= 3; ++j)
+    {
+      for (int i = iMin; i <= iMax; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+        globalIds->InsertNextValue(PointId(i, j, k, numCellsX));
+      }
+    }
+  }
+  grid->SetPoints(points);
+  grid->GetPointData()->SetGlobalIds(globalIds);
+
+  vtkNew<vtkDoubleArray> density;
+  density->SetName("Density");
+  const int numLocalX = CellsPerProcess + 1;
+  grid->Allocate(3 * CellsPerProcess);
+  for (int j = 0; j < 3; ++j)
+  {
+    for (int i = iMin; i < iMax; ++i)
+    {
+      if (!IsKept(i, j, numCellsX))
+      {
+        continue;
+      }
+      vtkIdType voxel[8];
+      for (int corner = 0; corner < 8; ++corner)
+      {
+        const int di = corner & 1, dj = (corner >> 1) & 1, dk = (corner >> 2) & 1;
+        voxel[corner] = (i - iMin + di) + numLocalX * ((j + dj) + 4 * dk);
+      }
+      grid->InsertNextCell(VTK_VOXEL, 8, voxel);
+      density->InsertNextValue(i + 1);
+    }
+  }
+  grid->GetCellData()->AddArray(density);
+  return grid;
+}
+
+// (volume, integrated density) of every fragment of the whole grid, sorted.
+std::vector<std::pair<double, double> > ExpectedFragments(int numProcs)
+{
+  const int numCellsX = CellsPerProcess * numProcs;
+  std::vector<std::pair<double, double> > fragments;
+  std::vector<bool> visited(3 * numCellsX, false);
+  for (int seed = 0; seed < 3 * numCellsX; ++seed)
+  {
+    if (visited[seed] || !IsKept(seed % numCellsX, seed / numCellsX, numCellsX))
+    {
+      continue;
+    }
+    std::pair<double, double> fragment(0.0, 0.0);
+    std::vector<int> front(1, seed);
+    visited[seed] = true;
+    while (!front.empty())
+    {
+      const int cell = front.back();
+      front.pop_back();
+      const int i = cell % numCellsX, j = cell / numCellsX;
+      fragment.first += 1.0;
+      fragment.second += i + 1;
+      const int neighbors[4][2] = { { i - 1, j }, { i + 1, j }, { i, j - 1 }, { i, j + 1 } };
+      for (const auto& n : neighbors)
+      {
+        if (n[0] >= 0 && n[0] < numCellsX && n[1] >= 0 && n[1] < 3 &&
+          IsKept(n[0], n[1], numCellsX) && !visited[n[0] + numCellsX * n[1]])
+        {
+          visited[n[0] + numCellsX * n[1]] = true;
+          front.push_back(n[0] + numCellsX * n[1]);
+        }
+      }
+    }
+    fragments.push_back(fragment);
+  }
+  std::sort(fragments.begin(), fragments.end());
+  return fragments;
+}
+
+int Check(vtkGridConnectivity* filter, const std::vector<std::pair<double, double> >& expected,
+  vtkMultiProcessController* contr, vtkIdType& numSurfaceCells)
+{
+  auto output = vtkMultiBlockDataSet::SafeDownCast(filter->GetOutputDataObject(0));
+  auto surface = output ? vtkPolyData::SafeDownCast(output->GetBlock(0)) : nullptr;
+  // Reduce before any early return so that the processes do not hang.
+  vtkIdType numLocalCells = surface ? surface->GetNumberOfCells() : 0;
+  contr->AllReduce(&numLocalCells, &numSurfaceCells, 1, vtkCommunicator::SUM_OP);
+  expect(surface != nullptr, "missing output surface");
+
+  vtkDataArray* volumes = surface->GetFieldData()->GetArray("Fragment Volume");
+  vtkDataArray* densities = surface->GetFieldData()->GetArray("Density");
+  expect(volumes != nullptr && densities != nullptr, "missing fragment arrays");
+  // Index 0 is the unused "removed face" fragment.
+  expect(volumes->GetNumberOfTuples() == static_cast<vtkIdType>(expected.size()) + 1,
+    "wrong number of fragments");
+  std::vector<std::pair<double, double> > fragments;
+  for (vtkIdType ii = 1; ii < volumes->GetNumberOfTuples(); ++ii)
+  {
+    fragments.push_back(std::make_pair(volumes->GetTuple1(ii), densities->GetTuple1(ii)));
+  }
+  std::sort(fragments.begin(), fragments.end());
+  for (size_t ii = 0; ii < expected.size(); ++ii)
+  {
+    expect(std::abs(fragments[ii].first - expected[ii].first) < 1e-6, "wrong fragment volume");
+    expect(std::abs(fragments[ii].second - expected[ii].second) < 1e-6,
+      "wrong integrated density");
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestGridConnectivityDistributed(int argc, char* argv[])
+{
+  vtkMPIController* contr = vtkMPIController::New();
+  contr->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(contr);
+
+  const int rank = contr->GetLocalProcessId();
+  const int numProcs = contr->GetNumberOfProcesses();
+  auto expected = ExpectedFragments(numProcs);
+  auto piece = MakePiece(rank, numProcs);
+
+  int status = EXIT_SUCCESS;
+  {
+    // the filter uses the global controller.
+    vtkNew<vtkGridConnectivity> reference;
+    reference->SetInputData(piece);
+    reference->Update();
+    vtkIdType referenceSurfaceCells = 0;
+    status = Check(reference, expected, contr, referenceSurfaceCells);
+
+    vtkNew<vtkGridConnectivity> distributed;
+    distributed->SetInputData(piece);
+    distributed->DistributedResolutionOn();
+    distributed->Update();
+    vtkIdType distributedSurfaceCells = 0;
+    if (Check(distributed, expected, contr, distributedSurfaceCells) != EXIT_SUCCESS)
+    {
+      status = EXIT_FAILURE;
+    }
+    else if (distributedSurfaceCells != referenceSurfaceCells)
+    {
+      cerr << "The surfaces differ: " << distributedSurfaceCells << " faces instead of "
+           << referenceSurfaceCells << endl;
+      status = EXIT_FAILURE;
+    }
+  }
+  int globalStatus = EXIT_SUCCESS;
+  contr->AllReduce(&status, &globalStatus, 1, vtkCommunicator::MAX_OP);
+
+  vtkMultiProcessController::SetGlobalController(nullptr);
+  contr->Finalize();
+  contr->Delete();
+  return globalStatus;
+}
@@ -0,0 +1,307 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVArrayCalculator.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the compiled evaluation of vtkPVArrayCalculator gives the same
+// results as the evaluation by vtkFunctionParser.
+
+#include "vtkCellArray.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPVArrayCalculator.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+const char* ResultName = "Result";
+
+vtkSmartPointer<vtkPolyData> CreatePolyData(int numPoints, bool withF)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(numPoints);
+  auto uniform = [&random](double min, double max) {
+    random->Next();
+    return random->GetRangeValue(min, max);
+  };
+
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> s;
+  s->SetName("s");
+  vtkNew<vtkFloatArray> f;
+  f->SetName("F");
+  vtkNew<vtkIntArray> i;
+  i->SetName("i");
+  vtkNew<vtkFloatArray> v;
+  v->SetName("v");
+  v->SetNumberOfComponents(3);
+  vtkNew<vtkDoubleArray> w;
+  w->SetName("w");
+  w->SetNumberOfComponents(3);
+  w->SetComponentName(0, "U");
+  w->SetComponentName(1, "V");
+  w->SetComponentName(2, "W");
+  for (int cc = 0; cc < numPoints; ++cc)
+  {
+    points->InsertNextPoint(uniform(-1, 1), uniform(-1, 1), uniform(-1, 1));
+    s->InsertNextValue(uniform(-2, 2));
+    f->InsertNextValue(static_cast<float>(uniform(0.1, 3)));
+    // Has zeros, to get divisions by zero.
+    i->InsertNextValue(static_cast<int>(std::floor(uniform(-2, 3))));
+    v->InsertNextTuple3(uniform(-1, 1), uniform(-1, 1), uniform(-1, 1));
+    w->InsertNextTuple3(uniform(-1, 1), uniform(-1, 1), uniform(-1, 1));
+  }
+
+  vtkNew<vtkCellArray> verts;
+  for (vtkIdType cc = 0; cc < numPoints; ++cc)
+  {
+    verts->InsertNextCell(1, &cc);
+  }
+
+  auto polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+  polyData->SetVerts(verts);
+  polyData->GetPointData()->AddArray(s);
+  if (withF)
+  {
+    polyData->GetPointData()->AddArray(f);
+  }
+  polyData->GetPointData()->AddArray(i);
+  polyData->GetPointData()->AddArray(v);
+  polyData->GetPointData()->AddArray(w);
+  // The active attributes must be kept next to the result.
+  polyData->GetPointData()->SetActiveScalars("s");
+  polyData->GetPointData()->SetActiveVectors("v");
+  return polyData;
+}
+
+vtkSmartPointer<vtkDataObject> Calculate(vtkDataObject* input, const std::string& function,
+  bool compiled, bool replaceInvalidValues, int resultArrayType, int attributeType)
+{
+  vtkNew<vtkPVArrayCalculator> calculator;
+  calculator->SetInputData(input);
+  calculator->SetFunction(function.c_str());
+  calculator->SetResultArrayName(ResultName);
+  calculator->SetResultArrayType(resultArrayType);
+  calculator->SetAttributeType(attributeType);
+  calculator->SetReplaceInvalidValues(replaceInvalidValues);
+  calculator->SetReplacementValue(-42.0);
+  calculator->SetUseCompiledFunction(compiled);
+  calculator->Update();
+  return calculator->GetOutputDataObject(0);
+}
+
+bool CompareResults(vtkDataObject* expected, vtkDataObject* actual, const std::string& function)
+{
+  const int attributeType =
+    vtkTable::SafeDownCast(expected) ? vtkDataObject::ROW : vtkDataObject::POINT;
+  vtkDataSetAttributes* expectedAttributes = expected->GetAttributes(attributeType);
+  vtkDataSetAttributes* actualAttributes = actual->GetAttributes(attributeType);
+  if (expectedAttributes->GetNumberOfArrays() != actualAttributes->GetNumberOfArrays())
+  {
+    cerr << "'" << function << "': number of arrays mismatch." << endl;
+    return false;
+  }
+  for (int cc = 0; cc < expectedAttributes->GetNumberOfArrays(); ++cc)
+  {
+    const char* name = expectedAttributes->GetArrayName(cc);
+    if (!actualAttributes->HasArray(name))
+    {
+      cerr << "'" << function << "': missing array '" << name << "'." << endl;
+      return false;
+    }
+  }
+  auto sameName = [](vtkDataArray* a, vtkDataArray* b) {
+    return a && b ? std::string(a->GetName()) == b->GetName() : a == b;
+  };
+  if (!sameName(expectedAttributes->GetScalars(), actualAttributes->GetScalars()) ||
+    !sameName(expectedAttributes->GetVectors(), actualAttributes->GetVectors()))
+  {
+    cerr << "'" << function << "': active arrays mismatch." << endl;
+    return false;
+  }
+
+  vtkDataArray* expectedArray = expectedAttributes->GetArray(ResultName);
+  vtkDataArray* actualArray = actualAttributes->GetArray(ResultName);
+  if (!expectedArray || !actualArray)
+  {
+    if (expectedArray != actualArray)
+    {
+      cerr << "'" << function << "': result array mismatch." << endl;
+      return false;
+    }
+    return true;
+  }
+
+  if (expectedArray->GetDataType() != actualArray->GetDataType() ||
+    expectedArray->GetNumberOfComponents() != actualArray->GetNumberOfComponents() ||
+    expectedArray->GetNumberOfTuples() != actualArray->GetNumberOfTuples())
+  {
+    cerr << "'" << function << "': result array layout mismatch." << endl;
+    return false;
+  }
+  if ((expectedAttributes->GetScalars() == expectedArray) !=
+      (actualAttributes->GetScalars() == actualArray) ||
+    (expectedAttributes->GetVectors() == expectedArray) !=
+      (actualAttributes->GetVectors() == actualArray))
+  {
+    cerr << "'" << function << "': active attribute mismatch." << endl;
+    return false;
+  }
+
+  for (vtkIdType cc = 0; cc < expectedArray->GetNumberOfTuples(); ++cc)
+  {
+    for (int comp = 0; comp < expectedArray->GetNumberOfComponents(); ++comp)
+    {
+      const double e = expectedArray->GetComponent(cc, comp);
+      const double a = actualArray->GetComponent(cc, comp);
+      if (vtkMath::IsNan(e) && vtkMath::IsNan(a))
+      {
+        continue;
+      }
+      if (!(std::abs(e - a) <= 1e-12 * std::max(1.0, std::abs(e))))
+      {
+        cerr << "'" << function << "': tuple " << cc << ", component " << comp << ": expected "
+             << e << ", got " << a << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool CompareComposite(vtkDataObject* expected, vtkDataObject* actual, const std::string& function)
+{
+  auto expectedCD = vtkCompositeDataSet::SafeDownCast(expected);
+  auto actualCD = vtkCompositeDataSet::SafeDownCast(actual);
+  if (!expectedCD || !actualCD)
+  {
+    return CompareResults(expected, actual, function);
+  }
+
+  vtkSmartPointer<vtkCompositeDataIterator> expectedIter;
+  expectedIter.TakeReference(expectedCD->NewIterator());
+  vtkSmartPointer<vtkCompositeDataIterator> actualIter;
+  actualIter.TakeReference(actualCD->NewIterator());
+  for (expectedIter->InitTraversal(), actualIter->InitTraversal();
+       !expectedIter->IsDoneWithTraversal() && !actualIter->IsDoneWithTraversal();
+       expectedIter->GoToNextItem(), actualIter->GoToNextItem())
+  {
+    if (!CompareResults(expectedIter->GetCurrentDataObject(),
+          actualIter->GetCurrentDataObject(), function))
+    {
+      return false;
+    }
+  }
+  if (!expectedIter->IsDoneWithTraversal() || !actualIter->IsDoneWithTraversal())
+  {
+    cerr << "'" << function << "': block mismatch." << endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestPVArrayCalculator(int, char*[])
+{
+  // Evaluated on data without invalid values.
+  const std::vector<std::string> functions = { "s+F*2-3/F", "s-F/3*i", "F^0.5+s^2+s^i",
+    "abs(s)+exp(s)", "ceil(s)*floor(F)", "ln(F)-log10(F)", "sqrt(F)",
+    "sin(s)+cos(s)*tan(s)", "asin(s/2)+acos(s/2)+atan(s)", "sinh(s)*cosh(s)-tanh(s)",
+    "min(s,F)+max(s,i)", "sign(s)+sign(i)", "-s", "if(s>0,F,i)", "(s<F)|(s=i)",
+    "(s>0)&(F<1)", "mag(v)", "norm(w)", "cross(v,w)", "v.w", "v+w-v", "s*v", "v*s", "v/F",
+    "-v", "s*iHat+F*jHat+i*kHat", "if(s>0,v,w)", "mag(cross(v,jHat))*s", "v_X+w_V-\"w_W\"",
+    "coordsX*coordsY+coordsZ", "coords*2+v", "3.14159*s+2.71828", "2.5", "iHat" };
+  // Evaluated with ReplaceInvalidValues on, on data with invalid values.
+  const std::vector<std::string> invalidFunctions = { "s/i", "sqrt(s)", "ln(s)", "log10(i)",
+    "asin(s)", "acos(s)", "v/i", "norm(v*i)", "s^F", "if(i>0,s/i,F)" };
+
+  vtkSmartPointer<vtkPolyData> polyData = CreatePolyData(2000, true);
+
+  vtkNew<vtkTable> table;
+  table->GetRowData()->ShallowCopy(polyData->GetPointData());
+
+  // The second block misses 'F'.
+  vtkNew<vtkMultiBlockDataSet> multiBlock;
+  multiBlock->SetNumberOfBlocks(3);
+  multiBlock->SetBlock(0, polyData);
+  multiBlock->SetBlock(1, CreatePolyData(513, false));
+  multiBlock->SetBlock(2, CreatePolyData(1, true));
+
+  bool success = true;
+  auto check = [&](vtkDataObject* input, const std::string& function, bool replace, int type,
+                 int attributeType) {
+    vtkSmartPointer<vtkDataObject> expected =
+      Calculate(input, function, false, replace, type, attributeType);
+    vtkSmartPointer<vtkDataObject> actual =
+      Calculate(input, function, true, replace, type, attributeType);
+    success = CompareComposite(expected, actual, function) && success;
+  };
+
+  for (const auto& function : functions)
+  {
+    check(polyData, function, false, VTK_DOUBLE, vtkDataObject::POINT);
+    check(polyData, function, true, VTK_FLOAT, vtkDataObject::POINT);
+    if (function.find("coords") == std::string::npos)
+    {
+      check(table, function, false, VTK_DOUBLE, vtkDataObject::ROW);
+    }
+    if (function.find('F') == std::string::npos)
+    {
+      check(multiBlock, function, false, VTK_DOUBLE, vtkDataObject::POINT);
+    }
+  }
+  for (const auto& function : invalidFunctions)
+  {
+    check(polyData, function, true, VTK_DOUBLE, vtkDataObject::POINT);
+    check(polyData, function, true, VTK_INT, vtkDataObject::POINT);
+  }
+
+  // The arrays that were active stay in the output, and the one of the other
+  // kind stays active.
+  vtkSmartPointer<vtkDataObject> scalarResult =
+    Calculate(polyData, "s*F", true, false, VTK_DOUBLE, vtkDataObject::POINT);
+  vtkPointData* scalarPD = vtkPolyData::SafeDownCast(scalarResult)->GetPointData();
+  if (!scalarPD->HasArray("s") || !scalarPD->GetVectors() ||
+    std::string(scalarPD->GetVectors()->GetName()) != "v")
+  {
+    cerr << "scalar result dropped the active arrays of the input." << endl;
+    success = false;
+  }
+  vtkSmartPointer<vtkDataObject> vectorResult =
+    Calculate(polyData, "v*F", true, false, VTK_DOUBLE, vtkDataObject::POINT);
+  vtkPointData* vectorPD = vtkPolyData::SafeDownCast(vectorResult)->GetPointData();
+  if (!vectorPD->HasArray("v") || !vectorPD->GetScalars() ||
+    std::string(vectorPD->GetScalars()->GetName()) != "s")
+  {
+    cerr << "vector result dropped the active arrays of the input." << endl;
+    success = false;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
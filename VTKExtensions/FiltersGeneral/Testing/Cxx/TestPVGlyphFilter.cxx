@@ -0,0 +1,367 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVGlyphFilter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the glyphs of vtkPVGlyphFilter match the ones obtained by
+// transforming the source with a vtkTransform for each point (translate,
+// rotate, scale), for every glyph mode, with scalar and vector scaling,
+// orientation, a source transform, and float or double normals.
+
+#include "vtkCellArray.h"
+#include "vtkCellType.h"
+#include "vtkDataObject.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPVGlyphFilter.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTransform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#define expect(x, msg)                                                                             \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << __LINE__ << ": " << label << ": " msg << endl;                                         \
+    return EXIT_FAILURE;                                                                           \
+  }
+
+namespace
+{
+// The glyph matrix is built directly instead of through a vtkTransform
+// concatenation, which may round the last bits differently: allow for a few
+// float ulps.
+bool Matches(double value, double expected)
+{
+  return std::abs(value - expected) <= 1.0e-6 * std::max(1.0, std::abs(expected));
+}
+
+struct Config
+{
+  const char* ScaleArray;
+  const char* OrientationArray;
+  int VectorScaleMode;
+  bool UseSourceTransform;
+  bool DoubleNormals;
+};
+
+vtkSmartPointer<vtkImageData> CreateInput()
+{
+  auto image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(4, 3, 3);
+  image->SetOrigin(1.0, -2.0, 0.5);
+  image->SetSpacing(0.5, 1.0, 2.0);
+  const vtkIdType numPts = image->GetNumberOfPoints();
+
+  // Orientations along +x, -x (flip), none and general directions.
+  const double directions[6][3] = { { 1, 0, 0 }, { -2, 0, 0 }, { 0, 0, 0 }, { 0.3, -1.2, 0.7 },
+    { -0.5, 0.25, -2 }, { 0, 1, 0 } };
+  vtkNew<vtkDoubleArray> ids;
+  ids->SetName("InputId");
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("scalar");
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("vectors");
+  vectors->SetNumberOfComponents(3);
+  vtkNew<vtkDoubleArray> vectors2;
+  vectors2->SetName("vectors2");
+  vectors2->SetNumberOfComponents(2);
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    ids->InsertNextValue(ptId);
+    // A zero scale is replaced by a tiny one.
+    scalars->InsertNextValue(ptId == 5 ? 0.0 : 0.5 + 0.1 * ptId);
+    const double* d = directions[ptId % 6];
+    const double f = 1.0 + 0.05 * ptId;
+    vectors->InsertNextTuple3(f * d[0], f * d[1], f * d[2]);
+    vectors2->InsertNextTuple2(0.5 + 0.01 * ptId, 2.0 - 0.02 * ptId);
+  }
+  image->GetPointData()->AddArray(ids);
+  image->GetPointData()->AddArray(scalars);
+  image->GetPointData()->AddArray(vectors);
+  image->GetPointData()->AddArray(vectors2);
+  return image;
+}
+
+// Two triangles and a line, with normals that are not unit vectors.
+vtkSmartPointer<vtkPolyData> CreateSource(bool doubleNormals)
+{
+  auto source = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0.0, 0.0, 0.0);
+  points->InsertNextPoint(1.0, 0.1, 0.0);
+  points->InsertNextPoint(0.2, 0.9, 0.3);
+  points->InsertNextPoint(0.4, 0.3, 1.1);
+  source->SetPoints(points);
+  vtkNew<vtkCellArray> polys;
+  polys->InsertNextCell({ 0, 1, 2 });
+  polys->InsertNextCell({ 0, 2, 3 });
+  source->SetPolys(polys);
+  vtkNew<vtkCellArray> lines;
+  lines->InsertNextCell({ 1, 3 });
+  source->SetLines(lines);
+
+  vtkSmartPointer<vtkDataArray> normals;
+  if (doubleNormals)
+  {
+    normals = vtkSmartPointer<vtkDoubleArray>::New();
+  }
+  else
+  {
+    normals = vtkSmartPointer<vtkFloatArray>::New();
+  }
+  normals->SetName("Normals");
+  normals->SetNumberOfComponents(3);
+  normals->InsertNextTuple3(0.0, 0.0, 2.0);
+  normals->InsertNextTuple3(0.1, -0.3, 0.9);
+  normals->InsertNextTuple3(-1.0, 0.5, 0.25);
+  normals->InsertNextTuple3(0.7, 0.7, -0.1);
+  source->GetPointData()->SetNormals(normals);
+  return source;
+}
+
+// The transform used to glyph inPtId: what vtkPVGlyphFilter used to build
+// for every point.
+void ComputeReferenceTransform(
+  vtkDataSet* input, const Config& config, vtkIdType inPtId, double scaleFactor, vtkTransform* trans)
+{
+  vtkDataArray* scaleArray =
+    config.ScaleArray ? input->GetPointData()->GetArray(config.ScaleArray) : nullptr;
+  vtkDataArray* orientArray =
+    config.OrientationArray ? input->GetPointData()->GetArray(config.OrientationArray) : nullptr;
+
+  double scalex(1.0), scaley(1.0), scalez(1.0);
+  if (scaleArray)
+  {
+    if (scaleArray->GetNumberOfComponents() == 1)
+    {
+      scalex = scaley = scalez = scaleArray->GetComponent(inPtId, 0);
+    }
+    else if (scaleArray->GetNumberOfComponents() == 2)
+    {
+      double* vec2 = scaleArray->GetTuple(inPtId);
+      if (config.VectorScaleMode == vtkPVGlyphFilter::SCALE_BY_MAGNITUDE)
+      {
+        scalex = scaley = scalez = vtkMath::Norm2D(vec2);
+      }
+      else
+      {
+        scalex = vec2[0];
+        scaley = vec2[1];
+      }
+    }
+    else
+    {
+      double* vec3 = scaleArray->GetTuple(inPtId);
+      if (config.VectorScaleMode == vtkPVGlyphFilter::SCALE_BY_MAGNITUDE)
+      {
+        scalex = scaley = scalez = vtkMath::Norm(vec3);
+      }
+      else
+      {
+        scalex = vec3[0];
+        scaley = vec3[1];
+        scalez = vec3[2];
+      }
+    }
+  }
+  scalex *= scaleFactor;
+  scaley *= scaleFactor;
+  scalez *= scaleFactor;
+
+  trans->Identity();
+  double x[3];
+  input->GetPoint(inPtId, x);
+  trans->Translate(x[0], x[1], x[2]);
+  if (orientArray)
+  {
+    double v[3] = { 0.0 };
+    orientArray->GetTuple(inPtId, v);
+    double vMag = vtkMath::Norm(v);
+    if (vMag > 0.0)
+    {
+      if (v[1] == 0.0 && v[2] == 0.0)
+      {
+        if (v[0] < 0)
+        {
+          trans->RotateWXYZ(180.0, 0, 1, 0);
+        }
+      }
+      else
+      {
+        trans->RotateWXYZ(180.0, (v[0] + vMag) / 2.0, v[1] / 2.0, v[2] / 2.0);
+      }
+    }
+  }
+  trans->Scale(scalex == 0.0 ? 1.0e-10 : scalex, scaley == 0.0 ? 1.0e-10 : scaley,
+    scalez == 0.0 ? 1.0e-10 : scalez);
+}
+
+int CheckGlyphs(
+  vtkDataSet* input, const Config& config, int glyphMode, int stride, const std::string& label)
+{
+  vtkSmartPointer<vtkPolyData> source = CreateSource(config.DoubleNormals);
+  vtkNew<vtkTransform> sourceTransform;
+  sourceTransform->RotateZ(30.0);
+  sourceTransform->Scale(1.5, 0.5, 2.0);
+  sourceTransform->Translate(-0.5, 0.0, 0.25);
+
+  vtkNew<vtkPVGlyphFilter> glypher;
+  glypher->SetInputData(input);
+  glypher->SetInputData(1, source);
+  glypher->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS,
+    config.ScaleArray ? config.ScaleArray : "none");
+  glypher->SetInputArrayToProcess(1, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS,
+    config.OrientationArray ? config.OrientationArray : "none");
+  glypher->SetVectorScaleMode(config.VectorScaleMode);
+  glypher->SetScaleFactor(0.75);
+  glypher->SetGlyphMode(glyphMode);
+  glypher->SetStride(stride);
+  glypher->SetSeed(7);
+  glypher->SetMaximumNumberOfSamplePoints(10);
+  if (config.UseSourceTransform)
+  {
+    glypher->SetSourceTransform(sourceTransform);
+  }
+  glypher->Update();
+  vtkPolyData* output = glypher->GetOutput();
+
+  const vtkIdType numSourcePts = source->GetNumberOfPoints();
+  const vtkIdType numGlyphs = output->GetNumberOfPoints() / numSourcePts;
+  expect(output->GetNumberOfPoints() == numGlyphs * numSourcePts, "partial glyphs");
+  expect(numGlyphs > 0, "no glyphs");
+  vtkDataArray* ids = output->GetPointData()->GetArray("InputId");
+  vtkDataArray* normals = output->GetPointData()->GetNormals();
+  expect(ids != nullptr, "missing input point data");
+  expect(normals != nullptr && normals->GetDataType() == VTK_FLOAT, "missing float normals");
+
+  vtkNew<vtkPoints> transformedSourcePts;
+  transformedSourcePts->SetDataTypeToDouble();
+  if (config.UseSourceTransform)
+  {
+    sourceTransform->TransformPoints(source->GetPoints(), transformedSourcePts);
+  }
+  else
+  {
+    transformedSourcePts->DeepCopy(source->GetPoints());
+  }
+
+  vtkNew<vtkTransform> trans;
+  vtkIdType previousId = -1;
+  for (vtkIdType glyphId = 0; glyphId < numGlyphs; ++glyphId)
+  {
+    const vtkIdType inPtId = static_cast<vtkIdType>(ids->GetTuple1(glyphId * numSourcePts));
+    expect(inPtId > previousId, "glyphs are not in input point order");
+    switch (glyphMode)
+    {
+      case vtkPVGlyphFilter::ALL_POINTS:
+        expect(inPtId == glyphId, "a point was not glyphed");
+        break;
+      case vtkPVGlyphFilter::EVERY_NTH_POINT:
+        expect(inPtId == glyphId * stride, "wrong glyphed point");
+        break;
+      default:
+        break;
+    }
+    previousId = inPtId;
+
+    ComputeReferenceTransform(input, config, inPtId, 0.75, trans);
+    vtkNew<vtkPoints> expectedPts;
+    expectedPts->SetDataType(output->GetPoints()->GetDataType());
+    trans->TransformPoints(transformedSourcePts, expectedPts);
+    vtkNew<vtkFloatArray> expectedNormals;
+    expectedNormals->SetNumberOfComponents(3);
+    trans->TransformNormals(source->GetPointData()->GetNormals(), expectedNormals);
+
+    for (vtkIdType i = 0; i < numSourcePts; ++i)
+    {
+      const vtkIdType outPtId = glyphId * numSourcePts + i;
+      double expectedPt[3], pt[3], expectedNormal[3], normal[3];
+      expectedPts->GetPoint(i, expectedPt);
+      output->GetPoint(outPtId, pt);
+      expectedNormals->GetTuple(i, expectedNormal);
+      normals->GetTuple(outPtId, normal);
+      for (int comp = 0; comp < 3; ++comp)
+      {
+        expect(Matches(pt[comp], expectedPt[comp]), "point differs from vtkTransform");
+        expect(Matches(normal[comp], expectedNormal[comp]), "normal differs from vtkTransform");
+      }
+      expect(ids->GetTuple1(outPtId) == inPtId, "wrong point data");
+    }
+  }
+
+  // Every glyph has a copy of the source cells.
+  expect(output->GetNumberOfPolys() == numGlyphs * source->GetNumberOfPolys(), "wrong polys");
+  expect(output->GetNumberOfLines() == numGlyphs * source->GetNumberOfLines(), "wrong lines");
+  vtkNew<vtkIdList> sourcePtIds;
+  vtkNew<vtkIdList> outPtIds;
+  const vtkIdType numSourceCells = source->GetNumberOfCells();
+  for (vtkIdType cellId = 0; cellId < numSourceCells; ++cellId)
+  {
+    source->GetCellPoints(cellId, sourcePtIds);
+    const vtkIdType lastGlyph = numGlyphs - 1;
+    // The cells of each glyph follow the source cells.
+    vtkIdType outCellId = lastGlyph * numSourceCells + cellId;
+    expect(output->GetCellType(outCellId) == source->GetCellType(cellId), "wrong cell type");
+    output->GetCellPoints(outCellId, outPtIds);
+    expect(outPtIds->GetNumberOfIds() == sourcePtIds->GetNumberOfIds(), "wrong cell size");
+    for (vtkIdType i = 0; i < sourcePtIds->GetNumberOfIds(); ++i)
+    {
+      expect(outPtIds->GetId(i) == sourcePtIds->GetId(i) + lastGlyph * numSourcePts,
+        "wrong cell connectivity");
+    }
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestPVGlyphFilter(int, char*[])
+{
+  vtkSmartPointer<vtkImageData> input = CreateInput();
+
+  const Config configs[] = {
+    { "scalar", "vectors", vtkPVGlyphFilter::SCALE_BY_MAGNITUDE, false, false },
+    { "vectors", "vectors", vtkPVGlyphFilter::SCALE_BY_MAGNITUDE, false, true },
+    { "vectors", "vectors", vtkPVGlyphFilter::SCALE_BY_COMPONENTS, true, false },
+    { "vectors2", nullptr, vtkPVGlyphFilter::SCALE_BY_COMPONENTS, false, false },
+    { nullptr, "vectors", vtkPVGlyphFilter::SCALE_BY_MAGNITUDE, true, true },
+  };
+  const int modes[] = { vtkPVGlyphFilter::ALL_POINTS, vtkPVGlyphFilter::EVERY_NTH_POINT,
+    vtkPVGlyphFilter::SPATIALLY_UNIFORM_DISTRIBUTION,
+    vtkPVGlyphFilter::SPATIALLY_UNIFORM_INVERSE_TRANSFORM_SAMPLING_SURFACE,
+    vtkPVGlyphFilter::SPATIALLY_UNIFORM_INVERSE_TRANSFORM_SAMPLING_VOLUME };
+
+  int configIdx = 0;
+  for (const Config& config : configs)
+  {
+    for (int mode : modes)
+    {
+      std::string label =
+        "config " + std::to_string(configIdx) + ", glyph mode " + std::to_string(mode);
+      if (CheckGlyphs(input, config, mode, 3, label) != EXIT_SUCCESS)
+      {
+        return EXIT_FAILURE;
+      }
+    }
+    ++configIdx;
+  }
+  return EXIT_SUCCESS;
+}
@@ -14,7 +14,9 @@ PURPOSE.  See the above copyright notice for more information.
 =========================================================================*/
 #include "vtkCleanUnstructuredGrid.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCollection.h"
 #include "vtkDataSet.h"
@@ -22,27 +24,263 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkIntArray.h"
+#include "vtkMath.h"
 #include "vtkMergePoints.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkPoints.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// Coordinates of all the input points, gathered once for the threads.
+void GatherCoordinates(vtkDataSet* input, std::vector<double>& coords)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  coords.resize(3 * numPts);
+  // vtkDataSet::GetPoint is thread safe once it has been called from a
+  // single thread.
+  input->GetPoint(0, coords.data());
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      input->GetPoint(ptId, &coords[3 * ptId]);
+    }
+  });
+}
+
+// Exact merging: sorts the point ids by coordinates, then by id, so that
+// coincident points form runs starting with their lowest id. position[ptId]
+// is the index of ptId in order and runStart[index] is the index of the first
+// point of its run.
+void SortCoincidentPoints(const std::vector<double>& coords, std::vector<vtkIdType>& order,
+  std::vector<vtkIdType>& position, std::vector<vtkIdType>& runStart)
+{
+  vtkIdType numPts = static_cast<vtkIdType>(coords.size() / 3);
+  order.resize(numPts);
+  position.resize(numPts);
+  runStart.resize(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      order[ptId] = ptId;
+    }
+  });
+  const double* x = coords.data();
+  vtkSMPTools::Sort(order.begin(), order.end(), [x](vtkIdType a, vtkIdType b) {
+    const double* xa = x + 3 * a;
+    const double* xb = x + 3 * b;
+    for (int comp = 0; comp < 3; ++comp)
+    {
+      if (xa[comp] != xb[comp])
+      {
+        return xa[comp] < xb[comp];
+      }
+    }
+    return a < b;
+  });
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType index = begin; index < end; ++index)
+    {
+      position[order[index]] = index;
+    }
+  });
+  for (vtkIdType index = 0; index < numPts; ++index)
+  {
+    const double* xa = x + 3 * order[index];
+    const double* xb = index > 0 ? x + 3 * order[index - 1] : nullptr;
+    bool coincident = xb && xa[0] == xb[0] && xa[1] == xb[1] && xa[2] == xb[2];
+    runStart[index] = coincident ? runStart[index - 1] : index;
+  }
+}
+
+// Merging within a tolerance: finds, for each point, the lower id points
+// within tolerance, closest first, then by id. Points are binned on a grid
+// whose bins are at least as large as the tolerance, so only the 27
+// neighboring bins need to be searched.
+// In a cluster of points within tolerance of each other, the number of such
+// candidates grows quadratically with the size of the cluster while most of
+// them are merged points that cannot be chosen. Only the MaxCandidates
+// closest ones of each point are stored, in
+// Candidates[MaxCandidates * ptId, MaxCandidates * ptId + min(Counts[ptId], MaxCandidates)),
+// the others are visited again with ForEachCandidate when none of them can be
+// chosen.
+class ToleranceCandidates
+{
+public:
+  static const vtkIdType MaxCandidates = 8;
+
+  ToleranceCandidates(const std::vector<double>& coords, const double bounds[6], double tolerance)
+    : X(coords.data())
+    , Tolerance2(tolerance * tolerance)
+  {
+    vtkIdType numPts = static_cast<vtkIdType>(coords.size() / 3);
+    this->BinSize = tolerance;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      this->Origin[axis] = bounds[2 * axis];
+      this->BinSize =
+        std::max(this->BinSize, (bounds[2 * axis + 1] - bounds[2 * axis]) / MaxBin);
+    }
+
+    // Point ids sorted by bin, then by id.
+    this->Bins.resize(numPts);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        const double* pt = this->X + 3 * ptId;
+        this->Bins[ptId] = std::make_pair(
+          BinKey(this->BinIndex(pt, 0), this->BinIndex(pt, 1), this->BinIndex(pt, 2)), ptId);
+      }
+    });
+    vtkSMPTools::Sort(this->Bins.begin(), this->Bins.end());
+
+    this->Counts.resize(numPts);
+    this->Candidates.resize(MaxCandidates * numPts);
+    vtkSMPThreadLocal<std::vector<vtkIdType> > localCandidates;
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      std::vector<vtkIdType>& ptCandidates = localCandidates.Local();
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        ptCandidates.clear();
+        this->ForEachCandidate(
+          ptId, [&](vtkIdType candidate) { ptCandidates.push_back(candidate); });
+        vtkIdType count = static_cast<vtkIdType>(ptCandidates.size());
+        vtkIdType stored = std::min(count, MaxCandidates);
+        std::partial_sort(ptCandidates.begin(), ptCandidates.begin() + stored, ptCandidates.end(),
+          [&](vtkIdType a, vtkIdType b) { return this->Closer(ptId, a, b); });
+        std::copy(ptCandidates.begin(), ptCandidates.begin() + stored,
+          this->Candidates.begin() + MaxCandidates * ptId);
+        this->Counts[ptId] = count;
+      }
+    });
+  }
+
+  // Visits the lower id points within tolerance of ptId, in no particular
+  // order.
+  void ForEachCandidate(vtkIdType ptId, const std::function<void(vtkIdType)>& visit) const
+  {
+    const double* pt = this->X + 3 * ptId;
+    vtkTypeInt64 ijk[3] = { this->BinIndex(pt, 0), this->BinIndex(pt, 1),
+      this->BinIndex(pt, 2) };
+    for (vtkTypeInt64 k = std::max(ijk[2] - 1, static_cast<vtkTypeInt64>(0));
+         k <= std::min(ijk[2] + 1, MaxBin); ++k)
+    {
+      for (vtkTypeInt64 j = std::max(ijk[1] - 1, static_cast<vtkTypeInt64>(0));
+           j <= std::min(ijk[1] + 1, MaxBin); ++j)
+      {
+        for (vtkTypeInt64 i = std::max(ijk[0] - 1, static_cast<vtkTypeInt64>(0));
+             i <= std::min(ijk[0] + 1, MaxBin); ++i)
+        {
+          vtkTypeUInt64 key = BinKey(i, j, k);
+          // Lower ids come first in a bin, stop at ptId.
+          auto first = std::lower_bound(
+            this->Bins.begin(), this->Bins.end(), std::make_pair(key, vtkIdType(0)));
+          auto last = std::lower_bound(first, this->Bins.end(), std::make_pair(key, ptId));
+          for (auto iter = first; iter != last; ++iter)
+          {
+            if (vtkMath::Distance2BetweenPoints(pt, this->X + 3 * iter->second) <=
+              this->Tolerance2)
+            {
+              visit(iter->second);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // Whether a is closer to ptId than b, ties broken by id.
+  bool Closer(vtkIdType ptId, vtkIdType a, vtkIdType b) const
+  {
+    const double* pt = this->X + 3 * ptId;
+    double da = vtkMath::Distance2BetweenPoints(pt, this->X + 3 * a);
+    double db = vtkMath::Distance2BetweenPoints(pt, this->X + 3 * b);
+    return da < db || (da == db && a < b);
+  }
+
+  std::vector<vtkIdType> Counts;
+  std::vector<vtkIdType> Candidates;
+
+private:
+  static const int BitsPerAxis = 21;
+  static const vtkTypeInt64 MaxBin = (static_cast<vtkTypeInt64>(1) << BitsPerAxis) - 1;
+
+  vtkTypeInt64 BinIndex(const double* pt, int axis) const
+  {
+    vtkTypeInt64 bin =
+      static_cast<vtkTypeInt64>(std::floor((pt[axis] - this->Origin[axis]) / this->BinSize));
+    return std::min(std::max(bin, static_cast<vtkTypeInt64>(0)), MaxBin);
+  }
+
+  static vtkTypeUInt64 BinKey(vtkTypeInt64 i, vtkTypeInt64 j, vtkTypeInt64 k)
+  {
+    return static_cast<vtkTypeUInt64>(i | (j << BitsPerAxis) | (k << (2 * BitsPerAxis)));
+  }
+
+  const double* X;
+  double Tolerance2;
+  double Origin[3];
+  double BinSize;
+  std::vector<std::pair<vtkTypeUInt64, vtkIdType> > Bins;
+};
+
+const vtkIdType ToleranceCandidates::MaxCandidates;
+const int ToleranceCandidates::BitsPerAxis;
+const vtkTypeInt64 ToleranceCandidates::MaxBin;
+
+// Renumbers the connectivity of a cell array in place.
+template <typename ArrayT>
+void RemapConnectivity(ArrayT* connectivity, const vtkIdType* ptMap)
+{
+  using ValueType = typename ArrayT::ValueType;
+  ValueType* ids = connectivity->GetPointer(0);
+  vtkSMPTools::For(0, connectivity->GetNumberOfValues(), [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ii = begin; ii < end; ++ii)
+    {
+      ids[ii] = static_cast<ValueType>(ptMap[ids[ii]]);
+    }
+  });
+}
+}
+
 vtkStandardNewMacro(vtkCleanUnstructuredGrid);
 vtkCxxSetObjectMacro(vtkCleanUnstructuredGrid, Locator, vtkIncrementalPointLocator);
 
+//----------------------------------------------------------------------------
+vtkCleanUnstructuredGrid::vtkCleanUnstructuredGrid()
+{
+  this->SetPartitionArrayName("vtkProcessId");
+}
+
 //----------------------------------------------------------------------------
 vtkCleanUnstructuredGrid::~vtkCleanUnstructuredGrid()
 {
   this->SetLocator(nullptr);
+  this->SetPartitionArrayName(nullptr);
 }
 
 //----------------------------------------------------------------------------
 void vtkCleanUnstructuredGrid::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "UseMultithreadedMerge: " << this->UseMultithreadedMerge << endl;
+  os << indent << "MergeOnlyAcrossPartitions: " << this->MergeOnlyAcrossPartitions << endl;
+  os << indent << "PartitionArrayName: "
+     << (this->PartitionArrayName ? this->PartitionArrayName : "(none)") << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -106,41 +344,72 @@ int vtkCleanUnstructuredGrid::RequestData(vtkInformation* vtkNotUsed(request),
   vtkIdType* ptMap = new vtkIdType[num];
   double pt[3];
 
-  this->CreateDefaultLocator(input);
-  if (this->ToleranceIsAbsolute)
-  {
-    this->Locator->SetTolerance(this->AbsoluteTolerance);
-  }
-  else
-  {
-    this->Locator->SetTolerance(this->Tolerance * input->GetLength());
-  }
-  double bounds[6];
-  input->GetBounds(bounds);
-  this->Locator->InitPointInsertion(newPts, bounds);
-
   vtkIdType progressStep = num / 100;
   if (progressStep == 0)
   {
     progressStep = 1;
   }
-  for (id = 0; id < num; ++id)
+  bool multithreaded = this->UseMultithreadedMerge || this->MergeOnlyAcrossPartitions;
+  if (multithreaded)
   {
-    if (id % progressStep == 0)
+    double tol =
+      this->ToleranceIsAbsolute ? this->AbsoluteTolerance : this->Tolerance * input->GetLength();
+    this->MergePointsMultithreaded(input, tol, newPts, output->GetPointData(), ptMap);
+  }
+  else
+  {
+    this->CreateDefaultLocator(input);
+    if (this->ToleranceIsAbsolute)
     {
-      this->UpdateProgress(0.8 * ((float)id / num));
+      this->Locator->SetTolerance(this->AbsoluteTolerance);
     }
-    input->GetPoint(id, pt);
-    if (this->Locator->InsertUniquePoint(pt, newId))
+    else
     {
-      output->GetPointData()->CopyData(input->GetPointData(), id, newId);
+      this->Locator->SetTolerance(this->Tolerance * input->GetLength());
+    }
+    double bounds[6];
+    input->GetBounds(bounds);
+    this->Locator->InitPointInsertion(newPts, bounds);
+
+    for (id = 0; id < num; ++id)
+    {
+      if (id % progressStep == 0)
+      {
+        this->UpdateProgress(0.8 * ((float)id / num));
+      }
+      input->GetPoint(id, pt);
+      if (this->Locator->InsertUniquePoint(pt, newId))
+      {
+        output->GetPointData()->CopyData(input->GetPointData(), id, newId);
+      }
+      ptMap[id] = newId;
     }
-    ptMap[id] = newId;
   }
   output->SetPoints(newPts);
   newPts->Delete();
 
   // Now copy the cells.
+  // Without polyhedra, the connectivity of an unstructured grid input is
+  // renumbered in place, in parallel.
+  vtkUnstructuredGrid* ugInput = vtkUnstructuredGrid::SafeDownCast(input);
+  if (multithreaded && ugInput && !ugInput->GetFaces())
+  {
+    vtkNew<vtkCellArray> cells;
+    cells->DeepCopy(ugInput->GetCells());
+    if (cells->IsStorage64Bit())
+    {
+      RemapConnectivity(cells->GetConnectivityArray64(), ptMap);
+    }
+    else
+    {
+      RemapConnectivity(cells->GetConnectivityArray32(), ptMap);
+    }
+    output->SetCells(ugInput->GetCellTypesArray(), cells);
+    delete[] ptMap;
+    output->Squeeze();
+    return 1;
+  }
+
   vtkIdList* cellPoints = vtkIdList::New();
   num = input->GetNumberOfCells();
   output->Allocate(num);
@@ -151,9 +420,9 @@ int vtkCleanUnstructuredGrid::RequestData(vtkInformation* vtkNotUsed(request),
       this->UpdateProgress(0.8 + 0.2 * ((float)id / num));
     }
     // special handling for polyhedron cells
-    if (vtkUnstructuredGrid::SafeDownCast(input) && input->GetCellType(id) == VTK_POLYHEDRON)
+    if (ugInput && input->GetCellType(id) == VTK_POLYHEDRON)
     {
-      vtkUnstructuredGrid::SafeDownCast(input)->GetFaceStream(id, cellPoints);
+      ugInput->GetFaceStream(id, cellPoints);
       vtkUnstructuredGrid::ConvertFaceStreamPointIds(cellPoints, ptMap);
     }
     else
@@ -176,6 +445,147 @@ int vtkCleanUnstructuredGrid::RequestData(vtkInformation* vtkNotUsed(request),
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkCleanUnstructuredGrid::MergePointsMultithreaded(
+  vtkDataSet* input, double tolerance, vtkPoints* newPts, vtkPointData* outPD, vtkIdType* ptMap)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  if (numPts == 0)
+  {
+    return;
+  }
+  std::vector<double> coords;
+  GatherCoordinates(input, coords);
+  this->UpdateProgress(0.1);
+
+  // Optional partition of each point: points are only merged with points of
+  // another partition.
+  vtkDataArray* partitions = nullptr;
+  if (this->MergeOnlyAcrossPartitions)
+  {
+    partitions = this->PartitionArrayName
+      ? input->GetPointData()->GetArray(this->PartitionArrayName)
+      : nullptr;
+    if (!partitions)
+    {
+      vtkWarningMacro("Missing partition array \""
+        << (this->PartitionArrayName ? this->PartitionArrayName : "")
+        << "\". Merging all points.");
+    }
+  }
+
+  // Candidates of each point: lower id points it may be merged with, closest
+  // first. They are found in parallel, the merge itself is a cheap serial
+  // pass in id order so that points are kept as the locator would keep them.
+  std::vector<vtkIdType> order, position, runStart;
+  std::unique_ptr<ToleranceCandidates> candidates;
+  if (tolerance == 0.0)
+  {
+    SortCoincidentPoints(coords, order, position, runStart);
+  }
+  else
+  {
+    double bounds[6];
+    input->GetBounds(bounds);
+    candidates.reset(new ToleranceCandidates(coords, bounds, tolerance));
+  }
+  this->UpdateProgress(0.6);
+
+  std::vector<vtkIdType> keptIds;
+  keptIds.reserve(numPts);
+  std::vector<char> kept(numPts, 0);
+  // With partitions, an output point gathers at most one point of each
+  // partition, otherwise two duplicates of a partition would be merged
+  // through a point of another partition. This holds the (output point,
+  // partition) of the merged points, kept points have their own partition.
+  std::set<std::pair<vtkIdType, double> > mergedPartitions;
+  auto canMerge = [&](vtkIdType ptId, vtkIdType candidate) {
+    if (!kept[candidate])
+    {
+      return false;
+    }
+    if (!partitions)
+    {
+      return true;
+    }
+    double partition = partitions->GetComponent(ptId, 0);
+    return partition != partitions->GetComponent(candidate, 0) &&
+      mergedPartitions.find(std::make_pair(ptMap[candidate], partition)) ==
+      mergedPartitions.end();
+  };
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    vtkIdType mergedId = -1;
+    if (tolerance == 0.0)
+    {
+      // The first point of a run is always kept, hence without partitions
+      // this loop stops at the first candidate.
+      vtkIdType index = position[ptId];
+      for (vtkIdType candidate = runStart[index]; candidate < index && mergedId < 0; ++candidate)
+      {
+        if (canMerge(ptId, order[candidate]))
+        {
+          mergedId = order[candidate];
+        }
+      }
+    }
+    else
+    {
+      const vtkIdType* ptCandidates =
+        candidates->Candidates.data() + ToleranceCandidates::MaxCandidates * ptId;
+      vtkIdType count = candidates->Counts[ptId];
+      vtkIdType stored = std::min(count, ToleranceCandidates::MaxCandidates);
+      for (vtkIdType candidate = 0; candidate < stored && mergedId < 0; ++candidate)
+      {
+        if (canMerge(ptId, ptCandidates[candidate]))
+        {
+          mergedId = ptCandidates[candidate];
+        }
+      }
+      if (mergedId < 0 && count > stored)
+      {
+        // None of the closest candidates can be chosen, look for the closest
+        // one among all of them.
+        candidates->ForEachCandidate(ptId, [&](vtkIdType candidate) {
+          if ((mergedId < 0 || candidates->Closer(ptId, candidate, mergedId)) &&
+            canMerge(ptId, candidate))
+          {
+            mergedId = candidate;
+          }
+        });
+      }
+    }
+    if (mergedId < 0)
+    {
+      kept[ptId] = 1;
+      ptMap[ptId] = static_cast<vtkIdType>(keptIds.size());
+      keptIds.push_back(ptId);
+    }
+    else
+    {
+      ptMap[ptId] = ptMap[mergedId];
+      if (partitions)
+      {
+        mergedPartitions.insert(std::make_pair(ptMap[ptId], partitions->GetComponent(ptId, 0)));
+      }
+    }
+  }
+  this->UpdateProgress(0.7);
+
+  // Copy the kept points and their data.
+  vtkIdType numNewPts = static_cast<vtkIdType>(keptIds.size());
+  newPts->SetNumberOfPoints(numNewPts);
+  ArrayList arrays;
+  arrays.AddArrays(numNewPts, input->GetPointData(), outPD);
+  vtkSMPTools::For(0, numNewPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType newId = begin; newId < end; ++newId)
+    {
+      newPts->SetPoint(newId, &coords[3 * keptIds[newId]]);
+      arrays.Copy(keptIds[newId], newId);
+    }
+  });
+}
+
 //----------------------------------------------------------------------------
 int vtkCleanUnstructuredGrid::FillInputPortInformation(int vtkNotUsed(port), vtkInformation* info)
 {
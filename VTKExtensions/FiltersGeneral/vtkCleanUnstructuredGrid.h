@@ -23,6 +23,10 @@
  * merge duplicate points (with coincident coordinates) using the vtkMergePoints object
  * to merge points.
  *
+ * Alternatively, points can be merged with a multithreaded, sort-based
+ * algorithm (see UseMultithreadedMerge), which can also restrict merging to
+ * points coming from different partitions (see MergeOnlyAcrossPartitions).
+ *
  * @sa
  * vtkCleanPolyData
 */
@@ -35,6 +39,8 @@
 
 class vtkIncrementalPointLocator;
 class vtkDataSet;
+class vtkPointData;
+class vtkPoints;
 
 class VTKPVVTKEXTENSIONSFILTERSGENERAL_EXPORT vtkCleanUnstructuredGrid
   : public vtkUnstructuredGridAlgorithm
@@ -75,6 +81,46 @@ public:
   // Release locator
   void ReleaseLocator() { this->SetLocator(nullptr); }
 
+  //@{
+  /**
+   * When on, points are merged with a multithreaded algorithm instead of
+   * being inserted one at a time in the locator. Points are sorted by
+   * coordinates (zero tolerance) or binned by tolerance, and each point is
+   * merged with the closest lower id point kept so far within tolerance. With
+   * a zero tolerance, the output is identical to the one of the locator.
+   * Cell connectivity is renumbered in parallel too. Default is off.
+   */
+  vtkSetMacro(UseMultithreadedMerge, bool);
+  vtkGetMacro(UseMultithreadedMerge, bool);
+  vtkBooleanMacro(UseMultithreadedMerge, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, points are only merged with points of another partition, as
+   * given by the point data array named PartitionArrayName. For instance,
+   * merging the data of a distributed run gathered on a single process using
+   * the "vtkProcessId" array only merges the points shared by two processes
+   * and keeps the duplicate points of each process. An output point gathers
+   * at most one point of each partition, so the duplicates of a partition
+   * stay distinct even when they coincide with a point of another partition.
+   * This uses the multithreaded merge. Default is off.
+   */
+  vtkSetMacro(MergeOnlyAcrossPartitions, bool);
+  vtkGetMacro(MergeOnlyAcrossPartitions, bool);
+  vtkBooleanMacro(MergeOnlyAcrossPartitions, bool);
+  //@}
+
+  //@{
+  /**
+   * Set/get the name of the point data array identifying the partition of
+   * each point, used when MergeOnlyAcrossPartitions is on. Default is
+   * "vtkProcessId".
+   */
+  vtkSetStringMacro(PartitionArrayName);
+  vtkGetStringMacro(PartitionArrayName);
+  //@}
+
   //@{
   /**
    * Set/get the desired precision for the output types. See the documentation
@@ -88,7 +134,7 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
 protected:
-  vtkCleanUnstructuredGrid() = default;
+  vtkCleanUnstructuredGrid();
   ~vtkCleanUnstructuredGrid() override;
 
   // options for managing point merging tolerance
@@ -97,6 +143,14 @@ protected:
   double AbsoluteTolerance = 1.0;
   vtkIncrementalPointLocator* Locator = nullptr;
   int OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  bool UseMultithreadedMerge = false;
+  bool MergeOnlyAcrossPartitions = false;
+  char* PartitionArrayName = nullptr;
+
+  // Multithreaded counterpart of the locator insertion: fills newPts, outPD
+  // and the map from input to output point ids.
+  void MergePointsMultithreaded(
+    vtkDataSet* input, double tolerance, vtkPoints* newPts, vtkPointData* outPD, vtkIdType* ptMap);
 
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
   int FillInputPortInformation(int port, vtkInformation* info) override;
@@ -14,9 +14,11 @@
 =========================================================================*/
 #include "vtkGridConnectivity.h"
 
+#include "vtkBoundingBox.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellType.h"
+#include "vtkCommunicator.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataPipeline.h"
 #include "vtkCompositeDataSet.h"
@@ -39,6 +41,14 @@
 #include "vtkTriangle.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
+#if VTK_MODULE_ENABLE_VTK_ParallelMPI
+#include "vtkMPIController.h"
+#endif
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
 
 // Distributed:
 // Find the max process global point id (face hash).
@@ -455,6 +465,7 @@ vtkGridConnectivity::vtkGridConnectivity()
   this->EquivalenceSet = 0;
   this->FragmentVolumes = 0;
   this->FaceHash = 0;
+  this->DistributedResolution = false;
   this->Controller = vtkMultiProcessController::GetGlobalController();
   this->ProcessId = this->Controller ? this->Controller->GetLocalProcessId() : 0;
 }
@@ -475,6 +486,7 @@ vtkExecutive* vtkGridConnectivity::CreateDefaultExecutive()
 void vtkGridConnectivity::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DistributedResolution: " << this->DistributedResolution << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -673,6 +685,8 @@ vtkIdType vtkGridConnectivityComputeMax(T* ptr, vtkIdType num)
 void vtkGridConnectivity::InitializeFaceHash(vtkUnstructuredGrid** inputs, int numberOfInputs)
 {
   vtkIdType maxId = 0;
+  // Processes without inputs still have to take part in the resolution.
+  this->GlobalPointIdType = VTK_ID_TYPE;
 
   // We need to find the maximum global point Id to initialize the face hash.
   for (int ii = 0; ii < numberOfInputs; ++ii)
@@ -680,35 +694,28 @@ void vtkGridConnectivity::InitializeFaceHash(vtkUnstructuredGrid** inputs, int n
     vtkDataArray* a = inputs[ii]->GetPointData()->GetGlobalIds();
     void* ptr = a->GetVoidPointer(0);
     vtkIdType numIds = a->GetNumberOfTuples();
-    maxId = 0;
+    vtkIdType blockMaxId = 0;
     this->GlobalPointIdType = a->GetDataType();
     switch (this->GlobalPointIdType)
     {
-      vtkTemplateMacro(maxId = vtkGridConnectivityComputeMax(static_cast<VTK_TT*>(ptr), numIds));
+      vtkTemplateMacro(
+        blockMaxId = vtkGridConnectivityComputeMax(static_cast<VTK_TT*>(ptr), numIds));
       default:
         vtkErrorMacro("ThreadedRequestData: Unknown input ScalarType");
         return;
     }
+    maxId = std::max(maxId, blockMaxId);
   }
 
   // Now we need to compute the maximum of all processes.
-  int numProcs = this->Controller->GetNumberOfProcesses();
-  if (this->Controller->GetLocalProcessId() != 0)
-  {
-    this->Controller->Send(&maxId, 1, 0, 897324);
-    // Only process 0 needs a hash to hold all procs faces.
-  }
-  else
+  // Only process 0 needs a hash to hold all procs faces, unless the
+  // fragments are resolved in a distributed way.  Then every process
+  // adds the faces of its neighbors to its hash.
+  vtkIdType globalMaxId = maxId;
+  this->Controller->AllReduce(&maxId, &globalMaxId, 1, vtkCommunicator::MAX_OP);
+  if (this->DistributedResolution || this->Controller->GetLocalProcessId() == 0)
   {
-    for (int ii = 1; ii < numProcs; ++ii)
-    {
-      vtkIdType tmp;
-      this->Controller->Receive(&tmp, 1, ii, 897324);
-      if (tmp > maxId)
-      {
-        maxId = tmp;
-      }
-    }
+    maxId = globalMaxId;
   }
 
   if (this->FaceHash)
@@ -884,7 +891,16 @@ int vtkGridConnectivity::RequestData(
   // into final volumes indexed by the resolved fragment ids.
   // Note: the ids start from 1.  This is because we started assigning partial fragment ids
   // from 1 so the equivalence set has a entry for 0 even though it is not used.
-  this->ResolveProcessesFaces();
+  // With DistributedResolution, faces are only exchanged between neighboring
+  // processes and the fragments are resolved with collectives instead.
+  if (this->DistributedResolution)
+  {
+    this->ResolveDistributedFragments(inputs, numberOfInputs);
+  }
+  else
+  {
+    this->ResolveProcessesFaces();
+  }
 
   // Use the face hash and integration data to generate the output surface.
   this->GenerateOutput(output, inputs);
@@ -1521,6 +1537,407 @@ void vtkGridConnectivity::ResolveProcessesFaces()
   delete[] fragmentNumFaces;
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+// Exchanges one buffer with each of the neighbors, which must be sorted.
+// The receive buffers must already have the size of what the neighbors
+// send, and empty buffers are not sent.  With MPI, all the receives then
+// all the sends are posted without blocking before waiting for them.
+// Otherwise the neighbors are visited in increasing order and the lower
+// process of a pair sends first, which cannot hang.
+template <typename T>
+void ExchangeWithNeighbors(vtkMultiProcessController* controller,
+  const std::vector<int>& neighbors, std::vector<std::vector<T> >& sendBufs,
+  std::vector<std::vector<T> >& recvBufs, int tag)
+{
+  const size_t numNeighbors = neighbors.size();
+#if VTK_MODULE_ENABLE_VTK_ParallelMPI
+  if (vtkMPIController* mpiController = vtkMPIController::SafeDownCast(controller))
+  {
+    std::vector<vtkMPICommunicator::Request> requests(2 * numNeighbors);
+    size_t numRequests = 0;
+    for (size_t ii = 0; ii < numNeighbors; ++ii)
+    {
+      if (!recvBufs[ii].empty())
+      {
+        mpiController->NoBlockReceive(recvBufs[ii].data(), static_cast<int>(recvBufs[ii].size()),
+          neighbors[ii], tag, requests[numRequests++]);
+      }
+    }
+    for (size_t ii = 0; ii < numNeighbors; ++ii)
+    {
+      if (!sendBufs[ii].empty())
+      {
+        mpiController->NoBlockSend(sendBufs[ii].data(), static_cast<int>(sendBufs[ii].size()),
+          neighbors[ii], tag, requests[numRequests++]);
+      }
+    }
+    for (size_t ii = 0; ii < numRequests; ++ii)
+    {
+      requests[ii].Wait();
+    }
+    return;
+  }
+#endif
+
+  const int myProc = controller->GetLocalProcessId();
+  for (size_t ii = 0; ii < numNeighbors; ++ii)
+  {
+    const int otherProc = neighbors[ii];
+    const bool sendFirst = myProc < otherProc;
+    const vtkIdType sendSize = static_cast<vtkIdType>(sendBufs[ii].size());
+    const vtkIdType recvSize = static_cast<vtkIdType>(recvBufs[ii].size());
+    if (sendFirst && sendSize > 0)
+    {
+      controller->Send(sendBufs[ii].data(), sendSize, otherProc, tag);
+    }
+    if (recvSize > 0)
+    {
+      controller->Receive(recvBufs[ii].data(), recvSize, otherProc, tag);
+    }
+    if (!sendFirst && sendSize > 0)
+    {
+      controller->Send(sendBufs[ii].data(), sendSize, otherProc, tag);
+    }
+  }
+}
+
+// Exchanges the sizes of the buffers sent to the neighbors and sizes the
+// receive buffers accordingly.
+template <typename T>
+void ExchangeSizesWithNeighbors(vtkMultiProcessController* controller,
+  const std::vector<int>& neighbors, std::vector<std::vector<T> >& sendBufs,
+  std::vector<std::vector<T> >& recvBufs, int tag)
+{
+  const size_t numNeighbors = neighbors.size();
+  std::vector<std::vector<int> > sendSizes(numNeighbors);
+  std::vector<std::vector<int> > recvSizes(numNeighbors, std::vector<int>(1, 0));
+  for (size_t ii = 0; ii < numNeighbors; ++ii)
+  {
+    sendSizes[ii].push_back(static_cast<int>(sendBufs[ii].size()));
+  }
+  ExchangeWithNeighbors(controller, neighbors, sendSizes, recvSizes, tag);
+  recvBufs.resize(numNeighbors);
+  for (size_t ii = 0; ii < numNeighbors; ++ii)
+  {
+    recvBufs[ii].resize(recvSizes[ii][0]);
+  }
+}
+}
+
+//----------------------------------------------------------------------------
+// This method expects every process to have local faces, an unresolved
+// equivalence set and integration arrays indexed by partial fragment ids.
+// It is the distributed counterpart of ResolveProcessesFaces.  At the end,
+// the faces shared between processes have been removed from the hash, the
+// face fragment ids are the final fragment ids and the integration arrays
+// are indexed by the final fragment ids, on every process.
+//
+// The algorithm is:  Resolve the local fragments and make their ids global
+// by offsetting them with the number of fragments of the lower processes.
+// Exchange the boundary faces with the processes whose bounds overlap ours
+// (only the faces that lie within the bounds of the other process), without
+// blocking.
+// A remote face found in our hash is shared by the two processes: it is
+// internal and the two fragments are equivalent.
+// The distinct pairs of equivalent fragments are gathered on every process,
+// which merges them with a union-find over the fragments they contain.
+// Finally, sum the integration arrays with a reduction.
+void vtkGridConnectivity::ResolveDistributedFragments(
+  vtkUnstructuredGrid** inputs, int numberOfInputs)
+{
+  int numProcs = this->Controller->GetNumberOfProcesses();
+  int myProc = this->Controller->GetLocalProcessId();
+  vtkGridConnectivityFace* face;
+
+  this->ResolveEquivalentFragments();
+
+  // Resolved set 0 is the special "remove face" value, so the local
+  // fragments are [1, numberOfResolvedSets).
+  int numLocalFragments = std::max(this->EquivalenceSet->GetNumberOfResolvedSets() - 1, 0);
+  std::vector<int> fragmentCounts(numProcs, 0);
+  this->Controller->AllGather(&numLocalFragments, fragmentCounts.data(), 1);
+  int fragmentOffset = 0;
+  int numGlobalFragments = 0;
+  for (int procIdx = 0; procIdx < numProcs; ++procIdx)
+  {
+    if (procIdx == myProc)
+    {
+      fragmentOffset = numGlobalFragments;
+    }
+    numGlobalFragments += fragmentCounts[procIdx];
+  }
+
+  // Find the processes whose bounds overlap ours.  The boxes are slightly
+  // inflated so that processes touching at a face are neighbors.  Every
+  // process tests the same gathered boxes so the relation is symmetric.
+  vtkBoundingBox localBox;
+  for (int ii = 0; ii < numberOfInputs; ++ii)
+  {
+    if (inputs[ii]->GetNumberOfPoints() > 0)
+    {
+      localBox.AddBounds(inputs[ii]->GetBounds());
+    }
+  }
+  double bounds[6] = { 1.0, -1.0, 1.0, -1.0, 1.0, -1.0 };
+  if (localBox.IsValid())
+  {
+    localBox.GetBounds(bounds);
+  }
+  std::vector<double> allBounds(6 * numProcs);
+  this->Controller->AllGather(bounds, allBounds.data(), 6);
+  std::vector<vtkBoundingBox> boxes(numProcs);
+  for (int procIdx = 0; procIdx < numProcs; ++procIdx)
+  {
+    const double* procBounds = &allBounds[6 * procIdx];
+    if (procBounds[0] <= procBounds[1])
+    {
+      boxes[procIdx].SetBounds(procBounds);
+      boxes[procIdx].Inflate(1e-6 * boxes[procIdx].GetDiagonalLength());
+    }
+  }
+  std::vector<int> neighbors;
+  for (int procIdx = 0; procIdx < numProcs; ++procIdx)
+  {
+    if (procIdx != myProc && boxes[myProc].IsValid() && boxes[procIdx].IsValid() &&
+      boxes[myProc].Intersects(boxes[procIdx]))
+    {
+      neighbors.push_back(procIdx);
+    }
+  }
+
+  // Marshal our boundary faces (three smallest corners and global fragment id)
+  // and keep their bounds to select the faces sent to each neighbor.
+  std::vector<vtkIdType> faceRecords;
+  std::vector<vtkBoundingBox> faceBoxes;
+  if (!neighbors.empty())
+  {
+    faceRecords.reserve(4 * this->FaceHash->GetNumberOfFaces());
+    faceBoxes.reserve(this->FaceHash->GetNumberOfFaces());
+    this->FaceHash->InitTraversal();
+    while ((face = this->FaceHash->GetNextFace()))
+    {
+      vtkCell* cell = inputs[face->BlockId]->GetCell(face->CellId);
+      double faceBounds[6];
+      cell->GetFace(face->FaceId)->GetBounds(faceBounds);
+      faceBoxes.push_back(vtkBoundingBox(faceBounds));
+      faceRecords.push_back(this->FaceHash->GetFirstPointIndex());
+      faceRecords.push_back(face->CornerId2);
+      faceRecords.push_back(face->CornerId3);
+      faceRecords.push_back(face->FragmentId + fragmentOffset);
+    }
+  }
+
+  // Exchange the faces with the neighbors, sizes first.
+  std::vector<std::vector<vtkIdType> > sendBufs(neighbors.size());
+  std::vector<std::vector<vtkIdType> > recvBufs;
+  for (size_t nn = 0; nn < neighbors.size(); ++nn)
+  {
+    for (size_t ii = 0; ii < faceBoxes.size(); ++ii)
+    {
+      if (faceBoxes[ii].Intersects(boxes[neighbors[nn]]))
+      {
+        sendBufs[nn].insert(sendBufs[nn].end(), faceRecords.begin() + 4 * ii,
+          faceRecords.begin() + 4 * (ii + 1));
+      }
+    }
+  }
+  ExchangeSizesWithNeighbors(this->Controller, neighbors, sendBufs, recvBufs, 728341);
+  ExchangeWithNeighbors(this->Controller, neighbors, sendBufs, recvBufs, 728342);
+
+  // A remote face found in our hash is shared with the neighbor and the two
+  // fragments are equivalent.  Both processes of a pair find the same shared
+  // faces, so only the lower one records the equivalence.
+  std::set<std::pair<int, int> > pairs;
+  for (size_t nn = 0; nn < neighbors.size(); ++nn)
+  {
+    const vtkIdType numRecvFaces = static_cast<vtkIdType>(recvBufs[nn].size() / 4);
+    for (vtkIdType faceIdx = 0; faceIdx < numRecvFaces; ++faceIdx)
+    {
+      const vtkIdType* record = recvBufs[nn].data() + 4 * faceIdx;
+      face = this->FaceHash->AddFace(record[0], record[1], record[2]);
+      if (face->FragmentId > 0)
+      { // The face is internal.  It has been removed from the hash.
+        if (myProc < neighbors[nn])
+        {
+          pairs.insert(
+            std::make_pair(face->FragmentId + fragmentOffset, static_cast<int>(record[3])));
+        }
+      }
+      else
+      { // Not one of our faces.  Adding it again removes it from the hash.
+        this->FaceHash->AddFace(record[0], record[1], record[2]);
+      }
+    }
+  }
+
+  // Many faces connect the same two fragments, so the pairs are far fewer
+  // than the boundary faces.  Only they are gathered on every process.
+  std::vector<int> equivalences;
+  equivalences.reserve(2 * pairs.size());
+  for (const auto& pair : pairs)
+  {
+    equivalences.push_back(pair.first);
+    equivalences.push_back(pair.second);
+  }
+  int numLocalValues = static_cast<int>(equivalences.size());
+  std::vector<int> numValuesPerProc(numProcs, 0);
+  this->Controller->AllGather(&numLocalValues, numValuesPerProc.data(), 1);
+  std::vector<vtkIdType> recvLengths(numProcs);
+  std::vector<vtkIdType> offsets(numProcs);
+  vtkIdType numGlobalValues = 0;
+  for (int procIdx = 0; procIdx < numProcs; ++procIdx)
+  {
+    offsets[procIdx] = numGlobalValues;
+    recvLengths[procIdx] = numValuesPerProc[procIdx];
+    numGlobalValues += numValuesPerProc[procIdx];
+  }
+  std::vector<int> allEquivalences(numGlobalValues + 1);
+  this->Controller->AllGatherV(equivalences.data(), allEquivalences.data(), numLocalValues,
+    recvLengths.data(), offsets.data());
+
+  // Union-find over the fragments found on process boundaries.  Every
+  // process merges the same pairs, and the root of a set is its smallest
+  // fragment id, so they all find the same sets.
+  std::map<int, int> parents;
+  auto findRoot = [&parents](int id) {
+    auto it = parents.find(id);
+    while (it != parents.end() && it->second != id)
+    {
+      id = it->second;
+      it = parents.find(id);
+    }
+    return id;
+  };
+  for (vtkIdType ii = 0; ii < numGlobalValues; ii += 2)
+  {
+    int root1 = findRoot(allEquivalences[ii]);
+    int root2 = findRoot(allEquivalences[ii + 1]);
+    parents.insert(std::make_pair(root1, root1));
+    parents.insert(std::make_pair(root2, root2));
+    if (root1 < root2)
+    {
+      parents[root2] = root1;
+    }
+    else if (root2 < root1)
+    {
+      parents[root1] = root2;
+    }
+  }
+  // Fragments merged into a smaller one, in increasing order.
+  std::vector<int> mergedIds;
+  for (const auto& parent : parents)
+  {
+    if (parent.first != parent.second)
+    {
+      mergedIds.push_back(parent.first);
+    }
+  }
+
+  // Number the final fragments from 1 (0 stays the "remove face" value),
+  // in the order of their smallest global fragment id.  Only our own
+  // fragments need a final id.
+  int numFinalFragments = numGlobalFragments - static_cast<int>(mergedIds.size());
+  std::vector<int> finalIds(numLocalFragments + 1, 0);
+  for (int ii = 1; ii <= numLocalFragments; ++ii)
+  {
+    int root = findRoot(ii + fragmentOffset);
+    finalIds[ii] = root -
+      static_cast<int>(std::lower_bound(mergedIds.begin(), mergedIds.end(), root) -
+        mergedIds.begin());
+  }
+
+  this->FaceHash->InitTraversal();
+  while ((face = this->FaceHash->GetNextFace()))
+  {
+    face->FragmentId = finalIds[face->FragmentId];
+  }
+
+  // Sum the integration arrays.  They are packed in a single buffer:
+  // volumes, cell arrays and point arrays, each indexed by final fragment id.
+  // This assumes every process has the same arrays.  Processes without
+  // inputs have none, they only contribute (empty) volumes.
+  vtkIdType numValues = numFinalFragments + 1;
+  int numCellArrays = static_cast<int>(this->CellAttributesIntegration.size());
+  int numPointArrays = static_cast<int>(this->PointAttributesIntegration.size());
+  vtkIdType length = numValues * (1 + numCellArrays);
+  for (int ii = 0; ii < numPointArrays; ++ii)
+  {
+    length += numValues * this->PointAttributesIntegration[ii]->GetNumberOfComponents();
+  }
+  vtkIdType maxLength = length;
+  this->Controller->AllReduce(&length, &maxLength, 1, vtkCommunicator::MAX_OP);
+  bool sameArrays = (length == maxLength);
+  if (!sameArrays && numberOfInputs > 0)
+  {
+    vtkWarningMacro("Processes have different attribute arrays. Only volumes are integrated.");
+  }
+
+  std::vector<double> localSums(maxLength, 0.0);
+  std::vector<double> globalSums(maxLength, 0.0);
+  double* sumPtr = localSums.data();
+  for (int ii = 1; ii <= numLocalFragments; ++ii)
+  {
+    sumPtr[finalIds[ii]] += this->FragmentVolumes->GetValue(ii);
+  }
+  sumPtr += numValues;
+  if (sameArrays)
+  {
+    for (int jj = 0; jj < numCellArrays; ++jj)
+    {
+      vtkDoubleArray* da = this->CellAttributesIntegration[jj];
+      for (int ii = 1; ii <= numLocalFragments; ++ii)
+      {
+        sumPtr[finalIds[ii]] += da->GetValue(ii);
+      }
+      sumPtr += numValues;
+    }
+    for (int jj = 0; jj < numPointArrays; ++jj)
+    {
+      vtkDoubleArray* da = this->PointAttributesIntegration[jj];
+      int numComps = da->GetNumberOfComponents();
+      for (int ii = 1; ii <= numLocalFragments; ++ii)
+      {
+        double* resolvedPtr = sumPtr + finalIds[ii] * numComps;
+        for (int kk = 0; kk < numComps; ++kk)
+        {
+          resolvedPtr[kk] += da->GetComponent(ii, kk);
+        }
+      }
+      sumPtr += numValues * numComps;
+    }
+  }
+  this->Controller->AllReduce(
+    localSums.data(), globalSums.data(), maxLength, vtkCommunicator::SUM_OP);
+
+  sumPtr = globalSums.data();
+  this->FragmentVolumes->SetNumberOfTuples(numValues);
+  std::copy(sumPtr, sumPtr + numValues, this->FragmentVolumes->GetPointer(0));
+  sumPtr += numValues;
+  if (!sameArrays)
+  {
+    this->CellAttributesIntegration.clear();
+    this->PointAttributesIntegration.clear();
+    return;
+  }
+  for (int jj = 0; jj < numCellArrays; ++jj)
+  {
+    vtkDoubleArray* da = this->CellAttributesIntegration[jj];
+    da->SetNumberOfTuples(numValues);
+    std::copy(sumPtr, sumPtr + numValues, da->GetPointer(0));
+    sumPtr += numValues;
+  }
+  for (int jj = 0; jj < numPointArrays; ++jj)
+  {
+    vtkDoubleArray* da = this->PointAttributesIntegration[jj];
+    vtkIdType numPointValues = numValues * da->GetNumberOfComponents();
+    da->SetNumberOfTuples(numValues);
+    std::copy(sumPtr, sumPtr + numPointValues, da->GetPointer(0));
+    sumPtr += numPointValues;
+  }
+}
+
 //----------------------------------------------------------------------------
 // This method expects faces in the has, unresolved equivalence set and
 // integration arrays (volume) indexed bny the partial fragments.
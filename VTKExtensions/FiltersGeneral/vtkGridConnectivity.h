@@ -57,6 +57,15 @@ public:
   void IntegrateCellVolume(
     vtkCell* cell, int fragmentId, vtkUnstructuredGrid* input, vtkIdType cellIndex);
 
+  // When on, fragments spanning several processes are resolved without
+  // collecting the surface on process 0.  Boundary faces are only exchanged
+  // between processes whose bounds overlap, only the pairs of equivalent
+  // fragments found on process boundaries are shared to merge fragments and
+  // the integrated attributes are summed with reductions.  Off by default.
+  vtkSetMacro(DistributedResolution, bool);
+  vtkGetMacro(DistributedResolution, bool);
+  vtkBooleanMacro(DistributedResolution, bool);
+
 protected:
   vtkGridConnectivity();
   ~vtkGridConnectivity() override;
@@ -113,6 +122,11 @@ protected:
   void ResolveProcessesFaces();
   void CollectFacesAndArraysToRootProcess(int* fragmentIdMap, int* fragmentNumFaces);
 
+  // Resolves the fragments across processes without involving process 0.
+  void ResolveDistributedFragments(vtkUnstructuredGrid** inputs, int numberOfInputs);
+
+  bool DistributedResolution;
+
 private:
   vtkGridConnectivity(const vtkGridConnectivity&) = delete;
   void operator=(const vtkGridConnectivity&) = delete;
@@ -14,25 +14,40 @@
 =========================================================================*/
 #include "vtkPVArrayCalculator.h"
 
+#include "vtkArrayDispatch.h"
+#include "vtkCallbackCommand.h"
 #include "vtkCellData.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataObject.h"
 #include "vtkDataSet.h"
 #include "vtkFunctionParser.h"
 #include "vtkGraph.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVPostFilter.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkTable.h"
 
 #include <algorithm>
 #include <assert.h>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace
 {
@@ -69,6 +84,909 @@ public:
     this->Calc->AddScalarVariable(name.c_str(), this->ArrayName, this->Component);
   }
 };
+
+//----------------------------------------------------------------------------
+// Compiled evaluation of the calculator function.
+//
+// The byte code of the parsed function is a program for a stack machine that
+// vtkFunctionParser runs for each tuple. It is translated into a sequence of
+// instructions, each of which is applied to a block of tuples at once, every
+// stack position holding the values of all the tuples of the block. The
+// instructions apply the same operations, in the same order, as
+// vtkFunctionParser::Evaluate() hence give the same results.
+
+// Gives access to the byte code of the parsed function.
+class vtkPVArrayCalculatorParser : public vtkFunctionParser
+{
+public:
+  vtkTypeMacro(vtkPVArrayCalculatorParser, vtkFunctionParser);
+  static vtkPVArrayCalculatorParser* New()
+  {
+    vtkPVArrayCalculatorParser* ret = new vtkPVArrayCalculatorParser;
+    ret->InitializeObjectBase();
+    return ret;
+  }
+
+  int GetByteCodeSize() const { return this->ByteCodeSize; }
+  unsigned int GetByteCode(int i) const { return this->ByteCode[i]; }
+  double GetImmediate(int i) const { return this->Immediates[i]; }
+
+protected:
+  vtkPVArrayCalculatorParser() = default;
+  ~vtkPVArrayCalculatorParser() override = default;
+
+private:
+  vtkPVArrayCalculatorParser(const vtkPVArrayCalculatorParser&) = delete;
+  void operator=(const vtkPVArrayCalculatorParser&) = delete;
+};
+
+// Number of tuples processed by each instruction at once.
+const int vtkCalculatorBlockSize = 256;
+
+struct vtkCalculatorInstruction
+{
+  unsigned int OpCode;
+  int Top;      // index of the top of the stack before the instruction
+  int Variable; // for variables, index among the scalar or vector variables
+  bool VectorVariable;
+  double Value; // for immediates
+};
+
+struct vtkCalculatorProgram
+{
+  std::vector<vtkCalculatorInstruction> Instructions;
+  int StackSize = 0;
+  bool VectorResult = false;
+  // Variables used by the program.
+  std::vector<bool> ScalarVariableNeeded;
+  std::vector<bool> VectorVariableNeeded;
+
+  // Translates the byte code of the parsed function. Returns false if the byte
+  // code contains unsupported instructions.
+  bool Compile(vtkPVArrayCalculatorParser* parser)
+  {
+    if (!parser->IsScalarResult() && !parser->IsVectorResult())
+    {
+      // Parse error.
+      return false;
+    }
+    const int numScalars = parser->GetNumberOfScalarVariables();
+    const int numVectors = parser->GetNumberOfVectorVariables();
+    this->ScalarVariableNeeded.assign(numScalars, false);
+    this->VectorVariableNeeded.assign(numVectors, false);
+    this->VectorResult = parser->IsVectorResult() != 0;
+
+    int top = -1;
+    int numImmediates = 0;
+    for (int cc = 0; cc < parser->GetByteCodeSize(); ++cc)
+    {
+      vtkCalculatorInstruction instruction = { parser->GetByteCode(cc), top, -1, false, 0.0 };
+      int numOperands = 0;
+      int delta = 0;
+      switch (instruction.OpCode)
+      {
+        case VTK_PARSER_IMMEDIATE:
+          instruction.Value = parser->GetImmediate(numImmediates++);
+          delta = 1;
+          break;
+        case VTK_PARSER_UNARY_MINUS:
+        case VTK_PARSER_UNARY_PLUS:
+        case VTK_PARSER_ABSOLUTE_VALUE:
+        case VTK_PARSER_EXPONENT:
+        case VTK_PARSER_CEILING:
+        case VTK_PARSER_FLOOR:
+        case VTK_PARSER_LOGARITHME:
+        case VTK_PARSER_LOGARITHM10:
+        case VTK_PARSER_SQUARE_ROOT:
+        case VTK_PARSER_SINE:
+        case VTK_PARSER_COSINE:
+        case VTK_PARSER_TANGENT:
+        case VTK_PARSER_ARCSINE:
+        case VTK_PARSER_ARCCOSINE:
+        case VTK_PARSER_ARCTANGENT:
+        case VTK_PARSER_HYPERBOLIC_SINE:
+        case VTK_PARSER_HYPERBOLIC_COSINE:
+        case VTK_PARSER_HYPERBOLIC_TANGENT:
+        case VTK_PARSER_SIGN:
+          numOperands = 1;
+          break;
+        case VTK_PARSER_ADD:
+        case VTK_PARSER_SUBTRACT:
+        case VTK_PARSER_MULTIPLY:
+        case VTK_PARSER_DIVIDE:
+        case VTK_PARSER_POWER:
+        case VTK_PARSER_MIN:
+        case VTK_PARSER_MAX:
+        case VTK_PARSER_LESS_THAN:
+        case VTK_PARSER_GREATER_THAN:
+        case VTK_PARSER_EQUAL_TO:
+        case VTK_PARSER_AND:
+        case VTK_PARSER_OR:
+          numOperands = 2;
+          delta = -1;
+          break;
+        case VTK_PARSER_VECTOR_UNARY_MINUS:
+        case VTK_PARSER_VECTOR_UNARY_PLUS:
+        case VTK_PARSER_NORMALIZE:
+          numOperands = 3;
+          break;
+        case VTK_PARSER_MAGNITUDE:
+          numOperands = 3;
+          delta = -2;
+          break;
+        case VTK_PARSER_SCALAR_TIMES_VECTOR:
+        case VTK_PARSER_VECTOR_TIMES_SCALAR:
+        case VTK_PARSER_VECTOR_OVER_SCALAR:
+          numOperands = 4;
+          delta = -1;
+          break;
+        case VTK_PARSER_CROSS:
+        case VTK_PARSER_VECTOR_ADD:
+        case VTK_PARSER_VECTOR_SUBTRACT:
+          numOperands = 6;
+          delta = -3;
+          break;
+        case VTK_PARSER_DOT_PRODUCT:
+          numOperands = 6;
+          delta = -5;
+          break;
+        case VTK_PARSER_IHAT:
+        case VTK_PARSER_JHAT:
+        case VTK_PARSER_KHAT:
+          delta = 3;
+          break;
+        case VTK_PARSER_IF:
+          numOperands = 3;
+          delta = -2;
+          break;
+        case VTK_PARSER_VECTOR_IF:
+          numOperands = 7;
+          delta = -4;
+          break;
+        default:
+        {
+          if (instruction.OpCode < VTK_PARSER_BEGIN_VARIABLES)
+          {
+            return false;
+          }
+          const int variable = static_cast<int>(instruction.OpCode - VTK_PARSER_BEGIN_VARIABLES);
+          if (variable < numScalars)
+          {
+            this->ScalarVariableNeeded[variable] = true;
+            instruction.Variable = variable;
+            delta = 1;
+          }
+          else if (variable < numScalars + numVectors)
+          {
+            this->VectorVariableNeeded[variable - numScalars] = true;
+            instruction.Variable = variable - numScalars;
+            instruction.VectorVariable = true;
+            delta = 3;
+          }
+          else
+          {
+            return false;
+          }
+        }
+      }
+      if (top + 1 < numOperands)
+      {
+        return false;
+      }
+      top += delta;
+      this->StackSize = std::max(this->StackSize, top + 1);
+      this->Instructions.push_back(instruction);
+    }
+
+    return top == (this->VectorResult ? 2 : 0);
+  }
+};
+
+// Reads one component of a range of tuples as doubles.
+class vtkCalculatorSource
+{
+public:
+  virtual ~vtkCalculatorSource() = default;
+  virtual void Load(vtkIdType begin, int size, int component, double* values) const = 0;
+};
+
+template <typename ArrayT>
+class vtkCalculatorArraySource : public vtkCalculatorSource
+{
+public:
+  vtkCalculatorArraySource(ArrayT* array)
+    : Array(array)
+  {
+  }
+
+  void Load(vtkIdType begin, int size, int component, double* values) const override
+  {
+    vtkDataArrayAccessor<ArrayT> accessor(this->Array);
+    for (int i = 0; i < size; ++i)
+    {
+      values[i] = static_cast<double>(accessor.Get(begin + i, component));
+    }
+  }
+
+private:
+  ArrayT* Array;
+};
+
+// Coordinates of data sets with implicit points.
+class vtkCalculatorPointSource : public vtkCalculatorSource
+{
+public:
+  vtkCalculatorPointSource(vtkDataSet* dataSet)
+    : DataSet(dataSet)
+  {
+    // GetPoint(vtkIdType, double*) is thread safe once called from one thread.
+    double point[3];
+    this->DataSet->GetPoint(0, point);
+  }
+
+  void Load(vtkIdType begin, int size, int component, double* values) const override
+  {
+    double point[3];
+    for (int i = 0; i < size; ++i)
+    {
+      this->DataSet->GetPoint(begin + i, point);
+      values[i] = point[component];
+    }
+  }
+
+private:
+  vtkDataSet* DataSet;
+};
+
+struct vtkCalculatorSourceFactory
+{
+  std::unique_ptr<vtkCalculatorSource> Source;
+
+  template <typename ArrayT>
+  void operator()(ArrayT* array)
+  {
+    this->Source.reset(new vtkCalculatorArraySource<ArrayT>(array));
+  }
+};
+
+std::unique_ptr<vtkCalculatorSource> vtkNewCalculatorSource(vtkDataArray* array)
+{
+  vtkCalculatorSourceFactory factory;
+  if (!vtkArrayDispatch::Dispatch::Execute(array, factory))
+  {
+    factory(array);
+  }
+  return std::move(factory.Source);
+}
+
+// Writes one component of a range of tuples.
+class vtkCalculatorSink
+{
+public:
+  virtual ~vtkCalculatorSink() = default;
+  virtual void Store(vtkIdType begin, int size, int component, const double* values) const = 0;
+};
+
+template <typename ArrayT>
+class vtkCalculatorArraySink : public vtkCalculatorSink
+{
+public:
+  vtkCalculatorArraySink(ArrayT* array)
+    : Array(array)
+  {
+  }
+
+  void Store(vtkIdType begin, int size, int component, const double* values) const override
+  {
+    vtkDataArrayAccessor<ArrayT> accessor(this->Array);
+    using ValueT = typename vtkDataArrayAccessor<ArrayT>::APIType;
+    for (int i = 0; i < size; ++i)
+    {
+      accessor.Set(begin + i, component, static_cast<ValueT>(values[i]));
+    }
+  }
+
+private:
+  ArrayT* Array;
+};
+
+struct vtkCalculatorSinkFactory
+{
+  std::unique_ptr<vtkCalculatorSink> Sink;
+
+  template <typename ArrayT>
+  void operator()(ArrayT* array)
+  {
+    this->Sink.reset(new vtkCalculatorArraySink<ArrayT>(array));
+  }
+};
+
+std::unique_ptr<vtkCalculatorSink> vtkNewCalculatorSink(vtkDataArray* array)
+{
+  vtkCalculatorSinkFactory factory;
+  if (!vtkArrayDispatch::Dispatch::Execute(array, factory))
+  {
+    factory(array);
+  }
+  return std::move(factory.Sink);
+}
+
+// Source and components of a variable.
+struct vtkCalculatorBinding
+{
+  const vtkCalculatorSource* Source = nullptr;
+  int Components[3] = { 0, 0, 0 };
+};
+
+// Runs a program over ranges of tuples.
+class vtkCalculatorKernel
+{
+public:
+  vtkCalculatorKernel(const vtkCalculatorProgram& program,
+    const std::vector<vtkCalculatorBinding>& scalarVariables,
+    const std::vector<vtkCalculatorBinding>& vectorVariables, const vtkCalculatorSink& result,
+    bool replaceInvalidValues, double replacementValue)
+    : Program(program)
+    , ScalarVariables(scalarVariables)
+    , VectorVariables(vectorVariables)
+    , Result(result)
+    , ReplaceInvalidValues(replaceInvalidValues)
+    , ReplacementValue(replacementValue)
+    , Unsupported(false)
+  {
+  }
+
+  // Whether values were met that only vtkFunctionParser evaluates faithfully,
+  // e.g. invalid values that are not replaced. The results are incomplete.
+  bool GetUnsupported() const { return this->Unsupported; }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::vector<double>& stack = this->Stack.Local();
+    stack.resize(static_cast<size_t>(this->Program.StackSize) * vtkCalculatorBlockSize);
+    const int numComponents = this->Program.VectorResult ? 3 : 1;
+    for (vtkIdType block = begin; block < end; block += vtkCalculatorBlockSize)
+    {
+      if (this->Unsupported)
+      {
+        return;
+      }
+      const int size = static_cast<int>(std::min<vtkIdType>(vtkCalculatorBlockSize, end - block));
+      for (const auto& instruction : this->Program.Instructions)
+      {
+        if (!this->Execute(instruction, stack.data(), block, size))
+        {
+          this->Unsupported = true;
+          return;
+        }
+      }
+      for (int c = 0; c < numComponents; ++c)
+      {
+        this->Result.Store(block, size, c, stack.data() + c * vtkCalculatorBlockSize);
+      }
+    }
+  }
+
+private:
+  // Returns false if invalid values must be evaluated by vtkFunctionParser.
+  bool Execute(
+    const vtkCalculatorInstruction& instruction, double* stack, vtkIdType begin, int size) const
+  {
+    // Values of the tuples at the given stack position.
+    auto at = [&](int position) { return stack + position * vtkCalculatorBlockSize; };
+    const int top = instruction.Top;
+    const double replacement = this->ReplacementValue;
+    switch (instruction.OpCode)
+    {
+      case VTK_PARSER_IMMEDIATE:
+        std::fill_n(at(top + 1), size, instruction.Value);
+        return true;
+      case VTK_PARSER_UNARY_MINUS:
+        return ApplyUnary(at(top), size, [](double x) { return -x; });
+      case VTK_PARSER_UNARY_PLUS:
+      case VTK_PARSER_VECTOR_UNARY_PLUS:
+        return true;
+      case VTK_PARSER_ADD:
+        return ApplyBinary(at(top - 1), at(top), size, [](double x, double y) { return x + y; });
+      case VTK_PARSER_SUBTRACT:
+        return ApplyBinary(at(top - 1), at(top), size, [](double x, double y) { return x - y; });
+      case VTK_PARSER_MULTIPLY:
+        return ApplyBinary(at(top - 1), at(top), size, [](double x, double y) { return x * y; });
+      case VTK_PARSER_DIVIDE:
+      {
+        double* x = at(top - 1);
+        const double* y = at(top);
+        if (!this->CheckDomain(y, size, [](double v) { return v == 0.0; }))
+        {
+          return false;
+        }
+        for (int i = 0; i < size; ++i)
+        {
+          x[i] = y[i] == 0.0 ? replacement : x[i] / y[i];
+        }
+        return true;
+      }
+      case VTK_PARSER_POWER:
+      {
+        double* x = at(top - 1);
+        const double* y = at(top);
+        for (int i = 0; i < size; ++i)
+        {
+          if (x[i] < 0.0 && y[i] != std::floor(y[i]))
+          {
+            return false;
+          }
+        }
+        return ApplyBinary(x, y, size, [](double a, double b) { return std::pow(a, b); });
+      }
+      case VTK_PARSER_ABSOLUTE_VALUE:
+        return ApplyUnary(at(top), size, [](double x) { return std::fabs(x); });
+      case VTK_PARSER_EXPONENT:
+        return ApplyUnary(at(top), size, [](double x) { return std::exp(x); });
+      case VTK_PARSER_CEILING:
+        return ApplyUnary(at(top), size, [](double x) { return std::ceil(x); });
+      case VTK_PARSER_FLOOR:
+        return ApplyUnary(at(top), size, [](double x) { return std::floor(x); });
+      case VTK_PARSER_LOGARITHME:
+      case VTK_PARSER_LOGARITHM10:
+      {
+        double* x = at(top);
+        for (int i = 0; i < size; ++i)
+        {
+          if (x[i] == 0.0)
+          {
+            return false;
+          }
+        }
+        if (!this->CheckDomain(x, size, [](double v) { return v < 0.0; }))
+        {
+          return false;
+        }
+        if (instruction.OpCode == VTK_PARSER_LOGARITHM10)
+        {
+          return ApplyUnary(
+            x, size, [replacement](double v) { return v < 0.0 ? replacement : std::log10(v); });
+        }
+        return ApplyUnary(
+          x, size, [replacement](double v) { return v < 0.0 ? replacement : std::log(v); });
+      }
+      case VTK_PARSER_SQUARE_ROOT:
+        if (!this->CheckDomain(at(top), size, [](double v) { return v < 0.0; }))
+        {
+          return false;
+        }
+        return ApplyUnary(
+          at(top), size, [replacement](double v) { return v < 0.0 ? replacement : std::sqrt(v); });
+      case VTK_PARSER_SINE:
+        return ApplyUnary(at(top), size, [](double x) { return std::sin(x); });
+      case VTK_PARSER_COSINE:
+        return ApplyUnary(at(top), size, [](double x) { return std::cos(x); });
+      case VTK_PARSER_TANGENT:
+        return ApplyUnary(at(top), size, [](double x) { return std::tan(x); });
+      case VTK_PARSER_ARCSINE:
+        if (!this->CheckDomain(at(top), size, [](double v) { return v < -1.0 || v > 1.0; }))
+        {
+          return false;
+        }
+        return ApplyUnary(at(top), size, [replacement](double v) {
+          return (v < -1.0 || v > 1.0) ? replacement : std::asin(v);
+        });
+      case VTK_PARSER_ARCCOSINE:
+        if (!this->CheckDomain(at(top), size, [](double v) { return v < -1.0 || v > 1.0; }))
+        {
+          return false;
+        }
+        return ApplyUnary(at(top), size, [replacement](double v) {
+          return (v < -1.0 || v > 1.0) ? replacement : std::acos(v);
+        });
+      case VTK_PARSER_ARCTANGENT:
+        return ApplyUnary(at(top), size, [](double x) { return std::atan(x); });
+      case VTK_PARSER_HYPERBOLIC_SINE:
+        return ApplyUnary(at(top), size, [](double x) { return std::sinh(x); });
+      case VTK_PARSER_HYPERBOLIC_COSINE:
+        return ApplyUnary(at(top), size, [](double x) { return std::cosh(x); });
+      case VTK_PARSER_HYPERBOLIC_TANGENT:
+        return ApplyUnary(at(top), size, [](double x) { return std::tanh(x); });
+      case VTK_PARSER_MIN:
+        return ApplyBinary(
+          at(top - 1), at(top), size, [](double x, double y) { return y < x ? y : x; });
+      case VTK_PARSER_MAX:
+        return ApplyBinary(
+          at(top - 1), at(top), size, [](double x, double y) { return y > x ? y : x; });
+      case VTK_PARSER_SIGN:
+        return ApplyUnary(
+          at(top), size, [](double x) { return x < 0.0 ? -1.0 : (x == 0.0 ? 0.0 : 1.0); });
+      case VTK_PARSER_LESS_THAN:
+        return ApplyBinary(
+          at(top - 1), at(top), size, [](double x, double y) { return x < y ? 1.0 : 0.0; });
+      case VTK_PARSER_GREATER_THAN:
+        return ApplyBinary(
+          at(top - 1), at(top), size, [](double x, double y) { return x > y ? 1.0 : 0.0; });
+      case VTK_PARSER_EQUAL_TO:
+        return ApplyBinary(
+          at(top - 1), at(top), size, [](double x, double y) { return x == y ? 1.0 : 0.0; });
+      case VTK_PARSER_AND:
+        return ApplyBinary(at(top - 1), at(top), size,
+          [](double x, double y) { return (x != 0.0 && y != 0.0) ? 1.0 : 0.0; });
+      case VTK_PARSER_OR:
+        return ApplyBinary(at(top - 1), at(top), size,
+          [](double x, double y) { return (x != 0.0 || y != 0.0) ? 1.0 : 0.0; });
+      case VTK_PARSER_VECTOR_UNARY_MINUS:
+        for (int c = 0; c < 3; ++c)
+        {
+          ApplyUnary(at(top - 2 + c), size, [](double x) { return -x; });
+        }
+        return true;
+      case VTK_PARSER_VECTOR_ADD:
+        for (int c = 0; c < 3; ++c)
+        {
+          ApplyBinary(
+            at(top - 5 + c), at(top - 2 + c), size, [](double x, double y) { return x + y; });
+        }
+        return true;
+      case VTK_PARSER_VECTOR_SUBTRACT:
+        for (int c = 0; c < 3; ++c)
+        {
+          ApplyBinary(
+            at(top - 5 + c), at(top - 2 + c), size, [](double x, double y) { return x - y; });
+        }
+        return true;
+      case VTK_PARSER_DOT_PRODUCT:
+      {
+        double* x = at(top - 5);
+        const double *x1 = at(top - 4), *x2 = at(top - 3);
+        const double *y0 = at(top - 2), *y1 = at(top - 1), *y2 = at(top);
+        for (int i = 0; i < size; ++i)
+        {
+          x[i] = x[i] * y0[i] + x1[i] * y1[i] + x2[i] * y2[i];
+        }
+        return true;
+      }
+      case VTK_PARSER_CROSS:
+      {
+        double *x0 = at(top - 5), *x1 = at(top - 4), *x2 = at(top - 3);
+        const double *y0 = at(top - 2), *y1 = at(top - 1), *y2 = at(top);
+        for (int i = 0; i < size; ++i)
+        {
+          const double a[3] = { x0[i], x1[i], x2[i] };
+          const double b[3] = { y0[i], y1[i], y2[i] };
+          double c[3];
+          vtkMath::Cross(a, b, c);
+          x0[i] = c[0];
+          x1[i] = c[1];
+          x2[i] = c[2];
+        }
+        return true;
+      }
+      case VTK_PARSER_SCALAR_TIMES_VECTOR:
+      {
+        // The result is moved down to the position of the scalar.
+        double *x0 = at(top - 3), *x1 = at(top - 2), *x2 = at(top - 1);
+        const double* x3 = at(top);
+        for (int i = 0; i < size; ++i)
+        {
+          const double scalar = x0[i];
+          x0[i] = x1[i] * scalar;
+          x1[i] = x2[i] * scalar;
+          x2[i] = x3[i] * scalar;
+        }
+        return true;
+      }
+      case VTK_PARSER_VECTOR_TIMES_SCALAR:
+        for (int c = 0; c < 3; ++c)
+        {
+          ApplyBinary(
+            at(top - 3 + c), at(top), size, [](double x, double y) { return x * y; });
+        }
+        return true;
+      case VTK_PARSER_VECTOR_OVER_SCALAR:
+      {
+        const double* s = at(top);
+        if (!this->CheckDomain(s, size, [](double v) { return v == 0.0; }))
+        {
+          return false;
+        }
+        for (int c = 0; c < 3; ++c)
+        {
+          ApplyBinary(at(top - 3 + c), s, size,
+            [replacement](double x, double y) { return y == 0.0 ? replacement : x / y; });
+        }
+        return true;
+      }
+      case VTK_PARSER_MAGNITUDE:
+      {
+        double* x0 = at(top - 2);
+        const double *x1 = at(top - 1), *x2 = at(top);
+        for (int i = 0; i < size; ++i)
+        {
+          const double v[3] = { x0[i], x1[i], x2[i] };
+          x0[i] = vtkMath::Norm(v);
+        }
+        return true;
+      }
+      case VTK_PARSER_NORMALIZE:
+      {
+        double *x0 = at(top - 2), *x1 = at(top - 1), *x2 = at(top);
+        for (int i = 0; i < size; ++i)
+        {
+          const double v[3] = { x0[i], x1[i], x2[i] };
+          const double norm = vtkMath::Norm(v);
+          if (norm != 0.0)
+          {
+            x0[i] /= norm;
+            x1[i] /= norm;
+            x2[i] /= norm;
+          }
+          else if (this->ReplaceInvalidValues)
+          {
+            x0[i] = x1[i] = x2[i] = replacement;
+          }
+          else
+          {
+            return false;
+          }
+        }
+        return true;
+      }
+      case VTK_PARSER_IHAT:
+      case VTK_PARSER_JHAT:
+      case VTK_PARSER_KHAT:
+        for (int c = 0; c < 3; ++c)
+        {
+          const bool one = static_cast<int>(instruction.OpCode - VTK_PARSER_IHAT) == c;
+          std::fill_n(at(top + 1 + c), size, one ? 1.0 : 0.0);
+        }
+        return true;
+      case VTK_PARSER_IF:
+      {
+        double* condition = at(top - 2);
+        const double *x = at(top - 1), *y = at(top);
+        for (int i = 0; i < size; ++i)
+        {
+          condition[i] = condition[i] != 0.0 ? x[i] : y[i];
+        }
+        return true;
+      }
+      case VTK_PARSER_VECTOR_IF:
+      {
+        // The result is moved down to the position of the condition.
+        double *x0 = at(top - 6), *x1 = at(top - 5), *x2 = at(top - 4);
+        const double *t0 = at(top - 5), *t1 = at(top - 4), *t2 = at(top - 3);
+        const double *f0 = at(top - 2), *f1 = at(top - 1), *f2 = at(top);
+        for (int i = 0; i < size; ++i)
+        {
+          const bool condition = x0[i] != 0.0;
+          const double v[3] = { condition ? t0[i] : f0[i], condition ? t1[i] : f1[i],
+            condition ? t2[i] : f2[i] };
+          x0[i] = v[0];
+          x1[i] = v[1];
+          x2[i] = v[2];
+        }
+        return true;
+      }
+      default:
+        break;
+    }
+
+    if (instruction.OpCode >= VTK_PARSER_BEGIN_VARIABLES)
+    {
+      if (!instruction.VectorVariable)
+      {
+        const vtkCalculatorBinding& binding = this->ScalarVariables[instruction.Variable];
+        binding.Source->Load(begin, size, binding.Components[0], at(top + 1));
+      }
+      else
+      {
+        const vtkCalculatorBinding& binding = this->VectorVariables[instruction.Variable];
+        for (int c = 0; c < 3; ++c)
+        {
+          binding.Source->Load(begin, size, binding.Components[c], at(top + 1 + c));
+        }
+      }
+      return true;
+    }
+    return false;
+  }
+
+  template <typename FunctorT>
+  static bool ApplyUnary(double* x, int size, FunctorT f)
+  {
+    for (int i = 0; i < size; ++i)
+    {
+      x[i] = f(x[i]);
+    }
+    return true;
+  }
+
+  template <typename FunctorT>
+  static bool ApplyBinary(double* x, const double* y, int size, FunctorT f)
+  {
+    for (int i = 0; i < size; ++i)
+    {
+      x[i] = f(x[i], y[i]);
+    }
+    return true;
+  }
+
+  // Returns false if some of the values are invalid and are not replaced.
+  template <typename PredicateT>
+  bool CheckDomain(const double* x, int size, PredicateT invalid) const
+  {
+    if (this->ReplaceInvalidValues)
+    {
+      return true;
+    }
+    for (int i = 0; i < size; ++i)
+    {
+      if (invalid(x[i]))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const vtkCalculatorProgram& Program;
+  const std::vector<vtkCalculatorBinding>& ScalarVariables;
+  const std::vector<vtkCalculatorBinding>& VectorVariables;
+  const vtkCalculatorSink& Result;
+  const bool ReplaceInvalidValues;
+  const double ReplacementValue;
+  std::atomic<bool> Unsupported;
+  vtkSMPThreadLocal<std::vector<double> > Stack;
+};
+
+// Where the values of a variable come from.
+struct vtkCalculatorVariable
+{
+  bool Coordinates;
+  std::string ArrayName;
+  int Components[3];
+
+  bool operator==(const vtkCalculatorVariable& other) const
+  {
+    return this->Coordinates == other.Coordinates && this->ArrayName == other.ArrayName &&
+      std::equal(this->Components, this->Components + 3, other.Components);
+  }
+};
+
+// vtkFunctionParser ignores spaces in variable names.
+std::string vtkRemoveSpaces(const std::string& name)
+{
+  std::string result(name);
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  return result;
+}
+
+vtkIdType vtkGetNumberOfTuples(vtkDataObject* dataObject, int attributeType)
+{
+  if (vtkDataSet* dataSet = vtkDataSet::SafeDownCast(dataObject))
+  {
+    if (attributeType == vtkDataObject::POINT)
+    {
+      return dataSet->GetNumberOfPoints();
+    }
+    if (attributeType == vtkDataObject::CELL)
+    {
+      return dataSet->GetNumberOfCells();
+    }
+  }
+  else if (vtkGraph* graph = vtkGraph::SafeDownCast(dataObject))
+  {
+    if (attributeType == vtkDataObject::VERTEX)
+    {
+      return graph->GetNumberOfVertices();
+    }
+    if (attributeType == vtkDataObject::EDGE)
+    {
+      return graph->GetNumberOfEdges();
+    }
+  }
+  else if (vtkTable* table = vtkTable::SafeDownCast(dataObject))
+  {
+    if (attributeType == vtkDataObject::ROW)
+    {
+      return table->GetNumberOfRows();
+    }
+  }
+  return -1;
+}
+
+// Evaluates the program on the given attributes. Returns nullptr if the
+// results may differ from vtkFunctionParser's.
+vtkSmartPointer<vtkDataArray> vtkEvaluateProgram(const vtkCalculatorProgram& program,
+  const std::vector<vtkCalculatorVariable>& scalarVariables,
+  const std::vector<vtkCalculatorVariable>& vectorVariables, vtkDataObject* input,
+  int attributeType, int resultArrayType, bool replaceInvalidValues, double replacementValue)
+{
+  const vtkIdType numTuples = vtkGetNumberOfTuples(input, attributeType);
+  vtkDataSetAttributes* attributes = input->GetAttributes(attributeType);
+  if (numTuples < 1 || !attributes)
+  {
+    return nullptr;
+  }
+
+  std::map<std::string, std::unique_ptr<vtkCalculatorSource> > arraySources;
+  std::unique_ptr<vtkCalculatorSource> coordinatesSource;
+  auto bind = [&](const vtkCalculatorVariable& variable, vtkCalculatorBinding& binding) {
+    std::copy(variable.Components, variable.Components + 3, binding.Components);
+    const int maxComponent = *std::max_element(variable.Components, variable.Components + 3);
+    if (variable.Coordinates)
+    {
+      // Coordinates are only defined for the points of data sets.
+      vtkDataSet* dataSet = vtkDataSet::SafeDownCast(input);
+      if (attributeType != vtkDataObject::POINT || !dataSet || maxComponent > 2)
+      {
+        return false;
+      }
+      if (!coordinatesSource)
+      {
+        vtkPointSet* pointSet = vtkPointSet::SafeDownCast(dataSet);
+        if (!pointSet)
+        {
+          coordinatesSource.reset(new vtkCalculatorPointSource(dataSet));
+        }
+        else if (pointSet->GetPoints())
+        {
+          coordinatesSource = vtkNewCalculatorSource(pointSet->GetPoints()->GetData());
+        }
+        else
+        {
+          return false;
+        }
+      }
+      binding.Source = coordinatesSource.get();
+      return true;
+    }
+
+    vtkDataArray* array = attributes->GetArray(variable.ArrayName.c_str());
+    if (!array || array->GetNumberOfTuples() < numTuples ||
+      maxComponent >= array->GetNumberOfComponents())
+    {
+      return false;
+    }
+    auto& source = arraySources[variable.ArrayName];
+    if (!source)
+    {
+      source = vtkNewCalculatorSource(array);
+    }
+    binding.Source = source.get();
+    return true;
+  };
+
+  std::vector<vtkCalculatorBinding> scalarBindings(scalarVariables.size());
+  for (size_t cc = 0; cc < scalarVariables.size(); ++cc)
+  {
+    if (program.ScalarVariableNeeded[cc] && !bind(scalarVariables[cc], scalarBindings[cc]))
+    {
+      return nullptr;
+    }
+  }
+  std::vector<vtkCalculatorBinding> vectorBindings(vectorVariables.size());
+  for (size_t cc = 0; cc < vectorVariables.size(); ++cc)
+  {
+    if (program.VectorVariableNeeded[cc] && !bind(vectorVariables[cc], vectorBindings[cc]))
+    {
+      return nullptr;
+    }
+  }
+
+  vtkSmartPointer<vtkAbstractArray> array;
+  array.TakeReference(vtkAbstractArray::CreateArray(resultArrayType));
+  vtkSmartPointer<vtkDataArray> result(vtkArrayDownCast<vtkDataArray>(array));
+  if (!result)
+  {
+    return nullptr;
+  }
+  result->SetNumberOfComponents(program.VectorResult ? 3 : 1);
+  result->SetNumberOfTuples(numTuples);
+  std::unique_ptr<vtkCalculatorSink> sink = vtkNewCalculatorSink(result);
+
+  vtkCalculatorKernel kernel(
+    program, scalarBindings, vectorBindings, *sink, replaceInvalidValues, replacementValue);
+  vtkSMPTools::For(0, numTuples, kernel);
+  return kernel.GetUnsupported() ? nullptr : result;
+}
 }
 
 vtkStandardNewMacro(vtkPVArrayCalculator);
@@ -78,6 +996,7 @@ vtkPVArrayCalculator::vtkPVArrayCalculator()
   // We'll tell the superclass about all arrays (partial and full) and have it
   // ignore missing arrays when evaluating the calculator.
   this->IgnoreMissingArrays = true;
+  this->UseCompiledFunction = true;
 }
 
 // ----------------------------------------------------------------------------
@@ -254,11 +1173,206 @@ int vtkPVArrayCalculator::RequestData(
   assert(this->GetMTime() == mtime && "post: mtime cannot be changed in RequestData()");
   (void)mtime;
 
+  if (this->UseCompiledFunction &&
+    this->ExecuteCompiledFunction(input, vtkDataObject::GetData(outputVector, 0)))
+  {
+    return 1;
+  }
   return this->Superclass::RequestData(request, inputVector, outputVector);
 }
 
+// ----------------------------------------------------------------------------
+bool vtkPVArrayCalculator::ExecuteCompiledFunction(vtkDataObject* input, vtkDataObject* output)
+{
+  if (!input || !output || !this->GetFunction() || this->GetCoordinateResults() ||
+    this->GetResultNormals() || this->GetResultTCoords())
+  {
+    return false;
+  }
+
+  // Parse the function with the variables known to the superclass' parser, in
+  // the same order so that the variables have the same indices. Errors are
+  // reported by the superclass when it evaluates the function.
+  vtkNew<vtkPVArrayCalculatorParser> parser;
+  vtkNew<vtkCallbackCommand> ignore;
+  parser->AddObserver(vtkCommand::ErrorEvent, ignore);
+  parser->AddObserver(vtkCommand::WarningEvent, ignore);
+  const int numScalars = this->FunctionParser->GetNumberOfScalarVariables();
+  for (int cc = 0; cc < numScalars; ++cc)
+  {
+    const std::string name = this->FunctionParser->GetScalarVariableName(cc);
+    parser->SetScalarVariableValue(name.c_str(), 0.0);
+  }
+  const int numVectors = this->FunctionParser->GetNumberOfVectorVariables();
+  for (int cc = 0; cc < numVectors; ++cc)
+  {
+    const std::string name = this->FunctionParser->GetVectorVariableName(cc);
+    parser->SetVectorVariableValue(name.c_str(), 0.0, 0.0, 0.0);
+  }
+  parser->SetFunction(this->GetFunction());
+
+  vtkCalculatorProgram program;
+  if (!program.Compile(parser))
+  {
+    return false;
+  }
+
+  // Find where the values of the variables come from. Variables bound to
+  // different arrays (or to both an array and the coordinates) are left to the
+  // superclass, whose choice depends on the order it sets them in.
+  auto resolve = [](const std::string& key, const std::string& name, bool coordinates,
+                   const char* arrayName, const int components[3], int& found,
+                   vtkCalculatorVariable& variable) {
+    if (vtkRemoveSpaces(name) != key)
+    {
+      return true;
+    }
+    vtkCalculatorVariable candidate = { coordinates, arrayName ? arrayName : "",
+      { components[0], components[1], components[2] } };
+    if (found++ > 0 && !(candidate == variable))
+    {
+      return false;
+    }
+    variable = candidate;
+    return true;
+  };
+
+  std::vector<vtkCalculatorVariable> scalarVariables(numScalars);
+  for (int cc = 0; cc < numScalars; ++cc)
+  {
+    if (!program.ScalarVariableNeeded[cc])
+    {
+      continue;
+    }
+    const std::string key = vtkRemoveSpaces(parser->GetScalarVariableName(cc));
+    int found = 0;
+    for (int i = 0; i < this->GetNumberOfScalarArrays(); ++i)
+    {
+      const int component = this->GetSelectedScalarComponent(i);
+      const int components[3] = { component, component, component };
+      if (!resolve(key, this->GetScalarVariableName(i), false, this->GetScalarArrayName(i),
+            components, found, scalarVariables[cc]))
+      {
+        return false;
+      }
+    }
+    for (int i = 0; i < this->GetNumberOfCoordinateScalarArrays(); ++i)
+    {
+      const int component = this->GetSelectedCoordinateScalarComponent(i);
+      const int components[3] = { component, component, component };
+      if (!resolve(key, this->GetCoordinateScalarVariableName(i), true, nullptr, components,
+            found, scalarVariables[cc]))
+      {
+        return false;
+      }
+    }
+    if (found == 0)
+    {
+      return false;
+    }
+  }
+
+  std::vector<vtkCalculatorVariable> vectorVariables(numVectors);
+  for (int cc = 0; cc < numVectors; ++cc)
+  {
+    if (!program.VectorVariableNeeded[cc])
+    {
+      continue;
+    }
+    const std::string key = vtkRemoveSpaces(parser->GetVectorVariableName(cc));
+    int found = 0;
+    for (int i = 0; i < this->GetNumberOfVectorArrays(); ++i)
+    {
+      auto selected = this->GetSelectedVectorComponents(i);
+      const int components[3] = { selected[0], selected[1], selected[2] };
+      if (!resolve(key, this->GetVectorVariableName(i), false, this->GetVectorArrayName(i),
+            components, found, vectorVariables[cc]))
+      {
+        return false;
+      }
+    }
+    for (int i = 0; i < this->GetNumberOfCoordinateVectorArrays(); ++i)
+    {
+      auto selected = this->GetSelectedCoordinateVectorComponents(i);
+      const int components[3] = { selected[0], selected[1], selected[2] };
+      if (!resolve(key, this->GetCoordinateVectorVariableName(i), true, nullptr, components,
+            found, vectorVariables[cc]))
+      {
+        return false;
+      }
+    }
+    if (found == 0)
+    {
+      return false;
+    }
+  }
+
+  // Evaluate all the blocks before touching the output, any of them may have
+  // to be left to the superclass.
+  auto evaluate = [&](vtkDataObject* dataObject) {
+    return vtkEvaluateProgram(program, scalarVariables, vectorVariables, dataObject,
+      this->GetAttributeTypeFromInput(dataObject), this->GetResultArrayType(),
+      this->GetReplaceInvalidValues() != 0, this->GetReplacementValue());
+  };
+  auto setResult = [&](vtkDataObject* inputObject, vtkDataObject* outputObject,
+                     vtkDataArray* result) {
+    outputObject->ShallowCopy(inputObject);
+    result->SetName(this->GetResultArrayName());
+    vtkDataSetAttributes* attributes =
+      outputObject->GetAttributes(this->GetAttributeTypeFromInput(inputObject));
+    // Like vtkArrayCalculator, keep the array that was active before as a
+    // regular array rather than replacing it.
+    const int idx = attributes->AddArray(result);
+    attributes->SetActiveAttribute(
+      idx, program.VectorResult ? vtkDataSetAttributes::VECTORS : vtkDataSetAttributes::SCALARS);
+  };
+
+  vtkCompositeDataSet* inputCD = vtkCompositeDataSet::SafeDownCast(input);
+  if (!inputCD)
+  {
+    vtkSmartPointer<vtkDataArray> result = evaluate(input);
+    if (!result)
+    {
+      return false;
+    }
+    setResult(input, output, result);
+    return true;
+  }
+
+  vtkCompositeDataSet* outputCD = vtkCompositeDataSet::SafeDownCast(output);
+  if (!outputCD)
+  {
+    return false;
+  }
+  std::vector<vtkSmartPointer<vtkDataArray> > results;
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(inputCD->NewIterator());
+  iter->SkipEmptyNodesOn();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    results.push_back(evaluate(iter->GetCurrentDataObject()));
+    if (!results.back())
+    {
+      return false;
+    }
+  }
+
+  outputCD->CopyStructure(inputCD);
+  auto result = results.begin();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem(), ++result)
+  {
+    vtkDataObject* inputBlock = iter->GetCurrentDataObject();
+    vtkSmartPointer<vtkDataObject> outputBlock;
+    outputBlock.TakeReference(inputBlock->NewInstance());
+    setResult(inputBlock, outputBlock, *result);
+    outputCD->SetDataSet(iter, outputBlock);
+  }
+  return true;
+}
+
 // ----------------------------------------------------------------------------
 void vtkPVArrayCalculator::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "UseCompiledFunction: " << this->UseCompiledFunction << endl;
 }
@@ -24,6 +24,13 @@
  *  their mapping with the input fields. We extend vtkArrayCalculator to
  *  automatically add scalar/vector fields mapping using the array available in
  *  the input.
+ *
+ *  By default, the function is evaluated by a compiled backend: the parsed
+ *  function is translated once into a sequence of operations that are applied
+ *  to blocks of tuples, in parallel using vtkSMPTools. It gives the same
+ *  results as vtkFunctionParser. Configurations it does not handle (e.g.
+ *  CoordinateResults, ResultNormals, ResultTCoords, missing arrays, or invalid
+ *  values without ReplaceInvalidValues) are evaluated by the superclass.
  * @sa
  *  vtkArrayCalculator vtkFunctionParser
 */
@@ -45,12 +52,31 @@ public:
 
   static vtkPVArrayCalculator* New();
 
+  //@{
+  /**
+   * When on, the function is evaluated by the compiled backend whenever it
+   * supports the function and the input, otherwise by vtkFunctionParser one
+   * tuple at a time. Default is on.
+   */
+  vtkSetMacro(UseCompiledFunction, bool);
+  vtkGetMacro(UseCompiledFunction, bool);
+  vtkBooleanMacro(UseCompiledFunction, bool);
+  //@}
+
 protected:
   vtkPVArrayCalculator();
   ~vtkPVArrayCalculator() override;
 
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
+  /**
+   * Evaluates the function on \c input using the compiled backend and fills
+   * \c output. Returns false, leaving \c output untouched, if the compiled
+   * backend cannot reproduce the superclass results for this function and
+   * input, in which case the superclass must be used.
+   */
+  bool ExecuteCompiledFunction(vtkDataObject* input, vtkDataObject* output);
+
   /**
    * Get the attribute type.
    */
@@ -76,6 +102,8 @@ protected:
    */
   void AddArrayAndVariableNames(vtkDataObject* theInputObj, vtkDataSetAttributes* inDataAttrs);
 
+  bool UseCompiledFunction;
+
 private:
   vtkPVArrayCalculator(const vtkPVArrayCalculator&) = delete;
   void operator=(const vtkPVArrayCalculator&) = delete;
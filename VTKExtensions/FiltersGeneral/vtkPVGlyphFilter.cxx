@@ -16,16 +16,21 @@
 
 // VTK includes
 #include "vtkBoundingBox.h"
+#include "vtkCellArray.h"
 #include "vtkCellCenters.h"
 #include "vtkCellData.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkDataSet.h"
 #include "vtkDataSetSurfaceFilter.h"
 #include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkIdFilter.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkMinimalStandardRandomSequence.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
@@ -34,6 +39,7 @@
 #include "vtkOctreePointLocator.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTetra.h"
@@ -47,11 +53,13 @@
 
 // C/C++ includes
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <map>
 #include <numeric>
 #include <random>
 #include <set>
+#include <thread>
 #include <vector>
 
 static const std::string IDS_ARRAY_NAME = "vtkPVGlyphFilter_Ids";
@@ -495,6 +503,227 @@ public:
   }
 };
 
+namespace
+{
+//-----------------------------------------------------------------------------
+// Computes the matrix placing a glyph at \c x, oriented along \c v and scaled by
+// \c scale. This composes the translation, rotation and scaling with the same
+// operations as vtkTransform (in PreMultiply mode), so the glyphs are
+// identical to the ones obtained with it.
+void ComputeGlyphMatrix(const double x[3], const double v[3], const double scale[3],
+  double matrix[16])
+{
+  double translation[16];
+  vtkMatrix4x4::Identity(translation);
+  translation[3] = x[0];
+  translation[7] = x[1];
+  translation[11] = x[2];
+
+  double axis[3] = { 0.0, 1.0, 0.0 };
+  bool rotate = false;
+  double vMag = vtkMath::Norm(v);
+  if (vMag > 0.0)
+  {
+    // if there is no y or z component
+    if (v[1] == 0.0 && v[2] == 0.0)
+    {
+      // just flip x if we need to
+      rotate = v[0] < 0;
+    }
+    else
+    {
+      axis[0] = (v[0] + vMag) / 2.0;
+      axis[1] = v[1] / 2.0;
+      axis[2] = v[2] / 2.0;
+      rotate = true;
+    }
+  }
+
+  if (rotate)
+  {
+    // rotation of 180 degrees around axis, as a normalized quaternion
+    double angle = vtkMath::RadiansFromDegrees(180.0);
+    double w = cos(0.5 * angle);
+    double f = sin(0.5 * angle) / sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    double qx = axis[0] * f;
+    double qy = axis[1] * f;
+    double qz = axis[2] * f;
+
+    double ww = w * w;
+    double wx = w * qx;
+    double wy = w * qy;
+    double wz = w * qz;
+    double xx = qx * qx;
+    double yy = qy * qy;
+    double zz = qz * qz;
+    double xy = qx * qy;
+    double xz = qx * qz;
+    double yz = qy * qz;
+    double s = ww - xx - yy - zz;
+
+    double rotation[16];
+    vtkMatrix4x4::Identity(rotation);
+    rotation[0] = xx * 2 + s;
+    rotation[4] = (xy + wz) * 2;
+    rotation[8] = (xz - wy) * 2;
+    rotation[1] = (xy - wz) * 2;
+    rotation[5] = yy * 2 + s;
+    rotation[9] = (yz + wx) * 2;
+    rotation[2] = (xz + wy) * 2;
+    rotation[6] = (yz - wx) * 2;
+    rotation[10] = zz * 2 + s;
+    vtkMatrix4x4::Multiply4x4(translation, rotation, matrix);
+  }
+  else
+  {
+    std::copy(translation, translation + 16, matrix);
+  }
+
+  for (int row = 0; row < 3; row++)
+  {
+    for (int col = 0; col < 3; col++)
+    {
+      matrix[4 * row + col] *= scale[col];
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+void TransformGlyphPoints(const double matrix[16], const std::vector<double>& source, T* out)
+{
+  const size_t numPts = source.size() / 3;
+  for (size_t i = 0; i < numPts; i++)
+  {
+    const double* p = &source[3 * i];
+    out[3 * i] = static_cast<T>(matrix[0] * p[0] + matrix[1] * p[1] + matrix[2] * p[2] + matrix[3]);
+    out[3 * i + 1] =
+      static_cast<T>(matrix[4] * p[0] + matrix[5] * p[1] + matrix[6] * p[2] + matrix[7]);
+    out[3 * i + 2] =
+      static_cast<T>(matrix[8] * p[0] + matrix[9] * p[1] + matrix[10] * p[2] + matrix[11]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Normals are transformed by the transposed inverse of the glyph matrix. As
+// in vtkLinearTransform, the products are computed in double and normalized
+// with the precision of the source normals: float normals are cast to float
+// before being normalized, other types are normalized in double.
+template <typename T>
+void TransformGlyphNormals(const double matrix[16], const std::vector<double>& source, float* out)
+{
+  double inverse[16];
+  double normalMatrix[16];
+  vtkMatrix4x4::Invert(matrix, inverse);
+  vtkMatrix4x4::Transpose(inverse, normalMatrix);
+
+  const size_t numNormals = source.size() / 3;
+  for (size_t i = 0; i < numNormals; i++)
+  {
+    const double* n = &source[3 * i];
+    T normal[3] = {
+      static_cast<T>(normalMatrix[0] * n[0] + normalMatrix[1] * n[1] + normalMatrix[2] * n[2]),
+      static_cast<T>(normalMatrix[4] * n[0] + normalMatrix[5] * n[1] + normalMatrix[6] * n[2]),
+      static_cast<T>(normalMatrix[8] * n[0] + normalMatrix[9] * n[1] + normalMatrix[10] * n[2])
+    };
+    vtkMath::Normalize(normal);
+    out[3 * i] = static_cast<float>(normal[0]);
+    out[3 * i + 1] = static_cast<float>(normal[1]);
+    out[3 * i + 2] = static_cast<float>(normal[2]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Returns numGlyphs copies of the source cells, the copy of glyph i
+// referencing the i-th block of numSourcePts points.
+vtkSmartPointer<vtkCellArray> ReplicateGlyphCells(
+  vtkCellArray* sourceCells, vtkIdType numGlyphs, vtkIdType numSourcePts)
+{
+  std::vector<vtkIdType> sourceOffsets(1, 0);
+  std::vector<vtkIdType> sourceConnectivity;
+  vtkIdType npts;
+  const vtkIdType* pts;
+  for (sourceCells->InitTraversal(); sourceCells->GetNextCell(npts, pts);)
+  {
+    sourceConnectivity.insert(sourceConnectivity.end(), pts, pts + npts);
+    sourceOffsets.push_back(static_cast<vtkIdType>(sourceConnectivity.size()));
+  }
+  const vtkIdType numCells = static_cast<vtkIdType>(sourceOffsets.size()) - 1;
+  const vtkIdType connectivitySize = static_cast<vtkIdType>(sourceConnectivity.size());
+
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numGlyphs * numCells + 1);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(numGlyphs * connectivitySize);
+  vtkIdType* offsetsPtr = offsets->GetPointer(0);
+  vtkIdType* connectivityPtr = connectivity->GetPointer(0);
+  vtkSMPTools::For(0, numGlyphs, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType glyphId = begin; glyphId < end; glyphId++)
+    {
+      vtkIdType* glyphOffsets = offsetsPtr + glyphId * numCells;
+      for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+      {
+        glyphOffsets[cellId] = glyphId * connectivitySize + sourceOffsets[cellId];
+      }
+      vtkIdType* glyphConnectivity = connectivityPtr + glyphId * connectivitySize;
+      for (vtkIdType i = 0; i < connectivitySize; i++)
+      {
+        glyphConnectivity[i] = sourceConnectivity[i] + glyphId * numSourcePts;
+      }
+    }
+  });
+  offsetsPtr[numGlyphs * numCells] = numGlyphs * connectivitySize;
+
+  auto cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetData(offsets, connectivity);
+  return cells;
+}
+
+//-----------------------------------------------------------------------------
+// Inserts numGlyphs copies of the source cells in the output, glyph after
+// glyph, in the order of the source cells.
+void InsertGlyphCells(vtkPolyData* source, vtkIdType numGlyphs, vtkPolyData* output)
+{
+  const vtkIdType numSourcePts = source->GetNumberOfPoints();
+  const vtkIdType numSourceCells = source->GetNumberOfCells();
+  output->AllocateExact(numGlyphs * source->GetNumberOfVerts(),
+    numGlyphs * source->GetVerts()->GetNumberOfConnectivityIds(),
+    numGlyphs * source->GetNumberOfLines(),
+    numGlyphs * source->GetLines()->GetNumberOfConnectivityIds(),
+    numGlyphs * source->GetNumberOfPolys(),
+    numGlyphs * source->GetPolys()->GetNumberOfConnectivityIds(),
+    numGlyphs * source->GetNumberOfStrips(),
+    numGlyphs * source->GetStrips()->GetNumberOfConnectivityIds());
+
+  std::vector<int> sourceTypes(numSourceCells);
+  std::vector<vtkIdType> sourceOffsets(1, 0);
+  std::vector<vtkIdType> sourceConnectivity;
+  vtkNew<vtkIdList> pts;
+  for (vtkIdType cellId = 0; cellId < numSourceCells; cellId++)
+  {
+    sourceTypes[cellId] = source->GetCellType(cellId);
+    source->GetCellPoints(cellId, pts);
+    sourceConnectivity.insert(sourceConnectivity.end(), pts->GetPointer(0),
+      pts->GetPointer(0) + pts->GetNumberOfIds());
+    sourceOffsets.push_back(static_cast<vtkIdType>(sourceConnectivity.size()));
+  }
+
+  std::vector<vtkIdType> glyphConnectivity(sourceConnectivity.size());
+  for (vtkIdType glyphId = 0; glyphId < numGlyphs; glyphId++)
+  {
+    for (size_t i = 0; i < sourceConnectivity.size(); i++)
+    {
+      glyphConnectivity[i] = sourceConnectivity[i] + glyphId * numSourcePts;
+    }
+    for (vtkIdType cellId = 0; cellId < numSourceCells; cellId++)
+    {
+      output->InsertNextCell(sourceTypes[cellId], sourceOffsets[cellId + 1] - sourceOffsets[cellId],
+        glyphConnectivity.data() + sourceOffsets[cellId]);
+    }
+  }
+}
+}
+
 vtkStandardNewMacro(vtkPVGlyphFilter);
 vtkCxxSetObjectMacro(vtkPVGlyphFilter, Controller, vtkMultiProcessController);
 vtkCxxSetObjectMacro(vtkPVGlyphFilter, SourceTransform, vtkTransform);
@@ -826,9 +1055,6 @@ bool vtkPVGlyphFilter::Execute(unsigned int index, vtkDataSet* input,
 
   vtkDebugMacro(<< "Generating glyphs");
 
-  auto pts = vtkSmartPointer<vtkIdList>::New();
-  pts->Allocate(VTK_CELL_SIZE);
-
   unsigned char* inGhostLevels = nullptr;
   vtkDataArray* temp = nullptr;
   auto pd = input->GetPointData();
@@ -871,7 +1097,6 @@ bool vtkPVGlyphFilter::Execute(unsigned int index, vtkDataSet* input,
 
   auto sourcePts = source->GetPoints();
   vtkIdType numSourcePts = sourcePts->GetNumberOfPoints();
-  vtkIdType numSourceCells = source->GetNumberOfCells();
 
   vtkDataArray* sourceNormals = source->GetPointData()->GetNormals();
 
@@ -881,14 +1106,74 @@ bool vtkPVGlyphFilter::Execute(unsigned int index, vtkDataSet* input,
 
   outputPD->CopyAllocate(pd, numPts * numSourcePts);
 
-  vtkNew<vtkIdList> srcPointIdList;
-  srcPointIdList->SetNumberOfIds(numSourcePts);
-  vtkNew<vtkIdList> dstPointIdList;
-  dstPointIdList->SetNumberOfIds(numSourcePts);
-  vtkNew<vtkIdList> srcCellIdList;
-  srcCellIdList->SetNumberOfIds(numSourceCells);
-  vtkNew<vtkIdList> dstCellIdList;
-  dstCellIdList->SetNumberOfIds(numSourceCells);
+  // First pass: find the points to glyph. Visibility is stateful with the
+  // sampling glyph modes, hence it is only evaluated in parallel for the
+  // deterministic ones.
+  vtkUniformGrid* inputUG = vtkUniformGrid::SafeDownCast(input);
+  std::vector<unsigned char> visible(numPts);
+  auto computeVisibility = [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType inPtId = begin; inPtId < end; inPtId++)
+    {
+      // Check ghost points.
+      // If we are processing a piece, we do not want to duplicate
+      // glyphs on the borders.
+      // Also respect blanking specified on uniform grids.
+      visible[inPtId] =
+        !(inGhostLevels && inGhostLevels[inPtId] & vtkDataSetAttributes::DUPLICATEPOINT) &&
+        !(inputUG && !inputUG->IsPointVisible(inPtId)) &&
+        this->IsPointVisible(index, input, inPtId, cellCenters);
+    }
+  };
+  if (this->GlyphMode == ALL_POINTS || this->GlyphMode == EVERY_NTH_POINT)
+  {
+    vtkSMPTools::For(0, numPts, computeVisibility);
+  }
+  else
+  {
+    computeVisibility(0, numPts);
+  }
+
+  std::vector<vtkIdType> glyphPointIds;
+  for (vtkIdType inPtId = 0; inPtId < numPts; inPtId++)
+  {
+    if (visible[inPtId])
+    {
+      glyphPointIds.push_back(inPtId);
+    }
+  }
+  const vtkIdType numGlyphs = static_cast<vtkIdType>(glyphPointIds.size());
+
+  this->UpdateProgress(0.5);
+  if (this->GetAbortExecute())
+  {
+    return true;
+  }
+
+  // Source points and normals are shared by all glyphs.
+  std::vector<double> sourceCoords(3 * numSourcePts);
+  vtkPoints* glyphSourcePts = sourcePts;
+  vtkNew<vtkPoints> transformedSourcePts;
+  if (this->SourceTransform)
+  {
+    transformedSourcePts->SetDataTypeToDouble();
+    transformedSourcePts->Allocate(numSourcePts);
+    this->SourceTransform->TransformPoints(sourcePts, transformedSourcePts);
+    glyphSourcePts = transformedSourcePts;
+  }
+  for (vtkIdType i = 0; i < numSourcePts; i++)
+  {
+    glyphSourcePts->GetPoint(i, &sourceCoords[3 * i]);
+  }
+  std::vector<double> sourceNormalCoords;
+  const bool floatNormals = sourceNormals && sourceNormals->GetDataType() == VTK_FLOAT;
+  if (sourceNormals)
+  {
+    sourceNormalCoords.resize(3 * numSourcePts);
+    for (vtkIdType i = 0; i < numSourcePts; i++)
+    {
+      sourceNormals->GetTuple(i, &sourceNormalCoords[3 * i]);
+    }
+  }
 
   auto newPts = vtkSmartPointer<vtkPoints>::New();
 
@@ -906,202 +1191,202 @@ bool vtkPVGlyphFilter::Execute(unsigned int index, vtkDataSet* input,
     newPts->SetDataType(VTK_DOUBLE);
   }
 
-  newPts->Allocate(numPts * numSourcePts);
+  newPts->SetNumberOfPoints(numGlyphs * numSourcePts);
+  float* newFloatPts = nullptr;
+  double* newDoublePts = nullptr;
+  if (newPts->GetDataType() == VTK_DOUBLE)
+  {
+    newDoublePts = vtkDoubleArray::SafeDownCast(newPts->GetData())->GetPointer(0);
+  }
+  else
+  {
+    newFloatPts = vtkFloatArray::SafeDownCast(newPts->GetData())->GetPointer(0);
+  }
 
   vtkSmartPointer<vtkFloatArray> newNormals;
   if (sourceNormals)
   {
     newNormals.TakeReference(vtkFloatArray::New());
     newNormals->SetNumberOfComponents(3);
-    newNormals->Allocate(3 * numPts * numSourcePts);
+    newNormals->SetNumberOfTuples(numGlyphs * numSourcePts);
     newNormals->SetName("Normals");
   }
+  float* newNormalsPtr = newNormals ? newNormals->GetPointer(0) : nullptr;
 
-  // Setting up for calls to PolyData::InsertNextCell()
-  output->Allocate(source, 3 * numPts * numSourceCells, numPts * numSourceCells);
-
-  vtkSmartPointer<vtkPoints> transformedSourcePts = vtkSmartPointer<vtkPoints>::New();
-  transformedSourcePts->SetDataTypeToDouble();
-  transformedSourcePts->Allocate(numSourcePts);
-
-  // Traverse all Input points, transforming Source points and copying
-  // point attributes.
-  auto trans = vtkSmartPointer<vtkTransform>::New();
-  vtkNew<vtkIdList> pointIdList;
-  vtkIdType ptIncr = 0;
-  vtkIdType cellIncr = 0;
-  for (vtkIdType inPtId = 0; inPtId < numPts; inPtId++)
+  vtkNew<vtkIdList> srcPointIdList;
+  vtkNew<vtkIdList> dstPointIdList;
+  if (pd)
   {
-    double scalex(1.0), scaley(1.0), scalez(1.0);
-    if (!(inPtId % 10000))
+    srcPointIdList->SetNumberOfIds(numGlyphs * numSourcePts);
+    dstPointIdList->SetNumberOfIds(numGlyphs * numSourcePts);
+  }
+  vtkIdType* srcPointIds = srcPointIdList->GetPointer(0);
+  vtkIdType* dstPointIds = dstPointIdList->GetPointer(0);
+
+  // Second pass: each glyph owns a known range of the output, so glyphs are
+  // transformed and written in parallel. Every chunk checks for abort every
+  // 10000 glyphs, progress is only reported from the calling thread.
+  double x0[3];
+  input->GetPoint(0, x0); // makes GetPoint() thread safe
+  const std::thread::id callingThread = std::this_thread::get_id();
+  std::atomic<vtkIdType> processedGlyphs(0);
+  std::atomic<bool> aborted(false);
+  vtkSMPTools::For(0, numGlyphs, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType glyphId = begin; glyphId < end; glyphId++)
     {
-      this->UpdateProgress(static_cast<double>(inPtId) / numPts);
-      if (this->GetAbortExecute())
+      if (!((glyphId - begin) % 10000))
       {
-        break;
+        if (glyphId > begin)
+        {
+          processedGlyphs += 10000;
+        }
+        if (std::this_thread::get_id() == callingThread)
+        {
+          this->UpdateProgress(0.5 + 0.5 * processedGlyphs / numGlyphs);
+        }
+        if (aborted || this->GetAbortExecute())
+        {
+          aborted = true;
+          return;
+        }
       }
-    }
 
-    // Get the scalar and vector data
-    if (scaleArray)
-    {
-      if (scaleArray->GetNumberOfComponents() == 1)
-      {
-        scalex = scaley = scalez = scaleArray->GetComponent(inPtId, 0);
-      }
-      else
+      const vtkIdType inPtId = glyphPointIds[glyphId];
+      const vtkIdType ptIncr = glyphId * numSourcePts;
+      double scale[3] = { 1.0, 1.0, 1.0 };
+
+      // Get the scalar and vector data
+      if (scaleArray)
       {
-        // Consider the vector scaling mode
-        if (scaleArray->GetNumberOfComponents() == 2)
+        if (scaleArray->GetNumberOfComponents() == 1)
         {
-          double* vec2 = scaleArray->GetTuple(inPtId);
-          if (this->VectorScaleMode == SCALE_BY_MAGNITUDE)
-          {
-            scalex = scaley = scalez = vtkMath::Norm2D(vec2);
-          }
-          else if (this->VectorScaleMode == SCALE_BY_COMPONENTS)
-          {
-            scalex = vec2[0];
-            scaley = vec2[1];
-            // leave scalez alone for 2D
-          }
+          scale[0] = scale[1] = scale[2] = scaleArray->GetComponent(inPtId, 0);
         }
-        else if (scaleArray->GetNumberOfComponents() == 3)
+        else
         {
-          double* vec3 = scaleArray->GetTuple(inPtId);
-          if (this->VectorScaleMode == SCALE_BY_MAGNITUDE)
+          // Consider the vector scaling mode
+          if (scaleArray->GetNumberOfComponents() == 2)
           {
-            scalex = scaley = scalez = vtkMath::Norm(vec3);
+            double vec2[2];
+            scaleArray->GetTuple(inPtId, vec2);
+            if (this->VectorScaleMode == SCALE_BY_MAGNITUDE)
+            {
+              scale[0] = scale[1] = scale[2] = vtkMath::Norm2D(vec2);
+            }
+            else if (this->VectorScaleMode == SCALE_BY_COMPONENTS)
+            {
+              scale[0] = vec2[0];
+              scale[1] = vec2[1];
+              // leave scalez alone for 2D
+            }
           }
-          else
+          else if (scaleArray->GetNumberOfComponents() == 3)
           {
-            scalex = vec3[0];
-            scaley = vec3[1];
-            scalez = vec3[2];
+            double vec3[3];
+            scaleArray->GetTuple(inPtId, vec3);
+            if (this->VectorScaleMode == SCALE_BY_MAGNITUDE)
+            {
+              scale[0] = scale[1] = scale[2] = vtkMath::Norm(vec3);
+            }
+            else
+            {
+              scale[0] = vec3[0];
+              scale[1] = vec3[1];
+              scale[2] = vec3[2];
+            }
           }
         }
       }
-    }
-
-    // Apply scale factor
-    scalex *= this->ScaleFactor;
-    scaley *= this->ScaleFactor;
-    scalez *= this->ScaleFactor;
 
-    // Check ghost points.
-    // If we are processing a piece, we do not want to duplicate
-    // glyphs on the borders.
-    if (inGhostLevels && inGhostLevels[inPtId] & vtkDataSetAttributes::DUPLICATEPOINT)
-    {
-      continue;
-    }
+      // Apply scale factor, scale data if appropriate
+      for (int comp = 0; comp < 3; comp++)
+      {
+        scale[comp] *= this->ScaleFactor;
+        if (scale[comp] == 0.0)
+        {
+          scale[comp] = 1.0e-10;
+        }
+      }
 
-    // this is used to respect blanking specified on uniform grids.
-    vtkUniformGrid* inputUG = vtkUniformGrid::SafeDownCast(input);
-    if (inputUG && !inputUG->IsPointVisible(inPtId))
-    {
-      // input is a vtkUniformGrid and the current point is blanked. Don't glyph
-      // it.
-      continue;
-    }
+      // translate Source to Input point
+      double x[3];
+      input->GetPoint(inPtId, x);
 
-    if (!this->IsPointVisible(index, input, inPtId, cellCenters))
-    {
-      continue;
-    }
+      double v[3] = { 0.0 };
+      if (orientArray)
+      {
+        orientArray->GetTuple(inPtId, v);
+      }
 
-    // Now begin copying/transforming glyph
-    trans->Identity();
+      double matrix[16];
+      ComputeGlyphMatrix(x, v, scale, matrix);
 
-    // Copy all topology (transformation independent)
-    for (vtkIdType cellId = 0; cellId < numSourceCells; cellId++)
-    {
-      source->GetCellPoints(cellId, pointIdList);
-      int npts = pointIdList->GetNumberOfIds();
-      pts->Reset();
-      for (vtkIdType i = 0; i < npts; i++)
+      // multiply points and normals by resulting matrix
+      if (newDoublePts)
       {
-        pts->InsertId(i, pointIdList->GetId(i) + ptIncr);
+        TransformGlyphPoints(matrix, sourceCoords, newDoublePts + 3 * ptIncr);
+      }
+      else
+      {
+        TransformGlyphPoints(matrix, sourceCoords, newFloatPts + 3 * ptIncr);
+      }
+      if (newNormalsPtr && floatNormals)
+      {
+        TransformGlyphNormals<float>(matrix, sourceNormalCoords, newNormalsPtr + 3 * ptIncr);
+      }
+      else if (newNormalsPtr)
+      {
+        TransformGlyphNormals<double>(matrix, sourceNormalCoords, newNormalsPtr + 3 * ptIncr);
       }
-      output->InsertNextCell(source->GetCellType(cellId), pts);
-    }
-
-    // translate Source to Input point
-    double x[3];
-    input->GetPoint(inPtId, x);
-    trans->Translate(x[0], x[1], x[2]);
 
-    if (orientArray)
-    {
-      double v[3] = { 0.0 };
-      orientArray->GetTuple(inPtId, v);
-      double vMag = vtkMath::Norm(v);
-      if (vMag > 0.0)
+      // Copy point data from source (if possible)
+      if (pd)
       {
-        // if there is no y or z component
-        if (v[1] == 0.0 && v[2] == 0.0)
+        for (vtkIdType i = 0; i < numSourcePts; ++i)
         {
-          if (v[0] < 0) // just flip x if we need to
-          {
-            trans->RotateWXYZ(180.0, 0, 1, 0);
-          }
-        }
-        else
-        {
-          double vNew[3];
-          vNew[0] = (v[0] + vMag) / 2.0;
-          vNew[1] = v[1] / 2.0;
-          vNew[2] = v[2] / 2.0;
-          trans->RotateWXYZ(180.0, vNew[0], vNew[1], vNew[2]);
+          srcPointIds[ptIncr + i] = inPtId;
+          dstPointIds[ptIncr + i] = ptIncr + i;
         }
       }
     }
+  });
 
-    // scale data if appropriate
-    if (scalex == 0.0)
-    {
-      scalex = 1.0e-10;
-    }
-    if (scaley == 0.0)
-    {
-      scaley = 1.0e-10;
-    }
-    if (scalez == 0.0)
-    {
-      scalez = 1.0e-10;
-    }
-    trans->Scale(scalex, scaley, scalez);
-
-    // multiply points and normals by resulting matrix
-    if (this->SourceTransform)
-    {
-      transformedSourcePts->Reset();
-      this->SourceTransform->TransformPoints(sourcePts, transformedSourcePts);
-      trans->TransformPoints(transformedSourcePts, newPts);
-    }
-    else
-    {
-      trans->TransformPoints(sourcePts, newPts);
-    }
-
-    if (newNormals.GetPointer())
-    {
-      trans->TransformNormals(sourceNormals, newNormals);
-    }
+  if (aborted)
+  {
+    return true;
+  }
 
-    // Copy point data from source (if possible)
-    if (pd)
-    {
-      for (vtkIdType i = 0; i < numSourcePts; ++i)
-      {
-        srcPointIdList->SetId(i, inPtId);
-        dstPointIdList->SetId(i, ptIncr + i);
-      }
-      outputPD->CopyData(pd, srcPointIdList, dstPointIdList);
-    }
+  // Copy all topology (transformation independent). The cells of each glyph
+  // follow the source cells, glyph after glyph. vtkPolyData numbers the cells
+  // set by cell array type after type, hence cell arrays are only replicated
+  // in parallel for sources with a single cell type.
+  const int numSourceCellTypes = (source->GetNumberOfVerts() > 0 ? 1 : 0) +
+    (source->GetNumberOfLines() > 0 ? 1 : 0) + (source->GetNumberOfPolys() > 0 ? 1 : 0) +
+    (source->GetNumberOfStrips() > 0 ? 1 : 0);
+  if (numSourceCellTypes > 1)
+  {
+    InsertGlyphCells(source, numGlyphs, output);
+  }
+  else if (source->GetNumberOfVerts() > 0)
+  {
+    output->SetVerts(ReplicateGlyphCells(source->GetVerts(), numGlyphs, numSourcePts));
+  }
+  else if (source->GetNumberOfLines() > 0)
+  {
+    output->SetLines(ReplicateGlyphCells(source->GetLines(), numGlyphs, numSourcePts));
+  }
+  else if (source->GetNumberOfPolys() > 0)
+  {
+    output->SetPolys(ReplicateGlyphCells(source->GetPolys(), numGlyphs, numSourcePts));
+  }
+  else if (source->GetNumberOfStrips() > 0)
+  {
+    output->SetStrips(ReplicateGlyphCells(source->GetStrips(), numGlyphs, numSourcePts));
+  }
 
-    ptIncr += numSourcePts;
-    cellIncr += numSourceCells;
+  if (pd)
+  {
+    outputPD->CopyData(pd, srcPointIdList, dstPointIdList);
   }
 
   if (newNormals.GetPointer())
@@ -54,6 +54,14 @@
  * In parallel and with composite dataset, this filter ensures that each piece
  * samples only a representative number of points.
  * Note that the grid will be tetrahedralized first.
+ *
+ * Glyphs are generated in two passes: the points to glyph are found first,
+ * then all glyphs are transformed and written in parallel using vtkSMPTools.
+ * The visibility of the points is only evaluated in parallel with the
+ * ALL_POINTS and EVERY_NTH_POINT modes, since the other modes rely on
+ * IsPointVisible being called in order. The cells of each glyph follow the
+ * source cells; they are only replicated in parallel for glyph sources with a
+ * single cell type, since vtkPolyData groups the cells by type otherwise.
 */
 
 #ifndef vtkPVGlyphFilter_h
@@ -0,0 +1,155 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestMaterialInterfaceFilterParallel.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that fragments spanning blocks owned by different processes are
+// merged through the ghost block exchange of vtkMaterialInterfaceFilter.
+
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkMPIController.h"
+#include "vtkMaterialInterfaceFilter.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkNonOverlappingAMR.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUniformGrid.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cmath>
+
+#define expect(x, msg)                                                                             \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << __LINE__ << ": " msg << endl;                                                          \
+    return EXIT_FAILURE;                                                                           \
+  }
+
+namespace
+{
+// Blocks of 8^3 cells on a 4x3x3 grid of blocks, with two balls centered on
+// block corners, hence each ball spans 8 blocks.
+const int BlockCells = 8;
+const int BlocksPerAxis[3] = { 4, 3, 3 };
+const double Centers[2][3] = { { 8, 8, 8 }, { 24, 16, 16 } };
+const double Radius = 4.0;
+
+bool IsInside(const double x[3], const double center[3])
+{
+  const double dx = x[0] - center[0], dy = x[1] - center[1], dz = x[2] - center[2];
+  return dx * dx + dy * dy + dz * dz < Radius * Radius;
+}
+
+vtkSmartPointer<vtkUniformGrid> MakeBlock(const int index[3], int& numInside)
+{
+  auto grid = vtkSmartPointer<vtkUniformGrid>::New();
+  grid->SetOrigin(index[0] * BlockCells, index[1] * BlockCells, index[2] * BlockCells);
+  grid->SetSpacing(1, 1, 1);
+  grid->SetDimensions(BlockCells + 1, BlockCells + 1, BlockCells + 1);
+
+  vtkNew<vtkUnsignedCharArray> fraction;
+  fraction->SetName("Material");
+  fraction->SetNumberOfTuples(grid->GetNumberOfCells());
+  vtkIdType cellId = 0;
+  for (int k = 0; k < BlockCells; ++k)
+  {
+    for (int j = 0; j < BlockCells; ++j)
+    {
+      for (int i = 0; i < BlockCells; ++i, ++cellId)
+      {
+        const double x[3] = { index[0] * BlockCells + i + 0.5, index[1] * BlockCells + j + 0.5,
+          index[2] * BlockCells + k + 0.5 };
+        const bool inside = IsInside(x, Centers[0]) || IsInside(x, Centers[1]);
+        numInside += inside ? 1 : 0;
+        fraction->SetValue(cellId, inside ? 255 : 0);
+      }
+    }
+  }
+  grid->GetCellData()->AddArray(fraction);
+  return grid;
+}
+
+int Check(vtkMaterialInterfaceFilter* filter, int rank, int numInside)
+{
+  if (rank != 0)
+  {
+    // fragment statistics are gathered on process 0.
+    return EXIT_SUCCESS;
+  }
+  auto centers = vtkMultiBlockDataSet::SafeDownCast(filter->GetOutputDataObject(1));
+  expect(centers != nullptr && centers->GetNumberOfBlocks() == 1, "missing fragment centers");
+  auto fragments = vtkPolyData::SafeDownCast(centers->GetBlock(0));
+  expect(fragments != nullptr, "missing fragment centers for the material");
+  expect(fragments->GetNumberOfPoints() == 2, "fragments across processes were not merged");
+  vtkDataArray* volumes = fragments->GetPointData()->GetArray("Volume");
+  expect(volumes != nullptr, "missing 'Volume' array");
+  expect(volumes->GetTuple1(0) == volumes->GetTuple1(1), "fragments have different volumes");
+  expect(std::abs(volumes->GetTuple1(0) + volumes->GetTuple1(1) - numInside) < 1e-6,
+    "wrong total volume");
+  return EXIT_SUCCESS;
+}
+}
+
+int TestMaterialInterfaceFilterParallel(int argc, char* argv[])
+{
+  vtkMPIController* contr = vtkMPIController::New();
+  contr->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(contr);
+
+  const int rank = contr->GetLocalProcessId();
+  const int numProcs = contr->GetNumberOfProcesses();
+
+  // Blocks are dealt round robin, hence neighboring blocks belong to
+  // different processes.
+  int numBlocks[1] = { BlocksPerAxis[0] * BlocksPerAxis[1] * BlocksPerAxis[2] };
+  vtkNew<vtkNonOverlappingAMR> amr;
+  amr->Initialize(1, numBlocks);
+  int numInside = 0;
+  int blockId = 0;
+  for (int k = 0; k < BlocksPerAxis[2]; ++k)
+  {
+    for (int j = 0; j < BlocksPerAxis[1]; ++j)
+    {
+      for (int i = 0; i < BlocksPerAxis[0]; ++i, ++blockId)
+      {
+        const int index[3] = { i, j, k };
+        int blockInside = 0;
+        auto block = MakeBlock(index, blockInside);
+        numInside += blockInside;
+        if (blockId % numProcs == rank)
+        {
+          amr->SetDataSet(0, blockId, block);
+        }
+      }
+    }
+  }
+
+  int status = EXIT_SUCCESS;
+  {
+    // the filter uses the global controller.
+    vtkNew<vtkMaterialInterfaceFilter> filter;
+    filter->SetInputData(amr);
+    filter->SelectMaterialArray("Material");
+    filter->Update();
+    status = Check(filter, rank, numInside);
+  }
+  int globalStatus = EXIT_SUCCESS;
+  contr->AllReduce(&status, &globalStatus, 1, vtkCommunicator::MAX_OP);
+
+  vtkMultiProcessController::SetGlobalController(nullptr);
+  contr->Finalize();
+  contr->Delete();
+  return globalStatus;
+}
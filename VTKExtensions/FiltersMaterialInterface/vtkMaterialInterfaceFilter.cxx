@@ -21,6 +21,9 @@
 #include "vtkObject.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#if VTK_MODULE_ENABLE_VTK_ParallelMPI
+#include "vtkMPIController.h"
+#endif
 // PV interface
 #include "vtkCallbackCommand.h"
 #include "vtkDataArraySelection.h"
@@ -239,6 +242,98 @@ int GetEnabledArrayNames(vtkDataArraySelection* das, vector<string>& names)
   }
   return nEnabled;
 }
+
+// Number of cells in a cell extent.
+inline int GetExtentSize(const int ext[6])
+{
+  return (ext[1] - ext[0] + 1) * (ext[3] - ext[2] + 1) * (ext[5] - ext[4] + 1);
+}
+
+// Exchanges one buffer with each of the neighbors, which must be sorted.
+// Both sides must agree on the sizes: recvBufs are sized to what the
+// neighbors send, and empty buffers are not sent. With MPI, all the receives
+// then all the sends are posted without blocking before waiting for them,
+// so that the exchanges with all the neighbors overlap. Otherwise the
+// neighbors are visited in increasing rank order and the process with the
+// lower rank sends first, which cannot deadlock.
+template <typename T>
+void ExchangeWithNeighbors(vtkMultiProcessController* controller,
+  const std::vector<int>& neighbors, std::vector<std::vector<T> >& sendBufs,
+  std::vector<std::vector<T> >& recvBufs, int tag)
+{
+  const size_t numNeighbors = neighbors.size();
+#if VTK_MODULE_ENABLE_VTK_ParallelMPI
+  if (vtkMPIController* mpiController = vtkMPIController::SafeDownCast(controller))
+  {
+    std::vector<vtkMPICommunicator::Request> requests(2 * numNeighbors);
+    size_t numRequests = 0;
+    for (size_t ii = 0; ii < numNeighbors; ++ii)
+    {
+      if (!recvBufs[ii].empty())
+      {
+        mpiController->NoBlockReceive(recvBufs[ii].data(), static_cast<int>(recvBufs[ii].size()),
+          neighbors[ii], tag, requests[numRequests++]);
+      }
+    }
+    for (size_t ii = 0; ii < numNeighbors; ++ii)
+    {
+      if (!sendBufs[ii].empty())
+      {
+        mpiController->NoBlockSend(sendBufs[ii].data(), static_cast<int>(sendBufs[ii].size()),
+          neighbors[ii], tag, requests[numRequests++]);
+      }
+    }
+    for (size_t ii = 0; ii < numRequests; ++ii)
+    {
+      requests[ii].Wait();
+    }
+    return;
+  }
+#endif
+
+  const int myProc = controller->GetLocalProcessId();
+  for (size_t ii = 0; ii < numNeighbors; ++ii)
+  {
+    const int otherProc = neighbors[ii];
+    const bool sendFirst = myProc < otherProc;
+    const vtkIdType sendSize = static_cast<vtkIdType>(sendBufs[ii].size());
+    const vtkIdType recvSize = static_cast<vtkIdType>(recvBufs[ii].size());
+    if (sendFirst && sendSize > 0)
+    {
+      controller->Send(sendBufs[ii].data(), sendSize, otherProc, tag);
+    }
+    if (recvSize > 0)
+    {
+      controller->Receive(recvBufs[ii].data(), recvSize, otherProc, tag);
+    }
+    if (!sendFirst && sendSize > 0)
+    {
+      controller->Send(sendBufs[ii].data(), sendSize, otherProc, tag);
+    }
+  }
+}
+
+// Exchanges the sizes of the buffers to send to the neighbors, and sizes the
+// receive buffers accordingly.
+template <typename T>
+void ExchangeSizesWithNeighbors(vtkMultiProcessController* controller,
+  const std::vector<int>& neighbors, std::vector<std::vector<T> >& sendBufs,
+  std::vector<std::vector<T> >& recvBufs, int tag)
+{
+  const size_t numNeighbors = neighbors.size();
+  std::vector<std::vector<int> > sendSizes(numNeighbors);
+  std::vector<std::vector<int> > recvSizes(numNeighbors, std::vector<int>(1, 0));
+  for (size_t ii = 0; ii < numNeighbors; ++ii)
+  {
+    sendSizes[ii].push_back(static_cast<int>(sendBufs[ii].size()));
+  }
+  ExchangeWithNeighbors(controller, neighbors, sendSizes, recvSizes, tag);
+  recvBufs.resize(numNeighbors);
+  for (size_t ii = 0; ii < numNeighbors; ++ii)
+  {
+    recvBufs[ii].resize(recvSizes[ii][0]);
+  }
+}
 };
 //============================================================================
 // A class that implements an equivalent set.  It is used to combine fragments
@@ -289,7 +384,8 @@ private:
 
   // Return the id of the equivalent set.
   int GetReference(int memberId);
-  void EquateInternal(int id1, int id2);
+  // Return the root of the member's set, compressing the path on the way.
+  int FindRoot(int memberId);
 };
 
 //----------------------------------------------------------------------------
@@ -340,16 +436,31 @@ void vtkMaterialInterfaceEquivalenceSet::Print()
 // Return the id of the equivalent set.
 int vtkMaterialInterfaceEquivalenceSet::GetEquivalentSetId(int memberId)
 {
-  int ref;
-
-  ref = this->GetReference(memberId);
-  while (!this->Resolved && ref != memberId)
+  if (this->Resolved || memberId >= this->EquivalenceArray->GetNumberOfTuples())
   {
-    memberId = ref;
-    ref = this->GetReference(memberId);
+    return this->GetReference(memberId);
   }
+  return this->FindRoot(memberId);
+}
 
-  return ref;
+//----------------------------------------------------------------------------
+// Roots are the smallest member of their set, and every member points to
+// a smaller member, so compressing the path keeps the ordering.
+int vtkMaterialInterfaceEquivalenceSet::FindRoot(int memberId)
+{
+  int* refs = this->EquivalenceArray->GetPointer(0);
+  int root = memberId;
+  while (refs[root] != root)
+  {
+    root = refs[root];
+  }
+  while (refs[memberId] != root)
+  {
+    int next = refs[memberId];
+    refs[memberId] = root;
+    memberId = next;
+  }
+  return root;
 }
 
 //----------------------------------------------------------------------------
@@ -387,47 +498,17 @@ void vtkMaterialInterfaceEquivalenceSet::AddEquivalence(int id1, int id2)
 
   // Our rule for references in the equivalent set is that
   // all elements must point to a member equal to or smaller
-  // than itself.
-
-  // The only problem we could encounter is changing a reference.
-  // we do not want to orphan anything previously referenced.
-
-  // Replace the larger references.
-  if (id1 < id2)
+  // than itself. This is a union-find: link the larger root
+  // to the smaller one.
+  int root1 = this->FindRoot(id1);
+  int root2 = this->FindRoot(id2);
+  if (root1 < root2)
   {
-    // We could follow the references to the smallest.  It might
-    // make this processing more efficient.  This is a compromise.
-    // The referenced id will always be smaller than the id so
-    // order does not change.
-    this->EquateInternal(this->GetReference(id1), id2);
+    this->EquivalenceArray->SetValue(root2, root1);
   }
-  else
+  else if (root2 < root1)
   {
-    this->EquateInternal(this->GetReference(id2), id1);
-  }
-}
-
-//----------------------------------------------------------------------------
-// id1 must be less than or equal to id2.
-void vtkMaterialInterfaceEquivalenceSet::EquateInternal(int id1, int id2)
-{
-  // This is the reference that might be orphaned in this process.
-  int oldRef = this->GetEquivalentSetId(id2);
-
-  // The only problem we could encounter is changing a reference.
-  // we do not want to orphan anything previously referenced.
-  if (oldRef == id2 || oldRef == id1)
-  {
-    this->EquivalenceArray->SetValue(id2, id1);
-  }
-  else if (oldRef > id1)
-  {
-    this->EquivalenceArray->SetValue(id2, id1);
-    this->EquateInternal(id1, oldRef);
-  }
-  else
-  { // oldRef < id1
-    this->EquateInternal(oldRef, id1);
+    this->EquivalenceArray->SetValue(root1, root2);
   }
 }
 
@@ -1793,6 +1874,7 @@ int vtkMaterialInterfaceFilter::FillOutputPortInformation(int port, vtkInformati
 // Called to delete all the block structures.
 void vtkMaterialInterfaceFilter::DeleteAllBlocks()
 {
+  this->GhostNeighborProcesses.clear();
   if (this->NumberOfInputBlocks == 0)
   {
     return;
@@ -2922,134 +3004,133 @@ int MPI_Allgatherv ( void *sendbuf, int sendcount, MPI_Datatype sendtype,
 
 //----------------------------------------------------------------------------
 // Loop over all blocks from other processes.  Find all local blocks
-// that touch the block.
+// that touch the block. Ghost blocks are then exchanged with neighbor
+// processes only, all the blocks between two processes in one message.
 void vtkMaterialInterfaceFilter::ComputeAndDistributeGhostBlocks(
   int* numBlocksInProc, int* blockMetaData, int myProc, int numProcs)
 {
-  int requestMsg[8];
-  int* ext;
-  int bufSize = 0;
-  unsigned char* buf = 0;
-  int dataSize;
-  vtkMaterialInterfaceFilterBlock* ghostBlock;
-
-  // Loop through the other processes.
+  // Requests are (block id, required extent), grouped by the process
+  // that owns the block.
+  std::vector<std::vector<int> > requests(numProcs);
+  std::vector<std::vector<int> > requestLevels(numProcs);
+  std::vector<int> sourceProcs;
   int* blockMetaDataPtr = blockMetaData;
   for (int otherProc = 0; otherProc < numProcs; ++otherProc)
   {
-    if (otherProc == myProc)
+    for (int id = 0; id < numBlocksInProc[otherProc]; ++id, blockMetaDataPtr += 7)
     {
-      this->HandleGhostBlockRequests();
-      // Skip the metat data for this process.
-      blockMetaDataPtr += +7 * numBlocksInProc[myProc];
-    }
-    else
-    {
-      // Loop through the extents in the remote process.
-      for (int id = 0; id < numBlocksInProc[otherProc]; ++id)
+      // Block meta data is level and base-cell-extent.
+      int ext[6];
+      if (otherProc != myProc &&
+        this->ComputeRequiredGhostExtent(blockMetaDataPtr[0], blockMetaDataPtr + 1, ext))
       {
-        // Request message is (requesting process, block id, required extent)
-        requestMsg[0] = myProc;
-        requestMsg[1] = id;
-        ext = requestMsg + 2;
-        // Block meta data is level and base-cell-extent.
-        int ghostBlockLevel = blockMetaDataPtr[0];
-        int* ghostBlockExt = blockMetaDataPtr + 1;
-
-        if (this->ComputeRequiredGhostExtent(ghostBlockLevel, ghostBlockExt, ext))
-        {
-          this->Controller->Send(requestMsg, 8, otherProc, 708923);
-          // Now receive the ghost block.
-          dataSize = (ext[1] - ext[0] + 1) * (ext[3] - ext[2] + 1) * (ext[5] - ext[4] + 1);
-          if (bufSize < dataSize)
-          {
-            if (buf)
-            {
-              delete[] buf;
-            }
-            buf = new unsigned char[dataSize];
-            bufSize = dataSize;
-          }
-          this->Controller->Receive(buf, dataSize, otherProc, 433240);
-          // Make the ghost block and add it to the grid.
-          ghostBlock = new vtkMaterialInterfaceFilterBlock;
-          ghostBlock->InitializeGhostLayer(
-            buf, ext, ghostBlockLevel, this->GlobalOrigin, this->RootSpacing, otherProc, id);
-          // Save for deleting.
-          this->GhostBlocks.push_back(ghostBlock);
-          // Add to grid and connect up neighbors.
-          this->AddBlock(ghostBlock, this->GetBlockGhostLevel());
-        }
-        // Move to the next block.
-        blockMetaDataPtr += 7;
+        requests[otherProc].push_back(id);
+        requests[otherProc].insert(requests[otherProc].end(), ext, ext + 6);
+        requestLevels[otherProc].push_back(blockMetaDataPtr[0]);
       }
-      // Send the message that indicates we have no more requests.
-      requestMsg[0] = myProc;
-      requestMsg[1] = -1;
-      this->Controller->Send(requestMsg, 8, otherProc, 708923);
+    }
+    if (!requests[otherProc].empty())
+    {
+      sourceProcs.push_back(otherProc);
     }
   }
-  if (buf)
+
+  // Share who needs blocks from whom, so that processes only talk to
+  // their neighbors from now on.
+  int numSourceProcs = static_cast<int>(sourceProcs.size());
+  std::vector<int> numSourceProcsPerProc(numProcs);
+  this->Controller->AllGather(&numSourceProcs, &numSourceProcsPerProc[0], 1);
+  std::vector<vtkIdType> recvLengths(numProcs);
+  std::vector<vtkIdType> offsets(numProcs);
+  vtkIdType totalNumberOfSources = 0;
+  for (int ii = 0; ii < numProcs; ++ii)
   {
-    delete[] buf;
+    offsets[ii] = totalNumberOfSources;
+    recvLengths[ii] = numSourceProcsPerProc[ii];
+    totalNumberOfSources += numSourceProcsPerProc[ii];
   }
-}
+  std::vector<int> allSourceProcs(totalNumberOfSources + 1);
+  this->Controller->AllGatherV(sourceProcs.data(), &allSourceProcs[0], numSourceProcs,
+    &recvLengths[0], &offsets[0]);
 
-//----------------------------------------------------------------------------
-// Keep receiving and filling requests until all processes say they
-// are finished asking for blocks.
-void vtkMaterialInterfaceFilter::HandleGhostBlockRequests()
-{
-  int requestMsg[8];
-  int otherProc;
-  int blockId;
-  vtkMaterialInterfaceFilterBlock* block;
-  int bufSize = 0;
-  unsigned char* buf = 0;
-  int dataSize;
-  int* ext;
-
-  // We do not receive requests from our own process.
-  int remainingProcs = this->Controller->GetNumberOfProcesses() - 1;
-  while (remainingProcs != 0)
+  this->GhostNeighborProcesses = sourceProcs;
+  for (int otherProc = 0; otherProc < numProcs; ++otherProc)
   {
-    this->Controller->Receive(requestMsg, 8, vtkMultiProcessController::ANY_SOURCE, 708923);
-    otherProc = requestMsg[0];
-    blockId = requestMsg[1];
-    if (blockId == -1)
+    for (vtkIdType ii = 0; ii < recvLengths[otherProc]; ++ii)
     {
-      --remainingProcs;
+      if (allSourceProcs[offsets[otherProc] + ii] == myProc)
+      {
+        this->GhostNeighborProcesses.push_back(otherProc);
+      }
     }
-    else
+  }
+  std::sort(this->GhostNeighborProcesses.begin(), this->GhostNeighborProcesses.end());
+  this->GhostNeighborProcesses.erase(
+    std::unique(this->GhostNeighborProcesses.begin(), this->GhostNeighborProcesses.end()),
+    this->GhostNeighborProcesses.end());
+
+  // Exchange the requests with all the neighbors at once.
+  const std::vector<int>& neighbors = this->GhostNeighborProcesses;
+  const size_t numNeighbors = neighbors.size();
+  std::vector<std::vector<int> > localRequests(numNeighbors);
+  std::vector<std::vector<int> > remoteRequests;
+  for (size_t nn = 0; nn < numNeighbors; ++nn)
+  {
+    localRequests[nn].swap(requests[neighbors[nn]]);
+  }
+  ExchangeSizesWithNeighbors(this->Controller, neighbors, localRequests, remoteRequests, 708923);
+  ExchangeWithNeighbors(this->Controller, neighbors, localRequests, remoteRequests, 708924);
+
+  // Extract the data for all the requested ghost layers, then exchange it.
+  std::vector<std::vector<unsigned char> > sendBufs(numNeighbors);
+  std::vector<std::vector<unsigned char> > recvBufs(numNeighbors);
+  for (size_t nn = 0; nn < numNeighbors; ++nn)
+  {
+    std::vector<unsigned char>& sendBuf = sendBufs[nn];
+    const int numRemoteRequests = static_cast<int>(remoteRequests[nn].size());
+    for (int ii = 0; ii < numRemoteRequests; ii += 7)
     {
-      // Find the block.
-      block = this->InputBlocks[blockId];
-      if (block == 0)
-      { // Sanity check. This will lock up!
+      int blockId = remoteRequests[nn][ii];
+      int* ext = &remoteRequests[nn][ii + 1];
+      size_t offset = sendBuf.size();
+      sendBuf.resize(offset + GetExtentSize(ext), 0);
+      if (blockId < 0 || blockId >= this->NumberOfInputBlocks || this->InputBlocks[blockId] == 0)
+      { // Sanity check. Keep the message size so that the exchange goes on.
         vtkErrorMacro("Missing block request.");
-        return;
-      }
-      // Crop the block.
-      // Now extract the data for the ghost layer.
-      ext = requestMsg + 2;
-      dataSize = (ext[1] - ext[0] + 1) * (ext[3] - ext[2] + 1) * (ext[5] - ext[4] + 1);
-      if (bufSize < dataSize)
-      {
-        if (buf)
-        {
-          delete[] buf;
-        }
-        buf = new unsigned char[dataSize];
-        bufSize = dataSize;
+        continue;
       }
-      block->ExtractExtent(buf, ext);
-      // Send the block.
-      this->Controller->Send(buf, dataSize, otherProc, 433240);
+      this->InputBlocks[blockId]->ExtractExtent(&sendBuf[offset], ext);
     }
+
+    size_t recvSize = 0;
+    const int numLocalRequests = static_cast<int>(localRequests[nn].size());
+    for (int ii = 0; ii < numLocalRequests; ii += 7)
+    {
+      recvSize += GetExtentSize(&localRequests[nn][ii + 1]);
+    }
+    recvBufs[nn].resize(recvSize);
   }
-  if (buf)
+  ExchangeWithNeighbors(this->Controller, neighbors, sendBufs, recvBufs, 433240);
+
+  // Make the ghost blocks and add them to the grid.
+  for (size_t nn = 0; nn < numNeighbors; ++nn)
   {
-    delete[] buf;
+    const int otherProc = neighbors[nn];
+    unsigned char* volFraction = recvBufs[nn].data();
+    const int numLocalRequests = static_cast<int>(localRequests[nn].size());
+    for (int ii = 0; ii < numLocalRequests; ii += 7)
+    {
+      int ext[6];
+      std::copy(&localRequests[nn][ii + 1], &localRequests[nn][ii + 7], ext);
+      vtkMaterialInterfaceFilterBlock* ghostBlock = new vtkMaterialInterfaceFilterBlock;
+      ghostBlock->InitializeGhostLayer(volFraction, ext, requestLevels[otherProc][ii / 7],
+        this->GlobalOrigin, this->RootSpacing, otherProc, localRequests[nn][ii]);
+      volFraction += GetExtentSize(ext);
+      // Save for deleting.
+      this->GhostBlocks.push_back(ghostBlock);
+      // Add to grid and connect up neighbors.
+      this->AddBlock(ghostBlock, this->GetBlockGhostLevel());
+    }
   }
 }
 
@@ -8280,24 +8361,7 @@ void vtkMaterialInterfaceFilter::GatherEquivalenceSets(vtkMaterialInterfaceEquiv
   const int numLocalMembers = set->GetNumberOfMembers();
 
   // Find a mapping between local fragment id and the global fragment ids.
-  if (myProcId == 0)
-  {
-    this->NumberOfRawFragmentsInProcess[0] = numLocalMembers;
-    for (int ii = 1; ii < numProcs; ++ii)
-    {
-      this->Controller->Receive(this->NumberOfRawFragmentsInProcess + ii, 1, ii, 875034);
-    }
-    // Now send the results back to all processes.
-    for (int ii = 1; ii < numProcs; ++ii)
-    {
-      this->Controller->Send(this->NumberOfRawFragmentsInProcess, numProcs, ii, 875035);
-    }
-  }
-  else
-  {
-    this->Controller->Send(&numLocalMembers, 1, 0, 875034);
-    this->Controller->Receive(this->NumberOfRawFragmentsInProcess, numProcs, 0, 875035);
-  }
+  this->Controller->AllGather(&numLocalMembers, this->NumberOfRawFragmentsInProcess, 1);
   // Compute offsets.
   int totalNumberOfIds = 0;
   for (int ii = 0; ii < numProcs; ++ii)
@@ -8322,8 +8386,6 @@ void vtkMaterialInterfaceFilter::GatherEquivalenceSets(vtkMaterialInterfaceEquiv
   for (int ii = 0; ii < numLocalMembers; ++ii)
   {
     memberSetId = set->GetEquivalentSetId(ii);
-    // This will be inefficient until I make the scheduled improvemnt to the
-    // add method (Ordered multilevel tree instead of a one level tree).
     globalSet->AddEquivalence(ii + myOffset, memberSetId + myOffset);
   }
 
@@ -8358,208 +8420,188 @@ void vtkMaterialInterfaceFilter::GatherEquivalenceSets(vtkMaterialInterfaceEquiv
 }
 
 //----------------------------------------------------------------------------
+// Merge the global sets of all processes along a binomial tree rooted at
+// process 0, which resolves the final set and broadcasts it.
 void vtkMaterialInterfaceFilter::MergeGhostEquivalenceSets(
   vtkMaterialInterfaceEquivalenceSet* globalSet)
 {
   const int myProcId = this->Controller->GetLocalProcessId();
-  int* buf = globalSet->GetPointer();
-  const int numIds = globalSet->GetNumberOfMembers();
-
+  const int numProcs = this->Controller->GetNumberOfProcesses();
   // At this point all the sets are global and have the same number of ids.
-  // Send all the sets to process 0 to be merged.
-  if (myProcId > 0)
-  {
-    this->Controller->Send(buf, numIds, 0, 342320);
-    // Now receive the final equivalences.
-    this->Controller->Receive(&this->NumberOfResolvedFragments, 1, 0, 342321);
-    // Domain has numIds,  range has NumberOfResolvedFragments
-    this->Controller->Receive(buf, numIds, 0, 342322);
-    // We have to mark the set as resolved because the set being
-    // received has been resolved.  If we do not do this then
-    // We cannot get the proper set id.  Using the pointer
-    // here is a bad api.  TODO: Fix the API and make "Resolved" private.
-    globalSet->Resolved = 1;
-    return;
-  }
-
-  // Only process 0 from here out.
+  const int numIds = globalSet->GetNumberOfMembers();
 
-  int numProcs = this->Controller->GetNumberOfProcesses();
-  int* tmp;
-  tmp = new int[numIds];
-  for (int ii = 1; ii < numProcs; ++ii)
+  if (numIds > 0)
   {
-    this->Controller->Receive(tmp, numIds, ii, 342320);
-    // Merge the values.
-    for (int jj = 0; jj < numIds; ++jj)
+    std::vector<int> tmp(numIds);
+    for (int step = 1; step < numProcs; step <<= 1)
     {
-      if (tmp[jj] != jj)
-      { // TODO: Make sure this is efficient.  Avoid n^2.
-        globalSet->AddEquivalence(jj, tmp[jj]);
+      if (myProcId & step)
+      {
+        this->Controller->Send(globalSet->GetPointer(), numIds, myProcId - step, 342320);
+        break;
+      }
+      if (myProcId + step < numProcs)
+      {
+        this->Controller->Receive(&tmp[0], numIds, myProcId + step, 342320);
+        // Merge the values.
+        for (int jj = 0; jj < numIds; ++jj)
+        {
+          if (tmp[jj] != jj)
+          {
+            globalSet->AddEquivalence(jj, tmp[jj]);
+          }
+        }
       }
     }
   }
-  delete[] tmp;
 
   // Make the set ids sequential.
-  this->NumberOfResolvedFragments = globalSet->ResolveEquivalences();
+  if (myProcId == 0)
+  {
+    this->NumberOfResolvedFragments = globalSet->ResolveEquivalences();
+  }
 
-  // The pointers should still be valid.
-  // The array should not resize here.
   // Number of resolved fragemnts will be smaller
   // than TotalNumberOfRawFragments
-  for (int ii = 1; ii < numProcs; ++ii)
+  this->Controller->Broadcast(&this->NumberOfResolvedFragments, 1, 0);
+  if (numIds > 0)
   {
-    this->Controller->Send(&this->NumberOfResolvedFragments, 1, ii, 342321);
     // Domain has numIds,  range has NumberOfResolvedFragments
-    this->Controller->Send(buf, numIds, ii, 342322);
+    this->Controller->Broadcast(globalSet->GetPointer(), numIds, 0);
   }
+  // We have to mark the set as resolved because the set being
+  // received has been resolved.  If we do not do this then
+  // We cannot get the proper set id.  Using the pointer
+  // here is a bad api.  TODO: Fix the API and make "Resolved" private.
+  globalSet->Resolved = 1;
 }
 
 //----------------------------------------------------------------------------
+// Send the fragment ids of our ghost blocks to the processes that own the
+// blocks, and receive theirs. Only the neighbors found when the ghost blocks
+// were shared take part, all the blocks between two processes in one message.
 void vtkMaterialInterfaceFilter::ShareGhostEquivalences(
   vtkMaterialInterfaceEquivalenceSet* globalSet, int* procOffsets)
 {
-  const int numProcs = this->Controller->GetNumberOfProcesses();
-  const int myProcId = this->Controller->GetLocalProcessId();
-  int sendMsg[8];
+  const std::vector<int>& neighbors = this->GhostNeighborProcesses;
+  const size_t numNeighbors = neighbors.size();
+  std::vector<std::vector<int> > sendInfo(numNeighbors);
+  std::vector<std::vector<int> > sendIds(numNeighbors);
+  std::vector<std::vector<int> > recvInfo;
+  std::vector<std::vector<int> > recvIds(numNeighbors);
 
-  // Loop through the other processes.
-  for (int otherProc = 0; otherProc < numProcs; ++otherProc)
+  // Pack our ghost blocks by owner as (block id, cell extent) followed by
+  // the fragment ids.
+  const int num = static_cast<int>(this->GhostBlocks.size());
+  for (int blockId = 0; blockId < num; ++blockId)
   {
-    if (otherProc == myProcId)
+    vtkMaterialInterfaceFilterBlock* block = this->GhostBlocks[blockId];
+    if (!block || !block->GetGhostFlag())
     {
-      this->ReceiveGhostFragmentIds(globalSet, procOffsets);
+      continue;
     }
-    else
+    auto neighbor =
+      std::lower_bound(neighbors.begin(), neighbors.end(), block->GetOwnerProcessId());
+    if (neighbor == neighbors.end() || *neighbor != block->GetOwnerProcessId())
     {
-      // Loop through our ghost blocks sending the
-      // ones that are owned by otherProc.
-      int num = static_cast<int>(this->GhostBlocks.size());
-      for (int blockId = 0; blockId < num; ++blockId)
-      {
-        vtkMaterialInterfaceFilterBlock* block = this->GhostBlocks[blockId];
-        if (block && block->GetOwnerProcessId() == otherProc && block->GetGhostFlag())
-        {
-          sendMsg[0] = myProcId;
-          // Since this is a ghost block, the remote block id
-          // will be different than the id we use.
-          // We just want to make it easy for the process that owns this block
-          // to match the ghost block with the aoriginal.
-          sendMsg[1] = block->GetBlockId();
-          int* ext = sendMsg + 2;
-          block->GetCellExtent(ext);
-          this->Controller->Send(sendMsg, 8, otherProc, 722265);
-          // Now send the fragment id array.
-          int* framentIds = block->GetFragmentIdPointer();
-          this->Controller->Send(framentIds,
-            (ext[1] - ext[0] + 1) * (ext[3] - ext[2] + 1) * (ext[5] - ext[4] + 1), otherProc,
-            722266);
-        } // End if ghost  block owned by other process.
-      }   // End loop over all blocks.
-      // Send the message that indicates we have nothing more to send.
-      sendMsg[0] = myProcId;
-      sendMsg[1] = -1;
-      this->Controller->Send(sendMsg, 8, otherProc, 722265);
-    } // End if we should send or receive.
-  }   // End loop over all processes.
+      continue;
+    }
+    const size_t nn = neighbor - neighbors.begin();
+    // Since this is a ghost block, the remote block id
+    // will be different than the id we use.
+    // We just want to make it easy for the process that owns this block
+    // to match the ghost block with the aoriginal.
+    int ext[6];
+    block->GetCellExtent(ext);
+    sendInfo[nn].push_back(block->GetBlockId());
+    sendInfo[nn].insert(sendInfo[nn].end(), ext, ext + 6);
+    int* fragmentIds = block->GetFragmentIdPointer();
+    sendIds[nn].insert(sendIds[nn].end(), fragmentIds, fragmentIds + GetExtentSize(ext));
+  }
+
+  // Exchange with all the neighbors at once.
+  ExchangeSizesWithNeighbors(this->Controller, neighbors, sendInfo, recvInfo, 722265);
+  ExchangeWithNeighbors(this->Controller, neighbors, sendInfo, recvInfo, 722266);
+  for (size_t nn = 0; nn < numNeighbors; ++nn)
+  {
+    size_t recvIdsSize = 0;
+    const int recvInfoSize = static_cast<int>(recvInfo[nn].size());
+    for (int ii = 0; ii < recvInfoSize; ii += 7)
+    {
+      recvIdsSize += GetExtentSize(&recvInfo[nn][ii + 1]);
+    }
+    recvIds[nn].resize(recvIdsSize);
+  }
+  ExchangeWithNeighbors(this->Controller, neighbors, sendIds, recvIds, 722267);
+
+  for (size_t nn = 0; nn < numNeighbors; ++nn)
+  {
+    this->ReceiveGhostFragmentIds(globalSet, procOffsets, neighbors[nn], recvInfo[nn], recvIds[nn]);
+  }
 }
 
 //----------------------------------------------------------------------------
-// Receive all the gost blocks from remote processes and
-// find the equivalences.
+// Find the equivalences between our blocks and the ghost blocks
+// of a remote process.
 void vtkMaterialInterfaceFilter::ReceiveGhostFragmentIds(
-  vtkMaterialInterfaceEquivalenceSet* globalSet, int* procOffsets)
+  vtkMaterialInterfaceEquivalenceSet* globalSet, int* procOffsets, int otherProc,
+  const std::vector<int>& ghostInfo, const std::vector<int>& ghostFragmentIds)
 {
-  int msg[8];
-  int otherProc;
-  int blockId;
-  vtkMaterialInterfaceFilterBlock* block;
-  int bufSize = 0;
-  int* buf = 0;
-  int dataSize;
-  int* remoteExt;
-  int localId, remoteId;
   const int myProcId = this->Controller->GetLocalProcessId();
-  int localOffset = procOffsets[myProcId];
-  int remoteOffset;
-
-  // We do not receive requests from our own process.
-  int remainingProcs = this->Controller->GetNumberOfProcesses() - 1;
-  while (remainingProcs != 0)
-  {
-    this->Controller->Receive(msg, 8, vtkMultiProcessController::ANY_SOURCE, 722265);
-    otherProc = msg[0];
-    blockId = msg[1];
-    if (blockId == -1)
-    {
-      --remainingProcs;
+  const int localOffset = procOffsets[myProcId];
+  const int remoteOffset = procOffsets[otherProc];
+  const int* remoteFragmentIds = ghostFragmentIds.data();
+
+  const int infoSize = static_cast<int>(ghostInfo.size());
+  for (int ii = 0; ii < infoSize; ii += 7)
+  {
+    int blockId = ghostInfo[ii];
+    const int* remoteExt = &ghostInfo[ii + 1];
+    const int* nextFragmentIds = remoteFragmentIds + GetExtentSize(remoteExt);
+    // Find the block.
+    vtkMaterialInterfaceFilterBlock* block =
+      (blockId >= 0 && blockId < this->NumberOfInputBlocks) ? this->InputBlocks[blockId] : 0;
+    if (block == 0)
+    { // Sanity check.
+      vtkErrorMacro("Missing block request.");
+      remoteFragmentIds = nextFragmentIds;
+      continue;
     }
-    else
-    {
-      // Find the block.
-      block = this->InputBlocks[blockId];
-      if (block == 0)
-      { // Sanity check. This will lock up!
-        vtkErrorMacro("Missing block request.");
-        return;
-      }
-      // Receive the ghost fragment ids.
-      remoteExt = msg + 2;
-      dataSize = (remoteExt[1] - remoteExt[0] + 1) * (remoteExt[3] - remoteExt[2] + 1) *
-        (remoteExt[5] - remoteExt[4] + 1);
-      if (bufSize < dataSize)
-      {
-        if (buf)
-        {
-          delete[] buf;
-        }
-        buf = new int[dataSize];
-        bufSize = dataSize;
-      }
-      remoteOffset = procOffsets[otherProc];
-      this->Controller->Receive(buf, dataSize, otherProc, 722266);
-      // We have our block, and the remote fragmentIds.
-      // Now for the equivalences.
-      // Loop through all of the voxels.
-      int* remoteFragmentIds = buf;
-      int* localFragmentIds = block->GetFragmentIdPointer();
-      int localExt[6];
-      int localIncs[3];
-      block->GetCellExtent(localExt);
-      block->GetCellIncrements(localIncs);
-      int *px, *py, *pz;
-      // Find the starting voxel in the local block.
-      pz = localFragmentIds + (remoteExt[0] - localExt[0]) * localIncs[0] +
-        (remoteExt[2] - localExt[2]) * localIncs[1] + (remoteExt[4] - localExt[4]) * localIncs[2];
-      for (int iz = remoteExt[4]; iz <= remoteExt[5]; ++iz)
+    // We have our block, and the remote fragmentIds.
+    // Now for the equivalences.
+    // Loop through all of the voxels.
+    int* localFragmentIds = block->GetFragmentIdPointer();
+    int localExt[6];
+    int localIncs[3];
+    block->GetCellExtent(localExt);
+    block->GetCellIncrements(localIncs);
+    int *px, *py, *pz;
+    // Find the starting voxel in the local block.
+    pz = localFragmentIds + (remoteExt[0] - localExt[0]) * localIncs[0] +
+      (remoteExt[2] - localExt[2]) * localIncs[1] + (remoteExt[4] - localExt[4]) * localIncs[2];
+    for (int iz = remoteExt[4]; iz <= remoteExt[5]; ++iz)
+    {
+      py = pz;
+      for (int iy = remoteExt[2]; iy <= remoteExt[3]; ++iy)
       {
-        py = pz;
-        for (int iy = remoteExt[2]; iy <= remoteExt[3]; ++iy)
+        px = py;
+        for (int ix = remoteExt[0]; ix <= remoteExt[1]; ++ix)
         {
-          px = py;
-          for (int ix = remoteExt[0]; ix <= remoteExt[1]; ++ix)
+          // Convert local fragment ids to global ids.
+          int localId = *px;
+          int remoteId = *remoteFragmentIds;
+          if (localId >= 0 && remoteId >= 0)
           {
-            // Convert local fragment ids to global ids.
-            localId = *px;
-            remoteId = *remoteFragmentIds;
-            if (localId >= 0 && remoteId >= 0)
-            {
-              globalSet->AddEquivalence(localId + localOffset, remoteId + remoteOffset);
-            }
-            ++remoteFragmentIds;
-            ++px;
+            globalSet->AddEquivalence(localId + localOffset, remoteId + remoteOffset);
           }
-          py += localIncs[1];
+          ++remoteFragmentIds;
+          ++px;
         }
-        pz += localIncs[2];
+        py += localIncs[1];
       }
+      pz += localIncs[2];
     }
   }
-  if (buf)
-  {
-    delete[] buf;
-  }
 }
 
 //----------------------------------------------------------------------------
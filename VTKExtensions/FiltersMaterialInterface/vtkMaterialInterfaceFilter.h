@@ -376,8 +376,9 @@ protected:
   int GetNumberOfLocalBlocks(vtkNonOverlappingAMR* input);
   // Complex ghost layer Handling.
   std::vector<vtkMaterialInterfaceFilterBlock*> GhostBlocks;
+  // Processes we exchange ghost blocks with, in increasing order.
+  std::vector<int> GhostNeighborProcesses;
   void ShareGhostBlocks();
-  void HandleGhostBlockRequests();
   int ComputeRequiredGhostExtent(int level, int inExt[6], int outExt[6]);
 
   void ComputeAndDistributeGhostBlocks(
@@ -394,7 +395,8 @@ protected:
   void ResolveEquivalences();
   void GatherEquivalenceSets(vtkMaterialInterfaceEquivalenceSet* set);
   void ShareGhostEquivalences(vtkMaterialInterfaceEquivalenceSet* globalSet, int* procOffsets);
-  void ReceiveGhostFragmentIds(vtkMaterialInterfaceEquivalenceSet* globalSet, int* procOffset);
+  void ReceiveGhostFragmentIds(vtkMaterialInterfaceEquivalenceSet* globalSet, int* procOffsets,
+    int otherProc, const std::vector<int>& ghostInfo, const std::vector<int>& ghostFragmentIds);
   void MergeGhostEquivalenceSets(vtkMaterialInterfaceEquivalenceSet* globalSet);
 
   // Sum/finalize attribute's contribution for those
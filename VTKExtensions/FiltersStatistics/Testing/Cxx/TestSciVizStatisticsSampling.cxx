@@ -0,0 +1,130 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestSciVizStatisticsSampling.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the training rows drawn by vtkSciVizStatistics: the requested number
+// of distinct, sorted rows from the input, reproducible for a given seed and
+// uniformly spread over the input.
+
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPSciVizDescriptiveStats.h"
+#include "vtkTable.h"
+
+#include <cmath>
+
+#define expect(x, msg)                                                                             \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << __LINE__ << ": " msg << endl;                                                          \
+    return false;                                                                                  \
+  }
+
+namespace
+{
+class vtkTestSciVizStatistics : public vtkPSciVizDescriptiveStats
+{
+public:
+  static vtkTestSciVizStatistics* New();
+  vtkTypeMacro(vtkTestSciVizStatistics, vtkPSciVizDescriptiveStats);
+
+  vtkIdTypeArray* Sample(vtkTable* input, vtkIdType M)
+  {
+    this->Training->Initialize();
+    this->PrepareTrainingTable(this->Training, input, M);
+    return vtkIdTypeArray::SafeDownCast(this->Training->GetColumn(0));
+  }
+
+  vtkNew<vtkTable> Training;
+};
+vtkStandardNewMacro(vtkTestSciVizStatistics);
+
+bool CheckSample(vtkTestSciVizStatistics* stats, vtkTable* input, vtkIdType M)
+{
+  const vtkIdType N = input->GetNumberOfRows();
+  vtkIdTypeArray* rows = stats->Sample(input, M);
+  expect(rows != nullptr, "missing training column");
+  expect(rows->GetNumberOfTuples() == std::min(M, N), "wrong number of training rows");
+  for (vtkIdType cc = 0; cc < rows->GetNumberOfTuples(); ++cc)
+  {
+    const vtkIdType row = rows->GetValue(cc);
+    expect(row >= 0 && row < N, "training row out of range");
+    expect(cc == 0 || row > rows->GetValue(cc - 1), "training rows not sorted or not distinct");
+  }
+  return true;
+}
+
+bool TestSampling()
+{
+  const vtkIdType N = 1000000;
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetName("ids");
+  ids->SetNumberOfTuples(N);
+  for (vtkIdType cc = 0; cc < N; ++cc)
+  {
+    ids->SetValue(cc, cc);
+  }
+  vtkNew<vtkTable> input;
+  input->AddColumn(ids);
+
+  vtkNew<vtkTestSciVizStatistics> stats;
+  const vtkIdType sizes[] = { 1, 2, 10, 1000, N / 2, N - 1, N, N + 10 };
+  for (vtkIdType M : sizes)
+  {
+    if (!CheckSample(stats, input, M))
+    {
+      cerr << "failed for " << M << " training rows" << endl;
+      return false;
+    }
+  }
+
+  // the same seed gives the same sample, another one a different sample.
+  stats->SetRandomSeed(42);
+  vtkNew<vtkIdTypeArray> first;
+  first->DeepCopy(stats->Sample(input, 10));
+  vtkIdTypeArray* second = stats->Sample(input, 10);
+  bool same = true;
+  for (vtkIdType cc = 0; cc < 10; ++cc)
+  {
+    same = same && first->GetValue(cc) == second->GetValue(cc);
+  }
+  expect(same, "the sample is not reproducible");
+  stats->SetRandomSeed(43);
+  second = stats->Sample(input, 10);
+  same = true;
+  for (vtkIdType cc = 0; cc < 10; ++cc)
+  {
+    same = same && first->GetValue(cc) == second->GetValue(cc);
+  }
+  expect(!same, "the sample does not depend on the seed");
+
+  // single row samples, whose skips span the whole input, must be uniform.
+  const int numSamples = 4000;
+  double sum = 0.0;
+  for (int seed = 0; seed < numSamples; ++seed)
+  {
+    stats->SetRandomSeed(seed);
+    sum += static_cast<double>(stats->Sample(input, 1)->GetValue(0)) / N;
+  }
+  // the mean of U(0, 1) samples has a standard deviation of 1 / sqrt(12 n).
+  const double mean = sum / numSamples;
+  expect(std::abs(mean - 0.5) < 5.0 / std::sqrt(12.0 * numSamples), "the sample is not uniform");
+  return true;
+}
+}
+
+int TestSciVizStatisticsSampling(int, char* [])
+{
+  return TestSampling() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -2,35 +2,116 @@
 #include "vtkSciVizStatisticsPrivate.h"
 
 #include "vtkAlgorithm.h"
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayRange.h"
 #include "vtkDataObject.h"
 #include "vtkDataObjectTreeIterator.h"
 #include "vtkDataSetAttributes.h"
 #include "vtkDemandDrivenPipeline.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationIntegerKey.h"
 #include "vtkInformationVector.h"
-#include "vtkMath.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkPointData.h"
 #include "vtkStatisticsAlgorithm.h"
 #include "vtkStringArray.h"
 #include "vtkTable.h"
-#include "vtkVariantArray.h"
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
 #include <set>
 #include <sstream>
 
 vtkInformationKeyMacro(vtkSciVizStatistics, MULTIPLE_MODELS, Integer);
 
+namespace
+{
+// Copies each component of a multi-component array into its own column.
+struct SplitComponentsWorker
+{
+  template <typename ArrayT>
+  void operator()(ArrayT* array, std::vector<vtkAbstractArray*>& columns, bool& copied)
+  {
+    using ValueType = vtk::GetAPIType<ArrayT>;
+    using ColumnType = vtkAOSDataArrayTemplate<ValueType>;
+    const int ncomp = array->GetNumberOfComponents();
+    std::vector<ValueType*> dst(ncomp);
+    for (int i = 0; i < ncomp; ++i)
+    {
+      ColumnType* column = ColumnType::FastDownCast(columns[i]);
+      if (!column)
+      {
+        return;
+      }
+      dst[i] = column->GetPointer(0);
+    }
+
+    vtkIdType row = 0;
+    for (const auto tuple : vtk::DataArrayTupleRange(array))
+    {
+      for (int i = 0; i < ncomp; ++i)
+      {
+        dst[i][row] = tuple[i];
+      }
+      ++row;
+    }
+    copied = true;
+  }
+};
+
+// Draws M distinct values out of [0, N) uniformly, returned sorted. Uses
+// reservoir sampling with geometric skips (Li's "algorithm L"), hence the
+// number of random draws is O(M log(N/M)) instead of O(N).
+std::vector<vtkIdType> SampleRows(vtkIdType N, vtkIdType M, std::mt19937_64& rng)
+{
+  if (M <= 0 || M >= N)
+  {
+    std::vector<vtkIdType> rows(static_cast<size_t>(std::max<vtkIdType>(std::min(M, N), 0)));
+    std::iota(rows.begin(), rows.end(), 0);
+    return rows;
+  }
+  std::vector<vtkIdType> rows(static_cast<size_t>(M));
+  std::iota(rows.begin(), rows.end(), 0);
+
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::uniform_int_distribution<vtkIdType> slot(0, M - 1);
+  // uniform in (0, 1], so that the logarithms remain finite.
+  auto random = [&]() { return 1.0 - uniform(rng); };
+
+  double w = std::exp(std::log(random()) / M);
+  vtkIdType i = M - 1;
+  while (w < 1.0)
+  {
+    // the skip can be arbitrarily large (even infinite) when w is small, so
+    // compare it to the number of remaining rows before converting it.
+    const double skip = std::floor(std::log(random()) / std::log1p(-w));
+    if (!(skip < static_cast<double>(N - 1 - i)))
+    {
+      break;
+    }
+    i += static_cast<vtkIdType>(skip) + 1;
+    rows[slot(rng)] = i;
+    w *= std::exp(std::log(random()) / M);
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+}
+
 vtkSciVizStatistics::vtkSciVizStatistics()
 {
   this->P = new vtkSciVizStatisticsP;
   this->AttributeMode = vtkDataObject::POINT;
   this->TrainingFraction = 0.1;
+  this->RandomSeed = 0;
   this->Task = MODEL_AND_ASSESS;
   this->SetNumberOfInputPorts(2);  // data + optional model
   this->SetNumberOfOutputPorts(2); // model + assessed input
@@ -47,6 +128,7 @@ void vtkSciVizStatistics::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Task: " << this->Task << "\n";
   os << indent << "AttributeMode: " << this->AttributeMode << "\n";
   os << indent << "TrainingFraction: " << this->TrainingFraction << "\n";
+  os << indent << "RandomSeed: " << this->RandomSeed << "\n";
 }
 
 int vtkSciVizStatistics::GetNumberOfAttributeArrays()
@@ -549,15 +631,22 @@ int vtkSciVizStatistics::PrepareFullDataTable(vtkTable* inTable, vtkFieldData* d
         vtkStringArray* sarr = vtkStringArray::SafeDownCast(arr);
         if (darr)
         {
-          for (int i = 0; i < ncomp; ++i)
+          // Copy with the actual value type; fall back to the generic API
+          // for array types the dispatcher does not know about.
+          bool copied = false;
+          SplitComponentsWorker worker;
+          if (!vtkArrayDispatch::Dispatch::Execute(darr, worker, comps, copied) || !copied)
           {
-            vtkDataArray::SafeDownCast(comps[i])->CopyComponent(0, darr, i);
+            for (int i = 0; i < ncomp; ++i)
+            {
+              vtkDataArray::SafeDownCast(comps[i])->CopyComponent(0, darr, i);
+            }
           }
         }
         else if (sarr)
         {
-          std::vector<vtkStringArray*> scomps;
-          for (int i = 0; i < ncomp; ++i, ++vidx)
+          std::vector<vtkStringArray*> scomps(ncomp);
+          for (int i = 0; i < ncomp; ++i)
           {
             scomps[i] = vtkStringArray::SafeDownCast(comps[i]);
           }
@@ -576,7 +665,7 @@ int vtkSciVizStatistics::PrepareFullDataTable(vtkTable* inTable, vtkFieldData* d
           {
             for (int i = 0; i < ncomp; ++i, ++vidx)
             {
-              comps[i]->InsertVariantValue(j, arr->GetVariantValue(vidx));
+              comps[i]->SetVariantValue(j, arr->GetVariantValue(vidx));
             }
           }
         }
@@ -603,46 +692,34 @@ int vtkSciVizStatistics::PrepareTrainingTable(
 {
   // FIXME: this should eventually eliminate duplicate points as well as subsample...
   //        but will require the original ugrid/polydata/graph.
-  std::set<vtkIdType> trainRows;
   vtkIdType N = fullDataTable->GetNumberOfRows();
-  double frac = static_cast<double>(M) / static_cast<double>(N);
-  for (vtkIdType i = 0; i < N; ++i)
-  {
-    if (vtkMath::Random() < frac)
-    {
-      trainRows.insert(i);
-    }
-  }
-  // Now add or subtract entries as required.
-  N = N - 1;
-  while (static_cast<vtkIdType>(trainRows.size()) > M)
-  {
-    vtkIdType rec = static_cast<vtkIdType>(vtkMath::Random(0, N));
-    trainRows.erase(rec);
-  }
-  while (static_cast<vtkIdType>(trainRows.size()) < M)
-  {
-    vtkIdType rec = static_cast<vtkIdType>(vtkMath::Random(0, N));
-    trainRows.insert(rec);
-  }
-  // Finally, copy the subset into the training table
+  M = std::min(M, N);
+
+  // Seed with the rank so that processes draw different samples.
+  vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
+  const int rank = controller ? controller->GetLocalProcessId() : 0;
+  std::seed_seq seed{ static_cast<unsigned int>(this->RandomSeed),
+    static_cast<unsigned int>(rank) };
+  std::mt19937_64 rng(seed);
+  const std::vector<vtkIdType> trainRows = SampleRows(N, M, rng);
+
+  // Finally, copy the subset into the training table, one column at a time.
+  vtkNew<vtkIdList> srcIds;
+  srcIds->SetNumberOfIds(M);
+  std::copy(trainRows.begin(), trainRows.end(), srcIds->GetPointer(0));
+
   trainingTable->Initialize();
   for (int i = 0; i < fullDataTable->GetNumberOfColumns(); ++i)
   {
     vtkAbstractArray* srcCol = fullDataTable->GetColumn(i);
-    vtkAbstractArray* dstCol = vtkAbstractArray::CreateArray(srcCol->GetDataType());
+    vtkAbstractArray* dstCol = srcCol->NewInstance();
     dstCol->SetName(srcCol->GetName());
+    dstCol->SetNumberOfComponents(srcCol->GetNumberOfComponents());
+    dstCol->SetNumberOfTuples(M);
+    srcCol->GetTuples(srcIds, dstCol);
     trainingTable->AddColumn(dstCol);
     dstCol->FastDelete();
   }
-  trainingTable->SetNumberOfRows(M);
-  vtkNew<vtkVariantArray> row;
-  vtkIdType dstRow = 0;
-  for (std::set<vtkIdType>::iterator it = trainRows.begin(); it != trainRows.end(); ++it, ++dstRow)
-  {
-    fullDataTable->GetRow(*it, row);
-    trainingTable->SetRow(dstRow, row);
-  }
   return 1;
 }
 
@@ -94,16 +94,25 @@ public:
    * regardless of the value of TrainingFraction.
    * The default value is 0.1.
 
-   * The random sample of the original dataset (say, of size N) is obtained by choosing N random
-   numbers in [0,1).
-   * Any sample where the random number is less than \a TrainingFraction is included in the training
-   data.
-   * Samples are then randomly added or removed from the training data until it is the desired size.
+   * The training rows are drawn uniformly without replacement using reservoir sampling, which
+   * needs O(M log(N/M)) random numbers for M training rows out of N, and are copied column by
+   * column preserving their original order.
    */
   vtkSetClampMacro(TrainingFraction, double, 0.0, 1.0);
   vtkGetMacro(TrainingFraction, double);
   //@}
 
+  //@{
+  /**
+   * Set/get the seed used to draw the training data. The seed is combined with
+   * the rank of the process, so that each process draws a different sample
+   * while the model remains reproducible for a given seed and number of
+   * processes. The default value is 0.
+   */
+  vtkSetMacro(RandomSeed, int);
+  vtkGetMacro(RandomSeed, int);
+  //@}
+
   /**\brief Possible tasks the filter can perform.
     *
     * The MODEL_AND_ASSESS task is not recommended;
@@ -209,6 +218,7 @@ protected:
   int AttributeMode;
   int Task;
   double TrainingFraction;
+  int RandomSeed;
   vtkSciVizStatisticsP* P;
 
 private:
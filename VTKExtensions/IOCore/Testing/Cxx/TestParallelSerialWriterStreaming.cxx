@@ -0,0 +1,167 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestParallelSerialWriterStreaming.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkParallelSerialWriter reduces the same data with and without
+// StreamPieces, and that with an append filter the streamed pieces are
+// appended as they arrive rather than all at once.
+
+#include "vtkAppendPolyData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkIntArray.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkParallelSerialWriter.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+
+#define expect(x, msg)                                                                             \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << __LINE__ << ": " msg << endl;                                                          \
+    return false;                                                                                  \
+  }
+
+namespace
+{
+// Records the number of points it appended over all its executions, and
+// keeps a copy of its last output, which is the reduced data.
+class RecordingAppend : public vtkAppendPolyData
+{
+public:
+  static RecordingAppend* New();
+  vtkTypeMacro(RecordingAppend, vtkAppendPolyData);
+
+  vtkIdType NumberOfAppendedPoints = 0;
+  vtkNew<vtkPolyData> LastOutput;
+
+protected:
+  RecordingAppend() = default;
+
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override
+  {
+    for (int cc = 0; cc < inputVector[0]->GetNumberOfInformationObjects(); ++cc)
+    {
+      this->NumberOfAppendedPoints +=
+        vtkPolyData::GetData(inputVector[0], cc)->GetNumberOfPoints();
+    }
+    const int rc = this->Superclass::RequestData(request, inputVector, outputVector);
+    this->LastOutput->DeepCopy(vtkPolyData::GetData(outputVector));
+    return rc;
+  }
+
+private:
+  RecordingAppend(const RecordingAppend&) = delete;
+  void operator=(const RecordingAppend&) = delete;
+};
+vtkStandardNewMacro(RecordingAppend);
+
+// Rank r has r + 1 points, except rank 1 which has none.
+vtkSmartPointer<vtkPolyData> MakePiece(int rank)
+{
+  auto piece = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkIntArray> ranks;
+  ranks->SetName("rank");
+  const int numPoints = rank == 1 ? 0 : rank + 1;
+  for (int cc = 0; cc < numPoints; ++cc)
+  {
+    points->InsertNextPoint(rank, cc, 0);
+    ranks->InsertNextValue(rank);
+  }
+  piece->SetPoints(points);
+  piece->GetPointData()->AddArray(ranks);
+  return piece;
+}
+
+void Write(vtkPolyData* piece, RecordingAppend* helper, bool stream, int rank, int numProcs)
+{
+  // No FileNameMethod is set, so the writer is not invoked and the reduced
+  // data is checked on the helper instead.
+  vtkNew<vtkPolyDataAlgorithm> writer;
+  vtkNew<vtkParallelSerialWriter> psWriter;
+  psWriter->SetWriter(writer);
+  psWriter->SetFileNameMethod(nullptr);
+  psWriter->SetFileName("unused.vtp");
+  psWriter->SetPostGatherHelper(helper);
+  psWriter->SetStreamPieces(stream);
+  psWriter->SetPiece(rank);
+  psWriter->SetNumberOfPieces(numProcs);
+  psWriter->SetInputDataObject(piece);
+  psWriter->Write();
+}
+
+bool Check(RecordingAppend* gathered, RecordingAppend* streamed, int numProcs)
+{
+  vtkPolyData* expected = gathered->LastOutput;
+  vtkPolyData* actual = streamed->LastOutput;
+  int numPoints = 0;
+  for (int rank = 0; rank < numProcs; ++rank)
+  {
+    numPoints += rank == 1 ? 0 : rank + 1;
+  }
+  expect(expected->GetNumberOfPoints() == numPoints, "wrong number of gathered points");
+  expect(actual->GetNumberOfPoints() == numPoints, "wrong number of streamed points");
+  for (vtkIdType cc = 0; cc < numPoints; ++cc)
+  {
+    double e[3], a[3];
+    expected->GetPoint(cc, e);
+    actual->GetPoint(cc, a);
+    expect(std::equal(e, e + 3, a), "streamed points differ from the gathered ones");
+  }
+  expect(actual->GetPointData()->GetArray("rank") != nullptr, "missing point data");
+  // Each point is copied a bounded number of times, rather than once per
+  // piece received after it.
+  expect(
+    streamed->NumberOfAppendedPoints <= 3 * numPoints, "streamed pieces were copied too often");
+  return true;
+}
+}
+
+int TestParallelSerialWriterStreaming(int argc, char* argv[])
+{
+  vtkMPIController* contr = vtkMPIController::New();
+  contr->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(contr);
+
+  const int rank = contr->GetLocalProcessId();
+  const int numProcs = contr->GetNumberOfProcesses();
+
+  int success = 1;
+  {
+    vtkSmartPointer<vtkPolyData> piece = MakePiece(rank);
+    vtkNew<RecordingAppend> gathered;
+    Write(piece, gathered, false, rank, numProcs);
+    vtkNew<RecordingAppend> streamed;
+    Write(piece, streamed, true, rank, numProcs);
+    if (rank == 0)
+    {
+      success = Check(gathered, streamed, numProcs) ? 1 : 0;
+    }
+  }
+
+  int allSuccess = 0;
+  contr->AllReduce(&success, &allSuccess, 1, vtkCommunicator::LOGICAL_AND_OP);
+
+  vtkMultiProcessController::SetGlobalController(nullptr);
+  contr->Finalize();
+  contr->Delete();
+  return allSuccess ? EXIT_SUCCESS : EXIT_FAILURE;
+}
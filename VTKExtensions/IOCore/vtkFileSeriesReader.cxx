@@ -34,6 +34,8 @@
 #include "vtkInformationVector.h"
 #include "vtkLogger.h"
 #include "vtkMath.h"
+#include "vtkMultiProcessController.h"
+#include "vtkMultiProcessStream.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
@@ -46,14 +48,25 @@
 #define VTK_CREATE(type, name) vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
 #include <algorithm>
+#include <cstdio>
 #include <ctype.h> // for isprint().
 #include <map>
+#include <memory>
+#include <sstream>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "vtk_jsoncpp.h"
 
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#include <process.h>
+#define vtkFileSeriesReaderGetPid _getpid
+#else
+#include <unistd.h>
+#define vtkFileSeriesReaderGetPid getpid
+#endif
+
 //=============================================================================
 vtkStandardNewMacro(vtkFileSeriesReader);
 vtkInformationKeyMacro(vtkFileSeriesReader, FILE_SERIES_NUMBER_OF_FILES, Integer);
@@ -379,6 +392,234 @@ private:
 };
 }
 
+//=============================================================================
+namespace
+{
+// Series with fewer files than this are not worth caching.
+const unsigned int vtkFileSeriesMinimumFilesToCache = 64;
+const int vtkFileSeriesTimeCacheVersion = 1;
+
+// Time information reported by the internal reader for one file.
+struct vtkFileSeriesTimeInfo
+{
+  std::vector<double> TimeSteps;
+  std::vector<double> TimeRange;
+
+  void CopyFrom(vtkInformation* info)
+  {
+    this->TimeSteps.clear();
+    this->TimeRange.clear();
+    if (info->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+    {
+      const double* steps = info->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+      this->TimeSteps.assign(
+        steps, steps + info->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()));
+    }
+    if (info->Has(vtkStreamingDemandDrivenPipeline::TIME_RANGE()))
+    {
+      const double* range = info->Get(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+      this->TimeRange.assign(range, range + 2);
+    }
+  }
+
+  void CopyTo(vtkInformation* info) const
+  {
+    info->Remove(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    info->Remove(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+    if (!this->TimeSteps.empty())
+    {
+      info->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), this->TimeSteps.data(),
+        static_cast<int>(this->TimeSteps.size()));
+    }
+    if (this->TimeRange.size() == 2)
+    {
+      info->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), this->TimeRange.data(), 2);
+    }
+  }
+};
+
+void vtkFileSeriesWriteTimeInfos(vtkMultiProcessStream& stream,
+  const std::vector<vtkFileSeriesTimeInfo>& timeInfos, unsigned int begin, unsigned int end)
+{
+  stream << begin << end;
+  for (unsigned int i = begin; i < end; ++i)
+  {
+    stream << static_cast<unsigned int>(timeInfos[i].TimeSteps.size());
+    for (double step : timeInfos[i].TimeSteps)
+    {
+      stream << step;
+    }
+    stream << static_cast<unsigned int>(timeInfos[i].TimeRange.size());
+    for (double value : timeInfos[i].TimeRange)
+    {
+      stream << value;
+    }
+  }
+}
+
+void vtkFileSeriesReadTimeInfos(
+  vtkMultiProcessStream& stream, std::vector<vtkFileSeriesTimeInfo>& timeInfos)
+{
+  unsigned int begin, end;
+  stream >> begin >> end;
+  for (unsigned int i = begin; i < end && i < timeInfos.size(); ++i)
+  {
+    unsigned int count;
+    stream >> count;
+    timeInfos[i].TimeSteps.resize(count);
+    for (unsigned int cc = 0; cc < count; ++cc)
+    {
+      stream >> timeInfos[i].TimeSteps[cc];
+    }
+    stream >> count;
+    timeInfos[i].TimeRange.resize(count);
+    for (unsigned int cc = 0; cc < count; ++cc)
+    {
+      stream >> timeInfos[i].TimeRange[cc];
+    }
+  }
+}
+
+// Returns the name of the time cache file for the given series.
+std::string vtkFileSeriesTimeCacheFileName(
+  const std::string& readerName, const std::vector<std::string>& fileNames)
+{
+  const char* cacheDir = vtksys::SystemTools::GetEnv("PV_FILE_SERIES_CACHE_DIR");
+  if (cacheDir && *cacheDir)
+  {
+    // FNV-1a over the reader and the file names.
+    unsigned long long hash = 14695981039346656037ull;
+    auto hashString = [&hash](const std::string& str) {
+      for (const char c : str)
+      {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+      }
+      hash = (hash ^ 0xffu) * 1099511628211ull;
+    };
+    hashString(readerName);
+    for (const auto& fname : fileNames)
+    {
+      hashString(vtksys::SystemTools::CollapseFullPath(fname));
+    }
+    std::ostringstream name;
+    name << cacheDir << "/series-" << std::hex << hash << ".pvtimes.json";
+    return name.str();
+  }
+
+  const std::string& first = fileNames.front();
+  std::string dir = vtksys::SystemTools::GetFilenamePath(first);
+  return (dir.empty() ? std::string() : dir + "/") + "." +
+    vtksys::SystemTools::GetFilenameName(first) + ".pvtimes.json";
+}
+
+// Fills timeInfos from the cache file, if it exists and matches the reader and
+// the names, sizes and modification times of the files.
+bool vtkFileSeriesReadTimeCache(const std::string& cacheFileName, const std::string& readerName,
+  const std::vector<std::string>& fileNames, std::vector<vtkFileSeriesTimeInfo>& timeInfos)
+{
+  vtksys::ifstream file(cacheFileName.c_str());
+  if (!file)
+  {
+    return false;
+  }
+
+  Json::Value root;
+  Json::CharReaderBuilder builder;
+  builder["collectComments"] = false;
+  std::string errors;
+  if (!Json::parseFromStream(builder, file, &root, &errors) || !root.isObject() ||
+    root["version"].asInt() != vtkFileSeriesTimeCacheVersion ||
+    root["reader"].asString() != readerName)
+  {
+    return false;
+  }
+
+  const Json::Value& files = root["files"];
+  if (!files.isArray() || files.size() != fileNames.size())
+  {
+    return false;
+  }
+
+  std::vector<vtkFileSeriesTimeInfo> cached(fileNames.size());
+  for (Json::ArrayIndex i = 0; i < files.size(); ++i)
+  {
+    const Json::Value& entry = files[i];
+    if (!entry.isObject() || entry["name"].asString() != fileNames[i] ||
+      entry["size"].asUInt64() != vtksys::SystemTools::FileLength(fileNames[i]) ||
+      entry["mtime"].asInt64() != vtksys::SystemTools::ModifiedTime(fileNames[i]))
+    {
+      return false;
+    }
+    for (const auto& step : entry["steps"])
+    {
+      cached[i].TimeSteps.push_back(step.asDouble());
+    }
+    for (const auto& value : entry["range"])
+    {
+      cached[i].TimeRange.push_back(value.asDouble());
+    }
+  }
+  timeInfos.swap(cached);
+  return true;
+}
+
+// Saves timeInfos to the cache file. The file is written under a temporary
+// name, unique to the process and rank, and renamed so that concurrent readers
+// never see a partial file and concurrent writers never write the same file.
+void vtkFileSeriesWriteTimeCache(const std::string& cacheFileName, const std::string& readerName,
+  const std::vector<std::string>& fileNames, const std::vector<vtkFileSeriesTimeInfo>& timeInfos,
+  int processId)
+{
+  Json::Value root(Json::objectValue);
+  root["version"] = vtkFileSeriesTimeCacheVersion;
+  root["reader"] = readerName;
+  Json::Value& files = root["files"] = Json::Value(Json::arrayValue);
+  for (size_t i = 0; i < fileNames.size(); ++i)
+  {
+    Json::Value entry(Json::objectValue);
+    entry["name"] = fileNames[i];
+    entry["size"] = static_cast<Json::UInt64>(vtksys::SystemTools::FileLength(fileNames[i]));
+    entry["mtime"] = static_cast<Json::Int64>(vtksys::SystemTools::ModifiedTime(fileNames[i]));
+    Json::Value& steps = entry["steps"] = Json::Value(Json::arrayValue);
+    for (double step : timeInfos[i].TimeSteps)
+    {
+      steps.append(step);
+    }
+    Json::Value& range = entry["range"] = Json::Value(Json::arrayValue);
+    for (double value : timeInfos[i].TimeRange)
+    {
+      range.append(value);
+    }
+    files.append(entry);
+  }
+
+  std::ostringstream tmpname;
+  tmpname << cacheFileName << "." << vtkFileSeriesReaderGetPid() << "." << processId << ".tmp";
+  const std::string tmpFileName = tmpname.str();
+  {
+    vtksys::ofstream file(tmpFileName.c_str());
+    if (!file)
+    {
+      return;
+    }
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+    writer->write(root, &file);
+    if (!file)
+    {
+      file.close();
+      vtksys::SystemTools::RemoveFile(tmpFileName);
+      return;
+    }
+  }
+  if (!vtksys::SystemTools::RenameFile(tmpFileName, cacheFileName))
+  {
+    vtksys::SystemTools::RemoveFile(tmpFileName);
+  }
+}
+}
+
 //=============================================================================
 struct vtkFileSeriesReaderInternals
 {
@@ -403,15 +644,24 @@ vtkFileSeriesReader::vtkFileSeriesReader()
   this->UseJsonMetaFile = false;
 
   this->IgnoreReaderTime = false;
+  this->DistributeTimeQueries = false;
+  this->UseTimeCache = false;
+
+  this->Controller = NULL;
+  this->SetController(vtkMultiProcessController::GetGlobalController());
 }
 
 //-----------------------------------------------------------------------------
 vtkFileSeriesReader::~vtkFileSeriesReader()
 {
+  this->SetController(NULL);
   delete this->Internal->TimeRanges;
   delete this->Internal;
 }
 
+//-----------------------------------------------------------------------------
+vtkCxxSetObjectMacro(vtkFileSeriesReader, Controller, vtkMultiProcessController);
+
 //----------------------------------------------------------------------------
 void vtkFileSeriesReader::AddFileName(const char* name)
 {
@@ -648,14 +898,7 @@ int vtkFileSeriesReader::RequestInformation(vtkInformation* request,
     this->Internal->TimeRanges->AddTimeRange(0, outInfo);
 
     // Query all the other files for time info.
-    for (unsigned int i = 1; i < numFiles; i++)
-    {
-      // Expose current file number as information key for potential use in the internal reader
-      outputVector->GetInformationObject(requestFromPort)
-        ->Set(FILE_SERIES_CURRENT_FILE_NUMBER(), static_cast<int>(i));
-      this->RequestInformationForInput(static_cast<int>(i), request, outputVector);
-      this->Internal->TimeRanges->AddTimeRange(static_cast<int>(i), outInfo);
-    }
+    this->RequestTimeInformationForInputs(request, outputVector);
   }
 
   // Now that we have collected all of the time information, set the aggregate
@@ -668,6 +911,128 @@ int vtkFileSeriesReader::RequestInformation(vtkInformation* request,
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkFileSeriesReader::RequestTimeInformationForInputs(
+  vtkInformation* request, vtkInformationVector* outputVector)
+{
+  int requestFromPort = request->Has(vtkStreamingDemandDrivenPipeline::FROM_OUTPUT_PORT())
+    ? request->Get(vtkStreamingDemandDrivenPipeline::FROM_OUTPUT_PORT())
+    : 0;
+  vtkInformation* outInfo = outputVector->GetInformationObject(requestFromPort);
+
+  const unsigned int numFiles = this->GetNumberOfFileNames();
+  if (numFiles < 2)
+  {
+    return;
+  }
+
+  vtkMultiProcessController* controller = this->Controller;
+  const int numProcs = controller ? controller->GetNumberOfProcesses() : 1;
+  const int myId = controller ? controller->GetLocalProcessId() : 0;
+  const bool distribute = this->DistributeTimeQueries && numProcs > 1;
+  const bool useCache = this->UseTimeCache && numFiles >= vtkFileSeriesMinimumFilesToCache;
+  const std::string readerName = this->Reader->GetClassName();
+
+  // The internal reader is still on the first file.
+  std::vector<vtkFileSeriesTimeInfo> timeInfos(numFiles);
+  timeInfos[0].CopyFrom(outInfo);
+  std::string cacheFileName;
+  bool cached = false;
+  if (useCache)
+  {
+    cacheFileName = vtkFileSeriesTimeCacheFileName(readerName, this->Internal->FileNames);
+    // When distributing, only the root touches the cache and shares the result.
+    if (!distribute || myId == 0)
+    {
+      cached = vtkFileSeriesReadTimeCache(
+        cacheFileName, readerName, this->Internal->FileNames, timeInfos);
+      vtkLogF(TRACE, "%s: time cache '%s' %s", vtkLogIdentifier(this), cacheFileName.c_str(),
+        cached ? "hit" : "miss");
+    }
+    if (distribute)
+    {
+      vtkMultiProcessStream stream;
+      if (myId == 0)
+      {
+        stream << (cached ? 1 : 0);
+        if (cached)
+        {
+          vtkFileSeriesWriteTimeInfos(stream, timeInfos, 1, numFiles);
+        }
+      }
+      controller->Broadcast(stream, 0);
+      int hit;
+      stream >> hit;
+      cached = (hit != 0);
+      if (cached && myId != 0)
+      {
+        vtkFileSeriesReadTimeInfos(stream, timeInfos);
+      }
+    }
+  }
+
+  if (!cached)
+  {
+    // Each process queries a contiguous block of the remaining files.
+    unsigned int begin = 1;
+    unsigned int end = numFiles;
+    if (distribute)
+    {
+      const unsigned int count = numFiles - 1;
+      begin = 1 + static_cast<unsigned int>(static_cast<unsigned long long>(count) * myId / numProcs);
+      end = 1 +
+        static_cast<unsigned int>(static_cast<unsigned long long>(count) * (myId + 1) / numProcs);
+    }
+    for (unsigned int i = begin; i < end; i++)
+    {
+      // Expose current file number as information key for potential use in the internal reader
+      outInfo->Set(FILE_SERIES_CURRENT_FILE_NUMBER(), static_cast<int>(i));
+      this->RequestInformationForInput(static_cast<int>(i), request, outputVector);
+      timeInfos[i].CopyFrom(outInfo);
+    }
+
+    if (distribute)
+    {
+      vtkMultiProcessStream localStream;
+      vtkFileSeriesWriteTimeInfos(localStream, timeInfos, begin, end);
+      std::vector<vtkMultiProcessStream> allStreams;
+      controller->Gather(localStream, allStreams, 0);
+
+      vtkMultiProcessStream mergedStream;
+      if (myId == 0)
+      {
+        for (auto& stream : allStreams)
+        {
+          vtkFileSeriesReadTimeInfos(stream, timeInfos);
+        }
+        vtkFileSeriesWriteTimeInfos(mergedStream, timeInfos, 1, numFiles);
+      }
+      controller->Broadcast(mergedStream, 0);
+      if (myId != 0)
+      {
+        vtkFileSeriesReadTimeInfos(mergedStream, timeInfos);
+      }
+
+      // Each process stopped on a different file; go back to the first one so
+      // that the internal reader is in the same state everywhere.
+      outInfo->Set(FILE_SERIES_CURRENT_FILE_NUMBER(), 0);
+      this->RequestInformationForInput(0, request, outputVector);
+    }
+
+    if (useCache && myId == 0)
+    {
+      vtkFileSeriesWriteTimeCache(
+        cacheFileName, readerName, this->Internal->FileNames, timeInfos, myId);
+    }
+  }
+
+  for (unsigned int i = 1; i < numFiles; i++)
+  {
+    timeInfos[i].CopyTo(outInfo);
+    this->Internal->TimeRanges->AddTimeRange(static_cast<int>(i), outInfo);
+  }
+}
+
 //----------------------------------------------------------------------------
 int vtkFileSeriesReader::RequestUpdateExtent(vtkInformation* request,
   vtkInformationVector** vtkNotUsed(inputVector), vtkInformationVector* outputVector)
@@ -988,6 +1353,9 @@ void vtkFileSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
      << endl;
   os << indent << "UseMetaFile: " << this->UseMetaFile << endl;
   os << indent << "IgnoreReaderTime: " << this->IgnoreReaderTime << endl;
+  os << indent << "DistributeTimeQueries: " << this->DistributeTimeQueries << endl;
+  os << indent << "UseTimeCache: " << this->UseTimeCache << endl;
+  os << indent << "Controller: " << this->Controller << endl;
 }
 
 //-----------------------------------------------------------------------------
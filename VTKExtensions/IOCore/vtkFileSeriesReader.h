@@ -87,6 +87,7 @@
 
 class vtkInformationIntegerKey;
 class vtkInformationStringKey;
+class vtkMultiProcessController;
 class vtkStringArray;
 
 struct vtkFileSeriesReaderInternals;
@@ -153,6 +154,44 @@ public:
   vtkBooleanMacro(IgnoreReaderTime, bool);
   //@}
 
+  //@{
+  /**
+   * When the internal reader reports time, RequestInformation needs the time
+   * steps of every file in the series. If DistributeTimeQueries is true, the
+   * files are split between the processes of the Controller, each process
+   * queries its share and the results are exchanged, instead of every process
+   * querying every file. RequestInformation must then be called on all
+   * processes, and this must not be turned on for internal readers that
+   * communicate in RequestInformation. False by default.
+   */
+  vtkGetMacro(DistributeTimeQueries, bool);
+  vtkSetMacro(DistributeTimeQueries, bool);
+  vtkBooleanMacro(DistributeTimeQueries, bool);
+  //@}
+
+  //@{
+  /**
+   * If true, the time steps of large series are saved to a cache file and
+   * reused as long as the names, sizes and modification times of the files are
+   * unchanged. The cache is written to the directory named by the
+   * `PV_FILE_SERIES_CACHE_DIR` environment variable if set, otherwise next to
+   * the first file of the series. Failing to write the cache is not an error.
+   * False by default.
+   */
+  vtkGetMacro(UseTimeCache, bool);
+  vtkSetMacro(UseTimeCache, bool);
+  vtkBooleanMacro(UseTimeCache, bool);
+  //@}
+
+  //@{
+  /**
+   * Set/get the controller used to distribute time queries. Defaults to the
+   * global controller.
+   */
+  void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+  //@}
+
   // Expose number of files, first filename and current file number as
   // information keys for potential use in the internal reader
   static vtkInformationIntegerKey* FILE_SERIES_NUMBER_OF_FILES();
@@ -188,6 +227,14 @@ protected:
   virtual int RequestInformationForInput(
     int index, vtkInformation* request = NULL, vtkInformationVector* outputVector = NULL);
 
+  /**
+   * Collects the time information of all files but the first one and adds it
+   * to the time ranges, using the time cache and distributing the queries
+   * between processes when enabled. Called by RequestInformation when the
+   * internal reader reports time.
+   */
+  void RequestTimeInformationForInputs(vtkInformation* request, vtkInformationVector* outputVector);
+
   /**
    * Reads a metadata file and returns a list of filenames (in filesToRead).  If
    * the file could not be read correctly, 0 is returned.
@@ -232,6 +279,9 @@ protected:
   void CopyRealFileNamesFromFileNames();
 
   bool IgnoreReaderTime;
+  bool DistributeTimeQueries;
+  bool UseTimeCache;
+  vtkMultiProcessController* Controller;
 
   int ChooseInput(vtkInformation*);
 
@@ -24,15 +24,18 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiProcessController.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTrivialProducer.h"
 
 #include <algorithm>
 #include <cassert>
 #include <sstream>
 #include <string>
+#include <vector>
 #include <vtksys/SystemTools.hxx>
 
 namespace
@@ -48,6 +51,27 @@ bool vtkIsEmpty(vtkDataObject* dobj)
   }
   return true;
 }
+
+vtkIdType vtkNumberOfElements(vtkDataObject* dobj)
+{
+  vtkIdType count = 0;
+  for (int cc = 0; (dobj != NULL) && (cc < vtkDataObject::NUMBER_OF_ASSOCIATIONS); ++cc)
+  {
+    count += dobj->GetNumberOfElements(cc);
+  }
+  return count;
+}
+
+// Whether reducing partial results gives the same result as reducing all
+// the pieces at once, in which case pieces can be reduced as they arrive.
+// Appending is, and the append filters are the usual helpers.
+bool vtkIsAssociative(vtkAlgorithm* helper)
+{
+  return helper->GetInformation()->Get(vtkReductionFilter::ASSOCIATIVE_REDUCTION()) != 0 ||
+    helper->IsA("vtkAppendPolyData") || helper->IsA("vtkAppendFilter");
+}
+
+const int STREAM_PIECE_TAG = 197221;
 }
 
 vtkStandardNewMacro(vtkParallelSerialWriter);
@@ -59,6 +83,7 @@ vtkCxxSetObjectMacro(vtkParallelSerialWriter, Controller, vtkMultiProcessControl
 vtkParallelSerialWriter::vtkParallelSerialWriter()
   : NumberOfIORanks(1)
   , RankAssignmentMode(vtkParallelSerialWriter::ASSIGNMENT_MODE_CONTIGUOUS)
+  , StreamPieces(false)
   , Controller(nullptr)
   , SubController(nullptr)
 {
@@ -280,21 +305,32 @@ void vtkParallelSerialWriter::WriteAFile(const std::string& filename_arg, vtkDat
 
   const auto filename = this->GetPartitionFileName(filename_arg);
 
-  vtkSmartPointer<vtkReductionFilter> reductionFilter = vtkSmartPointer<vtkReductionFilter>::New();
-  reductionFilter->SetController(controller);
-  reductionFilter->SetPreGatherHelper(this->PreGatherHelper);
-  reductionFilter->SetPostGatherHelper(this->PostGatherHelper);
-  reductionFilter->SetInputDataObject(input);
-  reductionFilter->UpdateInformation();
-  vtkInformation* outInfo = reductionFilter->GetExecutive()->GetOutputInformation(0);
-  outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(), this->Piece);
-  outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(), this->NumberOfPieces);
-  outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(), this->GhostLevel);
-  reductionFilter->Update();
+  vtkSmartPointer<vtkDataObject> output;
+  if (this->StreamPieces)
+  {
+    output = this->StreamToIORank(controller, input);
+  }
+  else
+  {
+    vtkSmartPointer<vtkReductionFilter> reductionFilter =
+      vtkSmartPointer<vtkReductionFilter>::New();
+    reductionFilter->SetController(controller);
+    reductionFilter->SetPreGatherHelper(this->PreGatherHelper);
+    reductionFilter->SetPostGatherHelper(this->PostGatherHelper);
+    reductionFilter->SetInputDataObject(input);
+    reductionFilter->UpdateInformation();
+    vtkInformation* outInfo = reductionFilter->GetExecutive()->GetOutputInformation(0);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(), this->Piece);
+    outInfo->Set(
+      vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(), this->NumberOfPieces);
+    outInfo->Set(
+      vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(), this->GhostLevel);
+    reductionFilter->Update();
+    output = reductionFilter->GetOutputDataObject(0);
+  }
 
   if (controller->GetLocalProcessId() == 0)
   {
-    vtkDataObject* output = reductionFilter->GetOutputDataObject(0);
     if (vtkIsEmpty(output) == false)
     {
       std::ostringstream fname;
@@ -327,6 +363,129 @@ void vtkParallelSerialWriter::WriteAFile(const std::string& filename_arg, vtkDat
   }
 }
 
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> vtkParallelSerialWriter::StreamToIORank(
+  vtkMultiProcessController* controller, vtkDataObject* input)
+{
+  vtkSmartPointer<vtkDataObject> piece = input;
+  if (input && this->PreGatherHelper)
+  {
+    // don't just use the input directly, in that case the pipeline info gets
+    // messed up and PreGatherHelper won't have piece or time info.
+    vtkSmartPointer<vtkDataObject> incopy;
+    incopy.TakeReference(input->NewInstance());
+    incopy->ShallowCopy(input);
+    vtkNew<vtkTrivialProducer> incopyProducer;
+    incopyProducer->SetOutput(incopy);
+    this->PreGatherHelper->RemoveAllInputs();
+    this->PreGatherHelper->AddInputConnection(0, incopyProducer->GetOutputPort());
+    this->PreGatherHelper->Update();
+    vtkDataObject* result = this->PreGatherHelper->GetOutputDataObject(0);
+    piece.TakeReference(result->NewInstance());
+    piece->ShallowCopy(result);
+    this->PreGatherHelper->RemoveAllInputs();
+  }
+
+  const int myId = controller->GetLocalProcessId();
+  const int numProcs = controller->GetNumberOfProcesses();
+
+  // First, only exchange the sizes so that the IO rank knows which ranks have
+  // something to send.
+  const vtkIdType numElements = vtkNumberOfElements(piece);
+  std::vector<vtkIdType> allNumElements(numProcs, 0);
+  controller->Gather(&numElements, allNumElements.data(), 1, 0);
+
+  if (myId != 0)
+  {
+    if (numElements > 0)
+    {
+      controller->Send(piece.GetPointer(), 0, STREAM_PIECE_TAG);
+    }
+    return nullptr;
+  }
+
+  // Then receive the pieces in rank order, one at a time. When the helper
+  // allows it, pieces are reduced in batches as they arrive. A batch is
+  // reduced with the partial result once it is as large as the partial
+  // result, so that each piece is copied about twice overall while the IO
+  // rank holds at most about twice the partial result.
+  const bool appendOnArrival =
+    this->PostGatherHelper != nullptr && vtkIsAssociative(this->PostGatherHelper);
+  vtkSmartPointer<vtkDataObject> output;
+  std::vector<vtkSmartPointer<vtkDataObject> > pieces;
+  vtkIdType outputElements = 0;
+  vtkIdType batchElements = 0;
+  for (int rank = 0; rank < numProcs; ++rank)
+  {
+    if (allNumElements[rank] == 0)
+    {
+      continue;
+    }
+    vtkSmartPointer<vtkDataObject> received = piece;
+    if (rank != myId)
+    {
+      received.TakeReference(controller->ReceiveDataObject(rank, STREAM_PIECE_TAG));
+    }
+    if (!received)
+    {
+      continue;
+    }
+    if (!this->PostGatherHelper)
+    {
+      // allow a passthrough of the first piece, as vtkReductionFilter does.
+      output = output ? output : received;
+    }
+    else if (appendOnArrival)
+    {
+      pieces.push_back(received);
+      batchElements += allNumElements[rank];
+      if (batchElements >= outputElements)
+      {
+        if (output)
+        {
+          pieces.insert(pieces.begin(), output);
+        }
+        output = pieces.size() > 1 ? this->ReducePieces(pieces) : pieces[0];
+        pieces.clear();
+        outputElements += batchElements;
+        batchElements = 0;
+      }
+    }
+    else
+    {
+      pieces.push_back(received);
+    }
+  }
+
+  if (!pieces.empty())
+  {
+    if (output)
+    {
+      pieces.insert(pieces.begin(), output);
+    }
+    output = this->ReducePieces(pieces);
+  }
+  return output;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> vtkParallelSerialWriter::ReducePieces(
+  const std::vector<vtkSmartPointer<vtkDataObject> >& pieces)
+{
+  this->PostGatherHelper->RemoveAllInputs();
+  for (const auto& piece : pieces)
+  {
+    this->PostGatherHelper->AddInputDataObject(piece);
+  }
+  this->PostGatherHelper->Update();
+  vtkDataObject* reduced = this->PostGatherHelper->GetOutputDataObject(0);
+  vtkSmartPointer<vtkDataObject> output;
+  output.TakeReference(reduced->NewInstance());
+  output->ShallowCopy(reduced);
+  this->PostGatherHelper->RemoveAllInputs();
+  return output;
+}
+
 //----------------------------------------------------------------------------
 // Overload standard modified time function. If the internal reader is
 // modified, then this object is modified as well.
@@ -387,4 +546,5 @@ void vtkParallelSerialWriter::SetWriterFileName(const char* fname)
 void vtkParallelSerialWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "StreamPieces: " << this->StreamPieces << endl;
 }
@@ -25,6 +25,14 @@
  *
  * This also makes it possible to write time-series for temporal datasets using
  * simple non-time-aware writers.
+ *
+ * When StreamPieces is on, the pieces are not gathered collectively. The ranks
+ * first exchange the size of their piece, then each IO rank receives the
+ * non-empty pieces one at a time. When the PostGatherHelper is an append
+ * filter, or declares itself associative (see vtkReductionFilter), pieces are
+ * appended to the partial result in batches as they arrive. A batch is
+ * appended once it is as large as the partial result, so that each piece is
+ * copied about twice and the IO ranks hold at most about twice the result.
  */
 
 #ifndef vtkParallelSerialWriter_h
@@ -34,6 +42,7 @@
 #include "vtkPVVTKExtensionsIOCoreModule.h" //needed for exports
 #include "vtkSmartPointer.h"                // needed for vtkSmartPointer
 #include <string>                           // for std::string
+#include <vector>                           // for std::vector
 
 class vtkClientServerInterpreter;
 class vtkMultiProcessController;
@@ -191,6 +200,20 @@ public:
   vtkGetMacro(RankAssignmentMode, int);
   //@}
 
+  //@{
+  /**
+   * When on, each IO rank receives the pieces of its group one rank at a time
+   * instead of gathering them all at once, and ranks with empty pieces do not
+   * send anything. With an associative PostGatherHelper, pieces are reduced as
+   * they arrive, which bounds the peak memory used on the IO ranks for large
+   * data. The PreGatherHelper and PostGatherHelper are applied as usual.
+   * Off by default.
+   */
+  vtkSetMacro(StreamPieces, bool);
+  vtkGetMacro(StreamPieces, bool);
+  vtkBooleanMacro(StreamPieces, bool);
+  //@}
+
   //@{
   /**
    * Get/Set the controller to use. By default initialized to
@@ -218,6 +241,20 @@ private:
   void WriteATimestep(vtkDataObject* input);
   void WriteAFile(const std::string& fname, vtkDataObject* input);
 
+  /**
+   * Reduces `input` to the local rank 0 of `controller` by streaming the
+   * non-empty pieces to it one at a time. Returns the reduced data on the
+   * local rank 0, and nullptr on other ranks.
+   */
+  vtkSmartPointer<vtkDataObject> StreamToIORank(
+    vtkMultiProcessController* controller, vtkDataObject* input);
+
+  /**
+   * Runs the PostGatherHelper on `pieces` and returns a copy of its output.
+   */
+  vtkSmartPointer<vtkDataObject> ReducePieces(
+    const std::vector<vtkSmartPointer<vtkDataObject> >& pieces);
+
   void SetWriterFileName(const char* fname);
   void WriteInternal();
 
@@ -244,6 +281,7 @@ private:
 
   int NumberOfIORanks;
   int RankAssignmentMode;
+  bool StreamPieces;
 
   vtkMultiProcessController* Controller;
   vtkSmartPointer<vtkMultiProcessController> SubController;
@@ -0,0 +1,306 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPhastaReader.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Writes small PHASTA geometry and field files, in native and swapped byte
+// order, and checks that vtkPhastaReader reads the points, cells and the
+// columns of the field blocks, with and without field information, and moves
+// the points with the coordsX, coordsY and coordsZ fields.
+
+#include "vtkByteSwap.h"
+#include "vtkCellType.h"
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkPhastaReader.h"
+#include "vtkPointData.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtksys/FStream.hxx>
+
+#include <string>
+#include <vector>
+
+#define expect(x, msg)                                                                             \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << __LINE__ << ": " msg << endl;                                                          \
+    return EXIT_FAILURE;                                                                           \
+  }
+
+namespace
+{
+// Two hexahedra on a 3x2x2 lattice of points.
+const int NumberOfNodes = 12;
+const int NumberOfElements = 2;
+// Variables of the "solution" block: pressure, velocity, temperature, s1.
+const int NumberOfVariables = 6;
+// Variables of the float "errors" block.
+const int NumberOfErrors = 2;
+
+int NodeId(int i, int j, int k)
+{
+  return i + 3 * (j + 2 * k);
+}
+
+double SolutionValue(int var, int node)
+{
+  return 100.0 * var + node;
+}
+
+float ErrorValue(int var, int node)
+{
+  return 0.5f * var - node;
+}
+
+void WriteHeader(std::ostream& os, const char* key, size_t bytes, const std::vector<int>& values)
+{
+  os << key << " : < " << bytes << " >";
+  for (int value : values)
+  {
+    os << " " << value;
+  }
+  os << "\n";
+}
+
+// Binary blocks are followed by a newline.
+template <typename T>
+void WriteBlock(std::ostream& os, std::vector<T> values, bool swap)
+{
+  if (swap)
+  {
+    vtkByteSwap::SwapVoidRange(values.data(), values.size(), sizeof(T));
+  }
+  os.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+  os << "\n";
+}
+
+void WriteMagicNumber(std::ostream& os, bool swap)
+{
+  os << "# PHASTA Input File Version 2.0\n";
+  WriteHeader(os, "byteorder magic number", sizeof(int) + 1, { 1 });
+  WriteBlock(os, std::vector<int>(1, 362436), swap);
+}
+
+void WriteGeometry(const std::string& fileName, bool swap)
+{
+  vtksys::ofstream os(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  WriteMagicNumber(os, swap);
+  WriteHeader(os, "number of nodes", 0, { NumberOfNodes });
+  WriteHeader(os, "number of interior elements", 0, { NumberOfElements });
+  WriteHeader(os, "number of interior tpblocks", 0, { 1 });
+
+  // Coordinates are stored one component after the other.
+  std::vector<double> coordinates(3 * NumberOfNodes);
+  for (int k = 0; k < 2; ++k)
+  {
+    for (int j = 0; j < 2; ++j)
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        coordinates[NodeId(i, j, k)] = i;
+        coordinates[NumberOfNodes + NodeId(i, j, k)] = j;
+        coordinates[2 * NumberOfNodes + NodeId(i, j, k)] = k;
+      }
+    }
+  }
+  WriteHeader(os, "co-ordinates", coordinates.size() * sizeof(double) + 1, { NumberOfNodes, 3 });
+  WriteBlock(os, coordinates, swap);
+
+  // So is the connectivity, with 1-based vertex ids.
+  std::vector<int> connectivity(8 * NumberOfElements);
+  for (int e = 0; e < NumberOfElements; ++e)
+  {
+    const int hex[8] = { NodeId(e, 0, 0), NodeId(e + 1, 0, 0), NodeId(e + 1, 1, 0),
+      NodeId(e, 1, 0), NodeId(e, 0, 1), NodeId(e + 1, 0, 1), NodeId(e + 1, 1, 1),
+      NodeId(e, 1, 1) };
+    for (int v = 0; v < 8; ++v)
+    {
+      connectivity[v * NumberOfElements + e] = hex[v] + 1;
+    }
+  }
+  WriteHeader(os, "connectivity interior linear hexahedron", connectivity.size() * sizeof(int) + 1,
+    { NumberOfElements, 8, 1, 8, 1, 1, 1 });
+  WriteBlock(os, connectivity, swap);
+}
+
+void WriteField(const std::string& fileName, bool swap)
+{
+  vtksys::ofstream os(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  WriteMagicNumber(os, swap);
+
+  std::vector<double> solution(NumberOfVariables * NumberOfNodes);
+  for (int var = 0; var < NumberOfVariables; ++var)
+  {
+    for (int node = 0; node < NumberOfNodes; ++node)
+    {
+      solution[var * NumberOfNodes + node] = SolutionValue(var, node);
+    }
+  }
+  WriteHeader(
+    os, "solution", solution.size() * sizeof(double) + 1, { NumberOfNodes, NumberOfVariables, 1 });
+  WriteBlock(os, solution, swap);
+
+  std::vector<float> errors(NumberOfErrors * NumberOfNodes);
+  for (int var = 0; var < NumberOfErrors; ++var)
+  {
+    for (int node = 0; node < NumberOfNodes; ++node)
+    {
+      errors[var * NumberOfNodes + node] = ErrorValue(var, node);
+    }
+  }
+  WriteHeader(
+    os, "errors", errors.size() * sizeof(float) + 1, { NumberOfNodes, NumberOfErrors, 1 });
+  WriteBlock(os, errors, swap);
+}
+
+int CheckGeometry(vtkUnstructuredGrid* grid)
+{
+  expect(grid->GetNumberOfPoints() == NumberOfNodes, "wrong number of points");
+  for (int k = 0; k < 2; ++k)
+  {
+    for (int j = 0; j < 2; ++j)
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        double pt[3];
+        grid->GetPoint(NodeId(i, j, k), pt);
+        expect(pt[0] == i && pt[1] == j && pt[2] == k, "wrong point coordinates");
+      }
+    }
+  }
+  expect(grid->GetNumberOfCells() == NumberOfElements, "wrong number of cells");
+  vtkNew<vtkIdList> ptIds;
+  for (int e = 0; e < NumberOfElements; ++e)
+  {
+    expect(grid->GetCellType(e) == VTK_HEXAHEDRON, "wrong cell type");
+    grid->GetCellPoints(e, ptIds);
+    expect(ptIds->GetNumberOfIds() == 8 && ptIds->GetId(0) == NodeId(e, 0, 0) &&
+        ptIds->GetId(2) == NodeId(e + 1, 1, 0) && ptIds->GetId(7) == NodeId(e, 1, 1),
+      "wrong cell connectivity");
+  }
+  return EXIT_SUCCESS;
+}
+
+// Checks that the components of the array are the variables
+// [firstVar, firstVar + numComps) of a block.
+template <typename F>
+int CheckColumns(vtkDataArray* array, int numComps, int firstVar, F value)
+{
+  expect(array != nullptr, "missing array");
+  expect(array->GetNumberOfComponents() == numComps, "wrong number of components");
+  expect(array->GetNumberOfTuples() == NumberOfNodes, "wrong number of tuples");
+  for (int node = 0; node < NumberOfNodes; ++node)
+  {
+    for (int comp = 0; comp < numComps; ++comp)
+    {
+      expect(array->GetComponent(node, comp) == value(firstVar + comp, node), "wrong value");
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+int TestFiles(const std::string& geometry, const std::string& field)
+{
+  // Without field information, the solution gives fixed arrays.
+  vtkNew<vtkPhastaReader> reader;
+  reader->SetGeometryFileName(geometry.c_str());
+  reader->SetFieldFileName(field.c_str());
+  reader->Update();
+  vtkUnstructuredGrid* output = reader->GetOutput();
+  if (CheckGeometry(output) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  vtkPointData* pd = output->GetPointData();
+  if (CheckColumns(pd->GetArray("pressure"), 1, 0, SolutionValue) != EXIT_SUCCESS ||
+    CheckColumns(pd->GetArray("velocity"), 3, 1, SolutionValue) != EXIT_SUCCESS ||
+    CheckColumns(pd->GetArray("temperature"), 1, 4, SolutionValue) != EXIT_SUCCESS ||
+    CheckColumns(pd->GetArray("s1"), 1, 5, SolutionValue) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // With field information, only the requested columns are read.
+  vtkNew<vtkPhastaReader> fieldReader;
+  fieldReader->SetGeometryFileName(geometry.c_str());
+  fieldReader->SetFieldFileName(field.c_str());
+  fieldReader->SetFieldInfo("velocity", "solution", 1, 3, 0, "double");
+  fieldReader->SetFieldInfo("scalar", "solution", 5, 1, 0, "double");
+  fieldReader->SetFieldInfo("error", "errors", 1, 1, 0, "float");
+  fieldReader->Update();
+  output = fieldReader->GetOutput();
+  if (CheckGeometry(output) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  pd = output->GetPointData();
+  expect(pd->GetArray("pressure") == nullptr, "unexpected pressure array");
+  if (CheckColumns(pd->GetArray("velocity"), 3, 1, SolutionValue) != EXIT_SUCCESS ||
+    CheckColumns(pd->GetArray("scalar"), 1, 5, SolutionValue) != EXIT_SUCCESS ||
+    CheckColumns(pd->GetArray("error"), 1, 1, ErrorValue) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Moving mesh: the coordsX, coordsY and coordsZ point arrays replace the
+  // coordinates of the points.
+  vtkNew<vtkPhastaReader> movingReader;
+  movingReader->SetGeometryFileName(geometry.c_str());
+  movingReader->SetFieldFileName(field.c_str());
+  movingReader->SetFieldInfo("coordsX", "solution", 0, 1, 0, "double");
+  movingReader->SetFieldInfo("coordsY", "solution", 4, 1, 0, "double");
+  movingReader->SetFieldInfo("coordsZ", "errors", 1, 1, 0, "float");
+  movingReader->Update();
+  output = movingReader->GetOutput();
+  expect(output->GetNumberOfPoints() == NumberOfNodes, "wrong number of moved points");
+  for (int node = 0; node < NumberOfNodes; ++node)
+  {
+    double pt[3];
+    output->GetPoint(node, pt);
+    expect(pt[0] == SolutionValue(0, node) && pt[1] == SolutionValue(4, node) &&
+        pt[2] == ErrorValue(1, node),
+      "wrong moved point coordinates");
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestPhastaReader(int argc, char* argv[])
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+  {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+  }
+  std::string path = tempDir;
+  path += "/TestPhastaReader";
+  delete[] tempDir;
+
+  for (int swap = 0; swap < 2; ++swap)
+  {
+    std::string geometry = path + (swap ? "-swapped" : "") + ".geombc.dat.1";
+    std::string field = path + (swap ? "-swapped" : "") + ".restart.0.1";
+    WriteGeometry(geometry, swap != 0);
+    WriteField(field, swap != 0);
+    if (TestFiles(geometry, field) != EXIT_SUCCESS)
+    {
+      cerr << "Failed with " << (swap ? "swapped" : "native") << " byte order." << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
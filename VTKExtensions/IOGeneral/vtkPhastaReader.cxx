@@ -15,6 +15,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkPhastaReader.h"
 
 #include "vtkByteSwap.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellType.h" //added for constants such as VTK_TETRA etc...
 #include "vtkDataArray.h"
@@ -22,11 +23,15 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkFloatArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIdTypeArray.h"
 #include "vtkIntArray.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
+#include "vtkSOADataArrayTemplate.h"
 #include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 vtkStandardNewMacro(vtkPhastaReader);
@@ -64,13 +69,6 @@ struct vtkPhastaReaderInternal
 
 // Begin of copy from phastaIO
 
-#define swap_char(A, B)                                                                            \
-  {                                                                                                \
-    ucTmp = A;                                                                                     \
-    A = B;                                                                                         \
-    B = ucTmp;                                                                                     \
-  }
-
 std::map<int, char*> LastHeaderKey;
 std::vector<FILE*> fileArray;
 std::vector<int> byte_order;
@@ -193,6 +191,30 @@ void xfread(void* ptr, size_t size, size_t count, FILE* stream)
   }
 }
 
+// Offsets of the blocks of large files do not fit in a 32-bit long, as on
+// Windows: use the 64-bit variants of ftell and fseek.
+vtkTypeInt64 xftell(FILE* stream)
+{
+#if defined(_WIN32)
+  return _ftelli64(stream);
+#else
+  return static_cast<vtkTypeInt64>(ftello(stream));
+#endif
+}
+
+void xfseek(FILE* stream, vtkTypeInt64 offset)
+{
+#if defined(_WIN32)
+  int ret = _fseeki64(stream, offset, SEEK_SET);
+#else
+  int ret = fseeko(stream, static_cast<off_t>(offset), SEEK_SET);
+#endif
+  if (ret != 0)
+  {
+    vtkGenericWarningMacro(<< "Could not seek to " << offset << endl);
+  }
+}
+
 template <typename... Args>
 void xfscanf(FILE* stream, const char* format, Args... args)
 {
@@ -304,18 +326,7 @@ void vtkPhastaReader::SwapArrayByteOrder(void* array, int nbytes, int nItems)
 {
   /* This swaps the byte order for the array of nItems each
      of size nbytes , This will be called only locally  */
-  int i, j;
-  unsigned char ucTmp;
-  unsigned char* ucDst = (unsigned char*)array;
-
-  for (i = 0; i < nItems; i++)
-  {
-    for (j = 0; j < (nbytes / 2); j++)
-    {
-      swap_char(ucDst[j], ucDst[(nbytes - 1) - j]);
-    }
-    ucDst += nbytes;
-  }
+  vtkByteSwap::SwapVoidRange(array, static_cast<size_t>(nItems), static_cast<size_t>(nbytes));
 }
 
 void vtkPhastaReader::openfile(const char filename[], const char mode[], int* fileDescriptor)
@@ -409,12 +420,9 @@ void vtkPhastaReader::readheader(int* fileDescriptor, const char keyphrase[], vo
   return;
 }
 
-void vtkPhastaReader::readdatablock(int* fileDescriptor, const char keyphrase[], void* valueArray,
-  int* nItems, const char datatype[], const char iotype[])
+int vtkPhastaReader::checkdatablock(int* fileDescriptor, const char keyphrase[])
 {
   int filePtr = *fileDescriptor - 1;
-  FILE* fileObject;
-  char junk;
 
   if (*fileDescriptor < 1 || *fileDescriptor > (int)fileArray.size())
   {
@@ -422,7 +430,7 @@ void vtkPhastaReader::readdatablock(int* fileDescriptor, const char keyphrase[],
                            << "openfile function has to be called before \n"
                            << "accessing the file\n "
                            << "fatal error: cannot continue, returning out of call\n");
-    return;
+    return 0;
   }
 
   // error check..
@@ -438,11 +446,25 @@ void vtkPhastaReader::readdatablock(int* fileDescriptor, const char keyphrase[],
     if (Strict_Error)
     {
       vtkGenericWarningMacro(<< "fatal error: cannot continue, returning out of call\n");
-      return;
+      return 0;
     }
   }
 
   if (LastHeaderNotFound)
+  {
+    return 0;
+  }
+  return 1;
+}
+
+void vtkPhastaReader::readdatablock(int* fileDescriptor, const char keyphrase[], void* valueArray,
+  int* nItems, const char datatype[], const char iotype[])
+{
+  int filePtr = *fileDescriptor - 1;
+  FILE* fileObject;
+  char junk;
+
+  if (!checkdatablock(fileDescriptor, keyphrase))
   {
     return;
   }
@@ -486,6 +508,55 @@ void vtkPhastaReader::readdatablock(int* fileDescriptor, const char keyphrase[],
   return;
 }
 
+// PHASTA blocks store variables one after the other: a block of nItems
+// values is made of columns of columnLength values.  This reads the columns
+// [firstColumn, firstColumn + numColumns) straight into the given buffers,
+// one per column, skipping the other columns of binary blocks.
+void vtkPhastaReader::readdatacolumns(int* fileDescriptor, const char keyphrase[], void** columns,
+  int firstColumn, int numColumns, int columnLength, int* nItems, const char datatype[],
+  const char iotype[])
+{
+  int filePtr = *fileDescriptor - 1;
+  size_t type_size = typeSize(datatype);
+  size_t columnSize = type_size * static_cast<size_t>(columnLength);
+
+  isBinary(iotype);
+  if (!binary_format)
+  {
+    // Ascii values cannot be skipped, read the whole block.
+    std::vector<char> block(type_size * static_cast<size_t>(*nItems));
+    readdatablock(fileDescriptor, keyphrase, block.data(), nItems, datatype, iotype);
+    for (int c = 0; c < numColumns; c++)
+    {
+      memcpy(columns[c], block.data() + (firstColumn + c) * columnSize, columnSize);
+    }
+    return;
+  }
+
+  if (!checkdatablock(fileDescriptor, keyphrase))
+  {
+    return;
+  }
+
+  FILE* fileObject = fileArray[filePtr];
+  Wrong_Endian = byte_order[filePtr];
+  char junk;
+
+  vtkTypeInt64 blockStart = xftell(fileObject);
+  vtkTypeInt64 columnBytes = static_cast<vtkTypeInt64>(columnSize);
+  for (int c = 0; c < numColumns; c++)
+  {
+    xfseek(fileObject, blockStart + (firstColumn + c) * columnBytes);
+    xfread(columns[c], type_size, columnLength, fileObject);
+    if (Wrong_Endian)
+    {
+      SwapArrayByteOrder(columns[c], static_cast<int>(type_size), columnLength);
+    }
+  }
+  xfseek(fileObject, blockStart + static_cast<vtkTypeInt64>(type_size) * (*nItems));
+  xfread(&junk, sizeof(char), 1, fileObject);
+}
+
 // End of copy from phastaIO
 
 vtkPhastaReader::vtkPhastaReader()
@@ -588,9 +659,9 @@ int vtkPhastaReader::RequestData(
   // if there exists point arrays called coordsX, coordsY and coordsZ,
   // create another array of point data and set the output to use this
   vtkPointData* pointData = output->GetPointData();
-  vtkDoubleArray* coordsX = vtkDoubleArray::SafeDownCast(pointData->GetArray("coordsX"));
-  vtkDoubleArray* coordsY = vtkDoubleArray::SafeDownCast(pointData->GetArray("coordsY"));
-  vtkDoubleArray* coordsZ = vtkDoubleArray::SafeDownCast(pointData->GetArray("coordsZ"));
+  vtkDataArray* coordsX = pointData->GetArray("coordsX");
+  vtkDataArray* coordsY = pointData->GetArray("coordsY");
+  vtkDataArray* coordsZ = pointData->GetArray("coordsZ");
   if (coordsX && coordsY && coordsZ)
   {
     vtkIdType numPoints = output->GetPoints()->GetNumberOfPoints();
@@ -604,7 +675,8 @@ int vtkPhastaReader::RequestData(
     points->DeepCopy(output->GetPoints());
     for (vtkIdType i = 0; i < numPoints; i++)
     {
-      points->SetPoint(i, coordsX->GetValue(i), coordsY->GetValue(i), coordsZ->GetValue(i));
+      points->SetPoint(
+        i, coordsX->GetComponent(i, 0), coordsY->GetComponent(i, 0), coordsZ->GetComponent(i, 0));
     }
     output->SetPoints(points);
   }
@@ -612,6 +684,25 @@ int vtkPhastaReader::RequestData(
   return 1;
 }
 
+namespace
+{
+// PHASTA stores coordinates one component after the other, VTK points are
+// interleaved.
+template <typename T>
+void TransposeCoordinates(const double* pos, int numNodes, int dim, T* points)
+{
+  for (int j = 0; j < 3; j++)
+  {
+    const double* column = pos + static_cast<size_t>(j) * numNodes;
+    T* out = points + j;
+    for (int i = 0; i < numNodes; i++, out += 3)
+    {
+      *out = j < dim ? static_cast<T>(column[i]) : T(0);
+    }
+  }
+}
+}
+
 /* firstVertexNo is useful when reading multiple geom files and coalescing
    them into one, ReadGeomfile can then be called repeatedly from Execute with
    firstVertexNo forming consecutive series of vertex numbers */
@@ -622,8 +713,6 @@ void vtkPhastaReader::ReadGeomFile(
 
   /* variables for vtk */
   vtkUnstructuredGrid* output = this->GetOutput();
-  double* coordinates;
-  vtkIdType* nodes;
   int cell_type;
 
   //  int num_tpblocks;
@@ -633,11 +722,9 @@ void vtkPhastaReader::ReadGeomFile(
   // int data[11], data1[7];
   int dim;
   int num_int_blocks;
-  double* pos;
   // int *nlworkdata;
   /* element information */
   int num_elems, num_vertices, num_per_line;
-  int* connectivity = NULL;
 
   /* misc variables*/
   int i, j, k, item;
@@ -690,50 +777,51 @@ void vtkPhastaReader::ReadGeomFile(
 
   /* read the coordinates */
 
-  coordinates = new double[dim];
-  if (coordinates == NULL)
-  {
-    vtkErrorMacro(<< "Unable to allocate memory for nodal info");
-    return;
-  }
-
-  pos = new double[num_nodes * dim];
-  if (pos == NULL)
+  if (dim < 1 || dim > 3)
   {
-    vtkErrorMacro(<< "Unable to allocate memory for nodal info");
-    delete[] coordinates;
+    vtkErrorMacro(<< "Unrecognized dimension in " << geomFileName);
+    closefile(&geomfile, "read");
     return;
   }
 
+  std::vector<double> pos(static_cast<size_t>(num_nodes) * dim);
   item = num_nodes * dim;
-  readdatablock(&geomfile, "co-ordinates", pos, &item, "double", "binary");
+  readdatablock(&geomfile, "co-ordinates", pos.data(), &item, "double", "binary");
 
-  for (i = 0; i < num_nodes; i++)
+  // coordinates are stored one component after the other, transpose them
+  // straight into the points array when possible.
+  points->SetNumberOfPoints(firstVertexNo + num_nodes);
+  if (vtkFloatArray* floatPoints = vtkFloatArray::SafeDownCast(points->GetData()))
   {
-    for (j = 0; j < dim; j++)
-    {
-      coordinates[j] = pos[j * num_nodes + i];
-    }
-    switch (dim)
+    TransposeCoordinates(pos.data(), num_nodes, dim, floatPoints->GetPointer(3 * firstVertexNo));
+  }
+  else if (vtkDoubleArray* doublePoints = vtkDoubleArray::SafeDownCast(points->GetData()))
+  {
+    TransposeCoordinates(pos.data(), num_nodes, dim, doublePoints->GetPointer(3 * firstVertexNo));
+  }
+  else
+  {
+    double coordinates[3] = { 0, 0, 0 };
+    for (i = 0; i < num_nodes; i++)
     {
-      case 1:
-        points->InsertPoint(i + firstVertexNo, coordinates[0], 0, 0);
-        break;
-      case 2:
-        points->InsertPoint(i + firstVertexNo, coordinates[0], coordinates[1], 0);
-        break;
-      case 3:
-        points->InsertNextPoint(coordinates);
-        break;
-      default:
-        vtkErrorMacro(<< "Unrecognized dimension in " << geomFileName);
-        return;
+      for (j = 0; j < dim; j++)
+      {
+        coordinates[j] = pos[j * num_nodes + i];
+      }
+      points->SetPoint(i + firstVertexNo, coordinates);
     }
   }
 
   /* read the connectivity information */
   expect = 7;
 
+  // cells are gathered in flat arrays and handed over to the output at once.
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->InsertNextValue(0);
+  vtkNew<vtkIdTypeArray> cellConnectivity;
+  vtkNew<vtkUnsignedCharArray> cellTypes;
+  std::vector<int> connectivity;
+
   for (k = 0; k < num_int_blocks; k++)
   {
     readheader(&geomfile, "connectivity interior", array, &expect, "integer", "binary");
@@ -742,75 +830,91 @@ void vtkPhastaReader::ReadGeomFile(
     num_elems = array[0];
     num_vertices = array[1];
     num_per_line = array[3];
-    connectivity = new int[num_elems * num_per_line];
 
-    if (connectivity == NULL)
+    // find out element type
+    switch (num_vertices)
     {
-      vtkErrorMacro(<< "Unable to allocate memory for connectivity info");
-      return;
+      case 4:
+        cell_type = VTK_TETRA;
+        break;
+      case 5:
+        cell_type = VTK_PYRAMID;
+        break;
+      case 6:
+        cell_type = VTK_WEDGE;
+        break;
+      case 8:
+        cell_type = VTK_HEXAHEDRON;
+        break;
+      default:
+        vtkErrorMacro(<< "Unrecognized CELL_TYPE in " << geomFileName);
+        closefile(&geomfile, "read");
+        return;
     }
 
+    connectivity.resize(static_cast<size_t>(num_elems) * num_per_line);
     item = num_elems * num_per_line;
-    readdatablock(&geomfile, "connectivity interior", connectivity, &item, "integer", "binary");
+    readdatablock(
+      &geomfile, "connectivity interior", connectivity.data(), &item, "integer", "binary");
+
+    vtkIdType firstCell = cellTypes->GetNumberOfValues();
+    vtkIdType firstId = cellConnectivity->GetNumberOfValues();
+    cellTypes->SetNumberOfValues(firstCell + num_elems);
+    offsets->SetNumberOfValues(firstCell + num_elems + 1);
+    cellConnectivity->SetNumberOfValues(firstId + static_cast<vtkIdType>(num_elems) * num_vertices);
 
-    /* insert cells */
+    unsigned char* types = cellTypes->GetPointer(firstCell);
+    vtkIdType* cellOffsets = offsets->GetPointer(firstCell + 1);
     for (i = 0; i < num_elems; i++)
     {
-      nodes = new vtkIdType[num_vertices];
-
-      // connectivity starts from 1 so node[j] will never be -ve
-      for (j = 0; j < num_vertices; j++)
-      {
-        nodes[j] = connectivity[i + num_elems * j] + firstVertexNo - 1;
-      }
-
-      /* 1 is subtracted from the connectivity info to reflect that in vtk
-         vertex  numbering start from 0 as opposed to 1 in geomfile */
+      types[i] = static_cast<unsigned char>(cell_type);
+      cellOffsets[i] = firstId + static_cast<vtkIdType>(i + 1) * num_vertices;
+    }
 
-      // find out element type
-      switch (num_vertices)
+    /* 1 is subtracted from the connectivity info to reflect that in vtk
+       vertex  numbering start from 0 as opposed to 1 in geomfile */
+    vtkIdType* nodes = cellConnectivity->GetPointer(firstId);
+    for (j = 0; j < num_vertices; j++)
+    {
+      const int* column = connectivity.data() + static_cast<size_t>(num_elems) * j;
+      for (i = 0; i < num_elems; i++)
       {
-        case 4:
-          cell_type = VTK_TETRA;
-          break;
-        case 5:
-          cell_type = VTK_PYRAMID;
-          break;
-        case 6:
-          cell_type = VTK_WEDGE;
-          break;
-        case 8:
-          cell_type = VTK_HEXAHEDRON;
-
-          break;
-        default:
-          delete[] nodes;
-          vtkErrorMacro(<< "Unrecognized CELL_TYPE in " << geomFileName);
-          return;
+        nodes[static_cast<vtkIdType>(i) * num_vertices + j] = column[i] + firstVertexNo - 1;
       }
+    }
+  }
 
-      /* insert the element */
-      output->InsertNextCell(cell_type, num_vertices, nodes);
-      delete[] nodes;
+  /* insert the elements */
+  if (output->GetNumberOfCells() == 0)
+  {
+    vtkNew<vtkCellArray> cells;
+    cells->SetData(offsets, cellConnectivity);
+    output->SetCells(cellTypes, cells);
+  }
+  else
+  {
+    const vtkIdType* nodes = cellConnectivity->GetPointer(0);
+    for (vtkIdType cellId = 0; cellId < cellTypes->GetNumberOfValues(); cellId++)
+    {
+      vtkIdType start = offsets->GetValue(cellId);
+      output->InsertNextCell(
+        cellTypes->GetValue(cellId), offsets->GetValue(cellId + 1) - start, nodes + start);
     }
   }
+
   // update the firstVertexNo so that next slice/partition can be read
   firstVertexNo = firstVertexNo + num_nodes;
 
   // clean up
   closefile(&geomfile, "read");
-  delete[] coordinates;
-  delete[] pos;
-  delete[] connectivity;
 }
 
 void vtkPhastaReader::ReadFieldFile(
   char* fieldFileName, int, vtkDataSetAttributes* field, int& noOfNodes)
 {
 
-  int i, j;
+  int i;
   int item;
-  double* data;
   int fieldfile;
 
   openfile(fieldFileName, "read", &fieldfile);
@@ -826,7 +930,7 @@ void vtkPhastaReader::ReadFieldFile(
   /* read the solution */
   vtkDoubleArray* pressure = vtkDoubleArray::New();
   pressure->SetName("pressure");
-  vtkDoubleArray* velocity = vtkDoubleArray::New();
+  vtkSOADataArrayTemplate<double>* velocity = vtkSOADataArrayTemplate<double>::New();
   velocity->SetName("velocity");
   velocity->SetNumberOfComponents(3);
   vtkDoubleArray* temperature = vtkDoubleArray::New();
@@ -837,21 +941,22 @@ void vtkPhastaReader::ReadFieldFile(
   noOfNodes = array[0];
   this->NumberOfVariables = array[1];
 
+  if (this->NumberOfVariables < 5)
+  {
+    vtkErrorMacro(<< "Expected at least 5 variables in " << fieldFileName << ", got "
+                  << this->NumberOfVariables);
+    pressure->Delete();
+    velocity->Delete();
+    temperature->Delete();
+    closefile(&fieldfile, "read");
+    return;
+  }
+
   vtkDoubleArray* sArrays[4];
   for (i = 0; i < 4; i++)
   {
     sArrays[i] = 0;
   }
-  item = noOfNodes * this->NumberOfVariables;
-  data = new double[item];
-  if (data == NULL)
-  {
-    vtkErrorMacro(<< "Unable to allocate memory for field info");
-    return;
-  }
-
-  readdatablock(&fieldfile, "solution", data, &item, "double", "binary");
-
   for (i = 5; i < this->NumberOfVariables; i++)
   {
     int idx = i - 5;
@@ -865,17 +970,25 @@ void vtkPhastaReader::ReadFieldFile(
   pressure->SetNumberOfTuples(noOfNodes);
   velocity->SetNumberOfTuples(noOfNodes);
   temperature->SetNumberOfTuples(noOfNodes);
-  for (i = 0; i < noOfNodes; i++)
+
+  // Variables are stored one after the other, read each one straight into
+  // its array (component).
+  std::vector<void*> columns(this->NumberOfVariables);
+  columns[0] = pressure->GetPointer(0);
+  for (i = 0; i < 3; i++)
   {
-    pressure->SetTuple1(i, data[i]);
-    velocity->SetTuple3(i, data[noOfNodes + i], data[2 * noOfNodes + i], data[3 * noOfNodes + i]);
-    temperature->SetTuple1(i, data[4 * noOfNodes + i]);
-    for (j = 5; j < this->NumberOfVariables; j++)
-    {
-      sArrays[j - 5]->SetTuple1(i, data[j * noOfNodes + i]);
-    }
+    columns[1 + i] = velocity->GetComponentArrayPointer(i);
+  }
+  columns[4] = temperature->GetPointer(0);
+  for (i = 5; i < this->NumberOfVariables; i++)
+  {
+    columns[i] = sArrays[i - 5]->GetPointer(0);
   }
 
+  item = noOfNodes * this->NumberOfVariables;
+  readdatacolumns(&fieldfile, "solution", columns.data(), 0, this->NumberOfVariables, noOfNodes,
+    &item, "double", "binary");
+
   field->AddArray(pressure);
   field->SetActiveScalars("pressure");
   pressure->Delete();
@@ -894,7 +1007,6 @@ void vtkPhastaReader::ReadFieldFile(
 
   // clean up
   closefile(&fieldfile, "read");
-  delete[] data;
 
 } // closes ReadFieldFile
 
@@ -902,7 +1014,7 @@ void vtkPhastaReader::ReadFieldFile(
   char* fieldFileName, int, vtkUnstructuredGrid* output, int& noOfDatas)
 {
 
-  int i, j, numOfVars;
+  int j, numOfVars;
   int item;
   int fieldfile;
 
@@ -935,19 +1047,16 @@ void vtkPhastaReader::ReadFieldFile(
     else
       field = output->GetPointData();
 
-    // void *data;
-    int dtype; // (0=double, 1=float)
+    // Each component is a column of the PHASTA block: read them straight
+    // into the components of a structure-of-arrays.
     vtkDataArray* dataArray;
-    /* read the field data */
     if (strcmp(dataType, "double") == 0)
     {
-      dataArray = vtkDoubleArray::New();
-      dtype = 0;
+      dataArray = vtkSOADataArrayTemplate<double>::New();
     }
     else if (strcmp(dataType, "float") == 0)
     {
-      dataArray = vtkFloatArray::New();
-      dtype = 1;
+      dataArray = vtkSOADataArrayTemplate<float>::New();
     }
     else
     {
@@ -986,187 +1095,51 @@ void vtkPhastaReader::ReadFieldFile(
       continue;
     }
 
-    item = numOfVars * noOfDatas;
-    if (dtype == 0)
-    { // data is type double
-
-      double* data;
-      data = new double[item];
-
-      if (data == NULL)
-      {
-        vtkErrorMacro(<< "Unable to allocate memory for field info");
-
-        dataArray->Delete();
-        continue;
-      }
-
-      readdatablock(&fieldfile, phastaFieldTag, data, &item, dataType, "binary");
-
-      switch (numOfComps)
-      {
-        case 1:
-        {
-          int offset = index * noOfDatas;
-
-          if (!activeScalars)
-            field->SetActiveScalars(paraviewFieldTag);
-          else
-            activeScalars = 1;
-          for (i = 0; i < noOfDatas; i++)
-          {
-            dataArray->SetTuple1(i, data[offset + i]);
-          }
-        }
+    switch (numOfComps)
+    {
+      case 1:
+        if (!activeScalars)
+          field->SetActiveScalars(paraviewFieldTag);
+        else
+          activeScalars = 1;
         break;
-        case 3:
-        {
-          int offset[3];
-          for (j = 0; j < 3; j++)
-            offset[j] = (index + j) * noOfDatas;
-
-          if (!activeScalars)
-            field->SetActiveVectors(paraviewFieldTag);
-          else
-            activeScalars = 1;
-          for (i = 0; i < noOfDatas; i++)
-          {
-            dataArray->SetTuple3(i, data[offset[0] + i], data[offset[1] + i], data[offset[2] + i]);
-          }
-        }
+      case 3:
+        if (!activeScalars)
+          field->SetActiveVectors(paraviewFieldTag);
+        else
+          activeScalars = 1;
         break;
-        case 9:
-        {
-          int offset[9];
-          for (j = 0; j < 9; j++)
-            offset[j] = (index + j) * noOfDatas;
-
-          if (!activeTensors)
-            field->SetActiveTensors(paraviewFieldTag);
-          else
-            activeTensors = 1;
-          for (i = 0; i < noOfDatas; i++)
-          {
-            dataArray->SetTuple9(i, data[offset[0] + i], data[offset[1] + i], data[offset[2] + i],
-              data[offset[3] + i], data[offset[4] + i], data[offset[5] + i], data[offset[6] + i],
-              data[offset[7] + i], data[offset[8] + i]);
-          }
-        }
+      case 9:
+        if (!activeTensors)
+          field->SetActiveTensors(paraviewFieldTag);
+        else
+          activeTensors = 1;
         break;
-        default:
-          vtkErrorMacro("number of components [" << numOfComps << "] NOT supported");
-
-          dataArray->Delete();
-          delete[] data;
-          continue;
-      }
+      default:
+        vtkErrorMacro("number of components [" << numOfComps << "] NOT supported");
 
-      // clean up
-      delete[] data;
+        dataArray->Delete();
+        continue;
     }
-    else if (dtype == 1)
-    { // data is type float
 
-      float* data;
-      data = new float[item];
-
-      if (data == NULL)
+    std::vector<void*> columns(numOfComps);
+    for (j = 0; j < numOfComps; j++)
+    {
+      if (auto doubleArray = vtkSOADataArrayTemplate<double>::SafeDownCast(dataArray))
       {
-        vtkErrorMacro(<< "Unable to allocate memory for field info");
-
-        dataArray->Delete();
-        continue;
+        columns[j] = doubleArray->GetComponentArrayPointer(j);
       }
-
-      readdatablock(&fieldfile, phastaFieldTag, data, &item, dataType, "binary");
-
-      switch (numOfComps)
+      else
       {
-        case 1:
-        {
-          int offset = index * noOfDatas;
-
-          if (!activeScalars)
-            field->SetActiveScalars(paraviewFieldTag);
-          else
-            activeScalars = 1;
-          for (i = 0; i < noOfDatas; i++)
-          {
-            // double tmpval = (double) data[offset+i];
-            // dataArray->SetTuple1(i, tmpval);
-            dataArray->SetTuple1(i, data[offset + i]);
-          }
-        }
-        break;
-        case 3:
-        {
-          int offset[3];
-          for (j = 0; j < 3; j++)
-            offset[j] = (index + j) * noOfDatas;
-
-          if (!activeScalars)
-            field->SetActiveVectors(paraviewFieldTag);
-          else
-            activeScalars = 1;
-          for (i = 0; i < noOfDatas; i++)
-          {
-            // double tmpval[3];
-            // for(j=0;j<3;j++)
-            //   tmpval[j] = (double) data[offset[j]+i];
-            // dataArray->SetTuple3(i,
-            //                    tmpval[0], tmpval[1], tmpval[3]);
-            dataArray->SetTuple3(i, data[offset[0] + i], data[offset[1] + i], data[offset[2] + i]);
-          }
-        }
-        break;
-        case 9:
-        {
-          int offset[9];
-          for (j = 0; j < 9; j++)
-            offset[j] = (index + j) * noOfDatas;
-
-          if (!activeTensors)
-            field->SetActiveTensors(paraviewFieldTag);
-          else
-            activeTensors = 1;
-          for (i = 0; i < noOfDatas; i++)
-          {
-            // double tmpval[9];
-            // for(j=0;j<9;j++)
-            //   tmpval[j] = (double) data[offset[j]+i];
-            // dataArray->SetTuple9(i,
-            //                     tmpval[0],
-            //                     tmpval[1],
-            //                     tmpval[2],
-            //                     tmpval[3],
-            //                     tmpval[4],
-            //                     tmpval[5],
-            //                     tmpval[6],
-            //                     tmpval[7],
-            //                     tmpval[8]);
-            dataArray->SetTuple9(i, data[offset[0] + i], data[offset[1] + i], data[offset[2] + i],
-              data[offset[3] + i], data[offset[4] + i], data[offset[5] + i], data[offset[6] + i],
-              data[offset[7] + i], data[offset[8] + i]);
-          }
-        }
-        break;
-        default:
-          vtkErrorMacro("number of components [" << numOfComps << "] NOT supported");
-
-          dataArray->Delete();
-          delete[] data;
-          continue;
+        columns[j] = static_cast<vtkSOADataArrayTemplate<float>*>(dataArray)
+                       ->GetComponentArrayPointer(j);
       }
-
-      // clean up
-      delete[] data;
-    }
-    else
-    {
-      vtkErrorMacro("Data type [" << dataType << "] NOT supported");
-      continue;
     }
 
+    item = numOfVars * noOfDatas;
+    readdatacolumns(&fieldfile, phastaFieldTag, columns.data(), index, numOfComps, noOfDatas,
+      &item, dataType, "binary");
+
     field->AddArray(dataArray);
 
     // clean up
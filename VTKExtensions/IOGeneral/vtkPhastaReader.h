@@ -101,8 +101,12 @@ private:
   static void closefile(int* fileDescriptor, const char mode[]);
   static void readheader(int* fileDescriptor, const char keyphrase[], void* valueArray, int* nItems,
     const char datatype[], const char iotype[]);
+  static int checkdatablock(int* fileDescriptor, const char keyphrase[]);
   static void readdatablock(int* fileDescriptor, const char keyphrase[], void* valueArray,
     int* nItems, const char datatype[], const char iotype[]);
+  static void readdatacolumns(int* fileDescriptor, const char keyphrase[], void** columns,
+    int firstColumn, int numColumns, int columnLength, int* nItems, const char datatype[],
+    const char iotype[]);
 
 private:
   vtkPhastaReaderInternal* Internal;
@@ -0,0 +1,112 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestReductionFilterTree.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the tree reduction of vtkReductionFilter merges tables in
+// process order, whichever process the result is reduced to.
+
+#include "vtkIntArray.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkPVMergeTables.h"
+#include "vtkReductionFilter.h"
+#include "vtkTable.h"
+
+#define expect(x, msg)                                                                             \
+  if (!(x))                                                                                        \
+  {                                                                                                \
+    cerr << __LINE__ << ": " msg << endl;                                                          \
+    return EXIT_FAILURE;                                                                           \
+  }
+
+namespace
+{
+// Process `rank` has rank + 1 rows, all set to rank.
+void FillTable(vtkTable* table, int rank)
+{
+  vtkNew<vtkIntArray> values;
+  values->SetName("rank");
+  for (int cc = 0; cc <= rank; ++cc)
+  {
+    values->InsertNextValue(rank);
+  }
+  table->AddColumn(values);
+}
+
+int CheckTable(vtkTable* table, int numProcs)
+{
+  vtkIntArray* values = vtkIntArray::SafeDownCast(table->GetColumnByName("rank"));
+  expect(values != nullptr, "missing column");
+  expect(values->GetNumberOfTuples() == numProcs * (numProcs + 1) / 2, "wrong number of rows");
+  vtkIdType row = 0;
+  for (int rank = 0; rank < numProcs; ++rank)
+  {
+    for (int cc = 0; cc <= rank; ++cc, ++row)
+    {
+      expect(values->GetValue(row) == rank, "rows are not in process order");
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+int Reduce(vtkTable* input, int mode, int destProcessId, int rank, int numProcs)
+{
+  vtkNew<vtkPVMergeTables> merge;
+  vtkNew<vtkReductionFilter> reduction;
+  reduction->SetPostGatherHelper(merge);
+  reduction->SetReductionMode(mode);
+  reduction->SetReductionProcessId(destProcessId);
+  reduction->SetInputData(input);
+  reduction->Update();
+  expect(reduction->IsPostGatherHelperAssociative(), "vtkPVMergeTables should be associative");
+
+  vtkTable* output = vtkTable::SafeDownCast(reduction->GetOutputDataObject(0));
+  expect(output != nullptr, "output is not a table");
+  if (mode == vtkReductionFilter::REDUCE_ALL_TO_ALL || rank == destProcessId)
+  {
+    return CheckTable(output, numProcs);
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestReductionFilterTree(int argc, char* argv[])
+{
+  vtkMPIController* contr = vtkMPIController::New();
+  contr->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(contr);
+
+  const int rank = contr->GetLocalProcessId();
+  const int numProcs = contr->GetNumberOfProcesses();
+
+  vtkNew<vtkTable> input;
+  FillTable(input, rank);
+
+  int status = EXIT_SUCCESS;
+  for (int dest = 0; dest < numProcs && status == EXIT_SUCCESS; ++dest)
+  {
+    status = Reduce(input, vtkReductionFilter::REDUCE_ALL_TO_ONE, dest, rank, numProcs);
+  }
+  if (status == EXIT_SUCCESS)
+  {
+    status = Reduce(input, vtkReductionFilter::REDUCE_ALL_TO_ALL, 0, rank, numProcs);
+  }
+
+  int globalStatus = EXIT_SUCCESS;
+  contr->AllReduce(&status, &globalStatus, 1, vtkCommunicator::MAX_OP);
+
+  vtkMultiProcessController::SetGlobalController(nullptr);
+  contr->Finalize();
+  contr->Delete();
+  return globalStatus;
+}
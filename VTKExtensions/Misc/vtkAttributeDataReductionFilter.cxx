@@ -22,6 +22,7 @@
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
 #include "vtkTable.h"
 
@@ -35,6 +36,7 @@ vtkAttributeDataReductionFilter::vtkAttributeDataReductionFilter()
   this->ReductionType = vtkAttributeDataReductionFilter::ADD;
   this->AttributeType = vtkAttributeDataReductionFilter::POINT_DATA |
     vtkAttributeDataReductionFilter::CELL_DATA | vtkAttributeDataReductionFilter::ROW_DATA;
+  this->GetInformation()->Set(vtkReductionFilter::ASSOCIATIVE_REDUCTION(), 1);
 }
 
 //-----------------------------------------------------------------------------
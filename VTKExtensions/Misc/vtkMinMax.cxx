@@ -27,6 +27,7 @@
 #include "vtkInformationVector.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkReductionFilter.h"
 #include "vtkUnsignedCharArray.h"
 
 #include "vtkMultiProcessController.h"
@@ -44,6 +45,9 @@ vtkMinMax::vtkMinMax()
   this->PFirstPass = NULL;
   this->FirstPasses = NULL;
   this->MismatchOccurred = 0;
+
+  // min/max/sum of partial results is the min/max/sum of all.
+  this->GetInformation()->Set(vtkReductionFilter::ASSOCIATIVE_REDUCTION(), 1);
 }
 
 //-----------------------------------------------------------------------------
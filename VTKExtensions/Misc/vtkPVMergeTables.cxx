@@ -21,6 +21,7 @@
 #include "vtkInformationVector.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkObjectFactory.h"
+#include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
 #include "vtkTable.h"
 
@@ -28,6 +29,7 @@ vtkStandardNewMacro(vtkPVMergeTables);
 //----------------------------------------------------------------------------
 vtkPVMergeTables::vtkPVMergeTables()
 {
+  this->GetInformation()->Set(vtkReductionFilter::ASSOCIATIVE_REDUCTION(), 1);
 }
 
 //----------------------------------------------------------------------------
@@ -25,6 +25,7 @@
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationExecutivePortKey.h"
+#include "vtkInformationIntegerKey.h"
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
@@ -45,6 +46,7 @@
 #include <vector>
 
 vtkStandardNewMacro(vtkReductionFilter);
+vtkInformationKeyMacro(vtkReductionFilter, ASSOCIATIVE_REDUCTION, Integer);
 vtkCxxSetObjectMacro(vtkReductionFilter, Controller, vtkMultiProcessController);
 vtkCxxSetObjectMacro(vtkReductionFilter, PreGatherHelper, vtkAlgorithm);
 vtkCxxSetObjectMacro(vtkReductionFilter, PostGatherHelper, vtkAlgorithm);
@@ -93,6 +95,14 @@ void vtkReductionFilter::SetPostGatherHelperName(const char* name)
   this->SetPostGatherHelper(vtkAlgorithm::SafeDownCast(foo));
 }
 
+//-----------------------------------------------------------------------------
+bool vtkReductionFilter::IsPostGatherHelperAssociative()
+{
+  return this->PostGatherHelper &&
+    this->PostGatherHelper->GetInformation()->Get(vtkReductionFilter::ASSOCIATIVE_REDUCTION()) !=
+    0;
+}
+
 //-----------------------------------------------------------------------------
 int vtkReductionFilter::RequestDataObject(
   vtkInformation* reqInfo, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
@@ -367,6 +377,37 @@ void vtkReductionFilter::Reduce(vtkDataObject* input, vtkDataObject* output)
     }
   }
 
+  if (this->PassThrough < 0 && this->IsPostGatherHelperAssociative() &&
+    !vtkSelection::SafeDownCast(preOutput))
+  {
+    const bool allToAll = this->ReductionMode == vtkReductionFilter::REDUCE_ALL_TO_ALL;
+    const int destProcessId = allToAll ? 0 : this->ReductionProcessId;
+    vtkSmartPointer<vtkDataObject> reduced = this->TreeReduce(preOutput, output, destProcessId);
+    if (myId == destProcessId)
+    {
+      if (reduced)
+      {
+        output->ShallowCopy(reduced);
+      }
+    }
+    else if (preOutput && this->ReductionMode == vtkReductionFilter::REDUCE_ALL_TO_ONE)
+    {
+      vtkSmartPointer<vtkDataObject> inputs[1] = { preOutput };
+      this->PostProcess(output, inputs, 1);
+    }
+
+    if (allToAll)
+    {
+      int hasData = (myId == destProcessId && reduced) ? 1 : 0;
+      controller->Broadcast(&hasData, 1, destProcessId);
+      if (hasData)
+      {
+        controller->Broadcast(output, destProcessId);
+      }
+    }
+    return;
+  }
+
   std::vector<vtkSmartPointer<vtkDataObject> > data_sets;
   std::vector<vtkSmartPointer<vtkDataObject> > receiveData(numProcs);
 
@@ -436,6 +477,100 @@ void vtkReductionFilter::Reduce(vtkDataObject* input, vtkDataObject* output)
     this->PostProcess(output, &data_sets[0], static_cast<unsigned int>(data_sets.size()));
   }
 }
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> vtkReductionFilter::TreeReduce(
+  vtkDataObject* preOutput, vtkDataObject* output, int destProcessId)
+{
+  vtkMultiProcessController* controller = this->Controller;
+  const int numProcs = controller->GetNumberOfProcesses();
+  const int myId = controller->GetLocalProcessId();
+
+  // The tree is always rooted at process 0: each process then merges the
+  // pieces of a contiguous range of processes starting at its own, which
+  // keeps the pieces in process order. The result is forwarded to
+  // destProcessId afterwards.
+  vtkSmartPointer<vtkDataObject> current = preOutput;
+  bool processed = false;
+  for (int step = 1; step < numProcs; step *= 2)
+  {
+    if (myId % (2 * step) != 0)
+    {
+      // Hand the partial result over to the partner and drop out.
+      const int partner = myId - step;
+      int hasData = current ? 1 : 0;
+      controller->Send(&hasData, 1, partner, TREE_REDUCTION_DATA);
+      if (hasData)
+      {
+        controller->Send(current, partner, TREE_REDUCTION_DATA);
+      }
+      current = NULL;
+      break;
+    }
+    if (myId + step >= numProcs)
+    {
+      continue;
+    }
+
+    const int partner = myId + step;
+    int hasData = 0;
+    controller->Receive(&hasData, 1, partner, TREE_REDUCTION_DATA);
+    if (!hasData)
+    {
+      continue;
+    }
+    vtkSmartPointer<vtkDataObject> received;
+    received.TakeReference(controller->ReceiveDataObject(partner, TREE_REDUCTION_DATA));
+    if (!current)
+    {
+      current = received;
+      continue;
+    }
+
+    // The partner holds the pieces of the processes following ours, hence it
+    // goes second to preserve process order.
+    vtkSmartPointer<vtkDataObject> inputs[2] = { current, received };
+    vtkSmartPointer<vtkDataObject> merged;
+    merged.TakeReference(output->NewInstance());
+    this->PostProcess(merged, inputs, 2);
+    current = merged;
+    processed = true;
+  }
+
+  if (myId == 0 && current && !processed)
+  {
+    // Nothing was merged here, still run the helper as the gather path would.
+    vtkSmartPointer<vtkDataObject> inputs[1] = { current };
+    vtkSmartPointer<vtkDataObject> reduced;
+    reduced.TakeReference(output->NewInstance());
+    this->PostProcess(reduced, inputs, 1);
+    current = reduced;
+  }
+
+  if (destProcessId != 0)
+  {
+    if (myId == 0)
+    {
+      int hasData = current ? 1 : 0;
+      controller->Send(&hasData, 1, destProcessId, TREE_REDUCTION_DATA);
+      if (hasData)
+      {
+        controller->Send(current, destProcessId, TREE_REDUCTION_DATA);
+      }
+      current = NULL;
+    }
+    else if (myId == destProcessId)
+    {
+      int hasData = 0;
+      controller->Receive(&hasData, 1, 0, TREE_REDUCTION_DATA);
+      if (hasData)
+      {
+        current.TakeReference(controller->ReceiveDataObject(0, TREE_REDUCTION_DATA));
+      }
+    }
+  }
+  return myId == destProcessId ? current : NULL;
+}
+
 //----------------------------------------------------------------------------
 int vtkReductionFilter::GatherSelection(vtkSelection* sendData,
   std::vector<vtkSmartPointer<vtkDataObject> >& receiveData, int destProcessId)
@@ -486,4 +621,6 @@ void vtkReductionFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Controller: " << this->Controller << endl;
   os << indent << "PassThrough: " << this->PassThrough << endl;
   os << indent << "GenerateProcessIds: " << this->GenerateProcessIds << endl;
+  os << indent << "ReductionMode: " << this->ReductionMode << endl;
+  os << indent << "ReductionProcessId: " << this->ReductionProcessId << endl;
 }
@@ -28,6 +28,22 @@
  * In addition to doing reduction the PassThrough variable lets you choose
  * to pass through the results of any one node instead of aggregating all of
  * them together.
+ *
+ * When the PostGatherHelper is associative, i.e. it accepts its own output as
+ * input and reducing partial reductions gives the same result as reducing
+ * everything at once, the data is reduced along a binary tree instead: at each
+ * step pairs of processes merge their partial results, so that no process
+ * receives more than log2(P) pieces. With REDUCE_ALL_TO_ALL the result is then
+ * broadcast from the root instead of gathering all the data on every process.
+ * Helpers opt into this by setting the ASSOCIATIVE_REDUCTION() key on their
+ * algorithm information:
+ *
+ * @code{cpp}
+ * this->GetInformation()->Set(vtkReductionFilter::ASSOCIATIVE_REDUCTION(), 1);
+ * @endcode
+ *
+ * Pieces are always merged in process order. The tree is not used when
+ * PassThrough is set or when reducing vtkSelection.
 */
 
 #ifndef vtkReductionFilter_h
@@ -38,6 +54,7 @@
 #include "vtkSmartPointer.h"              // needed for vtkSmartPointer.
 #include <vector>                         //  needed for std::vector
 
+class vtkInformationIntegerKey;
 class vtkMultiProcessController;
 class vtkSelection;
 class VTKPVVTKEXTENSIONSMISC_EXPORT vtkReductionFilter : public vtkDataObjectAlgorithm
@@ -126,9 +143,22 @@ public:
 
   enum Tags
   {
-    TRANSMIT_DATA_OBJECT = 23484
+    TRANSMIT_DATA_OBJECT = 23484,
+    TREE_REDUCTION_DATA = 23485
   };
 
+  /**
+   * Key set to 1 on the information of a PostGatherHelper (see
+   * vtkAlgorithm::GetInformation()) to declare that it is associative and can
+   * be used for tree reduction.
+   */
+  static vtkInformationIntegerKey* ASSOCIATIVE_REDUCTION();
+
+  /**
+   * Returns true if the PostGatherHelper declares itself associative.
+   */
+  bool IsPostGatherHelperAssociative();
+
 protected:
   vtkReductionFilter();
   ~vtkReductionFilter() override;
@@ -147,6 +177,15 @@ protected:
   void PostProcess(
     vtkDataObject* output, vtkSmartPointer<vtkDataObject> inputs[], unsigned int num_inputs);
 
+  /**
+   * Reduces preOutput along a binary tree rooted at process 0, running the
+   * PostGatherHelper on pairs of partial results in process order, and sends
+   * the result to destProcessId. Returns the reduced data on destProcessId,
+   * NULL elsewhere or if there is no data.
+   */
+  vtkSmartPointer<vtkDataObject> TreeReduce(
+    vtkDataObject* preOutput, vtkDataObject* output, int destProcessId);
+
   /**
    * Gather for vtkSelection
    * sendData is a vtkSelection while receiveData is a vector of NumberOfProcesses
@@ -2331,6 +2331,38 @@ def GetOpenGLInformation(location=servermanager.vtkSMSession.CLIENT):
     session.GatherInformation(location, openGLInfo, 0)
     return openGLInfo
 
+def EnableTimeline(enable=True, capacity=None):
+    """Enable or disable recording of the execution timeline on the client and
+    on all server processes. `capacity` sets the maximum number of events kept
+    on each process. Use SaveTimeline() to save the recorded events."""
+    timeline = servermanager.misc.Timeline()
+    if capacity is not None:
+        timeline.Capacity = capacity
+    timeline.Enabled = 1 if enable else 0
+    del timeline
+
+def SaveTimeline(filename, clear=False):
+    """Gather the execution timeline recorded on the client and on all server
+    processes and save it as a Chrome trace (JSON) that can be loaded in
+    chrome://tracing or https://ui.perfetto.dev. If `clear` is True, the
+    recorded events are cleared once gathered. See EnableTimeline()."""
+    session = servermanager.ActiveConnection.Session
+    if not servermanager.ActiveConnection.IsRemote():
+        locations = [session.CLIENT_AND_SERVERS]
+    elif session.GetRenderClientMode() == session.RENDERING_UNIFIED:
+        locations = [session.CLIENT, session.SERVERS]
+    else:
+        locations = [session.CLIENT, session.DATA_SERVER, session.RENDER_SERVER]
+
+    timeline = servermanager.vtkPVTimelineInformation()
+    for location in locations:
+        info = servermanager.vtkPVTimelineInformation()
+        info.SetClearEvents(clear)
+        session.GatherInformation(location, info, 0)
+        timeline.AddInformation(info)
+    if not timeline.WriteChromeTrace(filename):
+        raise RuntimeError("Failed to write timeline to '%s'" % filename)
+
 #==============================================================================
 # Usage and demo code set
 #==============================================================================